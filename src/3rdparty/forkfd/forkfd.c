@@ -99,6 +99,7 @@
 
 static int system_has_forkfd(void);
 static int system_forkfd(int flags, pid_t *ppid, int *system);
+static int system_vforkfd(int flags, pid_t *ppid, int (*)(void *), void *token, int *system);
 static int system_forkfd_wait(int ffd, struct forkfd_info *info, int ffdwoptions, struct rusage *rusage);
 
 static int disable_fork_fallback(void)
@@ -764,6 +765,52 @@ err_free:
     freeInfo(header, info);
     return -1;
 }
+
+/**
+ * @brief vforkfd returns a file descriptor representing a child process
+ * @return a file descriptor, or -1 in case of failure
+ *
+ * vforkfd() operates in the same way as forkfd() and the @a flags and @a ppid
+ * arguments are the same as described in forkfd()'s documentation. Unlike
+ * forkfd(), vforkfd() never returns FFD_CHILD_PROCESS: instead, the child
+ * process starts by calling @a childFn with the @a token argument and exits
+ * with its return value as the exit status.
+ *
+ * In addition to the flags accepted by forkfd(), vforkfd() accepts:
+ *
+ * @li @c FFD_VFORK_SEMANTICS Allow the child to be started with vfork(2)
+ * semantics: it shares the parent's memory and the calling thread is
+ * suspended until the child either calls execve(2) or exits. This avoids
+ * copying the parent's page tables, which is expensive for processes with a
+ * large resident set. If this flag is passed, @a childFn must restrict itself
+ * to the operations that are permitted after vfork(2): it must not modify any
+ * memory it does not own and should only call async-signal-safe functions.
+ * This flag is ignored if FFD_USE_FORK is also passed.
+ *
+ * If the system does not support starting the child with vfork(2) semantics,
+ * vforkfd() falls back to forkfd() and calls @a childFn in the forked child.
+ */
+int vforkfd(int flags, pid_t *ppid, int (*childFn)(void *), void *token)
+{
+    int fd;
+
+    if (disable_fork_fallback())
+        flags &= ~FFD_USE_FORK;
+
+    if ((flags & (FFD_USE_FORK | FFD_VFORK_SEMANTICS)) == FFD_VFORK_SEMANTICS) {
+        int system;
+        fd = system_vforkfd(flags, ppid, childFn, token, &system);
+        if (system || disable_fork_fallback())
+            return fd;
+    }
+
+    fd = forkfd(flags & ~FFD_VFORK_SEMANTICS, ppid);
+    if (fd == FFD_CHILD_PROCESS) {
+        /* child process */
+        _exit(childFn(token));
+    }
+    return fd;
+}
 #endif // FORKFD_NO_FORKFD
 
 #if _POSIX_SPAWN > 0 && !defined(FORKFD_NO_SPAWNFD)
@@ -880,6 +927,16 @@ int system_forkfd(int flags, pid_t *ppid, int *system)
     return -1;
 }
 
+int system_vforkfd(int flags, pid_t *ppid, int (*childFn)(void *), void *token, int *system)
+{
+    (void)flags;
+    (void)ppid;
+    (void)childFn;
+    (void)token;
+    *system = 0;
+    return -1;
+}
+
 int system_forkfd_wait(int ffd, struct forkfd_info *info, int options, struct rusage *rusage)
 {
     (void)ffd;
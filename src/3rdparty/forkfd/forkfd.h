@@ -41,6 +41,7 @@ extern "C" {
 #define FFD_CLOEXEC             1
 #define FFD_NONBLOCK            2
 #define FFD_USE_FORK            4
+#define FFD_VFORK_SEMANTICS     8
 
 #define FFD_CHILD_PROCESS (-2)
 
@@ -53,6 +54,7 @@ struct forkfd_info {
 };
 
 int forkfd(int flags, pid_t *ppid);
+int vforkfd(int flags, pid_t *ppid, int (*childFn)(void *), void *token);
 int forkfd_wait4(int ffd, struct forkfd_info *info, int options, struct rusage *rusage);
 static inline int forkfd_wait(int ffd, struct forkfd_info *info, struct rusage *rusage)
 {
@@ -85,6 +85,16 @@ int system_forkfd(int flags, pid_t *ppid, int *system)
     return ret;
 }
 
+int system_vforkfd(int flags, pid_t *ppid, int (*childFn)(void *), void *token, int *system)
+{
+    /* there's no vfork(2) equivalent of pdfork(2), so just fork and run the
+     * child function */
+    int ret = system_forkfd(flags, ppid, system);
+    if (ret == FFD_CHILD_PROCESS)
+        _exit(childFn(token));
+    return ret;
+}
+
 int system_forkfd_wait(int ffd, struct forkfd_info *info, int ffdoptions, struct rusage *rusage)
 {
     pid_t pid;
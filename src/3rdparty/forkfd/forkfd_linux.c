@@ -36,6 +36,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/resource.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
@@ -131,16 +132,33 @@ int system_has_forkfd()
     return ffd_atomic_load(&system_forkfd_state, FFD_ATOMIC_RELAXED) > 0;
 }
 
-int system_forkfd(int flags, pid_t *ppid, int *system)
+static int system_forkfd_availability()
 {
-    pid_t pid;
-    int pidfd;
-
     int state = ffd_atomic_load(&system_forkfd_state, FFD_ATOMIC_RELAXED);
     if (state == 0) {
         state = detect_clone_pidfd_support();
         ffd_atomic_store(&system_forkfd_state, state, FFD_ATOMIC_RELAXED);
     }
+    return state;
+}
+
+static int system_forkfd_pidfd_set_flags(int pidfd, int flags)
+{
+    if ((flags & FFD_CLOEXEC) == 0) {
+        /* pidfd defaults to O_CLOEXEC */
+        fcntl(pidfd, F_SETFD, 0);
+    }
+    if (flags & FFD_NONBLOCK)
+        fcntl(pidfd, F_SETFL, fcntl(pidfd, F_GETFL) | O_NONBLOCK);
+    return pidfd;
+}
+
+int system_forkfd(int flags, pid_t *ppid, int *system)
+{
+    pid_t pid;
+    int pidfd;
+
+    int state = system_forkfd_availability();
     if (state < 0) {
         *system = 0;
         return state;
@@ -160,13 +178,64 @@ int system_forkfd(int flags, pid_t *ppid, int *system)
     }
 
     /* parent process */
-    if ((flags & FFD_CLOEXEC) == 0) {
-        /* pidfd defaults to O_CLOEXEC */
-        fcntl(pidfd, F_SETFD, 0);
+    return system_forkfd_pidfd_set_flags(pidfd, flags);
+}
+
+int system_vforkfd(int flags, pid_t *ppid, int (*childFn)(void *), void *token, int *system)
+{
+    /*
+     * The child runs on its own stack while we are suspended by CLONE_VFORK.
+     * It needs to be large enough for childFn and for the dynamic linker
+     * resolving the symbols it calls (which saves the full vector register
+     * state), so we use the same 32 kB that glibc's posix_spawn uses. A
+     * PROT_NONE guard page turns an overflow into a crash of the child
+     * instead of a silent corruption of whatever is mapped next to it.
+     */
+    const size_t childStackSize = 32 * 1024;
+    size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    size_t stackSize = (childStackSize + pageSize - 1) & ~(pageSize - 1);
+    size_t mapSize = stackSize + pageSize;
+    char *map;
+    pid_t pid;
+    int pidfd;
+    int saved_errno;
+
+    int state = system_forkfd_availability();
+    if (state < 0) {
+        *system = 0;
+        return state;
     }
-    if (flags & FFD_NONBLOCK)
-        fcntl(pidfd, F_SETFL, fcntl(pidfd, F_GETFL) | O_NONBLOCK);
-    return pidfd;
+
+    *system = 1;
+    map = (char *)mmap(NULL, mapSize, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    if (map == MAP_FAILED)
+        return -1;
+
+    unsigned long cloneflags = CLONE_PIDFD | CLONE_VFORK | CLONE_VM | SIGCHLD;
+#if defined(__hppa__)
+    /* the stack grows upwards on PA-RISC, so the guard page goes on top */
+    if (mprotect(map + stackSize, pageSize, PROT_NONE) == 0)
+        pid = clone(childFn, map, cloneflags, token, &pidfd, NULL, NULL);
+#else
+    if (mprotect(map, pageSize, PROT_NONE) == 0)
+        pid = clone(childFn, map + mapSize, cloneflags, token, &pidfd, NULL, NULL);
+#endif
+    else
+        pid = -1;
+
+    /* the child has either exec'ed or exited by now, so it's done with the stack */
+    saved_errno = errno;
+    munmap(map, mapSize);
+    errno = saved_errno;
+
+    if (pid < 0)
+        return pid;
+    if (ppid)
+        *ppid = pid;
+
+    /* parent process (the child has either exec'ed or exited by now) */
+    return system_forkfd_pidfd_set_flags(pidfd, flags);
 }
 
 int system_forkfd_wait(int ffd, struct forkfd_info *info, int ffdoptions, struct rusage *rusage)
@@ -138,4 +138,14 @@ if (!in.commitTransaction())
     return;     // wait for more data
 //! [6]
 
+//! [7]
+QFile file("cache.dat");
+file.open(QIODevice::ReadOnly);
+const uchar *memory = file.map(0, file.size());
+QDataStream in(QByteArray::fromRawData(reinterpret_cast<const char *>(memory), file.size()));
+in.setZeroCopyEnabled(true);
+QByteArray blob;
+in >> blob;     // refers to the mapped file, no copy is made
+//! [7]
+
 }
@@ -186,3 +186,15 @@ QVariant MyModel::data(const QModelIndex &index, int role) const
     return roleData.data();
 }
 //! [16]
+
+//! [17]
+QList<QModelRoleData> roleData;
+for (int item = 0; item < 2 * 3; ++item) {
+    roleData.append(QModelRoleData(Qt::DisplayRole));
+    roleData.append(QModelRoleData(Qt::DecorationRole));
+}
+
+model->rangeData(model->index(0, 0), model->index(1, 2), roleData);
+
+// roleData[6].data() is the text of the item in row 1, column 0
+//! [17]
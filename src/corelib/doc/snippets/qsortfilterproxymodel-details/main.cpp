@@ -50,6 +50,7 @@
 
 #include <QtGui>
 #include <QApplication>
+#include <QLineEdit>
 #include <QSortFilterProxyModel>
 
 class MyItemModel : public QStandardItemModel
@@ -97,6 +98,23 @@ Widget::Widget(QWidget *parent)
         proxyModel->setFilterRegularExpression(QRegularExpression("\.png", QRegularExpression::CaseInsensitiveOption));
         proxyModel->setFilterKeyColumn(1);
 //! [5]
+
+//! [6]
+        QLineEdit *searchEdit = new QLineEdit(this);
+        proxyModel->setFilterTimeSlice(10);
+        connect(searchEdit, &QLineEdit::textEdited, proxyModel,
+                [proxyModel, previousText = QString()](const QString &text) mutable {
+            using FilterChange = QSortFilterProxyModel::FilterChange;
+            FilterChange change = FilterChange::Unspecified;
+            if (text.contains(previousText))
+                change = FilterChange::Narrowing;
+            else if (previousText.contains(text))
+                change = FilterChange::Widening;
+            previousText = text;
+            proxyModel->setFilterRegularExpression(
+                    QRegularExpression(QRegularExpression::escape(text)), change);
+        });
+//! [6]
 }
 
 int main(int argc, char *argv[])
@@ -56,6 +56,10 @@
 #include "qdatetime.h"
 #include "qcoreapplication.h"
 #include "qthread.h"
+#if QT_CONFIG(thread)
+#include "qwaitcondition.h"
+#include <thread>
+#endif
 #include "private/qloggingregistry_p.h"
 #include "private/qcoreapplication_p.h"
 #include "private/qsimd_p.h"
@@ -161,6 +165,7 @@ static QT_PREPEND_NAMESPACE(qint64) qt_gettid()
 
 #include <cstdlib>
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -1734,6 +1739,343 @@ static bool wasm_default_message_handler(QtMsgType type,
 
 // --------------------------------------------------------------------------
 
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(thread) && defined(Q_COMPILER_THREAD_LOCAL)
+#  define QLOGGING_HAVE_ASYNC_OUTPUT
+#endif
+
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+namespace {
+/*
+    Asynchronous output for the default stderr message handler, enabled by
+    setting QT_LOGGING_ASYNC=1 in the environment.
+
+    Messages are still formatted by the thread logging them, but instead of
+    writing them to stderr, that thread appends them to a ring buffer of its
+    own. Only the owning thread writes into a ring and only drain() reads
+    from it, so logging takes no lock. A background thread drains all rings,
+    merging them in the order in which the messages were logged.
+
+    Memory is bounded by the ring size per logging thread. When a ring is
+    full, its thread drains all rings itself, or, if QT_LOGGING_ASYNC_OVERFLOW
+    is set to "drop", drops the message and reports the number of dropped
+    messages with the next output. Everything is written out before a fatal
+    message terminates the application, and when the application exits.
+*/
+class QAsyncMessageRing
+{
+public:
+    enum : quint32 { Capacity = 64 * 1024 }; // must be a power of two
+
+    struct Header
+    {
+        quint64 sequence;
+        quint32 size;
+        quint32 reserved;
+    };
+
+    static quint32 recordSize(quint32 size)
+    {
+        return (quint32(sizeof(Header)) + size + 7) & ~7u;
+    }
+
+    static bool fits(qsizetype size)
+    {
+        return size <= qsizetype(Capacity - sizeof(Header));
+    }
+
+    bool tryAppend(quint64 sequence, const QByteArray &message)
+    {
+        const quint32 size = quint32(message.size());
+        const quint32 head = m_head.loadRelaxed();
+        if (Capacity - (head - m_tail.loadAcquire()) < recordSize(size))
+            return false;
+
+        const Header header = { sequence, size, 0 };
+        write(head, &header, sizeof(header));
+        write(head + sizeof(header), message.constData(), size);
+        m_head.storeRelease(head + recordSize(size));
+        return true;
+    }
+
+    void read(quint32 pos, void *data, quint32 size) const
+    {
+        const quint32 offset = pos & (Capacity - 1);
+        const quint32 first = qMin(size, Capacity - offset);
+        memcpy(data, m_buffer + offset, first);
+        memcpy(static_cast<char *>(data) + first, m_buffer, size - first);
+    }
+
+    QAtomicInteger<quint32> m_head;  // advanced by the owning thread only
+    QAtomicInteger<quint32> m_tail;  // advanced by drain() only
+    QAtomicInt m_orphaned;           // the owning thread has exited
+
+private:
+    void write(quint32 pos, const void *data, quint32 size)
+    {
+        const quint32 offset = pos & (Capacity - 1);
+        const quint32 first = qMin(size, Capacity - offset);
+        memcpy(m_buffer + offset, data, first);
+        memcpy(m_buffer, static_cast<const char *>(data) + first, size - first);
+    }
+
+    char m_buffer[Capacity];
+};
+
+struct QAsyncMessageRingHolder
+{
+    QAsyncMessageRing *ring = nullptr;
+
+    ~QAsyncMessageRingHolder()
+    {
+        // the ring is deleted by drain() once it has been emptied
+        if (ring)
+            ring->m_orphaned.storeRelease(1);
+        ring = nullptr;
+    }
+};
+
+static thread_local QAsyncMessageRingHolder currentAsyncMessageRing;
+
+class QAsyncMessageOutput
+{
+public:
+    QAsyncMessageOutput();
+    ~QAsyncMessageOutput();
+
+    void append(const QByteArray &message);
+    void flush();
+
+private:
+    QAsyncMessageRing *currentRing();
+    bool hasPendingMessages();
+    bool drain();
+    void wakeWriter();
+    void run();
+
+    QAtomicInteger<quint64> m_sequence;
+    QAtomicInteger<quint64> m_dropped;
+    QAtomicInt m_writerIdle;
+    const bool m_dropOnOverflow;
+
+    QMutex m_ringsMutex;            // protects m_rings
+    QList<QAsyncMessageRing *> m_rings;
+
+    QMutex m_drainMutex;            // serializes drain()
+    QByteArray m_output;
+
+    QMutex m_wakeMutex;             // protects m_stopping
+    QWaitCondition m_wakeUp;
+    bool m_stopping = false;
+    std::thread m_writer;
+};
+
+QAsyncMessageOutput::QAsyncMessageOutput()
+    : m_dropOnOverflow(qgetenv("QT_LOGGING_ASYNC_OVERFLOW") == "drop")
+{
+    QT_TRY {
+        m_writer = std::thread([this] { run(); });
+    } QT_CATCH (...) {
+        // Without a writer, the rings are drained when full, before fatal
+        // messages and on exit.
+    }
+}
+
+QAsyncMessageOutput::~QAsyncMessageOutput()
+{
+    if (m_writer.joinable()) {
+        {
+            const auto locker = qt_scoped_lock(m_wakeMutex);
+            m_stopping = true;
+            m_wakeUp.wakeOne();
+        }
+        m_writer.join();
+    }
+    flush();
+    // The rings are not deleted: threads that are still running may log
+    // into them (and onto stderr directly) until the process ends.
+}
+
+QAsyncMessageRing *QAsyncMessageOutput::currentRing()
+{
+    QAsyncMessageRing *ring = currentAsyncMessageRing.ring;
+    if (Q_UNLIKELY(!ring)) {
+        ring = new QAsyncMessageRing;
+        const auto locker = qt_scoped_lock(m_ringsMutex);
+        m_rings.append(ring);
+        currentAsyncMessageRing.ring = ring;
+    }
+    return ring;
+}
+
+void QAsyncMessageOutput::append(const QByteArray &message)
+{
+    const quint64 sequence = m_sequence.fetchAndAddRelaxed(1);
+    if (QAsyncMessageRing::fits(message.size())) {
+        if (Q_LIKELY(currentRing()->tryAppend(sequence, message))) {
+            wakeWriter();
+            return;
+        }
+        if (m_dropOnOverflow) {
+            m_dropped.fetchAndAddRelaxed(1);
+            return;
+        }
+    }
+
+    // Write out what is queued on this thread, so memory stays bounded and
+    // the order of our own messages is kept.
+    const auto locker = qt_scoped_lock(m_drainMutex);
+    drain();
+    fwrite(message.constData(), 1, message.size(), stderr);
+    fflush(stderr);
+}
+
+void QAsyncMessageOutput::flush()
+{
+    const auto locker = qt_scoped_lock(m_drainMutex);
+    drain();
+}
+
+bool QAsyncMessageOutput::hasPendingMessages()
+{
+    const auto locker = qt_scoped_lock(m_ringsMutex);
+    for (const QAsyncMessageRing *ring : qAsConst(m_rings)) {
+        if (ring->m_head.loadAcquire() != ring->m_tail.loadRelaxed())
+            return true;
+    }
+    return m_dropped.loadRelaxed() != 0;
+}
+
+// Called with m_drainMutex locked. Returns true if anything was written.
+bool QAsyncMessageOutput::drain()
+{
+    struct Cursor
+    {
+        QAsyncMessageRing *ring;
+        quint32 pos;
+        quint32 end;
+        QAsyncMessageRing::Header header;
+    };
+    QVarLengthArray<Cursor, 32> cursors;
+    {
+        const auto locker = qt_scoped_lock(m_ringsMutex);
+        for (QAsyncMessageRing *ring : qAsConst(m_rings)) {
+            Cursor cursor = { ring, ring->m_tail.loadRelaxed(), ring->m_head.loadAcquire(), {} };
+            if (cursor.pos != cursor.end)
+                ring->read(cursor.pos, &cursor.header, sizeof(cursor.header));
+            cursors.append(cursor);
+        }
+    }
+
+    m_output.clear();
+    // merge the rings by sequence number
+    for (;;) {
+        Cursor *next = nullptr;
+        for (Cursor &cursor : cursors) {
+            if (cursor.pos != cursor.end
+                    && (!next || cursor.header.sequence < next->header.sequence)) {
+                next = &cursor;
+            }
+        }
+        if (!next)
+            break;
+
+        const quint32 size = next->header.size;
+        const qsizetype offset = m_output.size();
+        m_output.resize(offset + size);
+        next->ring->read(next->pos + sizeof(QAsyncMessageRing::Header), m_output.data() + offset, size);
+        next->pos += QAsyncMessageRing::recordSize(size);
+        if (next->pos != next->end)
+            next->ring->read(next->pos, &next->header, sizeof(next->header));
+    }
+
+    // messages are only dropped when a ring is full, i.e. after what it holds
+    if (const quint64 dropped = m_dropped.fetchAndStoreRelaxed(0)) {
+        m_output += "QT_LOGGING_ASYNC: " + QByteArray::number(dropped)
+                + " message(s) dropped, the log buffer was full\n";
+    }
+
+    if (!m_output.isEmpty()) {
+        fwrite(m_output.constData(), 1, m_output.size(), stderr);
+        fflush(stderr);
+    }
+
+    // only now release the space, so that a full ring means unwritten output
+    bool hasOrphans = false;
+    for (const Cursor &cursor : qAsConst(cursors)) {
+        cursor.ring->m_tail.storeRelease(cursor.pos);
+        hasOrphans |= cursor.ring->m_orphaned.loadRelaxed() != 0;
+    }
+
+    if (hasOrphans) {
+        const auto locker = qt_scoped_lock(m_ringsMutex);
+        for (qsizetype i = m_rings.size() - 1; i >= 0; --i) {
+            QAsyncMessageRing *ring = m_rings.at(i);
+            if (ring->m_orphaned.loadAcquire()
+                    && ring->m_head.loadAcquire() == ring->m_tail.loadRelaxed()) {
+                m_rings.removeAt(i);
+                delete ring;
+            }
+        }
+    }
+
+    return !m_output.isEmpty();
+}
+
+void QAsyncMessageOutput::wakeWriter()
+{
+    // pairs with the fence in run(): either we see the writer idle, or it
+    // sees our message before going to sleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_writerIdle.loadRelaxed()) {
+        const auto locker = qt_scoped_lock(m_wakeMutex);
+        m_wakeUp.wakeOne();
+    }
+}
+
+void QAsyncMessageOutput::run()
+{
+    for (;;) {
+        bool wrote;
+        {
+            const auto locker = qt_scoped_lock(m_drainMutex);
+            wrote = drain();
+        }
+        if (wrote)
+            continue;
+
+        const auto locker = qt_scoped_lock(m_wakeMutex);
+        if (m_stopping)
+            break;
+        m_writerIdle.storeRelaxed(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!hasPendingMessages())
+            m_wakeUp.wait(&m_wakeMutex);
+        m_writerIdle.storeRelaxed(0);
+    }
+}
+} // unnamed namespace
+
+Q_GLOBAL_STATIC(QAsyncMessageOutput, asyncMessageOutput)
+
+static bool asyncOutputEnabled()
+{
+    static const bool enabled = qEnvironmentVariableIntValue("QT_LOGGING_ASYNC");
+    return enabled;
+}
+#endif // QLOGGING_HAVE_ASYNC_OUTPUT
+
+/*!
+    \internal
+    Writes out all messages queued by the asynchronous output, if enabled.
+*/
+static void flushAsyncOutput()
+{
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+    if (asyncOutputEnabled() && asyncMessageOutput.exists())
+        asyncMessageOutput->flush();
+#endif
+}
+
 static void stderr_message_handler(QtMsgType type, const QMessageLogContext &context, const QString &message)
 {
     QString formattedMessage = qFormatLogMessage(type, context, message);
@@ -1743,6 +2085,13 @@ static void stderr_message_handler(QtMsgType type, const QMessageLogContext &con
     if (formattedMessage.isNull())
         return;
 
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+    if (asyncOutputEnabled() && !asyncMessageOutput.isDestroyed()) {
+        asyncMessageOutput->append(formattedMessage.append(QLatin1Char('\n')).toLocal8Bit());
+        return;
+    }
+#endif
+
     fprintf(stderr, "%s\n", formattedMessage.toLocal8Bit().constData());
     fflush(stderr);
 }
@@ -1839,12 +2188,16 @@ static void qt_message_print(const QString &message)
         return;
     }
 #endif
+    flushAsyncOutput();
     fprintf(stderr, "%s", message.toLocal8Bit().constData());
     fflush(stderr);
 }
 
 static void qt_message_fatal(QtMsgType, const QMessageLogContext &context, const QString &message)
 {
+    // don't lose what was logged before the fatal message
+    flushAsyncOutput();
+
 #if defined(Q_CC_MSVC) && defined(QT_DEBUG) && defined(_DEBUG) && defined(_CRT_ERROR)
     wchar_t contextFileL[256];
     // we probably should let the compiler do this for us, by declaring QMessageLogContext::file to
@@ -1969,6 +2322,16 @@ void qErrnoWarning(int code, const char *msg, ...)
     output under X11 or to the debugger under Windows. If it is a
     fatal message, the application aborts immediately.
 
+    When the default message handler writes to \c stderr, it can do so
+    asynchronously: if the \c QT_LOGGING_ASYNC environment variable is set
+    to \c 1, messages are formatted by the thread logging them and then
+    written by a background thread, in the order they were logged. Each
+    logging thread buffers up to 64 KiB of messages; when its buffer is
+    full, the thread writes out the queued messages itself, or drops the
+    message if \c QT_LOGGING_ASYNC_OVERFLOW is set to \c drop. Queued
+    messages are always written before a fatal message aborts the
+    application, and when the application exits.
+
     Only one message handler can be defined, since this is usually
     done on an application-wide basis to control debug output.
 
@@ -3,6 +3,7 @@
 HEADERS +=  \
         io/qabstractfileengine_p.h \
         io/qbuffer.h \
+        io/qcompressiondevice.h \
         io/qdataurl_p.h \
         io/qdebug.h \
         io/qdebug_p.h \
@@ -26,6 +27,7 @@ HEADERS +=  \
         io/qtemporaryfile_p.h \
         io/qresource_p.h \
         io/qresource_iterator_p.h \
+        io/qresourcepathhash_p.h \
         io/qsavefile.h \
         io/qstandardpaths.h \
         io/qstorageinfo.h \
@@ -42,11 +44,13 @@ HEADERS +=  \
         io/qfileselector.h \
         io/qfileselector_p.h \
         io/qloggingcategory.h \
+        io/qlogrecord.h \
         io/qloggingregistry_p.h
 
 SOURCES += \
         io/qabstractfileengine.cpp \
         io/qbuffer.cpp \
+        io/qcompressiondevice.cpp \
         io/qdataurl.cpp \
         io/qdebug.cpp \
         io/qdir.cpp \
@@ -75,6 +79,7 @@ SOURCES += \
         io/qfilesystemengine.cpp \
         io/qfileselector.cpp \
         io/qloggingcategory.cpp \
+        io/qlogrecord.cpp \
         io/qloggingregistry.cpp
 
 qtConfig(zstd): QMAKE_USE_PRIVATE += zstd
@@ -1206,6 +1206,13 @@ qint64 QAbstractFileEngine::readLine(char *data, qint64 maxlen)
 
    \value UnMapExtension Whether the file engine provides the ability to
    unmap memory that was previously mapped.
+
+   \value WriteVectorExtension Whether the file engine provides the ability
+   to write several blocks of data, passed in a WriteVectorExtensionOption, in
+   a single operation (a gather write). The number of bytes written is
+   returned in a WriteVectorExtensionReturn. Any number of blocks can be
+   passed; engines that need to can split them into batches, such as batches
+   of at most \c IOV_MAX blocks for \c{writev()} on Unix.
 */
 
 /*!
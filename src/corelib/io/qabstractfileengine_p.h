@@ -170,7 +170,8 @@ public:
         AtEndExtension,
         FastReadLineExtension,
         MapExtension,
-        UnMapExtension
+        UnMapExtension,
+        WriteVectorExtension
     };
     class ExtensionOption
     {};
@@ -193,6 +194,16 @@ public:
         uchar *address;
     };
 
+    class WriteVectorExtensionOption : public ExtensionOption {
+    public:
+        const QByteArrayView *blocks;
+        int count;
+    };
+    class WriteVectorExtensionReturn : public ExtensionReturn {
+    public:
+        qint64 written;
+    };
+
     virtual bool extension(Extension extension, const ExtensionOption *option = nullptr, ExtensionReturn *output = nullptr);
     virtual bool supportsExtension(Extension extension) const;
 
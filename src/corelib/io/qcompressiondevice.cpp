@@ -0,0 +1,779 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qcompressiondevice.h"
+#include "private/qiodevice_p.h"
+
+#include <zlib.h>
+#if QT_CONFIG(zstd)
+#  include <zstd.h>
+#endif
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+enum { CompressionChunkSize = 64 * 1024 };
+
+static int zlibWindowBits(QCompressionDevice::Format format)
+{
+    switch (format) {
+    case QCompressionDevice::ZlibFormat:
+        return MAX_WBITS;
+    case QCompressionDevice::DeflateFormat:
+        return -MAX_WBITS;
+    case QCompressionDevice::GzipFormat:
+        return MAX_WBITS + 16;
+    case QCompressionDevice::ZstdFormat:
+        break;
+    }
+    Q_UNREACHABLE();
+    return 0;
+}
+
+/** QCompressionDevicePrivate **/
+class QCompressionDevicePrivate : public QIODevicePrivate
+{
+    Q_DECLARE_PUBLIC(QCompressionDevice)
+
+public:
+    bool initStream();
+    void endStream();
+    bool compress(const char *data, qint64 len, bool finish);
+    bool writeOutput(qint64 len);
+
+    QIODevice *device = nullptr;
+    QCompressionDevice::Format format = QCompressionDevice::GzipFormat;
+    int level = -1;
+    int workerCount = 0;
+    z_stream *zlibStream = nullptr;
+#if QT_CONFIG(zstd)
+    ZSTD_CStream *zstdStream = nullptr;
+#endif
+    QByteArray output;
+};
+
+bool QCompressionDevicePrivate::initStream()
+{
+    output.resize(CompressionChunkSize);
+    if (format == QCompressionDevice::ZstdFormat) {
+#if QT_CONFIG(zstd)
+        zstdStream = ZSTD_createCStream();
+        if (!zstdStream)
+            return false;
+        const int zstdLevel = qMax(level, 0); // 0 selects the default level
+#  if ZSTD_VERSION_NUMBER >= 10400
+        ZSTD_CCtx_setParameter(zstdStream, ZSTD_c_compressionLevel, zstdLevel);
+        // fails if zstd was built without multithreading support, in which
+        // case compression simply happens in the calling thread
+        if (workerCount > 0)
+            ZSTD_CCtx_setParameter(zstdStream, ZSTD_c_nbWorkers, workerCount);
+        return true;
+#  else
+        return !ZSTD_isError(ZSTD_initCStream(zstdStream, zstdLevel));
+#  endif
+#else
+        return false;
+#endif
+    }
+
+    zlibStream = new z_stream;
+    memset(zlibStream, 0, sizeof(z_stream));
+    if (deflateInit2(zlibStream, level < 0 ? Z_DEFAULT_COMPRESSION : qMin(level, 9), Z_DEFLATED,
+                     zlibWindowBits(format), 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        delete zlibStream;
+        zlibStream = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void QCompressionDevicePrivate::endStream()
+{
+    if (zlibStream) {
+        deflateEnd(zlibStream);
+        delete zlibStream;
+        zlibStream = nullptr;
+    }
+#if QT_CONFIG(zstd)
+    if (zstdStream) {
+        ZSTD_freeCStream(zstdStream);
+        zstdStream = nullptr;
+    }
+#endif
+    output.clear();
+}
+
+bool QCompressionDevicePrivate::writeOutput(qint64 len)
+{
+    if (len && device->write(output.constData(), len) != len) {
+        errorString = QCompressionDevice::tr("Could not write compressed data: %1")
+                .arg(device->errorString());
+        return false;
+    }
+    return true;
+}
+
+bool QCompressionDevicePrivate::compress(const char *data, qint64 len, bool finish)
+{
+#if QT_CONFIG(zstd)
+    if (zstdStream) {
+        ZSTD_inBuffer input = { data, size_t(len), 0 };
+        for (;;) {
+            ZSTD_outBuffer out = { output.data(), size_t(output.size()), 0 };
+            const size_t ret = finish ? ZSTD_endStream(zstdStream, &out)
+                                      : ZSTD_compressStream(zstdStream, &out, &input);
+            if (ZSTD_isError(ret)) {
+                errorString = QString::fromUtf8(ZSTD_getErrorName(ret));
+                return false;
+            }
+            if (!writeOutput(qint64(out.pos)))
+                return false;
+            // ZSTD_endStream() returns the amount of data still to be flushed
+            if (finish ? ret == 0 : input.pos == input.size)
+                return true;
+        }
+    }
+#endif
+
+    do {
+        const uInt chunk = uInt(qMin<qint64>(len, std::numeric_limits<uInt>::max()));
+        zlibStream->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        zlibStream->avail_in = chunk;
+        data += chunk;
+        len -= chunk;
+
+        const int flush = finish && len == 0 ? Z_FINISH : Z_NO_FLUSH;
+        do {
+            zlibStream->next_out = reinterpret_cast<Bytef *>(output.data());
+            zlibStream->avail_out = uInt(output.size());
+            if (deflate(zlibStream, flush) == Z_STREAM_ERROR) {
+                errorString = QCompressionDevice::tr("Internal compression error");
+                return false;
+            }
+            if (!writeOutput(output.size() - zlibStream->avail_out))
+                return false;
+        } while (zlibStream->avail_out == 0);
+    } while (len > 0);
+    return true;
+}
+
+/*!
+    \class QCompressionDevice
+    \inmodule QtCore
+    \reentrant
+    \since 6.0
+    \brief The QCompressionDevice class compresses data written to it into
+    another QIODevice.
+
+    \ingroup io
+
+    QCompressionDevice compresses data on the fly while it is written, so
+    arbitrarily large amounts of data can be compressed without holding
+    them in memory. The compressed stream is written to the device passed
+    to the constructor, which must be open for writing. The stream is
+    complete once the QCompressionDevice is closed; this does not close
+    the underlying device.
+
+    \snippet code/src_corelib_io_qcompressiondevice.cpp 0
+
+    Use QDecompressionDevice to read the data back. The \l ZlibFormat
+    produces the same stream as qCompress(), minus the four bytes of the
+    uncompressed length that qCompress() prepends.
+
+    \sa QDecompressionDevice, qCompress()
+*/
+
+/*!
+    \enum QCompressionDevice::Format
+
+    This enum describes the supported compressed data formats.
+
+    \value ZlibFormat A deflate stream with a zlib header and checksum (RFC 1950).
+    \value DeflateFormat A raw deflate stream, without header (RFC 1951).
+    \value GzipFormat A deflate stream with a gzip header and checksum, as
+           written by the \c gzip tool (RFC 1952).
+    \value ZstdFormat A Zstandard stream (RFC 8878). This format is only
+           available if Qt was built with Zstandard support.
+
+    \sa isFormatSupported()
+*/
+
+/*!
+    Constructs a QCompressionDevice that writes data compressed in \a format
+    to \a device, with the given \a parent.
+
+    \sa open()
+*/
+QCompressionDevice::QCompressionDevice(QIODevice *device, Format format, QObject *parent)
+    : QIODevice(*new QCompressionDevicePrivate, parent)
+{
+    Q_D(QCompressionDevice);
+    d->device = device;
+    d->format = format;
+}
+
+/*!
+    Destroys the QCompressionDevice, closing it first if necessary.
+*/
+QCompressionDevice::~QCompressionDevice()
+{
+    close();
+}
+
+/*!
+    Returns the device the compressed data is written to.
+*/
+QIODevice *QCompressionDevice::device() const
+{
+    Q_D(const QCompressionDevice);
+    return d->device;
+}
+
+/*!
+    Returns the format of the compressed data.
+*/
+QCompressionDevice::Format QCompressionDevice::format() const
+{
+    Q_D(const QCompressionDevice);
+    return d->format;
+}
+
+/*!
+    Returns the compression level, or -1 if the default level of the format
+    is used.
+
+    \sa setCompressionLevel()
+*/
+int QCompressionDevice::compressionLevel() const
+{
+    Q_D(const QCompressionDevice);
+    return d->level;
+}
+
+/*!
+    Sets the compression level to \a level. Valid levels range from 0 (no
+    compression) to 9 for the deflate based formats, and from 1 to 19 for
+    \l ZstdFormat. Higher levels compress better, at the expense of CPU
+    time. The default of -1 selects the default level of the format.
+
+    The level takes effect the next time the device is opened.
+
+    \sa compressionLevel()
+*/
+void QCompressionDevice::setCompressionLevel(int level)
+{
+    Q_D(QCompressionDevice);
+    d->level = qMax(level, -1);
+}
+
+/*!
+    Returns the number of worker threads used for compression. The default
+    of 0 compresses in the thread that writes to the device.
+
+    \sa setWorkerCount()
+*/
+int QCompressionDevice::workerCount() const
+{
+    Q_D(const QCompressionDevice);
+    return d->workerCount;
+}
+
+/*!
+    Sets the number of worker threads used for compression to \a count.
+    With workers, write() only queues the data, and the compression of
+    consecutive blocks overlaps with the writing thread and with each other.
+
+    Only \l ZstdFormat supports worker threads, and only if the Zstandard
+    library was built with multithreading support. Otherwise, data is
+    compressed in the thread that writes to the device.
+
+    The worker count takes effect the next time the device is opened.
+
+    \sa workerCount()
+*/
+void QCompressionDevice::setWorkerCount(int count)
+{
+    Q_D(QCompressionDevice);
+    d->workerCount = qMax(count, 0);
+}
+
+/*!
+    Returns \c true if data can be compressed and decompressed in \a format.
+*/
+bool QCompressionDevice::isFormatSupported(Format format)
+{
+    if (format == ZstdFormat)
+        return QT_CONFIG(zstd);
+    return true;
+}
+
+/*!
+    \reimp
+
+    Opens the device for writing and starts a new compressed stream. \a mode
+    must be QIODevice::WriteOnly; compression devices cannot be read from.
+*/
+bool QCompressionDevice::open(OpenMode mode)
+{
+    Q_D(QCompressionDevice);
+    if ((mode & ReadOnly) || !(mode & WriteOnly)) {
+        qWarning("QCompressionDevice::open: Compression devices can only be opened for writing");
+        return false;
+    }
+    if (!d->device || !d->device->isWritable()) {
+        d->errorString = tr("The output device is not open for writing");
+        return false;
+    }
+    if (!isFormatSupported(d->format)) {
+        d->errorString = tr("Unsupported compression format");
+        return false;
+    }
+    if (!d->initStream()) {
+        d->errorString = tr("Could not initialize the compressor");
+        return false;
+    }
+    return QIODevice::open(mode | Unbuffered);
+}
+
+/*!
+    \reimp
+
+    Finishes the compressed stream and closes the device. The underlying
+    device is not closed.
+
+    If the end of the stream cannot be written, errorString() describes
+    the error after the device was closed.
+*/
+void QCompressionDevice::close()
+{
+    Q_D(QCompressionDevice);
+    if (!isOpen())
+        return;
+    emit aboutToClose();
+    const bool finished = d->compress(nullptr, 0, true);
+    d->endStream();
+    QIODevice::close();
+    if (!finished)
+        setErrorString(d->errorString);
+}
+
+/*!
+    \reimp
+
+    Compression devices are always sequential.
+*/
+bool QCompressionDevice::isSequential() const
+{
+    return true;
+}
+
+/*!
+    \reimp
+*/
+qint64 QCompressionDevice::readData(char *data, qint64 maxlen)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxlen);
+    return -1;
+}
+
+/*!
+    \reimp
+*/
+qint64 QCompressionDevice::writeData(const char *data, qint64 len)
+{
+    Q_D(QCompressionDevice);
+    return d->compress(data, len, false) ? len : -1;
+}
+
+/** QDecompressionDevicePrivate **/
+class QDecompressionDevicePrivate : public QIODevicePrivate
+{
+    Q_DECLARE_PUBLIC(QDecompressionDevice)
+
+public:
+    bool initStream();
+    void endStream();
+    bool fillInput();
+    qint64 decompress(char *data, qint64 maxlen);
+    void decompressAhead();
+
+    QIODevice *device = nullptr;
+    QCompressionDevice::Format format = QCompressionDevice::GzipFormat;
+    z_stream *zlibStream = nullptr;
+#if QT_CONFIG(zstd)
+    ZSTD_DStream *zstdStream = nullptr;
+#endif
+    QByteArray input;
+    qsizetype inputOffset = 0;
+    bool frameEnded = false;
+    bool deviceAtEnd = false;
+    bool finished = false;
+};
+
+bool QDecompressionDevicePrivate::initStream()
+{
+    input.clear();
+    inputOffset = 0;
+    frameEnded = false;
+    deviceAtEnd = false;
+    finished = false;
+
+    if (format == QCompressionDevice::ZstdFormat) {
+#if QT_CONFIG(zstd)
+        zstdStream = ZSTD_createDStream();
+        return zstdStream != nullptr;
+#else
+        return false;
+#endif
+    }
+
+    zlibStream = new z_stream;
+    memset(zlibStream, 0, sizeof(z_stream));
+    if (inflateInit2(zlibStream, zlibWindowBits(format)) != Z_OK) {
+        delete zlibStream;
+        zlibStream = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void QDecompressionDevicePrivate::endStream()
+{
+    if (zlibStream) {
+        inflateEnd(zlibStream);
+        delete zlibStream;
+        zlibStream = nullptr;
+    }
+#if QT_CONFIG(zstd)
+    if (zstdStream) {
+        ZSTD_freeDStream(zstdStream);
+        zstdStream = nullptr;
+    }
+#endif
+    input.clear();
+    inputOffset = 0;
+}
+
+bool QDecompressionDevicePrivate::fillInput()
+{
+    input.resize(CompressionChunkSize);
+    const qint64 n = device->read(input.data(), input.size());
+    inputOffset = 0;
+    if (n <= 0) {
+        input.resize(0);
+        // sequential devices may receive more data later
+        deviceAtEnd = n < 0 || !device->isOpen() || !device->isSequential();
+        return false;
+    }
+    input.resize(n);
+    return true;
+}
+
+// Returns the number of bytes decompressed into data, 0 if more input is
+// needed but not available yet, or -1 at the end of the data or on errors.
+qint64 QDecompressionDevicePrivate::decompress(char *data, qint64 maxlen)
+{
+    qint64 total = 0;
+    while (total < maxlen) {
+        if (inputOffset == input.size() && !fillInput()) {
+            if (!deviceAtEnd)
+                break;
+            finished = true;
+            if (!frameEnded) {
+                errorString = QDecompressionDevice::tr("Unexpected end of compressed data");
+                return total ? total : -1;
+            }
+            break;
+        }
+
+        const char *in = input.constData() + inputOffset;
+        const qsizetype available = input.size() - inputOffset;
+        char *out = data + total;
+        const qint64 space = maxlen - total;
+        qsizetype consumed = 0;
+        qint64 produced = 0;
+
+#if QT_CONFIG(zstd)
+        if (zstdStream) {
+            ZSTD_inBuffer inBuffer = { in, size_t(available), 0 };
+            ZSTD_outBuffer outBuffer = { out, size_t(space), 0 };
+            const size_t ret = ZSTD_decompressStream(zstdStream, &outBuffer, &inBuffer);
+            if (ZSTD_isError(ret)) {
+                errorString = QString::fromUtf8(ZSTD_getErrorName(ret));
+                finished = true;
+                return total ? total : -1;
+            }
+            // a new frame may follow
+            frameEnded = ret == 0;
+            consumed = qsizetype(inBuffer.pos);
+            produced = qint64(outBuffer.pos);
+        } else
+#endif
+        {
+            if (frameEnded) {
+                // concatenated streams, as produced by appending to gzip files
+                inflateReset(zlibStream);
+                frameEnded = false;
+            }
+            const uInt inChunk = uInt(qMin<qint64>(available, std::numeric_limits<uInt>::max()));
+            const uInt outChunk = uInt(qMin<qint64>(space, std::numeric_limits<uInt>::max()));
+            zlibStream->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(in));
+            zlibStream->avail_in = inChunk;
+            zlibStream->next_out = reinterpret_cast<Bytef *>(out);
+            zlibStream->avail_out = outChunk;
+            const int ret = inflate(zlibStream, Z_NO_FLUSH);
+            if (ret == Z_NEED_DICT || (ret < 0 && ret != Z_BUF_ERROR)) {
+                errorString = QDecompressionDevice::tr("Invalid compressed data");
+                finished = true;
+                return total ? total : -1;
+            }
+            frameEnded = ret == Z_STREAM_END;
+            consumed = inChunk - zlibStream->avail_in;
+            produced = outChunk - zlibStream->avail_out;
+        }
+
+        if (!consumed && !produced) {
+            errorString = QDecompressionDevice::tr("Invalid compressed data");
+            finished = true;
+            return total ? total : -1;
+        }
+        inputOffset += consumed;
+        total += produced;
+    }
+    return total || !finished ? total : -1;
+}
+
+// Decompresses pending input into the read buffer, so that bytesAvailable()
+// only reports data that can actually be read.
+void QDecompressionDevicePrivate::decompressAhead()
+{
+    if (finished)
+        return;
+    char *data = buffer.reserve(CompressionChunkSize);
+    const qint64 n = decompress(data, CompressionChunkSize);
+    buffer.chop(CompressionChunkSize - qMax<qint64>(n, 0));
+}
+
+/*!
+    \class QDecompressionDevice
+    \inmodule QtCore
+    \reentrant
+    \since 6.0
+    \brief The QDecompressionDevice class reads and decompresses data from
+    another QIODevice.
+
+    \ingroup io
+
+    QDecompressionDevice decompresses data on the fly while it is read, so
+    arbitrarily large amounts of compressed data can be processed without
+    holding them in memory. The compressed data is read from the device
+    passed to the constructor, which must be open for reading.
+
+    \snippet code/src_corelib_io_qcompressiondevice.cpp 1
+
+    Streams that were concatenated, for example by appending to a gzip
+    file, are decompressed as one. If the underlying device is sequential,
+    such as a socket, readyRead() is emitted whenever it receives more data.
+
+    \sa QCompressionDevice, qUncompress()
+*/
+
+/*!
+    Constructs a QDecompressionDevice that reads data compressed in
+    \a format from \a device, with the given \a parent.
+
+    \sa open()
+*/
+QDecompressionDevice::QDecompressionDevice(QIODevice *device, QCompressionDevice::Format format,
+                                           QObject *parent)
+    : QIODevice(*new QDecompressionDevicePrivate, parent)
+{
+    Q_D(QDecompressionDevice);
+    d->device = device;
+    d->format = format;
+}
+
+/*!
+    Destroys the QDecompressionDevice, closing it first if necessary.
+*/
+QDecompressionDevice::~QDecompressionDevice()
+{
+    close();
+}
+
+/*!
+    Returns the device the compressed data is read from.
+*/
+QIODevice *QDecompressionDevice::device() const
+{
+    Q_D(const QDecompressionDevice);
+    return d->device;
+}
+
+/*!
+    Returns the format of the compressed data.
+*/
+QCompressionDevice::Format QDecompressionDevice::format() const
+{
+    Q_D(const QDecompressionDevice);
+    return d->format;
+}
+
+/*!
+    \reimp
+
+    Opens the device for reading. \a mode must be QIODevice::ReadOnly;
+    decompression devices cannot be written to.
+*/
+bool QDecompressionDevice::open(OpenMode mode)
+{
+    Q_D(QDecompressionDevice);
+    if ((mode & WriteOnly) || !(mode & ReadOnly)) {
+        qWarning("QDecompressionDevice::open: Decompression devices can only be opened for reading");
+        return false;
+    }
+    if (!d->device || !d->device->isReadable()) {
+        d->errorString = tr("The input device is not open for reading");
+        return false;
+    }
+    if (!QCompressionDevice::isFormatSupported(d->format)) {
+        d->errorString = tr("Unsupported compression format");
+        return false;
+    }
+    if (!d->initStream()) {
+        d->errorString = tr("Could not initialize the decompressor");
+        return false;
+    }
+    connect(d->device, &QIODevice::readyRead, this, &QIODevice::readyRead);
+    return QIODevice::open(mode);
+}
+
+/*!
+    \reimp
+
+    The underlying device is not closed.
+*/
+void QDecompressionDevice::close()
+{
+    Q_D(QDecompressionDevice);
+    if (!isOpen())
+        return;
+    QIODevice::close();
+    disconnect(d->device, &QIODevice::readyRead, this, &QIODevice::readyRead);
+    d->endStream();
+}
+
+/*!
+    \reimp
+
+    Decompression devices are always sequential.
+*/
+bool QDecompressionDevice::isSequential() const
+{
+    return true;
+}
+
+/*!
+    \reimp
+
+    Only decompressed data is counted. If no decompressed data is buffered,
+    this decompresses pending input first, so that the returned number of
+    bytes can always be read without blocking.
+*/
+qint64 QDecompressionDevice::bytesAvailable() const
+{
+    Q_D(const QDecompressionDevice);
+    if (isOpen() && QIODevice::bytesAvailable() == 0)
+        const_cast<QDecompressionDevicePrivate *>(d)->decompressAhead();
+    return QIODevice::bytesAvailable();
+}
+
+/*!
+    \reimp
+
+    Returns \c true if no decompressed data is available and the compressed
+    input is exhausted.
+*/
+bool QDecompressionDevice::atEnd() const
+{
+    Q_D(const QDecompressionDevice);
+    if (!isOpen() || bytesAvailable() > 0)
+        return !isOpen();
+    return d->finished || (d->inputOffset == d->input.size() && d->device->atEnd());
+}
+
+/*!
+    \reimp
+*/
+bool QDecompressionDevice::waitForReadyRead(int msecs)
+{
+    Q_D(QDecompressionDevice);
+    if (!isOpen() || d->finished)
+        return false;
+    if (QIODevice::bytesAvailable() || d->inputOffset < d->input.size())
+        return true;
+    return d->device->waitForReadyRead(msecs);
+}
+
+/*!
+    \reimp
+*/
+qint64 QDecompressionDevice::readData(char *data, qint64 maxlen)
+{
+    Q_D(QDecompressionDevice);
+    if (d->finished)
+        return -1;
+    return d->decompress(data, maxlen);
+}
+
+/*!
+    \reimp
+*/
+qint64 QDecompressionDevice::writeData(const char *data, qint64 len)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(len);
+    return -1;
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qcompressiondevice.cpp"
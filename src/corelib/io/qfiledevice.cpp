@@ -43,6 +43,7 @@
 #include "qfsfileengine_p.h"
 
 #include <private/qmemory_p.h>
+#include <qvarlengtharray.h>
 
 #ifdef QT_NO_QOBJECT
 #define tr(X) QString::fromLatin1(X)
@@ -284,9 +285,26 @@ bool QFileDevice::flush()
         return false;
     }
 
-    if (!d->writeBuffer.isEmpty()) {
+    while (!d->writeBuffer.isEmpty()) {
         qint64 size = d->writeBuffer.nextDataBlockSize();
-        qint64 written = d->fileEngine->write(d->writeBuffer.readPointer(), size);
+        qint64 written;
+        if (size < d->writeBuffer.size()
+                && d->fileEngine->supportsExtension(QAbstractFileEngine::WriteVectorExtension)) {
+            // The buffer holds several chunks (e.g. shallow copies of the byte
+            // arrays passed to write()): write them with one gather write.
+            QByteArrayView blocks[16];
+            QAbstractFileEngine::WriteVectorExtensionOption option;
+            option.blocks = blocks;
+            option.count = d->writeBuffer.dataBlocks(blocks, 16);
+            size = 0;
+            for (int i = 0; i < option.count; ++i)
+                size += blocks[i].size();
+            QAbstractFileEngine::WriteVectorExtensionReturn result;
+            written = d->fileEngine->extension(QAbstractFileEngine::WriteVectorExtension,
+                                               &option, &result) ? result.written : -1;
+        } else {
+            written = d->fileEngine->write(d->writeBuffer.readPointer(), size);
+        }
         if (written > 0)
             d->writeBuffer.free(written);
         if (written != size) {
@@ -473,6 +491,71 @@ qint64 QFileDevice::readData(char *data, qint64 len)
     return read;
 }
 
+/*!
+    \internal
+
+    Writes \a chunks that do not fit into the write buffer, or all chunks if
+    the file is unbuffered, with a single gather write. The data that is
+    still buffered goes into the same write, so that a buffered header and a
+    large payload following it reach the file together.
+*/
+bool QFileDevicePrivate::writeVector(const QList<QByteArray> &chunks, qint64 *written)
+{
+    Q_Q(QFileDevice);
+    if (!fileEngine || !fileEngine->supportsExtension(QAbstractFileEngine::WriteVectorExtension))
+        return false;
+
+    qint64 size = 0;
+    for (const QByteArray &chunk : chunks)
+        size += chunk.size();
+
+    // Small writes are collected in the buffer, which flush() writes with a
+    // single gather write.
+    const bool buffered = !(openMode & QIODevice::Unbuffered);
+    if (size == 0 || (buffered && writeBuffer.size() + size <= writeBufferChunkSize))
+        return false;
+
+    q->unsetError();
+    lastWasWrite = true;
+
+    constexpr int MaxBufferedBlocks = 16;
+    QVarLengthArray<QByteArrayView, MaxBufferedBlocks + 16> blocks(MaxBufferedBlocks);
+    blocks.resize(writeBuffer.dataBlocks(blocks.data(), MaxBufferedBlocks));
+    qint64 bufferedSize = 0;
+    for (QByteArrayView block : blocks)
+        bufferedSize += block.size();
+    if (bufferedSize != writeBuffer.size()) {
+        // too fragmented to go along with the chunks
+        if (!q->flush()) {
+            *written = -1;
+            return true;
+        }
+        blocks.clear();
+        bufferedSize = 0;
+    }
+    for (const QByteArray &chunk : chunks) {
+        if (!chunk.isEmpty())
+            blocks.append(chunk);
+    }
+
+    QAbstractFileEngine::WriteVectorExtensionOption option;
+    option.blocks = blocks.constData();
+    option.count = int(blocks.size());
+    QAbstractFileEngine::WriteVectorExtensionReturn result;
+    const qint64 ret = fileEngine->extension(QAbstractFileEngine::WriteVectorExtension,
+                                             &option, &result) ? result.written : -1;
+    if (ret > 0)
+        writeBuffer.free(qMin(ret, bufferedSize));
+    if (ret != bufferedSize + size) {
+        QFileDevice::FileError err = fileEngine->error();
+        if (err == QFileDevice::UnspecifiedError)
+            err = QFileDevice::WriteError;
+        setError(err, fileEngine->errorString());
+    }
+    *written = ret > bufferedSize ? ret - bufferedSize : qint64(-1);
+    return true;
+}
+
 /*!
     \internal
 */
@@ -559,8 +642,9 @@ qint64 QFileDevice::writeData(const char *data, qint64 len)
         return ret;
     }
 
-    // Write to the buffer.
-    d->writeBuffer.append(data, len);
+    // Write to the buffer; this keeps a shallow copy of the chunk passed to
+    // write(const QByteArray &), if any.
+    d->write(data, len);
     return len;
 }
 
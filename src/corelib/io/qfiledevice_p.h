@@ -72,6 +72,7 @@ protected:
     inline bool ensureFlushed() const;
 
     bool putCharHelper(char c) override;
+    bool writeVector(const QList<QByteArray> &chunks, qint64 *written) override;
 
     void setError(QFileDevice::FileError err);
     void setError(QFileDevice::FileError err, const QString &errorString);
@@ -889,6 +889,14 @@ bool QFSFileEngine::extension(Extension extension, const ExtensionOption *option
         const UnMapExtensionOption *options = (const UnMapExtensionOption*)option;
         return d->unmap(options->address);
     }
+#ifdef Q_OS_UNIX
+    if (extension == WriteVectorExtension && !d->fh && d->fd != -1) {
+        const WriteVectorExtensionOption *options = static_cast<const WriteVectorExtensionOption *>(option);
+        WriteVectorExtensionReturn *returnValue = static_cast<WriteVectorExtensionReturn *>(output);
+        returnValue->written = d->writeVectorFd(options->blocks, options->count);
+        return returnValue->written >= 0;
+    }
+#endif
 
     return false;
 }
@@ -907,6 +915,11 @@ bool QFSFileEngine::supportsExtension(Extension extension) const
         return true;
     if (extension == UnMapExtension || extension == MapExtension)
         return true;
+#ifdef Q_OS_UNIX
+    // the stdio buffer would be bypassed in buffered stdlib mode
+    if (extension == WriteVectorExtension && !d->fh && d->fd != -1)
+        return true;
+#endif
     return false;
 }
 
@@ -53,6 +53,7 @@
 #include "qvarlengtharray.h"
 
 #include <sys/mman.h>
+#include <sys/uio.h>
 #include <stdlib.h>
 #include <limits.h>
 #include <errno.h>
@@ -272,6 +273,66 @@ qint64 QFSFileEnginePrivate::nativeWrite(const char *data, qint64 len)
     return writeFdFh(data, len);
 }
 
+/*!
+    \internal
+
+    Writes the \a count blocks of data in \a blocks to the file descriptor
+    with as few writev() calls as possible.
+*/
+qint64 QFSFileEnginePrivate::writeVectorFd(const QByteArrayView *blocks, int count)
+{
+    Q_Q(QFSFileEngine);
+
+    QVarLengthArray<iovec, 16> vectors;
+    qint64 len = 0;
+    for (int i = 0; i < count; ++i) {
+        if (blocks[i].isEmpty())
+            continue;
+        iovec vector;
+        vector.iov_base = const_cast<char *>(blocks[i].data());
+        vector.iov_len = size_t(blocks[i].size());
+        vectors.append(vector);
+        len += blocks[i].size();
+    }
+
+#ifdef IOV_MAX
+    const int maxVectors = IOV_MAX;
+#else
+    const int maxVectors = 16;
+#endif
+    qint64 writtenBytes = 0;
+    iovec *vector = vectors.data();
+    int remaining = vectors.size();
+    while (remaining > 0) {
+        ssize_t result;
+        EINTR_LOOP(result, ::writev(fd, vector, qMin(remaining, maxVectors)));
+        if (result <= 0)
+            break;
+        writtenBytes += result;
+
+        // skip what was written, which may end in the middle of a block
+        while (remaining > 0 && size_t(result) >= vector->iov_len) {
+            result -= vector->iov_len;
+            ++vector;
+            --remaining;
+        }
+        if (remaining > 0) {
+            vector->iov_base = static_cast<char *>(vector->iov_base) + result;
+            vector->iov_len -= size_t(result);
+        }
+    }
+
+    if (len && writtenBytes == 0) {
+        writtenBytes = -1;
+        q->setError(errno == ENOSPC ? QFile::ResourceError : QFile::WriteError, QSystemError::stdString());
+    } else {
+        // reset the cached size, if any
+        metaData.clearFlags(QFileSystemMetaData::SizeAttribute);
+    }
+
+    return writtenBytes;
+}
+
 /*!
     \internal
 */
@@ -1750,6 +1750,73 @@ qint64 QIODevice::write(const QByteArray &data)
     return ret;
 }
 
+/*!
+    \since 6.0
+    \overload
+
+    Writes the contents of the byte arrays in \a chunks to the device, in
+    order, as if they had been concatenated. Returns the number of bytes that
+    were actually written, or -1 if an error occurred before any data was
+    written.
+
+    This avoids concatenating separately built pieces of data, such as a
+    protocol header and its payload, into a temporary byte array. Buffered
+    sequential devices, such as QTcpSocket and QProcess, store large chunks
+    in their write buffer without copying them, and copy small ones into
+    it. Where supported, QFile and QTcpSocket pass the chunks to a single
+    gather write (\c{writev()} on Unix): when flushing their write buffer
+    or, if the chunks do not fit into the buffer or the device is
+    unbuffered, directly together with any data that is still buffered.
+
+    \sa read(), writeData()
+*/
+
+qint64 QIODevice::write(const QList<QByteArray> &chunks)
+{
+    Q_D(QIODevice);
+    CHECK_WRITABLE(write, qint64(-1));
+
+    const bool sequential = d->isSequential();
+    // Make sure the device is positioned correctly.
+    if (d->pos != d->devicePos && !sequential && !seek(d->pos))
+        return qint64(-1);
+
+    // Let the device hand all chunks to the system at once, if it can. Text
+    // mode on Windows needs the line ending conversion done by write().
+#ifdef Q_OS_WIN
+    const bool canGather = !(d->openMode & Text);
+#else
+    const bool canGather = true;
+#endif
+    qint64 written = 0;
+    if (canGather && d->writeVector(chunks, &written)) {
+        if (!sequential && written > 0) {
+            d->pos += written;
+            d->devicePos += written;
+            d->buffer.skip(written);
+        }
+        return written;
+    }
+
+    for (const QByteArray &chunk : chunks) {
+        if (chunk.isEmpty())
+            continue;
+
+        // Keep a shallow copy of large chunks only, like write(const QByteArray &)
+        if (chunk.size() >= QRINGBUFFER_CHUNKSIZE)
+            d->currentWriteChunk = &chunk;
+        const qint64 ret = write(chunk.constData(), chunk.size());
+        d->currentWriteChunk = nullptr;
+
+        if (ret < 0)
+            return written ? written : ret;
+        written += ret;
+        if (ret < chunk.size())
+            break;
+    }
+    return written;
+}
+
 /*!
     \internal
 */
@@ -1766,6 +1833,22 @@ void QIODevicePrivate::write(const char *data, qint64 size)
     }
 }
 
+/*!
+    \internal
+
+    Writes all \a chunks with as few system calls as possible, bypassing
+    writeData(), and stores the number of bytes written (or -1 on error) in
+    \a written. Returns \c false if the device cannot do better than
+    writing the chunks one at a time, in which case QIODevice::write() does
+    that instead. The default implementation always returns \c false.
+*/
+bool QIODevicePrivate::writeVector(const QList<QByteArray> &chunks, qint64 *written)
+{
+    Q_UNUSED(chunks);
+    Q_UNUSED(written);
+    return false;
+}
+
 /*!
     Puts the character \a c back into the device, and decrements the
     current position unless the position is 0. This function is
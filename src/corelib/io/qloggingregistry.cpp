@@ -52,6 +52,8 @@
 #include <QtCore/private/qsettings_p.h>
 #endif
 
+#include <algorithm>
+
 // We can't use the default macros because this would lead to recursion.
 // Instead let's define our own one that unconditionally logs...
 #define debugMsg QMessageLogger(__FILE__, __LINE__, __FUNCTION__, "qt.core.logging").debug
@@ -167,6 +169,167 @@ void QLoggingRule::parse(QStringView pattern)
     category = p.toString();
 }
 
+/*!
+    \class QLoggingRuleMatcher
+    \internal
+
+    Matches category names against a list of logging rules without testing
+    every rule in turn. FullText and LeftFilter rules are looked up in a
+    trie of their patterns, and RightFilter rules in a trie of the reversed
+    patterns, so that the time taken depends on the length of the category
+    name rather than on the number of rules. Only MidFilter rules are tested
+    one by one.
+
+    As in QLoggingRegistry::defaultCategoryFilter(), a rule that was added
+    later takes precedence over earlier ones.
+*/
+
+QLoggingRuleMatcher::TrieNode &QLoggingRuleMatcher::Trie::insert(QLatin1String key, bool reversed)
+{
+    int node = 0;
+    const qsizetype size = key.size();
+    for (qsizetype i = 0; i < size; ++i) {
+        const char ch = key.data()[reversed ? size - 1 - i : i];
+        int child = nodes.at(node).firstChild;
+        while (child >= 0 && nodes.at(child).ch != ch)
+            child = nodes.at(child).nextSibling;
+        if (child < 0) {
+            TrieNode newNode;
+            newNode.ch = ch;
+            newNode.nextSibling = nodes.at(node).firstChild;
+            child = int(nodes.size());
+            nodes.append(std::move(newNode));
+            nodes[node].firstChild = child;
+        }
+        node = child;
+    }
+    return nodes[node];
+}
+
+/*!
+    \internal
+    Calls \a visitor with the index of every rule on the path that \a name
+    (read backwards if \a reversed is true) takes through the trie, and with
+    the full text rules of the node the whole name leads to.
+*/
+template <typename Visitor>
+void QLoggingRuleMatcher::Trie::match(QLatin1String name, bool reversed, Visitor visitor) const
+{
+    const TrieNode *node = nodes.constData();
+    const qsizetype size = name.size();
+    for (qsizetype i = 0; ; ++i) {
+        for (int rule : node->rules)
+            visitor(rule);
+        if (i == size) {
+            for (int rule : node->fullTextRules)
+                visitor(rule);
+            return;
+        }
+        const char ch = name.data()[reversed ? size - 1 - i : i];
+        int child = node->firstChild;
+        while (child >= 0 && nodes.at(child).ch != ch)
+            child = nodes.at(child).nextSibling;
+        if (child < 0)
+            return;
+        node = nodes.constData() + child;
+    }
+}
+
+void QLoggingRuleMatcher::clear()
+{
+    *this = QLoggingRuleMatcher();
+}
+
+/*!
+    \internal
+    Adds \a rules, which take precedence over the rules added before.
+*/
+void QLoggingRuleMatcher::addRules(const QList<QLoggingRule> &rules)
+{
+    for (const QLoggingRule &rule : rules) {
+        quint8 messageTypes = 0;
+        switch (rule.messageType) {
+        case -1:
+            messageTypes = (1 << NumMessageTypes) - 1;
+            break;
+        case QtDebugMsg:
+            messageTypes = 1 << DebugIndex;
+            break;
+        case QtInfoMsg:
+            messageTypes = 1 << InfoIndex;
+            break;
+        case QtWarningMsg:
+            messageTypes = 1 << WarningIndex;
+            break;
+        case QtCriticalMsg:
+            messageTypes = 1 << CriticalIndex;
+            break;
+        }
+        // category names are Latin-1, so other patterns can never match
+        const auto isLatin1 = [](QChar c) { return c.unicode() <= 0xff; };
+        if (!messageTypes || !rule.flags
+            || !std::all_of(rule.category.cbegin(), rule.category.cend(), isLatin1)) {
+            continue;
+        }
+
+        const int index = int(m_rules.size());
+        m_rules.append({ messageTypes, rule.enabled });
+        const QByteArray pattern = rule.category.toLatin1();
+        const QLatin1String key(pattern);
+        if (rule.flags == QLoggingRule::FullText)
+            m_prefixes.insert(key, false).fullTextRules.append(index);
+        else if (rule.flags == QLoggingRule::LeftFilter)
+            m_prefixes.insert(key, false).rules.append(index);
+        else if (rule.flags == QLoggingRule::RightFilter)
+            m_suffixes.insert(key, true).rules.append(index);
+        else
+            m_substrings.append(qMakePair(pattern, index));
+    }
+}
+
+template <typename Visitor>
+void QLoggingRuleMatcher::match(QLatin1String categoryName, Visitor visitor) const
+{
+    m_prefixes.match(categoryName, false, visitor);
+    m_suffixes.match(categoryName, true, visitor);
+    for (const auto &substring : m_substrings) {
+        if (categoryName.contains(QLatin1String(substring.first)))
+            visitor(substring.second);
+    }
+}
+
+/*!
+    \internal
+    Returns \c true if any rule applies to \a categoryName.
+*/
+bool QLoggingRuleMatcher::matches(QLatin1String categoryName) const
+{
+    bool matched = false;
+    match(categoryName, [&matched](int) { matched = true; });
+    return matched;
+}
+
+/*!
+    \internal
+    Overrides the entries of \a enabled, indexed by MessageTypeIndex, for
+    which a rule applies to \a categoryName.
+*/
+void QLoggingRuleMatcher::apply(QLatin1String categoryName, bool enabled[NumMessageTypes]) const
+{
+    int winner[NumMessageTypes] = { -1, -1, -1, -1 };
+    match(categoryName, [this, &winner](int index) {
+        const quint8 messageTypes = m_rules.at(index).messageTypes;
+        for (int type = 0; type < NumMessageTypes; ++type) {
+            if (messageTypes & (1 << type))
+                winner[type] = qMax(winner[type], index);
+        }
+    });
+    for (int type = 0; type < NumMessageTypes; ++type) {
+        if (winner[type] >= 0)
+            enabled[type] = m_rules.at(winner[type]).enabled;
+    }
+}
+
 /*!
     \class QLoggingSettingsParser
     \since 5.3
@@ -383,23 +546,43 @@ void QLoggingRegistry::setApiRules(const QString &content)
     if (qtLoggingDebug())
         debugMsg("Loading logging rules set by QLoggingCategory::setFilterRules ...");
 
+    QList<QLoggingRule> rules = parser.rules();
+
     const QMutexLocker locker(&registryMutex);
 
-    ruleSets[ApiRules] = parser.rules();
+    // Only the categories that the old or the new rules apply to can change
+    QLoggingRuleMatcher changedRules;
+    changedRules.addRules(ruleSets[ApiRules]);
+    changedRules.addRules(rules);
 
-    updateRules();
+    ruleSets[ApiRules] = std::move(rules);
+
+    updateRules(&changedRules);
 }
 
 /*!
     \internal
     Activates a new set of logging rules for the default filter.
 
+    If \a changedRules is given and the default filter is in use, only the
+    categories that these rules apply to are updated.
+
     (The caller must lock registryMutex to make sure the API is thread safe.)
 */
-void QLoggingRegistry::updateRules()
+void QLoggingRegistry::updateRules(const QLoggingRuleMatcher *changedRules)
 {
-    for (auto it = categories.keyBegin(), end = categories.keyEnd(); it != end; ++it)
-        (*categoryFilter)(*it);
+    ruleMatcher.clear();
+    for (const auto &ruleSet : ruleSets)
+        ruleMatcher.addRules(ruleSet);
+
+    const bool incremental = changedRules && categoryFilter == defaultCategoryFilter;
+    if (incremental && changedRules->isEmpty())
+        return;
+
+    for (auto it = categories.keyBegin(), end = categories.keyEnd(); it != end; ++it) {
+        if (!incremental || changedRules->matches(QLatin1String((*it)->categoryName())))
+            (*categoryFilter)(*it);
+    }
 }
 
 /*!
@@ -455,29 +638,13 @@ void QLoggingRegistry::defaultCategoryFilter(QLoggingCategory *cat)
             debug = false;
     }
 
-    const auto categoryName = QLatin1String(cat->categoryName());
-
-    for (const auto &ruleSet : reg->ruleSets) {
-        for (const auto &rule : ruleSet) {
-            int filterpass = rule.pass(categoryName, QtDebugMsg);
-            if (filterpass != 0)
-                debug = (filterpass > 0);
-            filterpass = rule.pass(categoryName, QtInfoMsg);
-            if (filterpass != 0)
-                info = (filterpass > 0);
-            filterpass = rule.pass(categoryName, QtWarningMsg);
-            if (filterpass != 0)
-                warning = (filterpass > 0);
-            filterpass = rule.pass(categoryName, QtCriticalMsg);
-            if (filterpass != 0)
-                critical = (filterpass > 0);
-        }
-    }
+    bool enabled[QLoggingRuleMatcher::NumMessageTypes] = { debug, info, warning, critical };
+    reg->ruleMatcher.apply(QLatin1String(cat->categoryName()), enabled);
 
-    cat->setEnabled(QtDebugMsg, debug);
-    cat->setEnabled(QtInfoMsg, info);
-    cat->setEnabled(QtWarningMsg, warning);
-    cat->setEnabled(QtCriticalMsg, critical);
+    cat->setEnabled(QtDebugMsg, enabled[QLoggingRuleMatcher::DebugIndex]);
+    cat->setEnabled(QtInfoMsg, enabled[QLoggingRuleMatcher::InfoIndex]);
+    cat->setEnabled(QtWarningMsg, enabled[QLoggingRuleMatcher::WarningIndex]);
+    cat->setEnabled(QtCriticalMsg, enabled[QLoggingRuleMatcher::CriticalIndex]);
 }
 
 
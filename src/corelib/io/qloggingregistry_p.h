@@ -90,6 +90,62 @@ private:
 Q_DECLARE_OPERATORS_FOR_FLAGS(QLoggingRule::PatternFlags)
 Q_DECLARE_TYPEINFO(QLoggingRule, Q_MOVABLE_TYPE);
 
+class Q_AUTOTEST_EXPORT QLoggingRuleMatcher
+{
+public:
+    enum MessageTypeIndex {
+        DebugIndex,
+        InfoIndex,
+        WarningIndex,
+        CriticalIndex,
+
+        NumMessageTypes
+    };
+
+    void clear();
+    void addRules(const QList<QLoggingRule> &rules);
+    bool isEmpty() const { return m_rules.isEmpty(); }
+
+    bool matches(QLatin1String categoryName) const;
+    void apply(QLatin1String categoryName, bool enabled[NumMessageTypes]) const;
+
+private:
+    struct Rule
+    {
+        quint8 messageTypes;
+        bool enabled;
+    };
+
+    struct TrieNode
+    {
+        char ch = 0;
+        int firstChild = -1;
+        int nextSibling = -1;
+        QList<int> rules;
+        QList<int> fullTextRules;
+    };
+
+    class Trie
+    {
+    public:
+        Trie() { nodes.resize(1); }
+        TrieNode &insert(QLatin1String key, bool reversed);
+        template <typename Visitor>
+        void match(QLatin1String name, bool reversed, Visitor visitor) const;
+
+    private:
+        QList<TrieNode> nodes;
+    };
+
+    template <typename Visitor>
+    void match(QLatin1String categoryName, Visitor visitor) const;
+
+    QList<Rule> m_rules;
+    Trie m_prefixes;    // FullText and LeftFilter rules
+    Trie m_suffixes;    // RightFilter rules, keyed by the reversed pattern
+    QList<QPair<QByteArray, int>> m_substrings; // MidFilter rules
+};
+
 class Q_AUTOTEST_EXPORT QLoggingSettingsParser
 {
 public:
@@ -126,7 +182,7 @@ public:
     static QLoggingRegistry *instance();
 
 private:
-    void updateRules();
+    void updateRules(const QLoggingRuleMatcher *changedRules = nullptr);
 
     static void defaultCategoryFilter(QLoggingCategory *category);
 
@@ -144,6 +200,7 @@ private:
 
     // protected by mutex:
     QList<QLoggingRule> ruleSets[NumRuleSets];
+    QLoggingRuleMatcher ruleMatcher;
     QHash<QLoggingCategory *, QtMsgType> categories;
     QLoggingCategory::CategoryFilter categoryFilter;
 
@@ -0,0 +1,713 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qlogrecord.h"
+
+#include <QtCore/qlocale.h>
+#include <QtCore/qnumeric.h>
+#include <QtCore/qvariant.h>
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/private/qlocale_p.h>
+#include <QtCore/private/qlocale_tools_p.h>
+#include <QtCore/private/qlogging_p.h>
+#include <QtCore/private/qstringconverter_p.h>
+
+#include <stdio.h>
+
+#if QT_CONFIG(journald)
+# define SD_JOURNAL_SUPPRESS_LOCATION
+# include <systemd/sd-journal.h>
+# include <syslog.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+struct Field
+{
+    QLogRecord::FieldType type;
+    const char *data;
+    qsizetype size;
+
+    template <typename T> T value() const
+    {
+        T result;
+        memcpy(&result, data, sizeof(T));
+        return result;
+    }
+};
+
+class FieldReader
+{
+public:
+    FieldReader(const char *data, qsizetype size) : ptr(data), end(data + size) {}
+
+    bool atEnd() const { return ptr == end; }
+
+    Field next()
+    {
+        Q_ASSERT(!atEnd());
+        Field field{ QLogRecord::FieldType(*ptr++), nullptr, 0 };
+        switch (field.type) {
+        case QLogRecord::Bool:
+            field.size = sizeof(bool);
+            break;
+        case QLogRecord::Int:
+        case QLogRecord::UInt:
+        case QLogRecord::Double:
+            field.size = 8;
+            break;
+        case QLogRecord::Utf16String:
+        case QLogRecord::Latin1String:
+        case QLogRecord::Utf8String:
+        case QLogRecord::ByteArray:
+            memcpy(&field.size, ptr, sizeof(qsizetype));
+            ptr += sizeof(qsizetype);
+            break;
+        }
+        field.data = ptr;
+        ptr += field.size;
+        return field;
+    }
+
+private:
+    const char *ptr;
+    const char *end;
+};
+
+// Finds the placeholder that follows \a p in a format string. Mirrors
+// QtPrivate::qLogFieldCount(): "{{" is an escaped brace and an unterminated
+// "{" is literal text. Returns the start of the placeholder's name, or
+// nullptr if there are no more placeholders.
+const char *nextPlaceholder(const char *p, const char **nameEnd)
+{
+    while ((p = strchr(p, '{'))) {
+        ++p;
+        if (*p == '{') {
+            ++p;
+            continue;
+        }
+        const char *close = strchr(p, '}');
+        if (!close)
+            return nullptr;
+        *nameEnd = close;
+        return p;
+    }
+    return nullptr;
+}
+} // unnamed namespace
+
+typedef QVarLengthArray<char, 256> Buffer;
+
+static void appendLiteral(Buffer &out, const char *text)
+{
+    out.append(text, qsizetype(strlen(text)));
+}
+
+static void appendNumber(Buffer &out, quint64 value, bool negative = false)
+{
+    char digits[20];
+    char *const end = digits + sizeof(digits);
+    char *p = end;
+    do {
+        *--p = char('0' + value % 10);
+        value /= 10;
+    } while (value);
+    if (negative)
+        out.append('-');
+    out.append(p, end - p);
+}
+
+// Writes the shortest representation of \a d that reads back as the same
+// value, laid out like JavaScript's Number.prototype.toString() does.
+static void appendDouble(Buffer &out, double d)
+{
+    char digits[32];
+    bool negative = false;
+    int length = 0;
+    int decpt = 0;
+    qt_doubleToAscii(d, QLocaleData::DFSignificantDigits, QLocale::FloatingPointShortest,
+                     digits, sizeof(digits), negative, length, decpt);
+    if (negative)
+        out.append('-');
+    if (!qIsFinite(d)) {
+        out.append(digits, length);
+    } else if (decpt > 21 || decpt <= -6) {
+        out.append(digits[0]);
+        if (length > 1) {
+            out.append('.');
+            out.append(digits + 1, length - 1);
+        }
+        out.append('e');
+        out.append(decpt > 0 ? '+' : '-');
+        appendNumber(out, quint64(qAbs(decpt - 1)));
+    } else if (decpt <= 0) {
+        out.append("0.", 2);
+        for (int i = decpt; i < 0; ++i)
+            out.append('0');
+        out.append(digits, length);
+    } else if (decpt >= length) {
+        out.append(digits, length);
+        for (int i = length; i < decpt; ++i)
+            out.append('0');
+    } else {
+        out.append(digits, decpt);
+        out.append('.');
+        out.append(digits + decpt, length - decpt);
+    }
+}
+
+static void appendUtf8(Buffer &out, QStringView text)
+{
+    const qsizetype offset = out.size();
+    out.resize(offset + 3 * text.size());
+    QStringConverter::State state;
+    const char *end = QUtf8::convertFromUnicode(out.data() + offset, text, &state);
+    out.resize(end - out.constData());
+}
+
+static void appendUtf8(Buffer &out, QLatin1String text)
+{
+    for (char c : text) {
+        const uchar u = uchar(c);
+        if (u < 0x80) {
+            out.append(c);
+        } else {
+            out.append(char(0xc0 | (u >> 6)));
+            out.append(char(0x80 | (u & 0x3f)));
+        }
+    }
+}
+
+static void appendJsonString(Buffer &out, const char *data, qsizetype size)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    out.append('"');
+    const char *run = data;
+    const char *end = data + size;
+    for (const char *p = data; p != end; ++p) {
+        const uchar c = uchar(*p);
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+        out.append(run, p - run);
+        run = p + 1;
+        out.append('\\');
+        switch (c) {
+        case '"': out.append('"'); break;
+        case '\\': out.append('\\'); break;
+        case '\b': out.append('b'); break;
+        case '\f': out.append('f'); break;
+        case '\n': out.append('n'); break;
+        case '\r': out.append('r'); break;
+        case '\t': out.append('t'); break;
+        default:
+            out.append("u00", 3);
+            out.append(hexDigits[c >> 4]);
+            out.append(hexDigits[c & 0xf]);
+            break;
+        }
+    }
+    out.append(run, end - run);
+    out.append('"');
+}
+
+static void appendJsonString(Buffer &out, const char *text)
+{
+    appendJsonString(out, text, qsizetype(strlen(text)));
+}
+
+// Appends the textual representation of \a field in UTF-8. For JSON,
+// strings are quoted and escaped, and non-finite numbers become null.
+static void appendField(Buffer &out, const Field &field, bool json)
+{
+    switch (field.type) {
+    case QLogRecord::Bool:
+        appendLiteral(out, field.value<bool>() ? "true" : "false");
+        return;
+    case QLogRecord::Int: {
+        const qint64 value = field.value<qint64>();
+        appendNumber(out, value < 0 ? 0 - quint64(value) : quint64(value), value < 0);
+        return;
+    }
+    case QLogRecord::UInt:
+        appendNumber(out, field.value<quint64>());
+        return;
+    case QLogRecord::Double: {
+        const double d = field.value<double>();
+        if (json && !qIsFinite(d))
+            appendLiteral(out, "null");
+        else
+            appendDouble(out, d);
+        return;
+    }
+    case QLogRecord::Utf16String:
+    case QLogRecord::Latin1String: {
+        Buffer utf8;
+        Buffer &target = json ? utf8 : out;
+        if (field.type == QLogRecord::Utf16String) {
+            appendUtf8(target, QStringView(reinterpret_cast<const QChar *>(field.data),
+                                           field.size / qsizetype(sizeof(QChar))));
+        } else {
+            appendUtf8(target, QLatin1String(field.data, field.size));
+        }
+        if (json)
+            appendJsonString(out, utf8.constData(), utf8.size());
+        return;
+    }
+    case QLogRecord::Utf8String:
+    case QLogRecord::ByteArray:
+        if (json)
+            appendJsonString(out, field.data, field.size);
+        else
+            out.append(field.data, field.size);
+        return;
+    }
+}
+
+static void formatMessage(Buffer &out, const char *format, const char *data, qsizetype size)
+{
+    FieldReader reader(data, size);
+    const char *p = format;
+    while (*p) {
+        if (*p == '{' || *p == '}') {
+            if (p[1] == *p) {
+                out.append(*p);
+                p += 2;
+                continue;
+            }
+            const char *close = *p == '{' ? strchr(p, '}') : nullptr;
+            if (close) {
+                if (!reader.atEnd())
+                    appendField(out, reader.next(), false);
+                p = close + 1;
+                continue;
+            }
+            out.append(*p++);
+            continue;
+        }
+        const char *run = p;
+        while (*p && *p != '{' && *p != '}')
+            ++p;
+        out.append(run, p - run);
+    }
+}
+
+static const char *messageTypeName(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg: return "debug";
+    case QtInfoMsg: return "info";
+    case QtWarningMsg: return "warning";
+    case QtCriticalMsg: return "critical";
+    case QtFatalMsg: return "fatal";
+    }
+    return "debug";
+}
+
+/*!
+    \class QLogRecord
+    \inmodule QtCore
+    \brief The QLogRecord class holds a structured log message whose
+    arguments are formatted only when the message is consumed.
+    \since 6.0
+
+    QLogRecord objects are created by the qCDebugFields(), qCInfoFields(),
+    qCWarningFields() and qCCriticalFields() macros. Each takes a logging
+    category, a format string literal in which every \c{{name}} is a named
+    field, and one argument per field:
+
+    \snippet code/src_corelib_io_qlogrecord.cpp 0
+
+    Unlike the stream operators of QDebug, the macros do not convert their
+    arguments to text. Integers, floating point numbers, booleans and strings
+    are copied into a compact binary buffer on the stack, and the record is
+    passed to the handler installed with qInstallLogRecordHandler(). The
+    handler decides how much of it to format: qJsonLogRecordHandler() writes
+    the fields as a JSON object, and qJournaldLogRecordHandler() passes them
+    to journald as separate fields. Without a record handler, the formatted
+    message() is passed to the regular message handler, like qCDebug()
+    output.
+
+    The number of arguments is checked against the format string at compile
+    time. Literal braces are written as \c{{{} and \c{}}}. Arguments must be
+    of an arithmetic or enumeration type, or one of QString, QStringView,
+    QLatin1String, QByteArray or \c{const char *} (which is taken to be
+    UTF-8).
+
+    The record refers to the format string and the message context without
+    copying them, and is only valid for the duration of the handler call.
+
+    \sa QLoggingCategory, qInstallLogRecordHandler()
+*/
+
+/*!
+    \enum QLogRecord::FieldType
+
+    This enum describes how the value of a field is stored.
+
+    \value Bool         A \c bool.
+    \value Int          A signed integer or enumeration, stored as qint64.
+    \value UInt         An unsigned integer, stored as quint64.
+    \value Double       A \c float or \c double, stored as \c double.
+    \value Utf16String  A QString or QStringView.
+    \value Latin1String A QLatin1String.
+    \value Utf8String   A \c{const char *}.
+    \value ByteArray    A QByteArray.
+*/
+
+/*!
+    \fn QLogRecord::QLogRecord(QtMsgType type, const char *file, int line, const char *function, const char *category, const char *format)
+    \internal
+*/
+
+/*!
+    \fn template <int FieldCount, typename... Args> void QLogRecord::log(const Args &... args)
+    \internal
+*/
+
+/*!
+    \fn QtMsgType QLogRecord::type() const
+
+    Returns the message type of the record.
+*/
+
+/*!
+    \fn const QMessageLogContext &QLogRecord::context() const
+
+    Returns the source location and category of the record.
+*/
+
+/*!
+    \fn const char *QLogRecord::format() const
+
+    Returns the format string the record was created with.
+*/
+
+/*!
+    \fn qsizetype QLogRecord::fieldCount() const
+
+    Returns the number of fields in the record.
+*/
+
+/*!
+    Returns the name of the field at \a index, as written between braces in
+    the format string.
+*/
+QLatin1String QLogRecord::fieldName(qsizetype index) const noexcept
+{
+    Q_ASSERT(index >= 0 && index < m_fieldCount);
+    const char *name = nullptr;
+    const char *nameEnd = m_format;
+    for (qsizetype i = 0; i <= index; ++i) {
+        name = nextPlaceholder(nameEnd, &nameEnd);
+        if (!name)
+            return QLatin1String();
+    }
+    return QLatin1String(name, nameEnd);
+}
+
+/*!
+    Returns how the value of the field at \a index is stored.
+*/
+QLogRecord::FieldType QLogRecord::fieldType(qsizetype index) const noexcept
+{
+    Q_ASSERT(index >= 0 && index < m_fieldCount);
+    FieldReader reader(m_data.constData(), m_data.size());
+    while (index--)
+        reader.next();
+    return reader.next().type;
+}
+
+/*!
+    Returns the value of the field at \a index. Strings are returned as
+    QString, except for QByteArray arguments.
+*/
+QVariant QLogRecord::fieldValue(qsizetype index) const
+{
+    Q_ASSERT(index >= 0 && index < m_fieldCount);
+    FieldReader reader(m_data.constData(), m_data.size());
+    while (index--)
+        reader.next();
+    const Field field = reader.next();
+    switch (field.type) {
+    case Bool:
+        return field.value<bool>();
+    case Int:
+        return field.value<qint64>();
+    case UInt:
+        return field.value<quint64>();
+    case Double:
+        return field.value<double>();
+    case Utf16String:
+        return QString(reinterpret_cast<const QChar *>(field.data),
+                       field.size / qsizetype(sizeof(QChar)));
+    case Latin1String:
+        return QString(QLatin1String(field.data, field.size));
+    case Utf8String:
+        return QString::fromUtf8(field.data, field.size);
+    case ByteArray:
+        return QByteArray(field.data, field.size);
+    }
+    return QVariant();
+}
+
+/*!
+    Returns the message with every field in the format string replaced by
+    its value. Floating point values are written in the shortest form that
+    reads back as the same value.
+*/
+QString QLogRecord::message() const
+{
+    Buffer out;
+    formatMessage(out, m_format, m_data.constData(), m_data.size());
+    return QString::fromUtf8(out.constData(), out.size());
+}
+
+/*!
+    Returns the record as a single-line JSON object. The object contains the
+    message type, the category, the formatted message, the source location
+    if it is known, and an object holding the fields by name.
+*/
+QByteArray QLogRecord::toJson() const
+{
+    Buffer out;
+    appendLiteral(out, "{\"type\":\"");
+    appendLiteral(out, messageTypeName(m_type));
+    appendLiteral(out, "\",\"category\":");
+    appendJsonString(out, m_context.category ? m_context.category : "default");
+    appendLiteral(out, ",\"message\":");
+    Buffer text;
+    formatMessage(text, m_format, m_data.constData(), m_data.size());
+    appendJsonString(out, text.constData(), text.size());
+    if (m_context.file) {
+        appendLiteral(out, ",\"file\":");
+        appendJsonString(out, m_context.file);
+        appendLiteral(out, ",\"line\":");
+        appendNumber(out, quint64(qAbs(m_context.line)), m_context.line < 0);
+    }
+    if (m_context.function) {
+        appendLiteral(out, ",\"function\":");
+        appendJsonString(out, m_context.function);
+    }
+    appendLiteral(out, ",\"fields\":{");
+    FieldReader reader(m_data.constData(), m_data.size());
+    const char *nameEnd = m_format;
+    for (qsizetype i = 0; i < m_fieldCount; ++i) {
+        const char *name = nextPlaceholder(nameEnd, &nameEnd);
+        if (i)
+            out.append(',');
+        appendJsonString(out, name, nameEnd - name);
+        out.append(':');
+        appendField(out, reader.next(), true);
+    }
+    appendLiteral(out, "}}");
+    return QByteArray(out.constData(), out.size());
+}
+
+static QBasicAtomicPointer<void (const QLogRecord &)> logRecordHandler = Q_BASIC_ATOMIC_INITIALIZER(nullptr);
+
+void QLogRecord::dispatch() const
+{
+    if (QtLogRecordHandler handler = logRecordHandler.loadAcquire())
+        handler(*this);
+    else
+        qt_message_output(m_type, m_context, message());
+}
+
+/*!
+    \relates QLogRecord
+    \since 6.0
+
+    Installs a log record \a handler and returns the previously installed
+    one. Passing \nullptr restores the default behavior, which formats the
+    record and passes the result to the message handler installed with
+    qInstallMessageHandler().
+
+    The handler is called for every record created by qCDebugFields() and
+    the related macros whose category is enabled, from the thread that
+    created it. It must be reentrant.
+
+    \sa qJsonLogRecordHandler(), qJournaldLogRecordHandler()
+*/
+QtLogRecordHandler qInstallLogRecordHandler(QtLogRecordHandler handler)
+{
+    return logRecordHandler.fetchAndStoreOrdered(handler);
+}
+
+/*!
+    \relates QLogRecord
+    \since 6.0
+
+    A log record handler that writes \a record to \c stderr as one line of
+    JSON, as returned by QLogRecord::toJson().
+
+    \sa qInstallLogRecordHandler()
+*/
+void qJsonLogRecordHandler(const QLogRecord &record)
+{
+    QByteArray line = record.toJson();
+    line += '\n';
+    fwrite(line.constData(), 1, size_t(line.size()), stderr);
+    fflush(stderr);
+}
+
+#if QT_CONFIG(journald)
+// journald field names consist of upper case letters, digits and
+// underscores; the QT_FIELD_ prefix keeps them clear of the standard fields.
+static void appendJournaldFieldName(Buffer &out, QLatin1String name)
+{
+    appendLiteral(out, "QT_FIELD_");
+    for (char c : name) {
+        if (c >= 'a' && c <= 'z')
+            out.append(char(c - 'a' + 'A'));
+        else if ((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))
+            out.append(c);
+        else
+            out.append('_');
+    }
+    out.append('=');
+}
+#endif
+
+/*!
+    \relates QLogRecord
+    \since 6.0
+
+    A log record handler that sends \a record to the systemd journal. Each
+    field is stored as a separate journal field named after the field with
+    a \c QT_FIELD_ prefix, upper-cased, so that it can be matched with
+    \c journalctl without parsing the message.
+
+    If Qt was built without journald support, or if \c stderr is attached to
+    a console, the record is passed on like it is without a record handler.
+
+    \sa qInstallLogRecordHandler()
+*/
+void qJournaldLogRecordHandler(const QLogRecord &record)
+{
+#if QT_CONFIG(journald)
+    if (!QtPrivate::shouldLogToStderr()) {
+        int priority = LOG_INFO;
+        switch (record.type()) {
+        case QtDebugMsg: priority = LOG_DEBUG; break;
+        case QtInfoMsg: priority = LOG_INFO; break;
+        case QtWarningMsg: priority = LOG_WARNING; break;
+        case QtCriticalMsg: priority = LOG_CRIT; break;
+        case QtFatalMsg: priority = LOG_ALERT; break;
+        }
+
+        const QMessageLogContext &context = record.context();
+        QVarLengthArray<QByteArray, 16> entries;
+        entries.append("MESSAGE=" + record.message().toUtf8());
+        entries.append("PRIORITY=" + QByteArray::number(priority));
+        entries.append(QByteArray("CODE_FUNC=") + (context.function ? context.function : "unknown"));
+        entries.append("CODE_LINE=" + QByteArray::number(context.line));
+        entries.append(QByteArray("CODE_FILE=") + (context.file ? context.file : "unknown"));
+        entries.append(QByteArray("QT_CATEGORY=") + (context.category ? context.category : "unknown"));
+
+        FieldReader reader(record.m_data.constData(), record.m_data.size());
+        for (qsizetype i = 0; i < record.fieldCount(); ++i) {
+            Buffer entry;
+            appendJournaldFieldName(entry, record.fieldName(i));
+            appendField(entry, reader.next(), false);
+            entries.append(QByteArray(entry.constData(), entry.size()));
+        }
+
+        QVarLengthArray<struct iovec, 16> iov;
+        for (const QByteArray &entry : entries)
+            iov.append({ const_cast<char *>(entry.constData()), size_t(entry.size()) });
+        sd_journal_sendv(iov.constData(), int(iov.size()));
+        return;
+    }
+#endif
+    qt_message_output(record.type(), record.context(), record.message());
+}
+
+/*!
+    \macro qCDebugFields(category, format, ...)
+    \relates QLogRecord
+    \since 6.0
+
+    Logs a structured debug message in \a category if debug output is
+    enabled for it. Every \c{{name}} in the string literal \a format names
+    the field whose value is the corresponding argument.
+
+    As with qCDebug(), the arguments are not evaluated if the category is
+    disabled. The macro expands to nothing if \c QT_NO_DEBUG_OUTPUT is
+    defined.
+
+    \sa QLogRecord, qCDebug()
+*/
+
+/*!
+    \macro qCInfoFields(category, format, ...)
+    \relates QLogRecord
+    \since 6.0
+
+    Logs a structured informational message in \a category with the fields
+    named in \a format. The macro expands to nothing if
+    \c QT_NO_INFO_OUTPUT is defined.
+
+    \sa qCDebugFields(), qCInfo()
+*/
+
+/*!
+    \macro qCWarningFields(category, format, ...)
+    \relates QLogRecord
+    \since 6.0
+
+    Logs a structured warning in \a category with the fields named in
+    \a format. The macro expands to nothing if \c QT_NO_WARNING_OUTPUT is
+    defined.
+
+    \sa qCDebugFields(), qCWarning()
+*/
+
+/*!
+    \macro qCCriticalFields(category, format, ...)
+    \relates QLogRecord
+    \since 6.0
+
+    Logs a structured critical message in \a category with the fields named
+    in \a format.
+
+    \sa qCDebugFields(), qCCritical()
+*/
+
+QT_END_NAMESPACE
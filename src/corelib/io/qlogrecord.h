@@ -0,0 +1,202 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QLOGRECORD_H
+#define QLOGRECORD_H
+
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvarlengtharray.h>
+
+#include <cstring>
+#include <type_traits>
+
+QT_BEGIN_NAMESPACE
+
+class QVariant;
+
+class Q_CORE_EXPORT QLogRecord
+{
+    Q_DISABLE_COPY(QLogRecord)
+public:
+    enum FieldType : quint8 {
+        Bool,
+        Int,
+        UInt,
+        Double,
+        Utf16String,
+        Latin1String,
+        Utf8String,
+        ByteArray
+    };
+
+    QLogRecord(QtMsgType type, const char *file, int line, const char *function,
+               const char *category, const char *format) noexcept
+        : m_context(file, line, function, category), m_format(format), m_type(type) {}
+
+    template <int FieldCount, typename... Args>
+    void log(const Args &... args)
+    {
+        static_assert(sizeof...(Args) == FieldCount,
+                      "The number of arguments must match the number of {fields} in the format");
+        (append(args), ...);
+        dispatch();
+    }
+
+    QtMsgType type() const noexcept { return m_type; }
+    const QMessageLogContext &context() const noexcept { return m_context; }
+    const char *format() const noexcept { return m_format; }
+
+    qsizetype fieldCount() const noexcept { return m_fieldCount; }
+    QLatin1String fieldName(qsizetype index) const noexcept;
+    FieldType fieldType(qsizetype index) const noexcept;
+    QVariant fieldValue(qsizetype index) const;
+
+    QString message() const;
+    QByteArray toJson() const;
+
+private:
+    friend Q_CORE_EXPORT void qJournaldLogRecordHandler(const QLogRecord &record);
+
+    void dispatch() const;
+
+    template <typename T>
+    void appendRaw(FieldType type, const T &value)
+    {
+        m_data.append(char(type));
+        m_data.append(reinterpret_cast<const char *>(&value), sizeof(T));
+        ++m_fieldCount;
+    }
+    void appendRaw(FieldType type, const void *data, qsizetype size)
+    {
+        appendRaw(type, size);
+        if (size)
+            m_data.append(static_cast<const char *>(data), size);
+    }
+
+    void append(bool value) { appendRaw(Bool, value); }
+    template <typename T, std::enable_if_t<std::is_integral_v<T> && std::is_signed_v<T>, bool> = true>
+    void append(T value) { appendRaw(Int, qint64(value)); }
+    template <typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_signed_v<T>, bool> = true>
+    void append(T value) { appendRaw(UInt, quint64(value)); }
+    template <typename T, std::enable_if_t<std::is_enum_v<T>, bool> = true>
+    void append(T value) { append(std::underlying_type_t<T>(value)); }
+    void append(double value) { appendRaw(Double, value); }
+    void append(float value) { appendRaw(Double, double(value)); }
+    void append(QStringView value)
+    { appendRaw(Utf16String, value.data(), value.size() * qsizetype(sizeof(QChar))); }
+    void append(const QString &value) { append(QStringView(value)); }
+    void append(QLatin1String value) { appendRaw(Latin1String, value.data(), value.size()); }
+    void append(const char *value)
+    { appendRaw(Utf8String, value, value ? qsizetype(std::strlen(value)) : 0); }
+    void append(const QByteArray &value) { appendRaw(ByteArray, value.constData(), value.size()); }
+
+    QMessageLogContext m_context;
+    const char *m_format;
+    QtMsgType m_type;
+    qsizetype m_fieldCount = 0;
+    QVarLengthArray<char, 256> m_data;
+};
+
+typedef void (*QtLogRecordHandler)(const QLogRecord &);
+Q_CORE_EXPORT QtLogRecordHandler qInstallLogRecordHandler(QtLogRecordHandler);
+
+Q_CORE_EXPORT void qJsonLogRecordHandler(const QLogRecord &record);
+Q_CORE_EXPORT void qJournaldLogRecordHandler(const QLogRecord &record);
+
+namespace QtPrivate {
+constexpr int qLogFieldCount(const char *format) noexcept
+{
+    int count = 0;
+    while (*format) {
+        if (*format++ != '{')
+            continue;
+        if (*format == '{') {
+            ++format;
+            continue;
+        }
+        while (*format && *format != '}')
+            ++format;
+        if (*format) {
+            ++count;
+            ++format;
+        }
+    }
+    return count;
+}
+} // namespace QtPrivate
+
+#define QT_LOG_FIELDS(category, type, enabled, format, ...) \
+    for (bool qt_category_enabled = category().enabled(); qt_category_enabled; qt_category_enabled = false) \
+        QLogRecord(type, QT_MESSAGELOG_FILE, QT_MESSAGELOG_LINE, QT_MESSAGELOG_FUNC, \
+                   category().categoryName(), format) \
+            .log<QtPrivate::qLogFieldCount(format)>(__VA_ARGS__)
+
+#define QT_NO_LOG_FIELDS(type, format, ...) \
+    while (false) \
+        QLogRecord(type, nullptr, 0, nullptr, nullptr, format) \
+            .log<QtPrivate::qLogFieldCount(format)>(__VA_ARGS__)
+
+#if !defined(QT_NO_DEBUG_OUTPUT)
+#  define qCDebugFields(category, format, ...) \
+    QT_LOG_FIELDS(category, QtDebugMsg, isDebugEnabled, format, __VA_ARGS__)
+#else
+#  define qCDebugFields(category, format, ...) QT_NO_LOG_FIELDS(QtDebugMsg, format, __VA_ARGS__)
+#endif
+
+#if !defined(QT_NO_INFO_OUTPUT)
+#  define qCInfoFields(category, format, ...) \
+    QT_LOG_FIELDS(category, QtInfoMsg, isInfoEnabled, format, __VA_ARGS__)
+#else
+#  define qCInfoFields(category, format, ...) QT_NO_LOG_FIELDS(QtInfoMsg, format, __VA_ARGS__)
+#endif
+
+#if !defined(QT_NO_WARNING_OUTPUT)
+#  define qCWarningFields(category, format, ...) \
+    QT_LOG_FIELDS(category, QtWarningMsg, isWarningEnabled, format, __VA_ARGS__)
+#else
+#  define qCWarningFields(category, format, ...) QT_NO_LOG_FIELDS(QtWarningMsg, format, __VA_ARGS__)
+#endif
+
+#define qCCriticalFields(category, format, ...) \
+    QT_LOG_FIELDS(category, QtCriticalMsg, isCriticalEnabled, format, __VA_ARGS__)
+
+QT_END_NAMESPACE
+
+#endif // QLOGRECORD_H
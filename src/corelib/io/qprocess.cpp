@@ -89,9 +89,11 @@ QT_END_NAMESPACE
 #include "qprocess_p.h"
 
 #include <qbytearray.h>
+#include <qdeadlinetimer.h>
 #include <qelapsedtimer.h>
 #include <qcoreapplication.h>
 #include <qsocketnotifier.h>
+#include <qthread.h>
 #include <qtimer.h>
 
 #ifdef Q_OS_WIN
@@ -1556,6 +1558,12 @@ std::function<void(void)> QProcess::childProcessModifier() const
     If the modifier function needs to exit the process, remember to use
     \c{_exit()}, not \c{exit()}.
 
+    \note Setting a modifier makes QProcess start the child with a full
+    \c{fork()}. Without one, QProcess may start the child with \c{vfork()}
+    semantics on systems that support it, which avoids copying the address
+    space of the parent and makes starting processes from large applications
+    considerably cheaper.
+
     \note In multithreaded applications, this function must be careful not to
     call any functions that may lock mutexes that may have been in use in
     other threads (in general, using only functions defined by POSIX as
@@ -2504,6 +2512,260 @@ QString QProcess::nullDevice()
 #endif
 }
 
+/*!
+    \class QProcessPool
+    \inmodule QtCore
+    \since 6.0
+
+    \brief The QProcessPool class starts a batch of processes, running a
+    limited number of them at the same time.
+
+    \ingroup io
+
+    \reentrant
+
+    QProcessPool queues the processes passed to start() and starts them in
+    order, keeping at most maxProcessCount() of them running at any time.
+    Whenever a process finishes or fails to start, the pool emits
+    processFinished() for it and starts the next queued process. Once the
+    last process is done, the pool emits done().
+
+    All the processes of a pool are driven by the event loop of the thread
+    the pool lives in, so no additional threads are involved. Alternatively,
+    waitForDone() runs the processes to completion without an event loop.
+
+    \code
+    QProcessPool pool;
+    for (const QString &fileName : fileNames)
+        pool.start("gzip", {"-k", fileName});
+    QObject::connect(&pool, &QProcessPool::processFinished, [](QProcess *process) {
+        if (process->exitStatus() != QProcess::NormalExit || process->exitCode() != 0)
+            qWarning() << process->arguments().last() << "failed";
+        process->deleteLater();
+    });
+    \endcode
+
+    To configure a process before it is started, for example to set its
+    working directory or environment, create the QProcess yourself and pass
+    it to start().
+
+    \sa QProcess, QThreadPool
+*/
+
+/*!
+    \fn void QProcessPool::processFinished(QProcess *process)
+
+    This signal is emitted when \a process has finished or has failed to
+    start. The pool does not use \a process any more after emitting this
+    signal, so it is safe to delete it with QObject::deleteLater() from a
+    slot connected to this signal.
+
+    \sa done(), QProcess::finished(), QProcess::errorOccurred()
+*/
+
+/*!
+    \fn void QProcessPool::done()
+
+    This signal is emitted when the last process of the pool has finished
+    and no processes are queued.
+
+    \sa processFinished(), waitForDone()
+*/
+
+void QProcessPoolPrivate::startQueuedProcesses()
+{
+    Q_Q(QProcessPool);
+    while (active.size() < maxProcessCount && !queue.isEmpty()) {
+        const QueuedProcess next = queue.takeFirst();
+        QProcess *process = next.process;
+        if (!process)
+            continue;
+
+        active.append(process);
+        QObject::connect(process, &QProcess::finished, q, [this, process] {
+            processDone(process);
+        });
+        QObject::connect(process, &QProcess::errorOccurred, q,
+                         [this, q, process](QProcess::ProcessError error) {
+            // QProcess::start() reports this synchronously; never emit the
+            // pool's signals from within start(), nor start the next
+            // process recursively
+            if (error == QProcess::FailedToStart) {
+                QMetaObject::invokeMethod(q, [this, guard = QPointer<QProcess>(process)] {
+                    if (guard)
+                        processDone(guard);
+                }, Qt::QueuedConnection);
+            }
+        });
+        QObject::connect(process, &QObject::destroyed, q, [this, process] {
+            processDone(process, false);
+        });
+        process->start(next.mode);
+    }
+}
+
+void QProcessPoolPrivate::processDone(QProcess *process, bool emitFinished)
+{
+    Q_Q(QProcessPool);
+    if (!active.removeOne(process))
+        return;
+    QObject::disconnect(process, nullptr, q, nullptr);
+
+    if (emitFinished)
+        emit q->processFinished(process);
+    startQueuedProcesses();
+    if (active.isEmpty() && queue.isEmpty())
+        emit q->done();
+}
+
+/*!
+    Constructs a process pool with the given \a parent. The maximum number of
+    processes running at the same time is QThread::idealThreadCount().
+*/
+QProcessPool::QProcessPool(QObject *parent)
+    : QObject(*new QProcessPoolPrivate, parent)
+{
+    Q_D(QProcessPool);
+    d->maxProcessCount = qMax(1, QThread::idealThreadCount());
+}
+
+/*!
+    Destroys the process pool. Queued processes are not started. Processes
+    that are running are not waited for; the ones the pool created in
+    start() are destroyed along with it.
+*/
+QProcessPool::~QProcessPool()
+{
+    Q_D(QProcessPool);
+    d->queue.clear();
+}
+
+/*!
+    Queues \a process to be started with the given open \a mode. If fewer
+    than maxProcessCount() processes are running, \a process is started
+    immediately.
+
+    The pool's signals are never emitted from within this function, even if
+    \a process fails to start; processFinished() is emitted for it once
+    control returns to the event loop, or from waitForDone().
+
+    The pool does not take ownership of \a process, but stops tracking it
+    when it is destroyed.
+
+    \sa QProcess::start(), processFinished()
+*/
+void QProcessPool::start(QProcess *process, QIODevice::OpenMode mode)
+{
+    Q_D(QProcessPool);
+    Q_ASSERT(process);
+    d->queue.append({ process, mode });
+    d->startQueuedProcesses();
+}
+
+/*!
+    \overload
+
+    Creates a process that runs \a program with the given \a arguments and
+    queues it to be started with the open \a mode. Returns the new process,
+    which is a child of the pool; it may already have been started by the
+    time this function returns.
+
+    \sa QProcess::start(const QString &, const QStringList &, QIODevice::OpenMode)
+*/
+QProcess *QProcessPool::start(const QString &program, const QStringList &arguments,
+                              QIODevice::OpenMode mode)
+{
+    QProcess *process = new QProcess(this);
+    process->setProgram(program);
+    process->setArguments(arguments);
+    start(process, mode);
+    return process;
+}
+
+/*!
+    \property QProcessPool::maxProcessCount
+    \brief the maximum number of processes the pool runs at the same time
+
+    The default is QThread::idealThreadCount(). Values less than 1 are
+    treated as 1. Raising the limit starts queued processes immediately;
+    lowering it does not affect processes that are already running.
+*/
+int QProcessPool::maxProcessCount() const
+{
+    Q_D(const QProcessPool);
+    return d->maxProcessCount;
+}
+
+void QProcessPool::setMaxProcessCount(int count)
+{
+    Q_D(QProcessPool);
+    d->maxProcessCount = qMax(1, count);
+    d->startQueuedProcesses();
+}
+
+/*!
+    \property QProcessPool::activeProcessCount
+    \brief the number of processes the pool has started that have not
+    finished yet
+*/
+int QProcessPool::activeProcessCount() const
+{
+    Q_D(const QProcessPool);
+    return int(d->active.size());
+}
+
+/*!
+    Returns the number of processes waiting to be started.
+*/
+int QProcessPool::queuedProcessCount() const
+{
+    Q_D(const QProcessPool);
+    return int(d->queue.size());
+}
+
+/*!
+    Removes the processes that have not been started yet from the queue.
+    Processes that are already running are not affected.
+*/
+void QProcessPool::clear()
+{
+    Q_D(QProcessPool);
+    if (d->queue.isEmpty())
+        return;
+    d->queue.clear();
+    if (d->active.isEmpty())
+        emit done();
+}
+
+/*!
+    Blocks until all processes of the pool, including the queued ones, have
+    finished, or until \a msecs milliseconds have passed. Returns \c true if
+    all processes finished; otherwise returns \c false.
+
+    The pool's signals, and those of its processes, are emitted from within
+    this function as the processes finish.
+
+    If \a msecs is -1, this function will not time out.
+
+    \sa QProcess::waitForFinished(), done()
+*/
+bool QProcessPool::waitForDone(int msecs)
+{
+    Q_D(QProcessPool);
+    const QDeadlineTimer deadline(msecs);
+    while (!d->active.isEmpty()) {
+        QProcess *process = d->active.constFirst();
+        if (process->waitForFinished(int(deadline.remainingTime())))
+            continue;
+        if (!d->active.contains(process))
+            continue;       // failed to start
+        if (process->state() != QProcess::NotRunning)
+            return false;   // timed out
+        d->processDone(process);
+    }
+    return true;
+}
+
 #endif // QT_CONFIG(process)
 
 QT_END_NAMESPACE
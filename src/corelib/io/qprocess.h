@@ -287,6 +287,38 @@ private:
     friend class QProcessManager;
 };
 
+class QProcessPoolPrivate;
+
+class Q_CORE_EXPORT QProcessPool : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int maxProcessCount READ maxProcessCount WRITE setMaxProcessCount)
+    Q_PROPERTY(int activeProcessCount READ activeProcessCount)
+public:
+    explicit QProcessPool(QObject *parent = nullptr);
+    ~QProcessPool();
+
+    void start(QProcess *process, QIODevice::OpenMode mode = QIODevice::ReadWrite);
+    QProcess *start(const QString &program, const QStringList &arguments = {},
+                    QIODevice::OpenMode mode = QIODevice::ReadWrite);
+
+    int maxProcessCount() const;
+    void setMaxProcessCount(int count);
+    int activeProcessCount() const;
+    int queuedProcessCount() const;
+
+    void clear();
+    bool waitForDone(int msecs = -1);
+
+Q_SIGNALS:
+    void processFinished(QProcess *process);
+    void done();
+
+private:
+    Q_DECLARE_PRIVATE(QProcessPool)
+    Q_DISABLE_COPY(QProcessPool)
+};
+
 #endif // QT_CONFIG(process)
 
 QT_END_NAMESPACE
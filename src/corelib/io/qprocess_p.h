@@ -57,6 +57,7 @@
 #include "QtCore/qhash.h"
 #include "QtCore/qmap.h"
 #include "QtCore/qshareddata.h"
+#include "QtCore/qpointer.h"
 #include "private/qiodevice_p.h"
 
 QT_REQUIRE_CONFIG(processenvironment);
@@ -383,6 +384,24 @@ public:
     void setErrorAndEmit(QProcess::ProcessError error, const QString &description = QString());
 };
 
+class QProcessPoolPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QProcessPool)
+public:
+    struct QueuedProcess
+    {
+        QPointer<QProcess> process;
+        QIODevice::OpenMode mode;
+    };
+
+    void startQueuedProcesses();
+    void processDone(QProcess *process, bool emitFinished = true);
+
+    QList<QueuedProcess> queue;
+    QList<QProcess *> active;
+    int maxProcessCount = 1;
+};
+
 #endif // QT_CONFIG(process)
 
 QT_END_NAMESPACE
@@ -111,6 +111,8 @@ QT_END_NAMESPACE
 #endif
 
 #include <errno.h>
+#include <pthread.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -359,6 +361,41 @@ static char **_q_dupEnvironment(const QProcessEnvironmentPrivate::Map &environme
     return envp;
 }
 
+struct ChildProcessStartInfo
+{
+    QProcessPrivate *d;
+    const char *workingDirectory;
+    char **argv;
+    char **envp;
+    const sigset_t *originalSignalMask; // set if the parent blocked all signals
+};
+
+static int childProcessStart(void *token)
+{
+    const ChildProcessStartInfo *info = static_cast<const ChildProcessStartInfo *>(token);
+    if (info->originalSignalMask) {
+        // We may be sharing memory with the parent, so none of its signal
+        // handlers may run here. Reset the caught signals to their default
+        // disposition (as execve() would) before unblocking them.
+        for (int sig = 1; sig < NSIG; ++sig) {
+            struct sigaction action;
+            if (::sigaction(sig, nullptr, &action) != 0)
+                continue;
+            if ((action.sa_flags & SA_SIGINFO) == 0
+                    && (action.sa_handler == SIG_DFL || action.sa_handler == SIG_IGN))
+                continue;
+            action.sa_handler = SIG_DFL;
+            action.sa_flags = 0;
+            sigemptyset(&action.sa_mask);
+            ::sigaction(sig, &action, nullptr);
+        }
+        ::pthread_sigmask(SIG_SETMASK, info->originalSignalMask, nullptr);
+    }
+
+    info->d->execChild(info->workingDirectory, info->argv, info->envp);
+    return -1;
+}
+
 void QProcessPrivate::startProcess()
 {
     Q_Q(QProcess);
@@ -461,25 +498,39 @@ void QProcessPrivate::startProcess()
     int ffdflags = FFD_CLOEXEC;
     if (childProcessModifier)
         ffdflags |= FFD_USE_FORK;
+    else
+        ffdflags |= FFD_VFORK_SEMANTICS;
 
     // QTBUG-86285
 #if !QT_CONFIG(forkfd_pidfd)
     ffdflags |= FFD_USE_FORK;
 #endif
 
+    // With vfork semantics, the child shares our memory until it calls
+    // execve(), so keep all signals blocked until then. childProcessStart()
+    // restores the mask in the child.
+    ChildProcessStartInfo startInfo = { this, workingDirPtr, argv, envp, nullptr };
+    sigset_t originalSignalMask;
+    if ((ffdflags & FFD_USE_FORK) == 0) {
+        sigset_t allSignals;
+        sigfillset(&allSignals);
+        ::pthread_sigmask(SIG_SETMASK, &allSignals, &originalSignalMask);
+        startInfo.originalSignalMask = &originalSignalMask;
+    }
+
     pid_t childPid;
-    forkfd = ::forkfd(ffdflags , &childPid);
+    forkfd = ::vforkfd(ffdflags, &childPid, childProcessStart, &startInfo);
     int lastForkErrno = errno;
-    if (forkfd != FFD_CHILD_PROCESS) {
-        // Parent process.
-        // Clean up duplicated memory.
-        for (int i = 0; i <= arguments.count(); ++i)
-            free(argv[i]);
-        for (int i = 0; i < envc; ++i)
-            free(envp[i]);
-        delete [] argv;
-        delete [] envp;
-    }
+    if (startInfo.originalSignalMask)
+        ::pthread_sigmask(SIG_SETMASK, &originalSignalMask, nullptr);
+
+    // Clean up duplicated memory.
+    for (int i = 0; i <= arguments.count(); ++i)
+        free(argv[i]);
+    for (int i = 0; i < envc; ++i)
+        free(envp[i]);
+    delete [] argv;
+    delete [] envp;
 
     // On QNX, if spawnChild failed, childPid will be -1 but forkfd is still 0.
     // This is intentional because we only want to handle failure to fork()
@@ -497,12 +548,6 @@ void QProcessPrivate::startProcess()
         return;
     }
 
-    // Start the child.
-    if (forkfd == FFD_CHILD_PROCESS) {
-        execChild(workingDirPtr, argv, envp);
-        ::_exit(-1);
-    }
-
     pid = qint64(childPid);
     Q_ASSERT(pid > 0);
 
@@ -547,6 +592,8 @@ struct ChildError
     char function[8];
 };
 
+// Runs in the child process, possibly sharing memory with the parent: this
+// function must not modify any member of QProcessPrivate.
 void QProcessPrivate::execChild(const char *workingDir, char **argv, char **envp)
 {
     ::signal(SIGPIPE, SIG_DFL);         // reset the signal that we ignored
@@ -601,7 +648,6 @@ void QProcessPrivate::execChild(const char *workingDir, char **argv, char **envp
 report_errno:
     error.code = errno;
     qt_safe_write(childStartedPipe[1], &error, sizeof(error));
-    childStartedPipe[1] = -1;
 }
 
 bool QProcessPrivate::processStarted(QString *errorMessage)
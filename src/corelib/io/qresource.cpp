@@ -41,6 +41,7 @@
 #include "qresource.h"
 #include "qresource_p.h"
 #include "qresource_iterator_p.h"
+#include "qresourcepathhash_p.h"
 #include "qset.h"
 #include <private/qlocking_p.h>
 #include "qdebug.h"
@@ -140,19 +141,24 @@ public:
     };
 
 private:
-    const uchar *tree, *names, *payloads;
+    const uchar *tree, *names, *payloads, *pathIndex;
+    quint32 indexNodeCount, indexBucketCount, indexSlotCount;
     int version;
     inline int findOffset(int node) const { return node * (14 + (version >= 0x02 ? 8 : 0)); } //sizeof each tree element
     uint hash(int node) const;
     QString name(int node) const;
+    bool nameEquals(int node, QStringView str) const;
     short flags(int node) const;
+    int findIndexedNode(QStringView path, const QLocale &locale) const;
+    void setPathIndex(const uchar *end);
 public:
     mutable QAtomicInt ref;
 
-    inline QResourceRoot(): tree(nullptr), names(nullptr), payloads(nullptr), version(0) {}
+    inline QResourceRoot(): tree(nullptr), names(nullptr), payloads(nullptr), pathIndex(nullptr),
+                            indexNodeCount(0), indexBucketCount(0), indexSlotCount(0), version(0) {}
     inline QResourceRoot(int version, const uchar *t, const uchar *n, const uchar *d) { setSource(version, t, n, d); }
     virtual ~QResourceRoot() { }
-    int findNode(const QString &path, const QLocale &locale=QLocale()) const;
+    int findNode(QStringView path, const QLocale &locale=QLocale()) const;
     inline bool isContainer(int node) const { return flags(node) & Directory; }
     QResource::Compression compressionAlgo(int node)
     {
@@ -176,11 +182,17 @@ public:
     virtual ResourceRootType type() const { return Resource_Builtin; }
 
 protected:
-    inline void setSource(int v, const uchar *t, const uchar *n, const uchar *d) {
+    // end is the end of the resource data, or null if it is not known
+    inline void setSource(int v, const uchar *t, const uchar *n, const uchar *d,
+                          const uchar *end = nullptr) {
         tree = t;
         names = n;
         payloads = d;
         version = v;
+        pathIndex = nullptr;
+        indexNodeCount = indexBucketCount = indexSlotCount = 0;
+        if (v >= 0x04)
+            setPathIndex(end);
     }
 };
 
@@ -798,21 +810,148 @@ inline QString QResourceRoot::name(int node) const
     return ret;
 }
 
-int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
+inline bool QResourceRoot::nameEquals(int node, QStringView str) const
+{
+    if (!node) // root
+        return str.isEmpty();
+    const int offset = findOffset(node);
+
+    qint32 name_offset = qFromBigEndian<qint32>(tree + offset);
+    const quint16 name_length = qFromBigEndian<qint16>(names + name_offset);
+    if (name_length != str.size())
+        return false;
+    name_offset += 2;
+    name_offset += 4; // jump past hash
+
+    const uchar *name_data = names + name_offset;
+    for (qsizetype i = 0; i < str.size(); ++i) {
+        if (qFromBigEndian<quint16>(name_data + 2 * i) != str.at(i).unicode())
+            return false;
+    }
+    return true;
+}
+
+/*
+    Looks up \a path in the perfect hash path index written by rcc for
+    format version 4 and higher. The index has the following layout, all
+    numbers being 32-bit big endian:
+
+        node count, bucket count, slot count
+        seed for each bucket
+        node number for each slot (0 if unused)
+        parent node number for each node
+
+    Every path maps to exactly one slot, which is verified by walking the
+    parent links back to the root, so no allocations are needed.
+*/
+void QResourceRoot::setPathIndex(const uchar *end)
+{
+    // the otherwise unused name offset of the root node locates the path index
+    const qint32 index_offset = qFromBigEndian<qint32>(tree);
+    if (index_offset <= 0)
+        return;
+    const uchar *index = tree + index_offset;
+    if (end && (index >= end || end - index < 12))
+        return;
+
+    // an inconsistent index is ignored, lookups then walk the tree
+    const quint32 node_count = qFromBigEndian<quint32>(index);
+    const quint32 bucket_count = qFromBigEndian<quint32>(index + 4);
+    const quint32 slot_count = qFromBigEndian<quint32>(index + 8);
+    if (!node_count || !bucket_count || !slot_count || node_count > quint32(INT_MAX))
+        return;
+    if (end) {
+        const quint64 indexSize = 4 * (3 + quint64(bucket_count) + slot_count + node_count);
+        const quint64 treeSize = quint64(node_count) * findOffset(1);
+        if (indexSize > quint64(end - index) || tree >= end || treeSize > quint64(end - tree))
+            return;
+    }
+    pathIndex = index;
+    indexNodeCount = node_count;
+    indexBucketCount = bucket_count;
+    indexSlotCount = slot_count;
+}
+
+int QResourceRoot::findIndexedNode(QStringView path, const QLocale &locale) const
+{
+    const auto indexValue = [this](qsizetype i) {
+        return qFromBigEndian<quint32>(pathIndex + 4 * i);
+    };
+    const qsizetype seedsBegin = 3;
+    const qsizetype slotsBegin = seedsBegin + indexBucketCount;
+    const qsizetype parentsBegin = slotsBegin + indexSlotCount;
+
+    const quint32 seed = indexValue(seedsBegin + qResourcePathHash(path, 0) % indexBucketCount);
+    const quint32 node = indexValue(slotsBegin + qResourcePathHash(path, seed) % indexSlotCount);
+    if (!node || node >= indexNodeCount)
+        return -1;
+
+    // verify the match, segment by segment from the end
+    const qsizetype lastSlash = path.lastIndexOf(QLatin1Char('/'));
+    const QStringView fileName = path.mid(lastSlash + 1);
+    quint32 parent = node;
+    for (QStringView rest = path; ; ) {
+        const qsizetype slash = rest.lastIndexOf(QLatin1Char('/'));
+        if (!parent || parent >= indexNodeCount || !nameEquals(parent, rest.mid(slash + 1)))
+            return -1;
+        parent = indexValue(parentsBegin + parent);
+        if (parent >= indexNodeCount)
+            return -1;
+        if (slash < 0)
+            break;
+        rest = rest.left(slash);
+    }
+    if (parent != 0)
+        return -1;
+
+    int offset = findOffset(node) + 4; // jump past name
+    const qint16 flags = qFromBigEndian<qint16>(tree + offset);
+    if (flags & Directory)
+        return node;
+
+    // the index refers to the first variant of a file; pick the best locale
+    parent = indexValue(parentsBegin + node);
+    if (parent >= indexNodeCount)
+        return -1;
+    offset = findOffset(parent) + 6; // jump past name and flags
+    const qint32 child_count = qFromBigEndian<qint32>(tree + offset);
+    const qint32 child = qFromBigEndian<qint32>(tree + offset + 4);
+    const qint64 children_end = qMin(qint64(child) + child_count, qint64(indexNodeCount));
+    const uint h = hash(node);
+    int result = -1;
+    for (int sub_node = node; sub_node < children_end && hash(sub_node) == h; ++sub_node) {
+        if (!nameEquals(sub_node, fileName))
+            continue;
+        offset = findOffset(sub_node) + 6; // jump past name and flags
+        const qint16 country = qFromBigEndian<qint16>(tree + offset);
+        const qint16 language = qFromBigEndian<qint16>(tree + offset + 2);
+        if (country == locale.country() && language == locale.language())
+            return sub_node;
+        if ((country == QLocale::AnyCountry && language == locale.language())
+            || (country == QLocale::AnyCountry && language == QLocale::C && result == -1)) {
+            result = sub_node;
+        }
+    }
+    return result;
+}
+
+int QResourceRoot::findNode(QStringView path, const QLocale &locale) const
 {
-    QString path = _path;
     {
-        QString root = mappingRoot();
+        const QString root = mappingRoot();
         if (!root.isEmpty()) {
             if (root == path) {
-                path = QLatin1Char('/');
+                path = u"/";
             } else {
-                if (!root.endsWith(QLatin1Char('/')))
-                    root += QLatin1Char('/');
-                if (path.size() >= root.size() && path.startsWith(root))
-                    path = path.mid(root.length() - 1);
+                QStringView prefix = root;
+                if (prefix.endsWith(QLatin1Char('/')))
+                    prefix.chop(1);
+                if (path.size() > prefix.size() && path.startsWith(prefix)
+                    && path.at(prefix.size()) == QLatin1Char('/')) {
+                    path = path.mid(prefix.size());
+                }
                 if (path.isEmpty())
-                    path = QLatin1Char('/');
+                    path = u"/";
             }
         }
     }
@@ -823,6 +962,17 @@ int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
     if (path == QLatin1String("/"))
         return 0;
 
+    if (pathIndex) {
+        QStringView relative = path;
+        while (relative.startsWith(QLatin1Char('/')))
+            relative = relative.mid(1);
+        // the index only knows normalized paths
+        if (!relative.isEmpty() && !relative.endsWith(QLatin1Char('/'))
+            && !relative.contains(QLatin1String("//"))) {
+            return findIndexedNode(relative, locale);
+        }
+    }
+
     // the root node is always first
     qint32 child_count = qFromBigEndian<qint32>(tree + 6);
     qint32 child       = qFromBigEndian<qint32>(tree + 10);
@@ -864,7 +1014,7 @@ int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
                 --sub_node;
             for (; sub_node < child + child_count && hash(sub_node) == h;
                  ++sub_node) { // here we go...
-                if (name(sub_node) == segment) {
+                if (nameEquals(sub_node, segment)) {
                     found = true;
                     int offset = findOffset(sub_node);
 #ifdef DEBUG_RESOURCE_MATCH
@@ -1015,7 +1165,7 @@ Q_CORE_EXPORT bool qRegisterResourceData(int version, const unsigned char *tree,
         return false;
     const auto locker = qt_scoped_lock(resourceMutex());
     ResourceList *list = resourceList();
-    if (version >= 0x01 && version <= 0x3) {
+    if (version >= 0x01 && version <= 0x4) {
         bool found = false;
         QResourceRoot res(version, tree, name, data);
         for (int i = 0; i < list->size(); ++i) {
@@ -1041,7 +1191,7 @@ Q_CORE_EXPORT bool qUnregisterResourceData(int version, const unsigned char *tre
         return false;
 
     const auto locker = qt_scoped_lock(resourceMutex());
-    if (version >= 0x01 && version <= 0x3) {
+    if (version >= 0x01 && version <= 0x4) {
         QResourceRoot res(version, tree, name, data);
         ResourceList *list = resourceList();
         for (int i = 0; i < list->size();) {
@@ -1121,9 +1271,10 @@ public:
         if (file_flags & ~acceptableFlags)
             return false;
 
-        if (version >= 0x01 && version <= 0x03) {
+        if (version >= 0x01 && version <= 0x04) {
             buffer = b;
-            setSource(version, b + tree_offset, b + name_offset, b + data_offset);
+            setSource(version, b + tree_offset, b + name_offset, b + data_offset,
+                      size >= 0 ? b + size : nullptr);
             return true;
         }
         return false;
@@ -65,13 +65,14 @@ QPersistentModelIndexData *QPersistentModelIndexData::create(const QModelIndex &
     Q_ASSERT(index.isValid()); // we will _never_ insert an invalid index in the list
     QPersistentModelIndexData *d = nullptr;
     QAbstractItemModel *model = const_cast<QAbstractItemModel *>(index.model());
-    QMultiHash<QModelIndex, QPersistentModelIndexData *> &indexes = model->d_func()->persistent.indexes;
-    const auto it = indexes.constFind(index);
-    if (it != indexes.cend()) {
+    QAbstractItemModelPrivate::Persistent &persistent = model->d_func()->persistent;
+    const auto it = persistent.indexes.constFind(index);
+    if (it != persistent.indexes.cend()) {
         d = (*it);
     } else {
         d = new QPersistentModelIndexData(index);
-        indexes.insert(index, d);
+        persistent.indexes.insert(index, d);
+        persistent.track(d);
     }
     Q_ASSERT(d);
     return d;
@@ -749,7 +750,7 @@ void QAbstractItemModelPrivate::invalidatePersistentIndexes()
 {
     for (QPersistentModelIndexData *data : qAsConst(persistent.indexes))
         data->index = QModelIndex();
-    persistent.indexes.clear();
+    persistent.clear();
 }
 
 /*!
@@ -762,6 +763,7 @@ void QAbstractItemModelPrivate::invalidatePersistentIndex(const QModelIndex &ind
     if (it != persistent.indexes.cend()) {
         QPersistentModelIndexData *data = *it;
         persistent.indexes.erase(it);
+        persistent.untrack(data);
         data->index = QModelIndex();
     }
 }
@@ -872,6 +874,7 @@ void QAbstractItemModelPrivate::removePersistentIndexData(QPersistentModelIndexD
         // This assert may happen if the model use changePersistentIndex in a way that could result on two
         // QPersistentModelIndex pointing to the same index.
         Q_UNUSED(removed);
+        persistent.untrack(data);
     }
     // make sure our optimization still works
     for (int i = persistent.moved.count() - 1; i >= 0; --i) {
@@ -895,10 +898,16 @@ void QAbstractItemModelPrivate::rowsAboutToBeInserted(const QModelIndex &parent,
     Q_UNUSED(last);
     QList<QPersistentModelIndexData *> persistent_moved;
     if (first < q->rowCount(parent)) {
-        for (auto *data : qAsConst(persistent.indexes)) {
-            const QModelIndex &index = data->index;
-            if (index.row() >= first && index.isValid() && index.parent() == parent) {
-                persistent_moved.append(data);
+        persistent.classify();
+        if (!parent.isValid()) {
+            // the top level entries are sorted by row, so only visit the ones that move
+            for (auto it = persistent.topLevel.lower_bound(first); it != persistent.topLevel.end(); ++it)
+                persistent_moved.append(*it);
+        } else {
+            for (auto *data : qAsConst(persistent.nested)) {
+                const QModelIndex &index = data->index;
+                if (index.row() >= first && index.parent() == parent)
+                    persistent_moved.append(data);
             }
         }
     }
@@ -912,13 +921,8 @@ void QAbstractItemModelPrivate::rowsInserted(const QModelIndex &parent,
     const int count = (last - first) + 1; // it is important to only use the delta, because the change could be nested
     for (auto *data : persistent_moved) {
         QModelIndex old = data->index;
-        persistent.indexes.erase(persistent.indexes.constFind(old));
-        data->index = q_func()->index(old.row() + count, old.column(), parent);
-        if (data->index.isValid()) {
-            persistent.insertMultiAtEnd(data->index, data);
-        } else {
+        if (!shiftPersistentIndex(data, old.row() + count, old.column(), parent))
             qWarning() << "QAbstractItemModel::endInsertRows:  Invalid index (" << old.row() + count << ',' << old.column() << ") in model" << q_func();
-        }
     }
 }
 
@@ -931,7 +935,7 @@ void QAbstractItemModelPrivate::itemsAboutToBeMoved(const QModelIndex &srcParent
     const bool sameParent = (srcParent == destinationParent);
     const bool movingUp = (srcFirst > destinationChild);
 
-    for (auto *data : qAsConst(persistent.indexes)) {
+    const auto visit = [&](QPersistentModelIndexData *data) {
         const QModelIndex &index = data->index;
         const QModelIndex &parent = index.parent();
         const bool isSourceIndex = (parent == srcParent);
@@ -944,31 +948,41 @@ void QAbstractItemModelPrivate::itemsAboutToBeMoved(const QModelIndex &srcParent
             childPosition = index.column();
 
         if (!index.isValid() || !(isSourceIndex || isDestinationIndex ) )
-            continue;
+            return;
 
         if (!sameParent && isDestinationIndex) {
             if (childPosition >= destinationChild)
                 persistent_moved_in_destination.append(data);
-            continue;
+            return;
         }
 
         if (sameParent && movingUp && childPosition < destinationChild)
-            continue;
+            return;
 
         if (sameParent && !movingUp && childPosition < srcFirst )
-            continue;
+            return;
 
         if (!sameParent && childPosition < srcFirst)
-            continue;
+            return;
 
         if (sameParent && (childPosition > srcLast) && (childPosition >= destinationChild ))
-            continue;
+            return;
 
         if ((childPosition <= srcLast) && (childPosition >= srcFirst)) {
             persistent_moved_explicitly.append(data);
         } else {
             persistent_moved_in_source.append(data);
         }
+    };
+
+    persistent.classify();
+    if (!srcParent.isValid() || !destinationParent.isValid()) {
+        for (auto *data : persistent.topLevel)
+            visit(data);
+    }
+    if (srcParent.isValid() || destinationParent.isValid()) {
+        for (auto *data : qAsConst(persistent.nested))
+            visit(data);
     }
     persistent.moved.push(persistent_moved_explicitly);
     persistent.moved.push(persistent_moved_in_source);
@@ -995,15 +1009,42 @@ void QAbstractItemModelPrivate::movePersistentIndexes(const QList<QPersistentMod
             column += change;
 
         persistent.indexes.erase(persistent.indexes.constFind(data->index));
+        persistent.untrack(data);
         data->index = q_func()->index(row, column, parent);
         if (data->index.isValid()) {
             persistent.insertMultiAtEnd(data->index, data);
+            persistent.track(data, parent);
         } else {
             qWarning() << "QAbstractItemModel::endMoveRows:  Invalid index (" << row << "," << column << ") in model" << q_func();
         }
     }
 }
 
+/*!
+  \internal
+
+  Changes the persistent index \a data to the index at \a row and \a column
+  under its unchanged \a parent. Returns \c false if the model has no such
+  index, in which case \a data is invalidated.
+*/
+bool QAbstractItemModelPrivate::shiftPersistentIndex(QPersistentModelIndexData *data, int row, int column,
+                                                     const QModelIndex &parent)
+{
+    persistent.indexes.erase(persistent.indexes.constFind(data->index));
+    const QModelIndex index = q_func()->index(row, column, parent);
+    // the top level entries are sorted by row, take them out while it changes
+    const bool resort = !parent.isValid() && data->index.row() != row;
+    if (resort || !index.isValid())
+        persistent.untrack(data);
+    data->index = index;
+    if (!index.isValid())
+        return false;
+    persistent.insertMultiAtEnd(index, data);
+    if (resort)
+        persistent.track(data, parent);
+    return true;
+}
+
 void QAbstractItemModelPrivate::itemsMoved(const QModelIndex &sourceParent, int sourceFirst, int sourceLast, const QModelIndex &destinationParent, int destinationChild, Qt::Orientation orientation)
 {
     const QList<QPersistentModelIndexData *> moved_in_destination = persistent.moved.pop();
@@ -1029,7 +1070,16 @@ void QAbstractItemModelPrivate::rowsAboutToBeRemoved(const QModelIndex &parent,
     QList<QPersistentModelIndexData *> persistent_invalidated;
     // find the persistent indexes that are affected by the change, either by being in the removed subtree
     // or by being on the same level and below the removed rows
-    for (auto *data : qAsConst(persistent.indexes)) {
+    persistent.classify();
+    if (!parent.isValid()) {
+        for (auto it = persistent.topLevel.lower_bound(first); it != persistent.topLevel.end(); ++it) {
+            if ((*it)->index.row() > last)
+                persistent_moved.append(*it);
+            else
+                persistent_invalidated.append(*it);
+        }
+    }
+    for (auto *data : qAsConst(persistent.nested)) {
         bool level_changed = false;
         QModelIndex current = data->index;
         while (current.isValid()) {
@@ -1057,19 +1107,15 @@ void QAbstractItemModelPrivate::rowsRemoved(const QModelIndex &parent,
     const int count = (last - first) + 1; // it is important to only use the delta, because the change could be nested
     for (auto *data : persistent_moved) {
         QModelIndex old = data->index;
-        persistent.indexes.erase(persistent.indexes.constFind(old));
-        data->index = q_func()->index(old.row() - count, old.column(), parent);
-        if (data->index.isValid()) {
-            persistent.insertMultiAtEnd(data->index, data);
-        } else {
+        if (!shiftPersistentIndex(data, old.row() - count, old.column(), parent))
             qWarning() << "QAbstractItemModel::endRemoveRows:  Invalid index (" << old.row() - count << ',' << old.column() << ") in model" << q_func();
-        }
     }
     const QList<QPersistentModelIndexData *> persistent_invalidated = persistent.invalidated.pop();
     for (auto *data : persistent_invalidated) {
         auto pit = persistent.indexes.constFind(data->index);
         if (pit != persistent.indexes.cend())
             persistent.indexes.erase(pit);
+        persistent.untrack(data);
         data->index = QModelIndex();
     }
 }
@@ -1081,10 +1127,18 @@ void QAbstractItemModelPrivate::columnsAboutToBeInserted(const QModelIndex &pare
     Q_UNUSED(last);
     QList<QPersistentModelIndexData *> persistent_moved;
     if (first < q->columnCount(parent)) {
-        for (auto *data : qAsConst(persistent.indexes)) {
-            const QModelIndex &index = data->index;
-            if (index.column() >= first && index.isValid() && index.parent() == parent)
-                persistent_moved.append(data);
+        persistent.classify();
+        if (!parent.isValid()) {
+            for (auto *data : persistent.topLevel) {
+                if (data->index.column() >= first)
+                    persistent_moved.append(data);
+            }
+        } else {
+            for (auto *data : qAsConst(persistent.nested)) {
+                const QModelIndex &index = data->index;
+                if (index.column() >= first && index.parent() == parent)
+                    persistent_moved.append(data);
+            }
         }
     }
     persistent.moved.push(persistent_moved);
@@ -1097,13 +1151,8 @@ void QAbstractItemModelPrivate::columnsInserted(const QModelIndex &parent,
     const int count = (last - first) + 1; // it is important to only use the delta, because the change could be nested
     for (auto *data : persistent_moved) {
         QModelIndex old = data->index;
-        persistent.indexes.erase(persistent.indexes.constFind(old));
-        data->index = q_func()->index(old.row(), old.column() + count, parent);
-        if (data->index.isValid()) {
-            persistent.insertMultiAtEnd(data->index, data);
-        } else {
+        if (!shiftPersistentIndex(data, old.row(), old.column() + count, parent))
             qWarning() << "QAbstractItemModel::endInsertColumns:  Invalid index (" << old.row() << ',' << old.column() + count << ") in model" << q_func();
-        }
     }
 }
 
@@ -1114,7 +1163,17 @@ void QAbstractItemModelPrivate::columnsAboutToBeRemoved(const QModelIndex &paren
     QList<QPersistentModelIndexData *> persistent_invalidated;
     // find the persistent indexes that are affected by the change, either by being in the removed subtree
     // or by being on the same level and to the right of the removed columns
-    for (auto *data : qAsConst(persistent.indexes)) {
+    persistent.classify();
+    if (!parent.isValid()) {
+        for (auto *data : persistent.topLevel) {
+            const int column = data->index.column();
+            if (column > last)
+                persistent_moved.append(data);
+            else if (column >= first)
+                persistent_invalidated.append(data);
+        }
+    }
+    for (auto *data : qAsConst(persistent.nested)) {
         bool level_changed = false;
         QModelIndex current = data->index;
         while (current.isValid()) {
@@ -1143,19 +1202,15 @@ void QAbstractItemModelPrivate::columnsRemoved(const QModelIndex &parent,
     const int count = (last - first) + 1; // it is important to only use the delta, because the change could be nested
     for (auto *data : persistent_moved) {
         QModelIndex old = data->index;
-        persistent.indexes.erase(persistent.indexes.constFind(old));
-        data->index = q_func()->index(old.row(), old.column() - count, parent);
-        if (data->index.isValid()) {
-            persistent.insertMultiAtEnd(data->index, data);
-        } else {
+        if (!shiftPersistentIndex(data, old.row(), old.column() - count, parent))
             qWarning() << "QAbstractItemModel::endRemoveColumns:  Invalid index (" << old.row() << ',' << old.column() - count << ") in model" << q_func();
-        }
     }
     const QList<QPersistentModelIndexData *> persistent_invalidated = persistent.invalidated.pop();
     for (auto *data : persistent_invalidated) {
         auto index = persistent.indexes.constFind(data->index);
         if (index != persistent.indexes.constEnd())
             persistent.indexes.erase(index);
+        persistent.untrack(data);
         data->index = QModelIndex();
     }
 }
@@ -3451,9 +3506,12 @@ void QAbstractItemModel::changePersistentIndex(const QModelIndex &from, const QM
     if (it != d->persistent.indexes.cend()) {
         QPersistentModelIndexData *data = *it;
         d->persistent.indexes.erase(it);
+        d->persistent.untrack(data);
         data->index = to;
-        if (to.isValid())
+        if (to.isValid()) {
             d->persistent.insertMultiAtEnd(to, data);
+            d->persistent.track(data);
+        }
     }
 }
 
@@ -3483,14 +3541,17 @@ void QAbstractItemModel::changePersistentIndexList(const QModelIndexList &from,
         if (it != d->persistent.indexes.cend()) {
             QPersistentModelIndexData *data = *it;
             d->persistent.indexes.erase(it);
+            d->persistent.untrack(data);
             data->index = to.at(i);
             if (data->index.isValid())
                 toBeReinserted << data;
         }
     }
 
-    for (auto *data : qAsConst(toBeReinserted))
+    for (auto *data : qAsConst(toBeReinserted)) {
         d->persistent.insertMultiAtEnd(data->index, data);
+        d->persistent.track(data);
+    }
 }
 
 /*!
@@ -3698,6 +3759,59 @@ void QAbstractItemModel::multiData(const QModelIndex &index, QModelRoleDataSpan
         d.setData(data(index, d.role()));
 }
 
+/*!
+    \since 6.0
+
+    Fills the \a roleDataSpan with the requested data for all the items
+    in the range from \a topLeft to \a bottomRight, in a single call.
+
+    The items are laid out in the span one row after the other, from
+    left to right within each row, and every item occupies the same
+    number of consecutive QModelRoleData objects. That number is the
+    size of the span divided by the number of items in the range. For
+    instance, fetching the display and decoration roles for two rows of
+    three columns requires a span of twelve elements, where the elements
+    at position 6 and 7 hold the data of the first item of the second row:
+
+    \snippet code/src_corelib_kernel_qabstractitemmodel.cpp 17
+
+    The default implementation calls multiData() for each item in the
+    range, with the part of the span that belongs to that item. A
+    subclass can reimplement this function to look up the data for many
+    items at once, for instance when the items of a row are stored
+    together. Proxy models reimplement it to forward the request to
+    their source model in as few calls as possible, if
+    \l{QAbstractProxyModel::}{rangeDataForwardingEnabled} is set.
+
+    The same rules apply as for multiData(): the data of roles that the
+    model cannot provide must be cleared, and the roles stored in the
+    span must not be modified.
+
+    \note Both \a topLeft and \a bottomRight must be valid indexes
+    with the same parent, and \a bottomRight must not be above or to
+    the left of \a topLeft.
+
+    \sa multiData(), QModelRoleDataSpan
+*/
+void QAbstractItemModel::rangeData(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                   QModelRoleDataSpan roleDataSpan) const
+{
+    Q_ASSERT(checkIndex(topLeft, CheckIndexOption::IndexIsValid));
+    Q_ASSERT(checkIndex(bottomRight, CheckIndexOption::IndexIsValid));
+    Q_ASSERT(topLeft.parent() == bottomRight.parent());
+
+    const QModelIndex parent = topLeft.parent();
+    const qsizetype rolesPerItem = QAbstractItemModelPrivate::rolesPerItem(topLeft, bottomRight,
+                                                                          roleDataSpan);
+    QModelRoleData *roleData = roleDataSpan.data();
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        for (int column = topLeft.column(); column <= bottomRight.column(); ++column) {
+            multiData(index(row, column, parent), QModelRoleDataSpan(roleData, rolesPerItem));
+            roleData += rolesPerItem;
+        }
+    }
+}
+
 /*!
     \class QAbstractTableModel
     \inmodule QtCore
@@ -4184,6 +4298,62 @@ void QAbstractItemModelPrivate::Persistent::insertMultiAtEnd(const QModelIndex&
     }
 }
 
+/*!
+    \internal
+
+    Starts tracking \a data, whose parent has not been looked up yet.
+*/
+void QAbstractItemModelPrivate::Persistent::track(QPersistentModelIndexData *data)
+{
+    unclassified.insert(data);
+}
+
+/*!
+    \internal
+
+    Starts tracking \a data, whose index is a child of \a parent.
+*/
+void QAbstractItemModelPrivate::Persistent::track(QPersistentModelIndexData *data, const QModelIndex &parent)
+{
+    if (parent.isValid())
+        nested.insert(data);
+    else
+        topLevel.insert(topLevel.end(), data); // shifted entries are reinserted in order
+}
+
+/*!
+    \internal
+
+    Stops tracking \a data. Must be called before its row changes.
+*/
+void QAbstractItemModelPrivate::Persistent::untrack(QPersistentModelIndexData *data)
+{
+    if (!topLevel.erase(data) && !nested.remove(data))
+        unclassified.remove(data);
+}
+
+/*!
+    \internal
+
+    Sorts the persistent indexes created or changed since the last structural
+    change into top level and nested ones. Deferring this keeps parent() calls
+    off the path that creates persistent indexes.
+*/
+void QAbstractItemModelPrivate::Persistent::classify()
+{
+    for (auto *data : qAsConst(unclassified))
+        track(data, data->index.parent());
+    unclassified.clear();
+}
+
+void QAbstractItemModelPrivate::Persistent::clear()
+{
+    indexes.clear();
+    topLevel.clear();
+    nested.clear();
+    unclassified.clear();
+}
+
 QT_END_NAMESPACE
 
 #include "moc_qabstractitemmodel.cpp"
@@ -361,6 +361,8 @@ public:
     [[nodiscard]] bool checkIndex(const QModelIndex &index, CheckIndexOptions options = CheckIndexOption::NoOption) const;
 
     virtual void multiData(const QModelIndex &index, QModelRoleDataSpan roleDataSpan) const;
+    virtual void rangeData(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                           QModelRoleDataSpan roleDataSpan) const;
 
 Q_SIGNALS:
     void dataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
@@ -534,7 +536,7 @@ inline Qt::ItemFlags QModelIndex::flags() const
 { return m ? m->flags(*this) : Qt::ItemFlags(); }
 
 inline size_t qHash(const QModelIndex &index, size_t seed = 0) noexcept
-{ return size_t((size_t(index.row()) << 4) + size_t(index.column()) + index.internalId()) ^ seed; }
+{ return qHashMulti(seed, index.row(), index.column(), index.internalId()); }
 
 QT_END_NAMESPACE
 
@@ -58,6 +58,8 @@
 #include "QtCore/qset.h"
 #include "QtCore/qhash.h"
 
+#include <set>
+
 QT_BEGIN_NAMESPACE
 
 QT_REQUIRE_CONFIG(itemmodel);
@@ -84,6 +86,7 @@ public:
     void removePersistentIndexData(QPersistentModelIndexData *data);
     void movePersistentIndexes(const QList<QPersistentModelIndexData *> &indexes, int change, const QModelIndex &parent,
                                Qt::Orientation orientation);
+    bool shiftPersistentIndex(QPersistentModelIndexData *data, int row, int column, const QModelIndex &parent);
     void rowsAboutToBeInserted(const QModelIndex &parent, int first, int last);
     void rowsInserted(const QModelIndex &parent, int first, int last);
     void rowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
@@ -95,6 +98,16 @@ public:
     static QAbstractItemModel *staticEmptyModel();
     static bool variantLessThan(const QVariant &v1, const QVariant &v2);
 
+    static qsizetype rolesPerItem(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                  QModelRoleDataSpan roleDataSpan)
+    {
+        const qsizetype items = qsizetype(bottomRight.row() - topLeft.row() + 1)
+                                * (bottomRight.column() - topLeft.column() + 1);
+        Q_ASSERT(items > 0);
+        Q_ASSERT(roleDataSpan.size() % items == 0);
+        return roleDataSpan.size() / items;
+    }
+
     void itemsAboutToBeMoved(const QModelIndex &srcParent, int srcFirst, int srcLast, const QModelIndex &destinationParent, int destinationChild, Qt::Orientation);
     void itemsMoved(const QModelIndex &srcParent, int srcFirst, int srcLast, const QModelIndex &destinationParent, int destinationChild, Qt::Orientation orientation);
     bool allowMove(const QModelIndex &srcParent, int srcFirst, int srcLast, const QModelIndex &destinationParent, int destinationChild, Qt::Orientation orientation);
@@ -146,6 +159,31 @@ public:
         QStack<QList<QPersistentModelIndexData *>> moved;
         QStack<QList<QPersistentModelIndexData *>> invalidated;
         void insertMultiAtEnd(const QModelIndex& key, QPersistentModelIndexData *data);
+
+        // Secondary index over the entries of indexes, so that structural
+        // changes only visit the persistent indexes they can affect.
+        // An entry's row must never change while it is in topLevel.
+        struct ByRow {
+            using is_transparent = void;
+            bool operator()(const QPersistentModelIndexData *lhs, const QPersistentModelIndexData *rhs) const
+            {
+                if (lhs->index.row() != rhs->index.row())
+                    return lhs->index.row() < rhs->index.row();
+                return std::less<const QPersistentModelIndexData *>()(lhs, rhs);
+            }
+            bool operator()(const QPersistentModelIndexData *lhs, int row) const
+            { return lhs->index.row() < row; }
+            bool operator()(int row, const QPersistentModelIndexData *rhs) const
+            { return row < rhs->index.row(); }
+        };
+        std::set<QPersistentModelIndexData *, ByRow> topLevel;      // parent is the root
+        QSet<QPersistentModelIndexData *> nested;                   // parent is a valid index
+        QSet<QPersistentModelIndexData *> unclassified;             // parent not looked up yet
+        void track(QPersistentModelIndexData *data);
+        void track(QPersistentModelIndexData *data, const QModelIndex &parent);
+        void untrack(QPersistentModelIndexData *data);
+        void classify();
+        void clear();
     } persistent;
 
     static const QHash<int,QByteArray> &defaultRoleNames();
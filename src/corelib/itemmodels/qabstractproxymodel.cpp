@@ -153,6 +153,39 @@ QAbstractItemModel *QAbstractProxyModel::sourceModel() const
     return d->model;
 }
 
+/*!
+    \property QAbstractProxyModel::rangeDataForwardingEnabled
+    \since 6.0
+    \brief whether rangeData() requests are forwarded to the source model
+
+    Proxy models that support it, such as QSortFilterProxyModel and
+    QIdentityProxyModel, can answer rangeData() by passing the request on
+    to the source model with as few calls as possible. This bypasses
+    data(), so it is only correct if the proxy model presents the data of
+    the source model unchanged.
+
+    When this property is \c false, rangeData() calls data() for every
+    item, so that subclasses that reimplement data() keep working.
+
+    The default value is \c false.
+
+    \sa QAbstractItemModel::rangeData()
+*/
+bool QAbstractProxyModel::isRangeDataForwardingEnabled() const
+{
+    Q_D(const QAbstractProxyModel);
+    return d->rangeDataForwardingEnabled;
+}
+
+void QAbstractProxyModel::setRangeDataForwardingEnabled(bool enable)
+{
+    Q_D(QAbstractProxyModel);
+    if (d->rangeDataForwardingEnabled == enable)
+        return;
+    d->rangeDataForwardingEnabled = enable;
+    emit rangeDataForwardingEnabledChanged(enable);
+}
+
 /*!
     \reimp
  */
@@ -53,6 +53,7 @@ class Q_CORE_EXPORT QAbstractProxyModel : public QAbstractItemModel
 {
     Q_OBJECT
     Q_PROPERTY(QAbstractItemModel* sourceModel READ sourceModel WRITE setSourceModel NOTIFY sourceModelChanged)
+    Q_PROPERTY(bool rangeDataForwardingEnabled READ isRangeDataForwardingEnabled WRITE setRangeDataForwardingEnabled NOTIFY rangeDataForwardingEnabledChanged)
 
 public:
     explicit QAbstractProxyModel(QObject *parent = nullptr);
@@ -61,6 +62,9 @@ public:
     virtual void setSourceModel(QAbstractItemModel *sourceModel);
     QAbstractItemModel *sourceModel() const;
 
+    bool isRangeDataForwardingEnabled() const;
+    void setRangeDataForwardingEnabled(bool enable);
+
     Q_INVOKABLE virtual QModelIndex mapToSource(const QModelIndex &proxyIndex) const = 0;
     Q_INVOKABLE virtual QModelIndex mapFromSource(const QModelIndex &sourceIndex) const = 0;
 
@@ -100,6 +104,7 @@ public:
 
 Q_SIGNALS:
     void sourceModelChanged(QPrivateSignal);
+    void rangeDataForwardingEnabledChanged(bool rangeDataForwardingEnabled);
 
 protected:
     QAbstractProxyModel(QAbstractProxyModelPrivate &, QObject *parent);
@@ -62,8 +62,10 @@ class Q_CORE_EXPORT QAbstractProxyModelPrivate : public QAbstractItemModelPrivat
 {
     Q_DECLARE_PUBLIC(QAbstractProxyModel)
 public:
-    QAbstractProxyModelPrivate() : QAbstractItemModelPrivate(), model(nullptr) {}
+    QAbstractProxyModelPrivate()
+        : QAbstractItemModelPrivate(), model(nullptr), rangeDataForwardingEnabled(false) {}
     QAbstractItemModel *model;
+    bool rangeDataForwardingEnabled;
     virtual void _q_sourceModelDestroyed();
     void mapDropCoordinatesToSource(int row, int column, const QModelIndex &parent,
                                     int *source_row, int *source_column, QModelIndex *source_parent) const;
@@ -87,6 +87,8 @@ public:
     // for columns{AboutToBe,}{Inserted,Removed}
     int m_newColumnCount;
 
+    bool m_rangeDataForwardingEnabled;
+
     // for layoutAboutToBeChanged/layoutChanged
     QList<QPersistentModelIndex> layoutChangePersistentIndexes;
     QList<QModelIndex> layoutChangeProxyIndexes;
@@ -95,7 +97,8 @@ public:
 QConcatenateTablesProxyModelPrivate::QConcatenateTablesProxyModelPrivate()
     : m_rowCount(0),
       m_columnCount(0),
-      m_newColumnCount(0)
+      m_newColumnCount(0),
+      m_rangeDataForwardingEnabled(false)
 {
 }
 
@@ -195,6 +198,48 @@ QVariant QConcatenateTablesProxyModel::data(const QModelIndex &index, int role)
     return sourceIndex.data(role);
 }
 
+/*!
+  \reimp
+  \since 6.0
+
+  If rangeDataForwardingEnabled is \c true, forwards the request to the
+  source models, with one call for each source model that contains rows
+  of the range. Otherwise, calls data() for every item.
+*/
+void QConcatenateTablesProxyModel::rangeData(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                             QModelRoleDataSpan roleDataSpan) const
+{
+    Q_D(const QConcatenateTablesProxyModel);
+    Q_ASSERT(checkIndex(topLeft, CheckIndexOption::IndexIsValid));
+    Q_ASSERT(checkIndex(bottomRight, CheckIndexOption::IndexIsValid));
+    if (!d->m_rangeDataForwardingEnabled) {
+        QAbstractItemModel::rangeData(topLeft, bottomRight, roleDataSpan);
+        return;
+    }
+    const qsizetype rolesPerRow = QAbstractItemModelPrivate::rolesPerItem(topLeft, bottomRight, roleDataSpan)
+                                  * (bottomRight.column() - topLeft.column() + 1);
+    QModelRoleData *roleData = roleDataSpan.data();
+    int row = topLeft.row();
+    int rowsPrior = 0;
+    for (QAbstractItemModel *model : d->m_models) {
+        if (row > bottomRight.row())
+            break;
+        const int rowCount = model->rowCount();
+        const int first = row - rowsPrior;
+        const int last = qMin(bottomRight.row() - rowsPrior, rowCount - 1);
+        rowsPrior += rowCount;
+        if (first >= rowCount)
+            continue;
+        const qsizetype size = rolesPerRow * (last - first + 1);
+        model->rangeData(model->index(first, topLeft.column()),
+                         model->index(last, bottomRight.column()),
+                         QModelRoleDataSpan(roleData, size));
+        roleData += size;
+        row += last - first + 1;
+    }
+    Q_ASSERT(roleData == roleDataSpan.end());
+}
+
 /*!
   \reimp
 */
@@ -458,6 +503,35 @@ QList<QAbstractItemModel *> QConcatenateTablesProxyModel::sourceModels() const
     return d->m_models.toList();
 }
 
+/*!
+    \property QConcatenateTablesProxyModel::rangeDataForwardingEnabled
+    \since 6.0
+    \brief whether rangeData() requests are forwarded to the source models
+
+    Forwarding the request to the source models bypasses data(), so it is
+    only correct if data() is not reimplemented to change the data of the
+    source models. When this property is \c false, rangeData() calls
+    data() for every item.
+
+    The default value is \c false.
+
+    \sa QAbstractItemModel::rangeData()
+*/
+bool QConcatenateTablesProxyModel::isRangeDataForwardingEnabled() const
+{
+    Q_D(const QConcatenateTablesProxyModel);
+    return d->m_rangeDataForwardingEnabled;
+}
+
+void QConcatenateTablesProxyModel::setRangeDataForwardingEnabled(bool enable)
+{
+    Q_D(QConcatenateTablesProxyModel);
+    if (d->m_rangeDataForwardingEnabled == enable)
+        return;
+    d->m_rangeDataForwardingEnabled = enable;
+    emit rangeDataForwardingEnabledChanged(enable);
+}
+
 /*!
     Adds a source model \a sourceModel, below all previously added source models.
 
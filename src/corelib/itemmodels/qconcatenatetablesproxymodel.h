@@ -51,6 +51,7 @@ class QConcatenateTablesProxyModelPrivate;
 class Q_CORE_EXPORT QConcatenateTablesProxyModel : public QAbstractItemModel
 {
     Q_OBJECT
+    Q_PROPERTY(bool rangeDataForwardingEnabled READ isRangeDataForwardingEnabled WRITE setRangeDataForwardingEnabled NOTIFY rangeDataForwardingEnabledChanged)
 
 public:
     explicit QConcatenateTablesProxyModel(QObject *parent = nullptr);
@@ -63,7 +64,12 @@ public:
     QModelIndex mapFromSource(const QModelIndex &sourceIndex) const;
     QModelIndex mapToSource(const QModelIndex &proxyIndex) const;
 
+    bool isRangeDataForwardingEnabled() const;
+    void setRangeDataForwardingEnabled(bool enable);
+
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    void rangeData(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                   QModelRoleDataSpan roleDataSpan) const override;
     bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
     QMap<int, QVariant> itemData(const QModelIndex &proxyIndex) const override;
     bool setItemData(const QModelIndex &index, const QMap<int, QVariant> &roles) override;
@@ -79,6 +85,9 @@ public:
     bool dropMimeData(const QMimeData *data, Qt::DropAction action, int row, int column, const QModelIndex &parent) override;
     QSize span(const QModelIndex &index) const override;
 
+Q_SIGNALS:
+    void rangeDataForwardingEnabledChanged(bool rangeDataForwardingEnabled);
+
 private:
     Q_DECLARE_PRIVATE(QConcatenateTablesProxyModel)
     Q_DISABLE_COPY(QConcatenateTablesProxyModel)
@@ -354,6 +354,27 @@ QVariant QIdentityProxyModel::headerData(int section, Qt::Orientation orientatio
     return d->model->headerData(section, orientation, role);
 }
 
+/*!
+    \reimp
+    \since 6.0
+
+    If \l{QAbstractProxyModel::}{rangeDataForwardingEnabled} is \c true,
+    forwards the request to the source model in a single call. Otherwise,
+    calls data() for every item.
+ */
+void QIdentityProxyModel::rangeData(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                    QModelRoleDataSpan roleDataSpan) const
+{
+    Q_D(const QIdentityProxyModel);
+    Q_ASSERT(checkIndex(topLeft, CheckIndexOption::IndexIsValid));
+    Q_ASSERT(checkIndex(bottomRight, CheckIndexOption::IndexIsValid));
+    if (!d->rangeDataForwardingEnabled) {
+        QAbstractItemModel::rangeData(topLeft, bottomRight, roleDataSpan);
+        return;
+    }
+    d->model->rangeData(mapToSource(topLeft), mapToSource(bottomRight), roleDataSpan);
+}
+
 /*!
     \reimp
  */
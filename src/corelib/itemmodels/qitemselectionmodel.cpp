@@ -44,6 +44,8 @@
 
 #include <algorithm>
 #include <functional>
+#include <limits>
+#include <vector>
 
 QT_BEGIN_NAMESPACE
 
@@ -465,62 +467,305 @@ static QList<QPair<QPersistentModelIndex, uint>> qSelectionPersistentRowLengths(
 }
 
 /*!
-    Merges the \a other selection with this QItemSelection using the
-    \a command given. This method guarantees that no ranges are overlapping.
+    \internal
 
-    Note that only QItemSelectionModel::Select,
-    QItemSelectionModel::Deselect, and QItemSelectionModel::Toggle are
-    supported.
+    Rebuilds the lookup from the valid ranges in \a selection.
+*/
+void QItemSelectionLookup::build(const QItemSelection &selection)
+{
+    spans.clear();
+    for (qsizetype i = 0; i < selection.count(); ++i) {
+        const QItemSelectionRange &range = selection.at(i);
+        if (!range.isValid())
+            continue;
+        spans[range.parent()].append({ range.top(), range.bottom(), range.left(), range.right(),
+                                       range.bottom(), i });
+    }
+    for (QList<Span> &list : spans) {
+        std::sort(list.begin(), list.end(),
+                  [](const Span &lhs, const Span &rhs) { return lhs.top < rhs.top; });
+        int maxBottom = -1;
+        for (Span &span : list) {
+            maxBottom = qMax(maxBottom, span.bottom);
+            span.maxBottom = maxBottom;
+        }
+    }
+}
 
-    \sa split()
+/*!
+    \internal
+
+    Returns \c true if any range in the lookup contains the item at \a row
+    and \a column under \a parent.
 */
-void QItemSelection::merge(const QItemSelection &other, QItemSelectionModel::SelectionFlags command)
+bool QItemSelectionLookup::contains(int row, int column, const QModelIndex &parent) const
+{
+    const auto it = spans.constFind(parent);
+    if (it == spans.constEnd())
+        return false;
+    const QList<Span> &list = *it;
+    auto span = std::upper_bound(list.cbegin(), list.cend(), row,
+                                 [](int row, const Span &s) { return row < s.top; });
+    while (span != list.cbegin()) {
+        --span;
+        if (span->maxBottom < row)
+            return false;
+        if (span->bottom >= row && span->left <= column && span->right >= column)
+            return true;
+    }
+    return false;
+}
+
+/*!
+    \internal
+
+    Removes everything covered by \a range from the ranges in \a pieces.
+*/
+static void subtractRange(QItemSelection *pieces, const QItemSelectionRange &range)
+{
+    for (qsizetype i = 0; i < pieces->count();) {
+        if (pieces->at(i).intersects(range)) {
+            const QItemSelectionRange piece = pieces->takeAt(i);
+            QItemSelection::split(piece, range, pieces);
+        } else {
+            ++i;
+        }
+    }
+}
+
+namespace {
+// One side of a selection range, without its parent: the row or column the
+// side lies on and the span it covers in the other direction.
+struct RangeEdge {
+    int position;
+    int from;
+    int to;
+
+    friend bool operator==(const RangeEdge &lhs, const RangeEdge &rhs) noexcept
+    { return lhs.position == rhs.position && lhs.from == rhs.from && lhs.to == rhs.to; }
+    friend size_t qHash(const RangeEdge &key, size_t seed = 0) noexcept
+    { return qHashMulti(seed, key.position, key.from, key.to); }
+};
+} // unnamed namespace
+
+/*!
+    \internal
+
+    Combines the ranges of \a selection starting at \a first with any range
+    they share a full side with, so that repeatedly selecting and deselecting
+    items does not leave the selection more fragmented than necessary. Ranges
+    before \a first are only combined with the later ones, never with each
+    other.
+*/
+static void coalesceRanges(QItemSelection *selection, qsizetype first)
+{
+    const qsizetype count = selection->count();
+    if (first >= count || count < 2)
+        return;
+    selection->detach();
+
+    // The edges of the ranges from first on, and the area they lie in. Ranges
+    // outside of that area cannot be next to any of them and are skipped
+    // without a lookup. Candidates found through the edges are checked for a
+    // matching model and parent before they are combined.
+    QMultiHash<RangeEdge, qsizetype> tops, bottoms, lefts, rights;
+    int areaTop = std::numeric_limits<int>::max();
+    int areaLeft = std::numeric_limits<int>::max();
+    int areaBottom = std::numeric_limits<int>::min();
+    int areaRight = std::numeric_limits<int>::min();
+    auto addEdges = [&](qsizetype i) {
+        const QItemSelectionRange &range = selection->at(i);
+        tops.insert({ range.top(), range.left(), range.right() }, i);
+        bottoms.insert({ range.bottom(), range.left(), range.right() }, i);
+        lefts.insert({ range.left(), range.top(), range.bottom() }, i);
+        rights.insert({ range.right(), range.top(), range.bottom() }, i);
+        areaTop = qMin(areaTop, range.top());
+        areaLeft = qMin(areaLeft, range.left());
+        areaBottom = qMax(areaBottom, range.bottom());
+        areaRight = qMax(areaRight, range.right());
+    };
+    auto removeEdges = [&](qsizetype i) {
+        const QItemSelectionRange &range = selection->at(i);
+        tops.remove({ range.top(), range.left(), range.right() }, i);
+        bottoms.remove({ range.bottom(), range.left(), range.right() }, i);
+        lefts.remove({ range.left(), range.top(), range.bottom() }, i);
+        rights.remove({ range.right(), range.top(), range.bottom() }, i);
+    };
+    for (qsizetype i = first; i < count; ++i)
+        addEdges(i);
+
+    std::vector<bool> removed(count, false);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (qsizetype i = 0; i < count; ++i) {
+            if (removed[i])
+                continue;
+            const QItemSelectionRange &range = selection->at(i);
+            const int top = range.top();
+            const int bottom = range.bottom();
+            if (bottom < areaTop - 1 || top > areaBottom + 1)
+                continue;
+            const int left = range.left();
+            const int right = range.right();
+            if (right < areaLeft - 1 || left > areaRight + 1)
+                continue;
+            auto combine = [&](const QMultiHash<RangeEdge, qsizetype> &edges, const RangeEdge &edge,
+                               bool rangeFirst) {
+                for (auto it = edges.constFind(edge); it != edges.cend() && it.key() == edge; ++it) {
+                    const qsizetype other = it.value();
+                    if (other == i || removed[other])
+                        continue;
+                    const QItemSelectionRange &neighbor = selection->at(other);
+                    if (neighbor.model() != range.model() || neighbor.parent() != range.parent()
+                        || !range.isValid()) {
+                        continue;
+                    }
+                    const QItemSelectionRange combined = rangeFirst
+                            ? QItemSelectionRange(range.topLeft(), neighbor.bottomRight())
+                            : QItemSelectionRange(neighbor.topLeft(), range.bottomRight());
+                    removeEdges(other);
+                    if (i >= first)
+                        removeEdges(i);
+                    removed[i] = true;
+                    (*selection)[other] = combined;
+                    addEdges(other);
+                    return true;
+                }
+                return false;
+            };
+            changed |= combine(tops, { bottom + 1, left, right }, true)
+                    || combine(bottoms, { top - 1, left, right }, false)
+                    || combine(lefts, { right + 1, top, bottom }, true)
+                    || combine(rights, { left - 1, top, bottom }, false);
+        }
+    }
+
+    qsizetype i = 0;
+    selection->erase(std::remove_if(selection->begin(), selection->end(),
+                                    [&](const QItemSelectionRange &) { return removed[i++]; }),
+                     selection->end());
+}
+
+/*!
+    \internal
+
+    Implements QItemSelection::merge() for \a selection. Returns the number of
+    ranges at the start of \a selection that were left as they were; the
+    ranges after them are new or split from old ones.
+*/
+static qsizetype mergeSelection(QItemSelection *selection, const QItemSelection &other,
+                                QItemSelectionModel::SelectionFlags command)
 {
     if (other.isEmpty() ||
           !(command & QItemSelectionModel::Select ||
           command & QItemSelectionModel::Deselect ||
           command & QItemSelectionModel::Toggle))
-        return;
+        return selection->count();
 
     QItemSelection newSelection = other;
-    // Collect intersections
-    QItemSelection intersections;
-    QItemSelection::iterator it = newSelection.begin();
-    while (it != newSelection.end()) {
-        if (!(*it).isValid()) {
-            it = newSelection.erase(it);
-            continue;
+    newSelection.erase(std::remove_if(newSelection.begin(), newSelection.end(),
+                                      [](const QItemSelectionRange &range) { return !range.isValid(); }),
+                       newSelection.end());
+
+    // Collect the intersecting pairs of (old range, new range). Large
+    // selections are looked up instead of comparing every range with every
+    // other one.
+    QList<std::pair<qsizetype, qsizetype>> intersections;
+    if (selection->count() > 16 && newSelection.count() > 16) {
+        QItemSelectionLookup lookup;
+        lookup.build(*selection);
+        for (qsizetype n = 0; n < newSelection.count(); ++n) {
+            const QItemSelectionRange &range = newSelection.at(n);
+            lookup.forEachIntersecting(range.parent(), range.top(), range.left(),
+                                       range.bottom(), range.right(), [&](qsizetype t) {
+                if (selection->at(t).intersects(range))
+                    intersections.append({ t, n });
+            });
         }
-        for (int t = 0; t < count(); ++t) {
-            if ((*it).intersects(at(t)))
-                intersections.append(at(t).intersected(*it));
+    } else {
+        for (qsizetype n = 0; n < newSelection.count(); ++n) {
+            const QItemSelectionRange &range = newSelection.at(n);
+            const int top = range.top();
+            const int bottom = range.bottom();
+            for (qsizetype t = 0; t < selection->count(); ++t) {
+                const QItemSelectionRange &old = selection->at(t);
+                if (old.top() <= bottom && old.bottom() >= top && range.intersects(old))
+                    intersections.append({ t, n });
+            }
         }
-        ++it;
     }
 
-    //  Split the old (and new) ranges using the intersections
-    for (int i = 0; i < intersections.count(); ++i) { // for each intersection
-        for (int t = 0; t < count();) { // splitt each old range
-            if (at(t).intersects(intersections.at(i))) {
-                split(at(t), intersections.at(i), this);
-                removeAt(t);
-            } else {
-                ++t;
-            }
+    qsizetype untouched = selection->count();
+    if (!intersections.isEmpty()) {
+        // Split the old ranges, keeping those that are not affected in place
+        std::stable_sort(intersections.begin(), intersections.end(),
+                         [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+        QItemSelection pieces;
+        QList<qsizetype> affected;
+        for (qsizetype next = 0; next < intersections.count();) {
+            const qsizetype t = intersections.at(next).first;
+            QItemSelection remaining;
+            remaining.append(selection->at(t));
+            for (; next < intersections.count() && intersections.at(next).first == t; ++next)
+                subtractRange(&remaining, newSelection.at(intersections.at(next).second));
+            pieces += remaining;
+            affected.append(t);
         }
+
         // only split newSelection if Toggle is specified
-        for (int n = 0; (command & QItemSelectionModel::Toggle) && n < newSelection.count();) {
-            if (newSelection.at(n).intersects(intersections.at(i))) {
-                split(newSelection.at(n), intersections.at(i), &newSelection);
-                newSelection.removeAt(n);
-            } else {
-                ++n;
+        if (command & QItemSelectionModel::Toggle) {
+            std::stable_sort(intersections.begin(), intersections.end(),
+                             [](const auto &lhs, const auto &rhs) { return lhs.second < rhs.second; });
+            QItemSelection toggled;
+            qsizetype next = 0;
+            for (qsizetype n = 0; n < newSelection.count(); ++n) {
+                QItemSelection remaining;
+                remaining.append(newSelection.at(n));
+                for (; next < intersections.count() && intersections.at(next).second == n; ++next)
+                    subtractRange(&remaining, selection->at(intersections.at(next).first));
+                toggled += remaining;
             }
+            newSelection = toggled;
         }
+
+        // removing a few ranges one by one only moves memory around, which
+        // is cheaper than moving every range after the first one
+        if (affected.count() < 32) {
+            for (auto t = affected.crbegin(); t != affected.crend(); ++t)
+                selection->removeAt(*t);
+        } else {
+            std::vector<bool> remove(selection->count(), false);
+            for (qsizetype t : qAsConst(affected))
+                remove[t] = true;
+            qsizetype t = 0;
+            selection->erase(std::remove_if(selection->begin(), selection->end(),
+                                            [&](const QItemSelectionRange &) { return remove[t++]; }),
+                             selection->end());
+        }
+        untouched = selection->count();
+        *selection += pieces;
     }
+
     // do not add newSelection for Deselect
     if (!(command & QItemSelectionModel::Deselect))
-        operator+=(newSelection);
+        *selection += newSelection;
+    return untouched;
+}
+
+/*!
+    Merges the \a other selection with this QItemSelection using the
+    \a command given. This method guarantees that no ranges are overlapping.
+
+    Note that only QItemSelectionModel::Select,
+    QItemSelectionModel::Deselect, and QItemSelectionModel::Toggle are
+    supported.
+
+    \sa split()
+*/
+void QItemSelection::merge(const QItemSelection &other, QItemSelectionModel::SelectionFlags command)
+{
+    mergeSelection(this, other, command);
 }
 
 /*!
@@ -573,6 +818,20 @@ void QItemSelection::split(const QItemSelectionRange &range,
     }
 }
 
+/*!
+    \internal
+
+    Merges the current selection into the committed ranges. Ranges that end
+    up next to each other are combined, so that the committed selection does
+    not get more fragmented than necessary by repeated toggling.
+*/
+void QItemSelectionModelPrivate::finalize()
+{
+    lookupDirty = true;
+    coalesceRanges(&ranges, mergeSelection(&ranges, currentSelection, currentCommand));
+    if (!currentSelection.isEmpty())  // ### perhaps this should be in QList
+        currentSelection.clear();
+}
 
 void QItemSelectionModelPrivate::initModel(QAbstractItemModel *m)
 {
@@ -601,6 +860,14 @@ void QItemSelectionModelPrivate::initModel(QAbstractItemModel *m)
           SLOT(_q_layoutAboutToBeChanged(QList<QPersistentModelIndex>,QAbstractItemModel::LayoutChangeHint)) },
         { SIGNAL(layoutChanged(QList<QPersistentModelIndex>,QAbstractItemModel::LayoutChangeHint)),
           SLOT(_q_layoutChanged(QList<QPersistentModelIndex>,QAbstractItemModel::LayoutChangeHint)) },
+        { SIGNAL(rowsInserted(QModelIndex,int,int)),
+          SLOT(_q_structureChanged()) },
+        { SIGNAL(rowsRemoved(QModelIndex,int,int)),
+          SLOT(_q_structureChanged()) },
+        { SIGNAL(columnsInserted(QModelIndex,int,int)),
+          SLOT(_q_structureChanged()) },
+        { SIGNAL(columnsRemoved(QModelIndex,int,int)),
+          SLOT(_q_structureChanged()) },
         { SIGNAL(modelReset()),
           SLOT(reset()) },
         { nullptr, nullptr }
@@ -616,6 +883,7 @@ void QItemSelectionModelPrivate::initModel(QAbstractItemModel *m)
         q->reset();
     }
     model = m;
+    lookupDirty = true;
     if (model) {
         for (const Cx *cx = &connections[0]; cx->signal; cx++)
             QObject::connect(model, cx->signal, q, cx->slot);
@@ -727,6 +995,7 @@ void QItemSelectionModelPrivate::_q_rowsAboutToBeRemoved(const QModelIndex &pare
             ++it;
     }
     ranges.append(newParts);
+    lookupDirty = true;
 
     if (!deselected.isEmpty())
         emit q->selectionChanged(QItemSelection(), deselected);
@@ -790,6 +1059,7 @@ void QItemSelectionModelPrivate::_q_columnsAboutToBeInserted(const QModelIndex &
         }
     }
     ranges += split;
+    lookupDirty = true;
 }
 
 /*!
@@ -819,6 +1089,7 @@ void QItemSelectionModelPrivate::_q_rowsAboutToBeInserted(const QModelIndex &par
         }
     }
     ranges += split;
+    lookupDirty = true;
 }
 
 /*!
@@ -995,6 +1266,8 @@ static bool qt_PersistentModelIndexLessThan(const QPersistentModelIndex &i1, con
 */
 void QItemSelectionModelPrivate::_q_layoutChanged(const QList<QPersistentModelIndex> &, QAbstractItemModel::LayoutChangeHint hint)
 {
+    lookupDirty = true;
+
     // special case for when all indexes are selected
     if (tableSelected && tableColCount == model->columnCount(tableParent)
         && tableRowCount == model->rowCount(tableParent)) {
@@ -1279,6 +1552,8 @@ void QItemSelectionModel::select(const QItemSelection &selection, QItemSelection
         d->currentSelection = sel;
     }
 
+    d->lookupDirty = true;
+
     // generate new selection, compare with old and emit selectionChanged()
     QItemSelection newSelection = d->ranges;
     newSelection.merge(d->currentSelection, d->currentCommand);
@@ -1376,6 +1651,22 @@ QModelIndex QItemSelectionModel::currentIndex() const
     return static_cast<QModelIndex>(d_func()->currentIndex);
 }
 
+/*!
+    \internal
+
+    Returns \c true if \a index lies within one of the committed selection
+    ranges. The lookup used for this is rebuilt on first use after the ranges
+    or the structure of the model changed.
+*/
+bool QItemSelectionModelPrivate::rangesContain(const QModelIndex &index) const
+{
+    if (lookupDirty) {
+        lookup.build(ranges);
+        lookupDirty = false;
+    }
+    return lookup.contains(index.row(), index.column(), index.parent());
+}
+
 /*!
     Returns \c true if the given model item \a index is selected.
 */
@@ -1385,15 +1676,8 @@ bool QItemSelectionModel::isSelected(const QModelIndex &index) const
     if (d->model != index.model() || !index.isValid())
         return false;
 
-    bool selected = false;
     //  search model ranges
-    QList<QItemSelectionRange>::const_iterator it = d->ranges.begin();
-    for (; it != d->ranges.end(); ++it) {
-        if ((*it).isValid() && (*it).contains(index)) {
-            selected = true;
-            break;
-        }
-    }
+    bool selected = d->rangesContain(index);
 
     // check  currentSelection
     if (d->currentSelection.count()) {
@@ -1827,6 +2111,76 @@ void QItemSelectionModel::setModel(QAbstractItemModel *model)
     emit modelChanged(model);
 }
 
+/*!
+    \internal
+
+    Removes the ranges that are in both \a first and \a second from both.
+*/
+static void removeCommonRanges(QItemSelection *first, QItemSelection *second)
+{
+    // The ranges the two have in common usually come in the same order, with
+    // only a few others in between. Walk both in step and only look up the
+    // ranges that do not line up.
+    QItemSelection firstLeft;
+    QItemSelection secondLeft;
+    qsizetype i = 0;
+    qsizetype j = 0;
+    while (i < first->count() && j < second->count()) {
+        if (first->at(i) == second->at(j)) {
+            ++i;
+            ++j;
+        } else if (i + 1 < first->count() && first->at(i + 1) == second->at(j)) {
+            firstLeft.append(first->at(i++));
+        } else if (j + 1 < second->count() && first->at(i) == second->at(j + 1)) {
+            secondLeft.append(second->at(j++));
+        } else {
+            firstLeft.append(first->at(i++));
+            secondLeft.append(second->at(j++));
+        }
+    }
+    firstLeft += first->mid(i);
+    secondLeft += second->mid(j);
+
+    if (!firstLeft.isEmpty() && !secondLeft.isEmpty()) {
+        // map each range in secondLeft to its first position, and each
+        // position to the next one holding an equal range
+        using RangeKey = std::pair<QModelIndex, QModelIndex>;
+        QHash<RangeKey, qsizetype> firstPosition;
+        firstPosition.reserve(secondLeft.count());
+        std::vector<qsizetype> nextPosition(secondLeft.count());
+        for (qsizetype s = secondLeft.count() - 1; s >= 0; --s) {
+            const RangeKey key(secondLeft.at(s).topLeft(), secondLeft.at(s).bottomRight());
+            const auto it = firstPosition.find(key);
+            if (it == firstPosition.end()) {
+                nextPosition[s] = -1;
+                firstPosition.insert(key, s);
+            } else {
+                nextPosition[s] = it.value();
+                it.value() = s;
+            }
+        }
+        std::vector<bool> common(secondLeft.count(), false);
+        const auto isCommon = [&](const QItemSelectionRange &range) {
+            const auto it = firstPosition.find({ range.topLeft(), range.bottomRight() });
+            if (it == firstPosition.end() || it.value() < 0 || secondLeft.at(it.value()) != range)
+                return false;
+            const qsizetype s = it.value();
+            common[s] = true;
+            it.value() = nextPosition[s];
+            return true;
+        };
+        firstLeft.erase(std::remove_if(firstLeft.begin(), firstLeft.end(), isCommon),
+                        firstLeft.end());
+        qsizetype s = 0;
+        secondLeft.erase(std::remove_if(secondLeft.begin(), secondLeft.end(),
+                                        [&](const QItemSelectionRange &) { return common[s++]; }),
+                         secondLeft.end());
+    }
+
+    first->swap(firstLeft);
+    second->swap(secondLeft);
+}
+
 /*!
     Compares the two selections \a newSelection and \a oldSelection
     and emits selectionChanged() with the deselected and selected items.
@@ -1849,21 +2203,7 @@ void QItemSelectionModel::emitSelectionChanged(const QItemSelection &newSelectio
     QItemSelection selected = newSelection;
 
     // remove equal ranges
-    bool advance;
-    for (int o = 0; o < deselected.count(); ++o) {
-        advance = true;
-        for (int s = 0; s < selected.count() && o < deselected.count();) {
-            if (deselected.at(o) == selected.at(s)) {
-                deselected.removeAt(o);
-                selected.removeAt(s);
-                advance = false;
-            } else {
-                ++s;
-            }
-        }
-        if (advance)
-            ++o;
-    }
+    removeCommonRanges(&deselected, &selected);
 
     // find intersections
     QItemSelection intersections;
@@ -53,10 +53,60 @@
 
 #include "private/qobject_p.h"
 
+#include <algorithm>
+
 QT_REQUIRE_CONFIG(itemmodel);
 
 QT_BEGIN_NAMESPACE
 
+// Answers point and overlap queries against the ranges of a QItemSelection
+// without looking at every range. The ranges are grouped by parent and sorted
+// by their top row; each span also remembers the largest bottom row of all
+// spans up to and including itself, so a query walks back from the last span
+// starting at or above the row and stops as soon as that bound falls short.
+// The row and column numbers are copied, so the lookup has to be rebuilt
+// whenever the selection or the structure of the model changes.
+class QItemSelectionLookup
+{
+public:
+    void build(const QItemSelection &selection);
+    void clear() { spans.clear(); }
+
+    bool contains(int row, int column, const QModelIndex &parent) const;
+
+    // Calls visit(position) for every range in the selection that overlaps
+    // the given rectangle under parent.
+    template <typename Visitor>
+    void forEachIntersecting(const QModelIndex &parent, int top, int left,
+                             int bottom, int right, Visitor visit) const
+    {
+        const auto it = spans.constFind(parent);
+        if (it == spans.constEnd())
+            return;
+        const QList<Span> &list = *it;
+        auto span = std::upper_bound(list.cbegin(), list.cend(), bottom,
+                                     [](int row, const Span &s) { return row < s.top; });
+        while (span != list.cbegin()) {
+            --span;
+            if (span->maxBottom < top)
+                break;
+            if (span->bottom >= top && span->left <= right && span->right >= left)
+                visit(span->position);
+        }
+    }
+
+private:
+    struct Span {
+        int top;
+        int bottom;
+        int left;
+        int right;
+        int maxBottom;
+        qsizetype position;
+    };
+    QHash<QModelIndex, QList<Span>> spans;
+};
+
 class QItemSelectionModelPrivate: public QObjectPrivate
 {
     Q_DECLARE_PUBLIC(QItemSelectionModel)
@@ -77,20 +127,19 @@ public:
     void _q_columnsAboutToBeInserted(const QModelIndex &parent, int start, int end);
     void _q_layoutAboutToBeChanged(const QList<QPersistentModelIndex> &parents = QList<QPersistentModelIndex>(), QAbstractItemModel::LayoutChangeHint hint = QAbstractItemModel::NoLayoutChangeHint);
     void _q_layoutChanged(const QList<QPersistentModelIndex> &parents = QList<QPersistentModelIndex>(), QAbstractItemModel::LayoutChangeHint hint = QAbstractItemModel::NoLayoutChangeHint);
+    void _q_structureChanged() { lookupDirty = true; }
+
+    bool rangesContain(const QModelIndex &index) const;
 
     inline void remove(QList<QItemSelectionRange> &r)
     {
         QList<QItemSelectionRange>::const_iterator it = r.constBegin();
         for (; it != r.constEnd(); ++it)
             ranges.removeAll(*it);
+        lookupDirty = true;
     }
 
-    inline void finalize()
-    {
-        ranges.merge(currentSelection, currentCommand);
-        if (!currentSelection.isEmpty())  // ### perhaps this should be in QList
-            currentSelection.clear();
-    }
+    void finalize();
 
     QPointer<QAbstractItemModel> model;
     QItemSelection ranges;
@@ -105,6 +154,9 @@ public:
     bool tableSelected;
     QPersistentModelIndex tableParent;
     int tableColCount, tableRowCount;
+    // isSelected() lookup into ranges, rebuilt on demand
+    mutable QItemSelectionLookup lookup;
+    mutable bool lookupDirty = true;
 };
 
 QT_END_NAMESPACE
@@ -42,12 +42,23 @@
 #include <qsize.h>
 #include <qdebug.h>
 #include <qdatetime.h>
+#include <qelapsedtimer.h>
 #include <qpair.h>
 #include <qstringlist.h>
+#include <qtimer.h>
+#include <qvarlengtharray.h>
 #include <private/qabstractitemmodel_p.h>
 #include <private/qabstractproxymodel_p.h>
+#if QT_CONFIG(icu)
+#include <qcollator.h>
+#endif
+#if QT_CONFIG(thread)
+#include <qsemaphore.h>
+#include <qthreadpool.h>
+#endif
 
 #include <algorithm>
+#include <numeric>
 
 QT_BEGIN_NAMESPACE
 
@@ -180,8 +191,21 @@ public:
     bool accept_children;
     bool complete_insert;
     bool dynamic_sortfilter;
+    bool sort_key_caching;
+    bool concurrent_sortfilter;
     QRowsRemoval itemsBeingRemoved;
 
+    // source rows whose filtering was deferred by a filter change while
+    // filter_time_slice is set
+    struct PendingFilter {
+        QModelIndex source_parent;
+        QList<int> source_rows;
+        int next;
+    };
+    QList<PendingFilter> pending_filters;
+    int filter_time_slice;
+    bool pending_filters_scheduled;
+
     QModelIndexPairList saved_persistent_indexes;
     QList<QPersistentModelIndex> saved_layoutChange_parents;
 
@@ -260,6 +284,20 @@ public:
     int find_source_sort_column() const;
     void sort_source_rows(QList<int> &source_rows,
                           const QModelIndex &source_parent) const;
+    void sort_source_rows_by_key(QList<int> &source_rows,
+                                 const QModelIndex &source_parent) const;
+    template <typename T>
+    void sort_by_typed_key(int *first, int *last, const QList<QVariant> &keys) const;
+    template <typename Less>
+    void sort_indexes(int *first, int *last, Less less) const;
+    template <typename Compare>
+    void stable_sort(int *first, int *last, Compare less) const;
+    int concurrent_task_count(int item_count) const;
+    template <typename Function>
+    void run_concurrently(int task_count, Function task) const;
+    template <typename Function>
+    void for_each_chunk(int item_count, Function function) const;
+    QList<bool> filter_source_rows(const QList<int> &source_rows, const QModelIndex &source_parent) const;
     QList<QPair<int, QList<int>>> proxy_intervals_for_source_items_to_add(
         const QList<int> &proxy_to_source, const QList<int> &source_items,
         const QModelIndex &source_parent, Qt::Orientation orient) const;
@@ -293,10 +331,20 @@ public:
     void update_persistent_indexes(const QModelIndexPairList &source_indexes);
 
     void filter_about_to_be_changed(const QModelIndex &source_parent = QModelIndex());
-    void filter_changed(Direction dir, const QModelIndex &source_parent = QModelIndex());
+    void filter_changed(Direction dir, const QModelIndex &source_parent = QModelIndex(),
+                        QSortFilterProxyModel::FilterChange change = QSortFilterProxyModel::FilterChange::Unspecified);
     QSet<int> handle_filter_changed(
         QList<int> &source_to_proxy, QList<int> &proxy_to_source,
-        const QModelIndex &source_parent, Qt::Orientation orient);
+        const QModelIndex &source_parent, Qt::Orientation orient,
+        QSortFilterProxyModel::FilterChange change);
+    QSet<int> refilter_source_items(
+        QList<int> &source_to_proxy, QList<int> &proxy_to_source,
+        const QList<int> &source_items, const QModelIndex &source_parent,
+        Qt::Orientation orient);
+    void queue_pending_filter(const QModelIndex &source_parent, QList<int> &&source_rows);
+    void process_pending_filters(int time_slice);
+    void schedule_pending_filters();
+    void flush_pending_filters();
 
     void updateChildrenMapping(const QModelIndex &source_parent, Mapping *parent_mapping,
                                Qt::Orientation orient, int start, int end, int delta_item_count, bool remove);
@@ -376,6 +424,93 @@ bool QSortFilterProxyModelPrivate::recursiveChildAcceptsRow(int source_row, cons
     return false;
 }
 
+/*!
+  \internal
+
+  Returns the number of tasks that \a item_count items are split into when
+  sorting or filtering them; 1 unless concurrent sorting and filtering is
+  enabled and there are enough items to make it worthwhile.
+*/
+int QSortFilterProxyModelPrivate::concurrent_task_count(int item_count) const
+{
+#if QT_CONFIG(thread)
+    // Below this, handing the work to another thread costs more than it saves
+    constexpr int MinimumChunkSize = 4096;
+    if (concurrent_sortfilter && item_count >= 2 * MinimumChunkSize) {
+        const int thread_count = QThreadPool::globalInstance()->maxThreadCount() + 1;
+        return qMin(thread_count, item_count / MinimumChunkSize);
+    }
+#else
+    Q_UNUSED(item_count);
+#endif
+    return 1;
+}
+
+/*!
+  \internal
+
+  Calls \a task for each task index in [0, \a task_count), spreading the calls
+  over the global thread pool, and returns once all of them have finished.
+  The calling thread runs the first task itself, and any task the pool has
+  no thread for.
+*/
+template <typename Function>
+void QSortFilterProxyModelPrivate::run_concurrently(int task_count, Function task) const
+{
+#if QT_CONFIG(thread)
+    if (task_count > 1) {
+        QSemaphore finished;
+        for (int i = 1; i < task_count; ++i) {
+            const auto run = [&task, &finished, i] {
+                task(i);
+                finished.release();
+            };
+            if (!QThreadPool::globalInstance()->tryStart(run))
+                run();
+        }
+        task(0);
+        finished.acquire(task_count - 1);
+        return;
+    }
+#endif
+    for (int i = 0; i < task_count; ++i)
+        task(i);
+}
+
+/*!
+  \internal
+
+  Splits [0, \a item_count) into consecutive chunks and calls \a function
+  with the begin and end of each, concurrently if that is enabled.
+*/
+template <typename Function>
+void QSortFilterProxyModelPrivate::for_each_chunk(int item_count, Function function) const
+{
+    const int chunk_count = concurrent_task_count(item_count);
+    run_concurrently(chunk_count, [&](int chunk) {
+        function(int(qint64(item_count) * chunk / chunk_count),
+                 int(qint64(item_count) * (chunk + 1) / chunk_count));
+    });
+}
+
+/*!
+  \internal
+
+  Returns whether each of the \a source_rows under \a source_parent is
+  accepted by the filter.
+*/
+QList<bool> QSortFilterProxyModelPrivate::filter_source_rows(
+    const QList<int> &source_rows, const QModelIndex &source_parent) const
+{
+    QList<bool> accepted(source_rows.size());
+    bool *accepted_data = accepted.data();
+    for_each_chunk(source_rows.size(), [&](int begin, int end) {
+        for (int i = begin; i < end; ++i)
+            accepted_data[i] = filterAcceptsRowInternal(source_rows.at(i), source_parent);
+    });
+    return accepted;
+}
+
 void QSortFilterProxyModelPrivate::remove_from_mapping(const QModelIndex &source_parent)
 {
     if (Mapping *m = source_index_mapping.take(source_parent)) {
@@ -392,6 +527,7 @@ void QSortFilterProxyModelPrivate::_q_clearMapping()
 
     qDeleteAll(source_index_mapping);
     source_index_mapping.clear();
+    pending_filters.clear();
     if (dynamic_sortfilter)
         source_sort_column = find_source_sort_column();
 
@@ -412,9 +548,19 @@ IndexMap::const_iterator QSortFilterProxyModelPrivate::create_mapping(
 
     int source_rows = model->rowCount(source_parent);
     m->source_rows.reserve(source_rows);
-    for (int i = 0; i < source_rows; ++i) {
-        if (filterAcceptsRowInternal(i, source_parent))
-            m->source_rows.append(i);
+    if (concurrent_sortfilter) {
+        QList<int> rows(source_rows);
+        std::iota(rows.begin(), rows.end(), 0);
+        const QList<bool> accepted = filter_source_rows(rows, source_parent);
+        for (int i = 0; i < source_rows; ++i) {
+            if (accepted.at(i))
+                m->source_rows.append(i);
+        }
+    } else {
+        for (int i = 0; i < source_rows; ++i) {
+            if (filterAcceptsRowInternal(i, source_parent))
+                m->source_rows.append(i);
+        }
     }
     int source_cols = model->columnCount(source_parent);
     m->source_columns.reserve(source_cols);
@@ -586,18 +732,242 @@ void QSortFilterProxyModelPrivate::sort_source_rows(
 {
     Q_Q(const QSortFilterProxyModel);
     if (source_sort_column >= 0) {
-        if (sort_order == Qt::AscendingOrder) {
+        int *first = source_rows.data();
+        int *last = first + source_rows.size();
+        if (sort_key_caching) {
+            sort_source_rows_by_key(source_rows, source_parent);
+        } else if (sort_order == Qt::AscendingOrder) {
             QSortFilterProxyModelLessThan lt(source_sort_column, source_parent, model, q);
-            std::stable_sort(source_rows.begin(), source_rows.end(), lt);
+            stable_sort(first, last, lt);
         } else {
             QSortFilterProxyModelGreaterThan gt(source_sort_column, source_parent, model, q);
-            std::stable_sort(source_rows.begin(), source_rows.end(), gt);
+            stable_sort(first, last, gt);
         }
     } else { // restore the source model order
         std::stable_sort(source_rows.begin(), source_rows.end());
     }
 }
 
+/*!
+  \internal
+
+  Stable-sorts [\a first, \a last) using \a less. When sorting concurrently,
+  consecutive chunks are sorted on the thread pool and then merged pairwise,
+  which gives the same order as sorting the whole range at once.
+*/
+template <typename Compare>
+void QSortFilterProxyModelPrivate::stable_sort(int *first, int *last, Compare less) const
+{
+    const int count = int(last - first);
+    const int chunk_count = concurrent_task_count(count);
+    if (chunk_count == 1) {
+        std::stable_sort(first, last, less);
+        return;
+    }
+
+    // chunk i is [bounds[i], bounds[i + 1])
+    QVarLengthArray<int, 64> bounds;
+    for (int chunk = 0; chunk <= chunk_count; ++chunk)
+        bounds.append(int(qint64(count) * chunk / chunk_count));
+
+    run_concurrently(chunk_count, [&](int chunk) {
+        std::stable_sort(first + bounds[chunk], first + bounds[chunk + 1], less);
+    });
+    for (int width = 1; width < chunk_count; width *= 2) {
+        const int merge_count = (chunk_count + width - 1) / (2 * width);
+        run_concurrently(merge_count, [&](int merge) {
+            const int left = 2 * width * merge;
+            const int middle = left + width;
+            const int right = qMin(middle + width, chunk_count);
+            std::inplace_merge(first + bounds[left], first + bounds[middle],
+                               first + bounds[right], less);
+        });
+    }
+}
+
+/*!
+  \internal
+
+  Stable-sorts the key indexes in [\a first, \a last) in the current sort
+  order, where \a less compares the keys at two indexes.
+*/
+template <typename Less>
+void QSortFilterProxyModelPrivate::sort_indexes(int *first, int *last, Less less) const
+{
+    if (sort_order == Qt::AscendingOrder)
+        stable_sort(first, last, less);
+    else
+        stable_sort(first, last, [less](int left, int right) { return less(right, left); });
+}
+
+template <typename T>
+void QSortFilterProxyModelPrivate::sort_by_typed_key(int *first, int *last,
+                                                     const QList<QVariant> &keys) const
+{
+    QList<T> typed_keys(keys.size());
+    T *typed_data = typed_keys.data();
+    for_each_chunk(keys.size(), [&](int begin, int end) {
+        for (int i = begin; i < end; ++i)
+            typed_data[i] = keys.at(i).value<T>();
+    });
+    sort_indexes(first, last, [typed_data](int left, int right) {
+        return typed_data[left] < typed_data[right];
+    });
+}
+
+static bool isTypedSortKey(int type)
+{
+    // the types QAbstractItemModelPrivate::isVariantLessThan() does not
+    // compare as strings
+    switch (type) {
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Float:
+    case QMetaType::Double:
+    case QMetaType::QChar:
+    case QMetaType::QDate:
+    case QMetaType::QTime:
+    case QMetaType::QDateTime:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*!
+  \internal
+
+  Sorts \a source_rows like sort_source_rows(), but fetches the sort role data
+  of each row only once and compares the cached keys the way the default
+  implementation of QSortFilterProxyModel::lessThan() compares them.
+*/
+void QSortFilterProxyModelPrivate::sort_source_rows_by_key(
+    QList<int> &source_rows, const QModelIndex &source_parent) const
+{
+    const QList<int> unsorted_rows = source_rows;
+    const int count = unsorted_rows.size();
+    QList<QVariant> keys(count);
+    QVariant *key_data = keys.data();
+    for_each_chunk(count, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            const QModelIndex index = model->index(unsorted_rows.at(i), source_sort_column, source_parent);
+            key_data[i] = model->data(index, sort_role);
+        }
+    });
+
+    int key_type = QMetaType::UnknownType;
+    bool same_type = true;
+    bool any_typed = false;
+    for (const QVariant &key : qAsConst(keys)) {
+        const int type = key.userType();
+        if (type == QMetaType::UnknownType)
+            continue;
+        any_typed = any_typed || isTypedSortKey(type);
+        if (key_type == QMetaType::UnknownType)
+            key_type = type;
+        else if (type != key_type)
+            same_type = false;
+    }
+
+    QList<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    int *first = order.data();
+    int *last = first + count;
+    if (any_typed && !same_type) {
+        // isVariantLessThan() does not order keys of different types
+        // consistently, so compare the keys exactly like lessThan() would
+        const QVariant *variant_data = keys.constData();
+        const Qt::CaseSensitivity cs = sort_casesensitivity;
+        const bool locale_aware = sort_localeaware;
+        sort_indexes(first, last, [variant_data, cs, locale_aware](int left, int right) {
+            return QAbstractItemModelPrivate::isVariantLessThan(variant_data[left], variant_data[right],
+                                                                cs, locale_aware);
+        });
+    } else {
+        // Rows without data compare greater than all others, so they go last in
+        // ascending and first in descending order; only the rest needs sorting.
+        if (sort_order == Qt::AscendingOrder)
+            last = std::stable_partition(first, last, [&keys](int i) { return keys.at(i).isValid(); });
+        else
+            first = std::stable_partition(first, last, [&keys](int i) { return !keys.at(i).isValid(); });
+
+        if (!any_typed) {
+            QList<QString> strings(count);
+            QString *string_data = strings.data();
+            for_each_chunk(count, [&](int begin, int end) {
+                for (int i = begin; i < end; ++i)
+                    string_data[i] = keys.at(i).toString();
+            });
+            if (!sort_localeaware) {
+                const Qt::CaseSensitivity cs = sort_casesensitivity;
+                sort_indexes(first, last, [string_data, cs](int left, int right) {
+                    return string_data[left].compare(string_data[right], cs) < 0;
+                });
+            } else {
+#if QT_CONFIG(icu)
+                // QString::localeAwareCompare() orders empty strings by code point
+                // rather than through the collator, so keep doing that here
+                const QCollator collator;
+                QList<QCollatorSortKey> collation_keys;
+                collation_keys.reserve(count);
+                for (const QString &string : qAsConst(strings))
+                    collation_keys.append(collator.sortKey(string));
+                const QCollatorSortKey *collation_data = collation_keys.constData();
+                sort_indexes(first, last, [string_data, collation_data](int left, int right) {
+                    if (string_data[left].isEmpty() || string_data[right].isEmpty())
+                        return string_data[left].isEmpty() && !string_data[right].isEmpty();
+                    return collation_data[left].compare(collation_data[right]) < 0;
+                });
+#else
+                sort_indexes(first, last, [string_data](int left, int right) {
+                    return string_data[left].localeAwareCompare(string_data[right]) < 0;
+                });
+#endif
+            }
+        } else {
+            switch (key_type) {
+            case QMetaType::Int:
+                sort_by_typed_key<int>(first, last, keys);
+                break;
+            case QMetaType::UInt:
+                sort_by_typed_key<uint>(first, last, keys);
+                break;
+            case QMetaType::LongLong:
+                sort_by_typed_key<qlonglong>(first, last, keys);
+                break;
+            case QMetaType::ULongLong:
+                sort_by_typed_key<qulonglong>(first, last, keys);
+                break;
+            case QMetaType::Float:
+                sort_by_typed_key<float>(first, last, keys);
+                break;
+            case QMetaType::Double:
+                sort_by_typed_key<double>(first, last, keys);
+                break;
+            case QMetaType::QChar:
+                sort_by_typed_key<QChar>(first, last, keys);
+                break;
+            case QMetaType::QDate:
+                sort_by_typed_key<QDate>(first, last, keys);
+                break;
+            case QMetaType::QTime:
+                sort_by_typed_key<QTime>(first, last, keys);
+                break;
+            case QMetaType::QDateTime:
+                sort_by_typed_key<QDateTime>(first, last, keys);
+                break;
+            default:
+                Q_UNREACHABLE();
+            }
+        }
+    }
+
+    for (int i = 0; i < count; ++i)
+        source_rows[i] = unsorted_rows.at(order.at(i));
+}
+
 /*!
   \internal
 
@@ -826,8 +1196,8 @@ void QSortFilterProxyModelPrivate::insert_source_items(
                 q->beginInsertColumns(proxy_parent, proxy_start, proxy_end);
         }
 
-        for (int i = 0; i < source_items.size(); ++i)
-            proxy_to_source.insert(proxy_start + i, source_items.at(i));
+        proxy_to_source.insert(proxy_start, source_items.size(), -1);
+        std::copy(source_items.cbegin(), source_items.cend(), proxy_to_source.begin() + proxy_start);
 
         build_source_to_proxy_mapping(proxy_to_source, source_to_proxy, proxy_start);
 
@@ -1183,14 +1553,15 @@ void QSortFilterProxyModelPrivate::filter_about_to_be_changed(const QModelIndex
   Updates the proxy model (adds/removes rows) based on the
   new filter.
 */
-void QSortFilterProxyModelPrivate::filter_changed(Direction dir, const QModelIndex &source_parent)
+void QSortFilterProxyModelPrivate::filter_changed(Direction dir, const QModelIndex &source_parent,
+                                                  QSortFilterProxyModel::FilterChange change)
 {
     IndexMap::const_iterator it = source_index_mapping.constFind(source_parent);
     if (it == source_index_mapping.constEnd())
         return;
     Mapping *m = it.value();
-    const QSet<int> rows_removed = (dir & Direction::Rows) ? handle_filter_changed(m->proxy_rows, m->source_rows, source_parent, Qt::Vertical) : QSet<int>();
-    const QSet<int> columns_removed = (dir & Direction::Columns) ? handle_filter_changed(m->proxy_columns, m->source_columns, source_parent, Qt::Horizontal) : QSet<int>();
+    const QSet<int> rows_removed = (dir & Direction::Rows) ? handle_filter_changed(m->proxy_rows, m->source_rows, source_parent, Qt::Vertical, change) : QSet<int>();
+    const QSet<int> columns_removed = (dir & Direction::Columns) ? handle_filter_changed(m->proxy_columns, m->source_columns, source_parent, Qt::Horizontal, change) : QSet<int>();
 
     // We need to iterate over a copy of m->mapped_children because otherwise it may be changed by other code, invalidating
     // the iterator it2.
@@ -1204,7 +1575,7 @@ void QSortFilterProxyModelPrivate::filter_changed(Direction dir, const QModelInd
             indexesToRemove.push_back(i);
             remove_from_mapping(source_child_index);
         } else {
-            filter_changed(dir, source_child_index);
+            filter_changed(dir, source_child_index, change);
         }
     }
     QList<int>::const_iterator removeIt = indexesToRemove.constEnd();
@@ -1223,35 +1594,80 @@ void QSortFilterProxyModelPrivate::filter_changed(Direction dir, const QModelInd
 
 /*!
   \internal
-  returns the removed items indexes
+
+  Refilters the items of the mapping given by \a source_to_proxy and
+  \a proxy_to_source after the filter changed. If the \a change narrowed the
+  filter, only the items that are currently mapped are tested again; if it
+  widened the filter, only the ones that are not.
+
+  Returns the indexes of the removed items. Rows are refiltered later if
+  filter_time_slice is set, in which case nothing is removed yet.
 */
 QSet<int> QSortFilterProxyModelPrivate::handle_filter_changed(
     QList<int> &source_to_proxy, QList<int> &proxy_to_source,
-    const QModelIndex &source_parent, Qt::Orientation orient)
+    const QModelIndex &source_parent, Qt::Orientation orient,
+    QSortFilterProxyModel::FilterChange change)
 {
-    Q_Q(QSortFilterProxyModel);
-    // Figure out which mapped items to remove
-    QList<int> source_items_remove;
-    for (int i = 0; i < proxy_to_source.count(); ++i) {
-        const int source_item = proxy_to_source.at(i);
-        if ((orient == Qt::Vertical)
-            ? !filterAcceptsRowInternal(source_item, source_parent)
-            : !q->filterAcceptsColumn(source_item, source_parent)) {
-            // This source item does not satisfy the filter, so it must be removed
-            source_items_remove.append(source_item);
+    using FilterChange = QSortFilterProxyModel::FilterChange;
+    // change hints only describe filterAcceptsRow()
+    if (orient == Qt::Horizontal)
+        change = FilterChange::Unspecified;
+
+    QList<int> source_items;
+    if (change != FilterChange::Widening)
+        source_items = proxy_to_source;
+    if (change != FilterChange::Narrowing) {
+        const int source_count = source_to_proxy.size();
+        for (int source_item = 0; source_item < source_count; ++source_item) {
+            if (source_to_proxy.at(source_item) == -1)
+                source_items.append(source_item);
         }
     }
-    // Figure out which non-mapped items to insert
+
+    if (orient == Qt::Vertical && filter_time_slice > 0) {
+        queue_pending_filter(source_parent, std::move(source_items));
+        return QSet<int>();
+    }
+    return refilter_source_items(source_to_proxy, proxy_to_source, source_items,
+                                 source_parent, orient);
+}
+
+/*!
+  \internal
+
+  Tests \a source_items against the filter, then removes the mapped ones that
+  are no longer accepted and inserts the unmapped ones that now are.
+  Returns the removed items indexes.
+*/
+QSet<int> QSortFilterProxyModelPrivate::refilter_source_items(
+    QList<int> &source_to_proxy, QList<int> &proxy_to_source,
+    const QList<int> &source_items, const QModelIndex &source_parent,
+    Qt::Orientation orient)
+{
+    Q_Q(QSortFilterProxyModel);
+    QList<bool> accepted;
+    if (orient == Qt::Vertical && concurrent_sortfilter)
+        accepted = filter_source_rows(source_items, source_parent);
+
+    QList<int> source_items_remove;
     QList<int> source_items_insert;
-    int source_count = source_to_proxy.size();
-    for (int source_item = 0; source_item < source_count; ++source_item) {
-        if (source_to_proxy.at(source_item) == -1) {
-            if ((orient == Qt::Vertical)
-                ? filterAcceptsRowInternal(source_item, source_parent)
-                : q->filterAcceptsColumn(source_item, source_parent)) {
-                // This source item satisfies the filter, so it must be added
-                source_items_insert.append(source_item);
-            }
+    for (int i = 0; i < source_items.size(); ++i) {
+        const int source_item = source_items.at(i);
+        bool accepts;
+        if (orient == Qt::Horizontal)
+            accepts = q->filterAcceptsColumn(source_item, source_parent);
+        else if (concurrent_sortfilter)
+            accepts = accepted.at(i);
+        else
+            accepts = filterAcceptsRowInternal(source_item, source_parent);
+
+        if (source_to_proxy.at(source_item) != -1) {
+            // This source item does not satisfy the filter, so it must be removed
+            if (!accepts)
+                source_items_remove.append(source_item);
+        } else if (accepts) {
+            // This source item satisfies the filter, so it must be added
+            source_items_insert.append(source_item);
         }
     }
     if (!source_items_remove.isEmpty() || !source_items_insert.isEmpty()) {
@@ -1266,6 +1682,112 @@ QSet<int> QSortFilterProxyModelPrivate::handle_filter_changed(
     return qListToSet(source_items_remove);
 }
 
+/*!
+  \internal
+
+  Defers filtering \a source_rows under \a source_parent to
+  process_pending_filters(), which runs from the event loop in slices of
+  filter_time_slice milliseconds.
+*/
+void QSortFilterProxyModelPrivate::queue_pending_filter(const QModelIndex &source_parent,
+                                                        QList<int> &&source_rows)
+{
+    // Rows are refiltered against the filter at the time they are processed,
+    // so an entry covering all rows makes the earlier ones for the parent moot
+    const IndexMap::const_iterator it = source_index_mapping.constFind(source_parent);
+    if (it != source_index_mapping.constEnd()
+            && source_rows.size() == it.value()->proxy_rows.size()) {
+        pending_filters.erase(
+            std::remove_if(pending_filters.begin(), pending_filters.end(),
+                           [&source_parent](const PendingFilter &pending) {
+                               return pending.source_parent == source_parent;
+                           }),
+            pending_filters.end());
+    }
+    if (source_rows.isEmpty())
+        return;
+    pending_filters.append({ source_parent, std::move(source_rows), 0 });
+
+    schedule_pending_filters();
+}
+
+/*!
+  \internal
+
+  Refilters the rows queued by queue_pending_filter() in batches until
+  \a time_slice milliseconds have passed, or all of them if \a time_slice is
+  not positive, and schedules another slice for the remaining ones.
+*/
+void QSortFilterProxyModelPrivate::process_pending_filters(int time_slice)
+{
+    // Small enough to check the time often, large enough to emit few signals
+    constexpr int BatchSize = 256;
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!pending_filters.isEmpty()) {
+        PendingFilter &pending = pending_filters.first();
+        const QModelIndex source_parent = pending.source_parent;
+        const int begin = pending.next;
+        const int end = time_slice > 0
+                ? qMin(begin + BatchSize, int(pending.source_rows.size()))
+                : int(pending.source_rows.size());
+        const QList<int> source_rows = pending.source_rows.mid(begin, end - begin);
+        pending.next = end;
+        if (end == pending.source_rows.size())
+            pending_filters.removeFirst();
+
+        // The mapping may be gone if the parent was filtered out meanwhile
+        IndexMap::const_iterator it = source_index_mapping.constFind(source_parent);
+        if (it == source_index_mapping.constEnd())
+            continue;
+        Mapping *m = it.value();
+        const QSet<int> rows_removed = refilter_source_items(m->proxy_rows, m->source_rows,
+                                                             source_rows, source_parent, Qt::Vertical);
+        it = source_index_mapping.constFind(source_parent);
+        if (!rows_removed.isEmpty() && it != source_index_mapping.constEnd()) {
+            m = it.value();
+            for (int i = m->mapped_children.size() - 1; i >= 0; --i) {
+                const QModelIndex source_child_index = m->mapped_children.at(i);
+                if (rows_removed.contains(source_child_index.row())) {
+                    m->mapped_children.remove(i);
+                    remove_from_mapping(source_child_index);
+                }
+            }
+        }
+
+        if (time_slice > 0 && timer.elapsed() >= time_slice)
+            break;
+    }
+
+    if (!pending_filters.isEmpty())
+        schedule_pending_filters();
+}
+
+void QSortFilterProxyModelPrivate::schedule_pending_filters()
+{
+    Q_Q(QSortFilterProxyModel);
+    if (pending_filters_scheduled)
+        return;
+    pending_filters_scheduled = true;
+    QTimer::singleShot(0, q, [this] {
+        pending_filters_scheduled = false;
+        process_pending_filters(filter_time_slice);
+    });
+}
+
+/*!
+  \internal
+
+  Refilters all queued rows now. Called before the source model changes its
+  structure, since the queued rows refer to the current one.
+*/
+void QSortFilterProxyModelPrivate::flush_pending_filters()
+{
+    if (!pending_filters.isEmpty())
+        process_pending_filters(0);
+}
+
 bool QSortFilterProxyModelPrivate::needsReorder(const QList<int> &source_rows, const QModelIndex &source_parent) const
 {
     Q_Q(const QSortFilterProxyModel);
@@ -1488,6 +2010,7 @@ void QSortFilterProxyModelPrivate::_q_sourceLayoutAboutToBeChanged(const QList<Q
 {
     Q_Q(QSortFilterProxyModel);
     Q_UNUSED(hint); // We can't forward Hint because we might filter additional rows or columns
+    flush_pending_filters();
     saved_persistent_indexes.clear();
 
     saved_layoutChange_parents.clear();
@@ -1541,6 +2064,7 @@ void QSortFilterProxyModelPrivate::_q_sourceRowsAboutToBeInserted(
 {
     Q_UNUSED(start);
     Q_UNUSED(end);
+    flush_pending_filters();
 
     const bool toplevel = !source_parent.isValid();
     const bool recursive_accepted = filter_recursive && !toplevel && filterAcceptsRowInternal(source_parent.row(), source_parent.parent());
@@ -1600,6 +2124,7 @@ void QSortFilterProxyModelPrivate::_q_sourceRowsInserted(
 void QSortFilterProxyModelPrivate::_q_sourceRowsAboutToBeRemoved(
     const QModelIndex &source_parent, int start, int end)
 {
+    flush_pending_filters();
     itemsBeingRemoved = QRowsRemoval(source_parent, start, end);
     source_items_about_to_be_removed(source_parent, start, end,
                                      Qt::Vertical);
@@ -1636,6 +2161,7 @@ void QSortFilterProxyModelPrivate::_q_sourceRowsRemoved(
 void QSortFilterProxyModelPrivate::_q_sourceRowsAboutToBeMoved(
     const QModelIndex &sourceParent, int /* sourceStart */, int /* sourceEnd */, const QModelIndex &destParent, int /* dest */)
 {
+    flush_pending_filters();
     // Because rows which are contiguous in the source model might not be contiguous
     // in the proxy due to sorting, the best thing we can do here is be specific about what
     // parents are having their children changed.
@@ -1664,6 +2190,7 @@ void QSortFilterProxyModelPrivate::_q_sourceColumnsAboutToBeInserted(
 {
     Q_UNUSED(start);
     Q_UNUSED(end);
+    flush_pending_filters();
     //Force the creation of a mapping now, even if its empty.
     //We need it because the proxy can be acessed at the moment it emits columnsAboutToBeInserted in insert_source_items
     if (can_create_mapping(source_parent))
@@ -1693,6 +2220,7 @@ void QSortFilterProxyModelPrivate::_q_sourceColumnsInserted(
 void QSortFilterProxyModelPrivate::_q_sourceColumnsAboutToBeRemoved(
     const QModelIndex &source_parent, int start, int end)
 {
+    flush_pending_filters();
     source_items_about_to_be_removed(source_parent, start, end,
                                      Qt::Horizontal);
 }
@@ -1718,6 +2246,7 @@ void QSortFilterProxyModelPrivate::_q_sourceColumnsRemoved(
 void QSortFilterProxyModelPrivate::_q_sourceColumnsAboutToBeMoved(
     const QModelIndex &sourceParent, int /* sourceStart */, int /* sourceEnd */, const QModelIndex &destParent, int /* dest */)
 {
+    flush_pending_filters();
     QList<QPersistentModelIndex> parents;
     parents << sourceParent;
     if (sourceParent != destParent)
@@ -1907,6 +2436,10 @@ QSortFilterProxyModel::QSortFilterProxyModel(QObject *parent)
     d->filter_recursive = false;
     d->accept_children = false;
     d->dynamic_sortfilter = true;
+    d->sort_key_caching = false;
+    d->concurrent_sortfilter = false;
+    d->filter_time_slice = 0;
+    d->pending_filters_scheduled = false;
     d->complete_insert = false;
     connect(this, SIGNAL(modelReset()), this, SLOT(_q_clearMapping()));
 }
@@ -2151,6 +2684,79 @@ QVariant QSortFilterProxyModel::data(const QModelIndex &index, int role) const
     return d->model->data(source_index, role);
 }
 
+/*!
+  \reimp
+  \since 6.0
+
+  If \l{QAbstractProxyModel::}{rangeDataForwardingEnabled} is \c true,
+  forwards the request to the source model. Rows that are adjacent in
+  the source model as well as in the proxy are fetched with a single
+  call; if the range covers columns that are not adjacent in the source
+  model, every row is fetched with one call per run of adjacent columns.
+  Otherwise, calls data() for every item.
+*/
+void QSortFilterProxyModel::rangeData(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                      QModelRoleDataSpan roleDataSpan) const
+{
+    Q_D(const QSortFilterProxyModel);
+    Q_ASSERT(checkIndex(topLeft, CheckIndexOption::IndexIsValid));
+    Q_ASSERT(checkIndex(bottomRight, CheckIndexOption::IndexIsValid));
+    if (!d->rangeDataForwardingEnabled) {
+        QAbstractItemModel::rangeData(topLeft, bottomRight, roleDataSpan);
+        return;
+    }
+    const auto it = d->index_to_iterator(topLeft);
+    const QSortFilterProxyModelPrivate::Mapping *m = it.value();
+    const QModelIndex &source_parent = it.key();
+    const int top = topLeft.row();
+    const int bottom = bottomRight.row();
+    const int left = topLeft.column();
+    const int right = bottomRight.column();
+    Q_ASSERT(bottom < m->source_rows.size() && right < m->source_columns.size());
+    const qsizetype rolesPerItem = QAbstractItemModelPrivate::rolesPerItem(topLeft, bottomRight,
+                                                                          roleDataSpan);
+
+    // runs of proxy columns that are adjacent in the source model: (first, count)
+    QVarLengthArray<QPair<int, int>, 4> column_runs;
+    for (int column = left; column <= right; ++column) {
+        if (!column_runs.isEmpty()
+            && m->source_columns.at(column) == m->source_columns.at(column - 1) + 1) {
+            ++column_runs.last().second;
+        } else {
+            column_runs.append(qMakePair(column, 1));
+        }
+    }
+
+    QModelRoleData *roleData = roleDataSpan.data();
+    const auto fetch = [&](int proxy_row, int rows, int proxy_column, int columns) {
+        const int source_row = m->source_rows.at(proxy_row);
+        const int source_column = m->source_columns.at(proxy_column);
+        const qsizetype size = rolesPerItem * rows * columns;
+        d->model->rangeData(d->model->index(source_row, source_column, source_parent),
+                            d->model->index(source_row + rows - 1, source_column + columns - 1,
+                                            source_parent),
+                            QModelRoleDataSpan(roleData, size));
+        roleData += size;
+    };
+
+    if (column_runs.size() == 1) {
+        // whole rows are contiguous in the span, so adjacent rows can be fetched together
+        int first = top;
+        for (int row = top + 1; row <= bottom + 1; ++row) {
+            if (row > bottom || m->source_rows.at(row) != m->source_rows.at(row - 1) + 1) {
+                fetch(first, row - first, left, right - left + 1);
+                first = row;
+            }
+        }
+    } else {
+        for (int row = top; row <= bottom; ++row) {
+            for (const auto &run : qAsConst(column_runs))
+                fetch(row, 1, run.first, run.second);
+        }
+    }
+    Q_ASSERT(roleData == roleDataSpan.end());
+}
+
 /*!
   \reimp
 */
@@ -2503,11 +3109,35 @@ QRegularExpression QSortFilterProxyModel::filterRegularExpression() const
 }
 
 void QSortFilterProxyModel::setFilterRegularExpression(const QRegularExpression &regularExpression)
+{
+    setFilterRegularExpression(regularExpression, FilterChange::Unspecified);
+}
+
+/*!
+    \since 6.0
+    \overload
+
+    Sets the regular expression used to filter the contents of the source
+    model to \a regularExpression, where \a change tells how the new
+    expression relates to the current one.
+
+    Pass FilterChange::Narrowing only if every row accepted by the new
+    expression is also accepted by the current one, for instance when
+    appending text to a fixed string, and FilterChange::Widening only if the
+    opposite holds. The proxy model then only tests the rows that can be
+    affected by the change, instead of all rows of the source model:
+
+    \snippet qsortfilterproxymodel-details/main.cpp 6
+
+    \sa FilterChange, invalidateRowsFilter(), filterTimeSlice
+*/
+void QSortFilterProxyModel::setFilterRegularExpression(const QRegularExpression &regularExpression,
+                                                       FilterChange change)
 {
     Q_D(QSortFilterProxyModel);
     d->filter_about_to_be_changed();
     d->filter_data = regularExpression;
-    d->filter_changed(QSortFilterProxyModelPrivate::Direction::Rows);
+    d->filter_changed(QSortFilterProxyModelPrivate::Direction::Rows, QModelIndex(), change);
 }
 #endif
 
@@ -2857,6 +3487,170 @@ void QSortFilterProxyModel::setAutoAcceptChildRows(bool accept)
     emit autoAcceptChildRowsChanged(accept);
 }
 
+/*!
+    \since 6.0
+    \property QSortFilterProxyModel::sortKeyCachingEnabled
+    \brief whether the sort role data of each row is fetched only once per sort.
+
+    By default, sorting compares two rows at a time by calling lessThan(),
+    which fetches the data of both rows from the source model. Sorting \e n
+    rows therefore fetches data \e{n log n} times.
+
+    If this property is true, the proxy model instead fetches the sortRole()
+    data of each row once, and sorts the rows by comparing these cached keys
+    the way the default implementation of lessThan() compares them. Integer,
+    floating point and date and time keys are compared without going through
+    QVariant, and locale-aware string sorting uses collation keys.
+
+    \note If this property is true, lessThan() is not called. Leave it
+    disabled when lessThan() is reimplemented.
+
+    The default value is false.
+
+    \sa sortRole, isSortLocaleAware, lessThan()
+*/
+
+/*!
+    \since 6.0
+    \fn void QSortFilterProxyModel::sortKeyCachingEnabledChanged(bool sortKeyCachingEnabled)
+
+    \brief This signal is emitted when the value of the \a sortKeyCachingEnabled property is changed.
+
+    \sa sortKeyCachingEnabled
+*/
+bool QSortFilterProxyModel::isSortKeyCachingEnabled() const
+{
+    Q_D(const QSortFilterProxyModel);
+    return d->sort_key_caching;
+}
+
+void QSortFilterProxyModel::setSortKeyCachingEnabled(bool enable)
+{
+    Q_D(QSortFilterProxyModel);
+    if (d->sort_key_caching == enable)
+        return;
+
+    // both modes produce the same order, so there is nothing to re-sort
+    d->sort_key_caching = enable;
+    emit sortKeyCachingEnabledChanged(enable);
+}
+
+/*!
+    \since 6.0
+    \property QSortFilterProxyModel::concurrentSortFilterEnabled
+    \brief whether sorting and filtering large numbers of rows is spread over
+    QThreadPool::globalInstance().
+
+    If this property is true, the proxy model calls filterAcceptsRow() and
+    lessThan() for different rows from several threads at the same time, and
+    with sortKeyCachingEnabled also fetches the sort keys that way. The
+    calling thread waits until all of them are done, so no signals are
+    emitted concurrently and the result is the same as without this property.
+
+    By setting this property to true, you declare that reading data from the
+    source model, as well as any reimplementation of filterAcceptsRow() and
+    lessThan(), is safe to do from several threads at once while the model is
+    not being modified. Most models derived from QAbstractItemModel do not
+    guarantee this.
+
+    The default value is false.
+
+    \sa sortKeyCachingEnabled, {Thread-Support in Qt Modules}
+*/
+
+/*!
+    \since 6.0
+    \fn void QSortFilterProxyModel::concurrentSortFilterEnabledChanged(bool concurrentSortFilterEnabled)
+
+    \brief This signal is emitted when the value of the \a concurrentSortFilterEnabled property is changed.
+
+    \sa concurrentSortFilterEnabled
+*/
+bool QSortFilterProxyModel::isConcurrentSortFilterEnabled() const
+{
+    Q_D(const QSortFilterProxyModel);
+    return d->concurrent_sortfilter;
+}
+
+void QSortFilterProxyModel::setConcurrentSortFilterEnabled(bool enable)
+{
+    Q_D(QSortFilterProxyModel);
+    if (d->concurrent_sortfilter == enable)
+        return;
+
+    d->concurrent_sortfilter = enable;
+    emit concurrentSortFilterEnabledChanged(enable);
+}
+
+/*!
+    \since 6.0
+    \property QSortFilterProxyModel::filterTimeSlice
+    \brief the time in milliseconds that refiltering rows may block the event
+    loop at once.
+
+    If this property is 0, changing the filter tests all affected rows
+    before returning, and adds and removes rows accordingly. If it is
+    positive, the proxy model instead tests the rows from the event loop in
+    slices of about this many milliseconds, emitting rowsRemoved() and
+    rowsInserted() for each slice, so that the user interface stays
+    responsive while a large model is being filtered. Until then, the rows
+    that have not been tested yet keep their previous state.
+
+    Rows waiting to be filtered are handled at once if the source model is
+    about to change its structure, or if this property is set back to 0.
+    Column filtering is never deferred.
+
+    The default value is 0.
+
+    \sa FilterChange, invalidateRowsFilter()
+*/
+
+/*!
+    \since 6.0
+    \fn void QSortFilterProxyModel::filterTimeSliceChanged(int filterTimeSlice)
+
+    \brief This signal is emitted when the value of the \a filterTimeSlice property is changed.
+
+    \sa filterTimeSlice
+*/
+int QSortFilterProxyModel::filterTimeSlice() const
+{
+    Q_D(const QSortFilterProxyModel);
+    return d->filter_time_slice;
+}
+
+void QSortFilterProxyModel::setFilterTimeSlice(int msecs)
+{
+    Q_D(QSortFilterProxyModel);
+    msecs = qMax(0, msecs);
+    if (d->filter_time_slice == msecs)
+        return;
+
+    d->filter_time_slice = msecs;
+    if (msecs == 0)
+        d->flush_pending_filters();
+    emit filterTimeSliceChanged(msecs);
+}
+
+/*!
+    \since 6.0
+    \enum QSortFilterProxyModel::FilterChange
+
+    This enum describes how a change of the filter affects the set of
+    accepted rows.
+
+    \value Unspecified Any row may be accepted or rejected after the change.
+    All rows are tested.
+    \value Narrowing Rows may only stop being accepted; no row that is
+    currently filtered out becomes accepted. Only the rows currently in the
+    proxy model are tested.
+    \value Widening Rows may only become accepted; no row that is currently
+    accepted becomes filtered out. Only the rows currently filtered out are
+    tested.
+
+    \sa setFilterRegularExpression(), invalidateRowsFilter()
+*/
+
 /*!
    \since 4.3
 
@@ -2934,6 +3728,24 @@ void QSortFilterProxyModel::invalidateRowsFilter()
     d->filter_changed(QSortFilterProxyModelPrivate::Direction::Rows);
 }
 
+/*!
+   \since 6.0
+   \overload
+
+   Invalidates the current filtering for the rows, where \a change tells
+   whether the filter parameters changed in a way that can only hide rows
+   that are currently shown (FilterChange::Narrowing), or only show rows that
+   are currently hidden (FilterChange::Widening). In those cases,
+   filterAcceptsRow() is only called for the rows that can be affected.
+
+   \sa FilterChange, filterTimeSlice
+*/
+void QSortFilterProxyModel::invalidateRowsFilter(FilterChange change)
+{
+    Q_D(QSortFilterProxyModel);
+    d->filter_changed(QSortFilterProxyModelPrivate::Direction::Rows, QModelIndex(), change);
+}
+
 /*!
     Returns \c true if the value of the item referred to by the given
     index \a source_left is less than the value of the item referred to by
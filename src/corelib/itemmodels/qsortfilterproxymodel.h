@@ -73,8 +73,18 @@ class Q_CORE_EXPORT QSortFilterProxyModel : public QAbstractProxyModel
     Q_PROPERTY(int filterRole READ filterRole WRITE setFilterRole NOTIFY filterRoleChanged)
     Q_PROPERTY(bool recursiveFilteringEnabled READ isRecursiveFilteringEnabled WRITE setRecursiveFilteringEnabled NOTIFY recursiveFilteringEnabledChanged)
     Q_PROPERTY(bool autoAcceptChildRows READ autoAcceptChildRows WRITE setAutoAcceptChildRows NOTIFY autoAcceptChildRowsChanged)
+    Q_PROPERTY(bool sortKeyCachingEnabled READ isSortKeyCachingEnabled WRITE setSortKeyCachingEnabled NOTIFY sortKeyCachingEnabledChanged)
+    Q_PROPERTY(bool concurrentSortFilterEnabled READ isConcurrentSortFilterEnabled WRITE setConcurrentSortFilterEnabled NOTIFY concurrentSortFilterEnabledChanged)
+    Q_PROPERTY(int filterTimeSlice READ filterTimeSlice WRITE setFilterTimeSlice NOTIFY filterTimeSliceChanged)
 
 public:
+    enum class FilterChange {
+        Unspecified,
+        Narrowing,
+        Widening
+    };
+    Q_ENUM(FilterChange)
+
     explicit QSortFilterProxyModel(QObject *parent = nullptr);
     ~QSortFilterProxyModel();
 
@@ -88,6 +98,7 @@ public:
 
 #if QT_CONFIG(regularexpression)
     QRegularExpression filterRegularExpression() const;
+    void setFilterRegularExpression(const QRegularExpression &regularExpression, FilterChange change);
 #endif
 
     int filterKeyColumn() const;
@@ -120,6 +131,15 @@ public:
     bool autoAcceptChildRows() const;
     void setAutoAcceptChildRows(bool accept);
 
+    bool isSortKeyCachingEnabled() const;
+    void setSortKeyCachingEnabled(bool enable);
+
+    bool isConcurrentSortFilterEnabled() const;
+    void setConcurrentSortFilterEnabled(bool enable);
+
+    int filterTimeSlice() const;
+    void setFilterTimeSlice(int msecs);
+
 public Q_SLOTS:
 #if QT_CONFIG(regularexpression)
     void setFilterRegularExpression(const QString &pattern);
@@ -136,6 +156,7 @@ protected:
 
     void invalidateFilter();
     void invalidateRowsFilter();
+    void invalidateRowsFilter(FilterChange change);
     void invalidateColumnsFilter();
 
 public:
@@ -150,6 +171,8 @@ public:
     bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
 
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    void rangeData(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                   QModelRoleDataSpan roleDataSpan) const override;
     bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
 
     QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
@@ -189,6 +212,9 @@ Q_SIGNALS:
     void filterRoleChanged(int filterRole);
     void recursiveFilteringEnabledChanged(bool recursiveFilteringEnabled);
     void autoAcceptChildRowsChanged(bool autoAcceptChildRows);
+    void sortKeyCachingEnabledChanged(bool sortKeyCachingEnabled);
+    void concurrentSortFilterEnabledChanged(bool concurrentSortFilterEnabled);
+    void filterTimeSliceChanged(int filterTimeSlice);
 
 private:
     Q_DECLARE_PRIVATE(QSortFilterProxyModel)
@@ -87,9 +87,11 @@
 # include "qline.h"
 #endif
 
+#include <array>
 #include <bitset>
 #include <new>
 #include <cstring>
+#include <tuple>
 
 QT_BEGIN_NAMESPACE
 
@@ -1513,12 +1515,12 @@ public:
     {
         const QWriteLocker locker(&lock);
         map.clear();
+        generation.ref();
     }
 
     bool contains(Key k) const
     {
-        const QReadLocker locker(&lock);
-        return map.contains(k);
+        return function(k) != nullptr;
     }
 
     bool insertIfNotContains(Key k, const T &f)
@@ -1527,14 +1529,38 @@ public:
         if (map.contains(k))
             return false;
         map.insert(k, f);
+        generation.ref();
         return true;
     }
 
     const T *function(Key k) const
     {
-        const QReadLocker locker(&lock);
-        auto it = map.find(k);
-        return it == map.end() ? nullptr : std::addressof(*it);
+        // Conversions are looked up far more often than registered, and mostly
+        // for the same few pairs of types. Each thread remembers the results of
+        // its recent lookups, including the failed ones, and only takes the lock
+        // when the registry has changed since.
+        struct CacheEntry
+        {
+            Key key;
+            uint generation;
+            const T *function;
+        };
+        static thread_local CacheEntry cache[CacheSize] = {};
+
+        const uint currentGeneration = generation.loadAcquire();
+        CacheEntry &entry = cache[qHash(k) & (CacheSize - 1)];
+        if (entry.generation == currentGeneration && entry.key == k)
+            return entry.function;
+
+        const T *f = nullptr;
+        {
+            const QReadLocker locker(&lock);
+            auto it = map.find(k);
+            if (it != map.end())
+                f = std::addressof(*it);
+        }
+        entry = { k, currentGeneration, f };
+        return f;
     }
 
     void remove(int from, int to)
@@ -1542,10 +1568,15 @@ public:
         const Key k(from, to);
         const QWriteLocker locker(&lock);
         map.remove(k);
+        generation.ref();
     }
 private:
+    static constexpr int CacheSize = 64;
+
     mutable QReadWriteLock lock;
     QHash<Key, T> map;
+    // starts at 1, so that the empty cache entries never match
+    QAtomicInteger<uint> generation = 1;
 };
 
 typedef QMetaTypeFunctionRegistry<QMetaType::ConverterFunction,QPair<int,int> >
@@ -2121,6 +2152,69 @@ static bool convertQObject(QMetaType fromType, const void *from, QMetaType toTyp
 }
 #endif
 
+namespace {
+// The conversions between the primitive numeric types are the most common
+// ones by far, so they are dispatched through a table instead of the module
+// helper. They behave exactly like the ones in QMetaTypeModuleHelper::convert().
+using NumericTypes = std::tuple<bool, int, uint, qlonglong, qulonglong, double, long, short,
+                                char, ulong, ushort, uchar, float, signed char>;
+constexpr size_t NumericTypeCount = std::tuple_size_v<NumericTypes>;
+
+template <typename To, typename From>
+bool convertNumeric(const void *from, void *to)
+{
+    const From &source = *static_cast<const From *>(from);
+    To &result = *static_cast<To *>(to);
+    if constexpr (std::is_floating_point_v<From> && !std::is_floating_point_v<To>)
+        result = qRound64(source);
+    else
+        result = To(source);
+    return true;
+}
+
+using NumericConverter = bool (*)(const void *, void *);
+
+template <size_t To, size_t... From>
+constexpr std::array<NumericConverter, NumericTypeCount> numericConvertersTo(std::index_sequence<From...>)
+{
+    return { { &convertNumeric<std::tuple_element_t<To, NumericTypes>,
+                               std::tuple_element_t<From, NumericTypes>>... } };
+}
+
+template <size_t... To>
+constexpr auto numericConverterTable(std::index_sequence<To...> types)
+{
+    return std::array<std::array<NumericConverter, NumericTypeCount>, NumericTypeCount> {
+        { numericConvertersTo<To>(types)... }
+    };
+}
+
+constexpr auto numericConverters = numericConverterTable(std::make_index_sequence<NumericTypeCount>());
+
+template <size_t... Index>
+constexpr auto numericTypeIndexTable(std::index_sequence<Index...>)
+{
+    std::array<qint8, QMetaType::LastCoreType + 1> indexes = {};
+    for (auto &index : indexes)
+        index = -1;
+    ((indexes[QMetaTypeId2<std::tuple_element_t<Index, NumericTypes>>::MetaType] = Index), ...);
+    return indexes;
+}
+
+constexpr auto numericTypeIndexes = numericTypeIndexTable(std::make_index_sequence<NumericTypeCount>());
+
+NumericConverter numericConverter(int fromTypeId, int toTypeId)
+{
+    if (uint(fromTypeId) > QMetaType::LastCoreType || uint(toTypeId) > QMetaType::LastCoreType)
+        return nullptr;
+    const int from = numericTypeIndexes[fromTypeId];
+    const int to = numericTypeIndexes[toTypeId];
+    if (from < 0 || to < 0)
+        return nullptr;
+    return numericConverters[to][from];
+}
+} // unnamed namespace
+
 /*!
     \fn bool QMetaType::convert(const void *from, int fromTypeId, void *to, int toTypeId)
     \obsolete
@@ -2140,16 +2234,19 @@ bool QMetaType::convert(QMetaType fromType, const void *from, QMetaType toType,
     if (!fromType.isValid() || !toType.isValid())
         return false;
 
-    if (fromType == toType) {
+    int fromTypeId = fromType.id();
+    int toTypeId = toType.id();
+
+    if (auto convertNumber = numericConverter(fromTypeId, toTypeId))
+        return convertNumber(from, to);
+
+    if (fromTypeId == toTypeId) {
         // just make a copy
         fromType.destruct(to);
         fromType.construct(to, from);
         return true;
     }
 
-    int fromTypeId = fromType.id();
-    int toTypeId = toType.id();
-
     if (auto moduleHelper = qModuleHelperForType(qMax(fromTypeId, toTypeId))) {
         if (moduleHelper->convert(from, fromTypeId, to, toTypeId))
             return true;
@@ -2354,6 +2451,9 @@ bool QMetaType::canConvert(QMetaType fromType, QMetaType toType)
     if (fromTypeId == toTypeId)
         return true;
 
+    if (numericConverter(fromTypeId, toTypeId))
+        return true;
+
     if (auto moduleHelper = qModuleHelperForType(qMax(fromTypeId, toTypeId))) {
         if (moduleHelper->convert(nullptr, fromTypeId, nullptr, toTypeId))
             return true;
@@ -43,6 +43,9 @@
 #include <qscopedvaluerollback.h>
 #include <QScopeGuard>
 
+#include <algorithm>
+#include <vector>
+
 QT_BEGIN_NAMESPACE
 
 using namespace QtPrivate;
@@ -98,6 +101,42 @@ void QPropertyBindingPrivate::unlinkAndDeref()
         destroyAndFreeMemory(this);
 }
 
+namespace {
+struct QPropertyUpdateGroupState
+{
+    struct Notification
+    {
+        const QPropertyBindingData *bindingData;
+        QUntypedPropertyData *propertyData;
+    };
+    using Notifications = std::vector<Notification>;
+
+    // notifications are only delayed while depth > 0
+    int depth = 0;
+    Notifications pending;
+    // notifications of the groups that are currently being ended
+    std::vector<Notifications *> ending;
+
+    Notification *find(const QPropertyBindingData *bindingData)
+    {
+        const auto matches = [bindingData](const Notification &n) {
+            return n.bindingData == bindingData;
+        };
+        auto it = std::find_if(pending.begin(), pending.end(), matches);
+        if (it != pending.end())
+            return &*it;
+        for (Notifications *notifications : ending) {
+            it = std::find_if(notifications->begin(), notifications->end(), matches);
+            if (it != notifications->end())
+                return &*it;
+        }
+        return nullptr;
+    }
+};
+}
+
+static thread_local QPropertyUpdateGroupState updateGroupState;
+
 void QPropertyBindingPrivate::markDirtyAndNotifyObservers()
 {
     if (dirty)
@@ -123,6 +162,48 @@ void QPropertyBindingPrivate::markDirtyAndNotifyObservers()
         staticObserverCallback(propertyDataPtr);
 }
 
+/*!
+  \internal
+  Marks the binding and, transitively, all the bindings depending on it dirty
+  at the end of an update group, without evaluating anything or calling change
+  handlers. notifyAfterUpdateGroup() does that later, once per binding.
+ */
+void QPropertyBindingPrivate::markDirtyForUpdateGroup()
+{
+    if (dirty)
+        return;
+    dirty = true;
+    pendingNotification = true;
+    trackingValueChange = true;
+    valueChangedInUpdateGroup = false;
+    if (firstObserver)
+        firstObserver.markBindingsDirty();
+}
+
+void QPropertyBindingPrivate::notifyAfterUpdateGroup()
+{
+    if (!pendingNotification)
+        return;
+    pendingNotification = false;
+
+    QPropertyBindingPrivatePtr keepAlive {this};
+    QScopeGuard guard([&]() {
+        trackingValueChange = false;
+        valueChangedInUpdateGroup = false;
+    });
+    bool knownIfChanged = false;
+    if (requiresEagerEvaluation()) {
+        const bool changed = evaluateIfDirtyAndReturnTrueIfValueChanged(propertyDataPtr);
+        if (!takeValueChangedInUpdateGroup() && !changed)
+            return;
+        knownIfChanged = true;
+    }
+    if (firstObserver)
+        firstObserver.notify(this, propertyDataPtr, knownIfChanged, /*endOfUpdateGroup=*/true);
+    if (hasStaticObserver)
+        staticObserverCallback(propertyDataPtr);
+}
+
 bool QPropertyBindingPrivate::evaluateIfDirtyAndReturnTrueIfValueChanged(const QUntypedPropertyData *data)
 {
     if (!dirty)
@@ -158,6 +239,10 @@ bool QPropertyBindingPrivate::evaluateIfDirtyAndReturnTrueIfValueChanged(const Q
     }
 
     dirty = false;
+    // the binding might be evaluated by other observers before its own change
+    // handlers get to find out whether the value changed
+    if (trackingValueChange && changed)
+        valueChangedInUpdateGroup = true;
     return changed;
 }
 
@@ -224,6 +309,10 @@ QMetaType QUntypedPropertyBinding::valueMetaType() const
 QPropertyBindingData::~QPropertyBindingData()
 {
     QPropertyBindingDataPointer d{this};
+    if (d_ptr & DelayedNotificationBit) {
+        if (auto *notification = updateGroupState.find(this))
+            notification->bindingData = nullptr;
+    }
     for (auto observer = d.firstObserver(); observer;) {
         auto next = observer.nextObserver();
         observer.unlink();
@@ -286,6 +375,16 @@ QPropertyBindingData::QPropertyBindingData(QPropertyBindingData &&other) : d_ptr
 {
     QPropertyBindingDataPointer d{this};
     d.fixupFirstObserverAfterMove();
+    if (d_ptr & DelayedNotificationBit) {
+        if (auto *notification = updateGroupState.find(&other)) {
+            // the binding data is a member of the property data, which is moved along
+            const auto offset = reinterpret_cast<char *>(notification->propertyData)
+                    - reinterpret_cast<const char *>(&other);
+            notification->bindingData = this;
+            notification->propertyData = reinterpret_cast<QUntypedPropertyData *>(
+                    reinterpret_cast<char *>(this) + offset);
+        }
+    }
 }
 
 QPropertyBindingPrivate *QPropertyBindingData::binding() const
@@ -340,7 +439,7 @@ void QPropertyBindingData::removeBinding()
 
     if (auto *existingBinding = d.bindingPtr()) {
         auto observer = existingBinding->takeObservers();
-        d_ptr &= ExtraBit;
+        d_ptr &= DelayedNotificationBit;
         if (observer)
             d.setObservers(observer.ptr);
         existingBinding->unlinkAndDeref();
@@ -363,10 +462,142 @@ void QPropertyBindingData::registerWithCurrentlyEvaluatingBinding() const
 void QPropertyBindingData::notifyObservers(QUntypedPropertyData *propertyDataPtr) const
 {
     QPropertyBindingDataPointer d{this};
-    if (QPropertyObserverPointer observer = d.firstObserver())
+    if (QPropertyObserverPointer observer = d.firstObserver()) {
+        QPropertyUpdateGroupState &group = updateGroupState;
+        if (group.depth) {
+            if (!(d_ptr & DelayedNotificationBit)) {
+                d_ptr |= DelayedNotificationBit;
+                group.pending.push_back({ this, propertyDataPtr });
+            }
+            return;
+        }
         observer.notify(d.bindingPtr(), propertyDataPtr);
+    }
+}
+
+void QPropertyBindingDataPointer::clearDelayedNotification() const
+{
+    ptr->d_ptr &= ~QPropertyBindingData::DelayedNotificationBit;
 }
 
+/*!
+    \since 6.0
+    \relates QProperty
+
+    Starts an update group on the current thread.
+
+    While an update group is in progress, writing to a property does not
+    notify its observers right away. Bindings depending on the property
+    are neither marked dirty nor re-evaluated, and change handlers are not
+    called. When the outermost update group ends, all the bindings depending
+    on the properties written in the meantime are marked dirty first, and
+    then the change handlers are called, once for every property or binding
+    whose value has changed. Bindings without change handlers stay dirty
+    until their value is read.
+
+    Setting many properties that share dependent bindings inside a group
+    therefore evaluates those bindings only once:
+
+    \code
+    QProperty<int> x, y, z;
+    QProperty<int> sum([&]() { return x + y + z; });
+    sum.onValueChanged([&]() { qDebug() << sum; });
+
+    {
+        QScopedPropertyUpdateGroup group;
+        x = 1;
+        y = 2;
+        z = 3;
+    } // sum is evaluated, and its change handler called, only once here
+    \endcode
+
+    Update groups can be nested; every call to this function must be
+    balanced by a call to Qt::endPropertyUpdateGroup().
+
+    \note Reading a binding that depends on a property written in the
+    current group returns the value from before the group started. The
+    change signals of properties declared with Q_OBJECT_BINDABLE_PROPERTY
+    are emitted right away for the properties written, and at the end of
+    the group for the properties that have a binding.
+
+    \sa Qt::endPropertyUpdateGroup(), QScopedPropertyUpdateGroup
+*/
+void Qt::beginPropertyUpdateGroup()
+{
+    ++updateGroupState.depth;
+}
+
+/*!
+    \since 6.0
+    \relates QProperty
+
+    Ends an update group. If this was the outermost group, the observers of
+    all the properties written since it started are notified.
+
+    \sa Qt::beginPropertyUpdateGroup(), QScopedPropertyUpdateGroup
+*/
+void Qt::endPropertyUpdateGroup()
+{
+    QPropertyUpdateGroupState &group = updateGroupState;
+    if (group.depth <= 0) {
+        qWarning("Qt::endPropertyUpdateGroup: No update group in progress");
+        return;
+    }
+    if (--group.depth)
+        return;
+
+    QPropertyUpdateGroupState::Notifications notifications;
+    notifications.swap(group.pending);
+    // change handlers may destroy or move the properties, and start groups of their own
+    group.ending.push_back(&notifications);
+    const auto cleanup = qScopeGuard([&group]() { group.ending.pop_back(); });
+
+    // mark everything dirty first, so that no binding is evaluated before all its
+    // dependencies have been marked; this also evaluates every binding only once
+    for (const auto &notification : notifications) {
+        if (!notification.bindingData)
+            continue; // destroyed inside the group
+        QPropertyBindingDataPointer d{notification.bindingData};
+        if (QPropertyObserverPointer observer = d.firstObserver())
+            observer.markBindingsDirty();
+    }
+
+    for (auto &notification : notifications) {
+        const auto [bindingData, propertyData] = std::exchange(notification, {});
+        if (!bindingData)
+            continue; // destroyed by a change handler
+        QPropertyBindingDataPointer d{bindingData};
+        d.clearDelayedNotification();
+        if (QPropertyObserverPointer observer = d.firstObserver())
+            observer.notify(d.bindingPtr(), propertyData, false, /*endOfUpdateGroup=*/true);
+    }
+}
+
+/*!
+    \class QScopedPropertyUpdateGroup
+    \inmodule QtCore
+    \since 6.0
+    \ingroup tools
+    \brief The QScopedPropertyUpdateGroup class starts an update group for the scope it is in.
+
+    The constructor calls Qt::beginPropertyUpdateGroup(), and the destructor
+    calls Qt::endPropertyUpdateGroup().
+
+    \sa Qt::beginPropertyUpdateGroup()
+*/
+
+/*!
+    \fn QScopedPropertyUpdateGroup::QScopedPropertyUpdateGroup()
+
+    Starts an update group by calling Qt::beginPropertyUpdateGroup().
+*/
+
+/*!
+    \fn QScopedPropertyUpdateGroup::~QScopedPropertyUpdateGroup()
+
+    Ends the update group by calling Qt::endPropertyUpdateGroup().
+*/
+
 int QPropertyBindingDataPointer::observerCount() const
 {
     int count = 0;
@@ -539,7 +770,8 @@ struct [[nodiscard]] QPropertyObserverNodeProtector {
   ObserverNotifiesChangeHandler case would not work. Thus we instead pass the knowledge of
   whether the value has changed we obtained when evaluating the binding eagerly along
  */
-void QPropertyObserverPointer::notify(QPropertyBindingPrivate *triggeringBinding, QUntypedPropertyData *propertyDataPtr,bool alreadyKnownToHaveChanged)
+void QPropertyObserverPointer::notify(QPropertyBindingPrivate *triggeringBinding, QUntypedPropertyData *propertyDataPtr,bool alreadyKnownToHaveChanged,
+                                      bool endOfUpdateGroup)
 {
     bool knownIfPropertyChanged = alreadyKnownToHaveChanged;
     bool propertyChanged = true;
@@ -575,6 +807,8 @@ void QPropertyObserverPointer::notify(QPropertyBindingPrivate *triggeringBinding
                 if (!knownIfPropertyChanged && triggeringBinding) {
                     knownIfPropertyChanged = true;
                     propertyChanged = triggeringBinding->evaluateIfDirtyAndReturnTrueIfValueChanged(propertyDataPtr);
+                    if (endOfUpdateGroup)
+                        propertyChanged = triggeringBinding->takeValueChangedInUpdateGroup() || propertyChanged;
                 }
                 if (!propertyChanged)
                     return;
@@ -587,7 +821,10 @@ void QPropertyObserverPointer::notify(QPropertyBindingPrivate *triggeringBinding
         case QPropertyObserver::ObserverNotifiesBinding:
             if (auto bindingToMarkDirty =  observer->bindingToMarkDirty) {
                 QPropertyObserverNodeProtector<QPropertyObserver::ObserverNotifiesBinding> protector(observer);
-                bindingToMarkDirty->markDirtyAndNotifyObservers();
+                if (endOfUpdateGroup)
+                    bindingToMarkDirty->notifyAfterUpdateGroup();
+                else
+                    bindingToMarkDirty->markDirtyAndNotifyObservers();
                 next = protector.m_placeHolder.next.data();
             } else {
                 next = observer->next.data();
@@ -606,6 +843,20 @@ void QPropertyObserverPointer::notify(QPropertyBindingPrivate *triggeringBinding
     }
 }
 
+/*! \internal
+  Marks the bindings observing the property dirty, see
+  QPropertyBindingPrivate::markDirtyForUpdateGroup()
+ */
+void QPropertyObserverPointer::markBindingsDirty()
+{
+    for (auto observer = *this; observer; observer = observer.nextObserver()) {
+        if (observer.ptr->next.tag() != QPropertyObserver::ObserverNotifiesBinding)
+            continue;
+        if (auto *binding = observer.ptr->bindingToMarkDirty)
+            binding->markDirtyForUpdateGroup();
+    }
+}
+
 void QPropertyObserverPointer::observeProperty(QPropertyBindingDataPointer property)
 {
     if (ptr->prev)
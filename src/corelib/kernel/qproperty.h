@@ -203,6 +203,19 @@ namespace Qt {
     }
 }
 
+namespace Qt {
+Q_CORE_EXPORT void beginPropertyUpdateGroup();
+Q_CORE_EXPORT void endPropertyUpdateGroup();
+}
+
+class QScopedPropertyUpdateGroup
+{
+    Q_DISABLE_COPY_MOVE(QScopedPropertyUpdateGroup)
+public:
+    QScopedPropertyUpdateGroup() { Qt::beginPropertyUpdateGroup(); }
+    ~QScopedPropertyUpdateGroup() { Qt::endPropertyUpdateGroup(); }
+};
+
 struct QPropertyObserverPrivate;
 struct QPropertyObserverPointer;
 
@@ -77,9 +77,11 @@ struct Q_AUTOTEST_EXPORT QPropertyBindingDataPointer
     void setObservers(QPropertyObserver *observer)
     {
         observer->prev = reinterpret_cast<QPropertyObserver**>(&(ptr->d_ptr));
-        ptr->d_ptr = (reinterpret_cast<quintptr>(observer) & ~QtPrivate::QPropertyBindingData::FlagMask);
+        ptr->d_ptr = (reinterpret_cast<quintptr>(observer) & ~QtPrivate::QPropertyBindingData::FlagMask)
+                | (ptr->d_ptr & QtPrivate::QPropertyBindingData::DelayedNotificationBit);
     }
     void fixupFirstObserverAfterMove() const;
+    void clearDelayedNotification() const;
     void addObserver(QPropertyObserver *observer);
     void setFirstObserver(QPropertyObserver *observer);
     QPropertyObserverPointer firstObserver() const;
@@ -104,7 +106,9 @@ struct QPropertyObserverPointer
     void setChangeHandler(QPropertyObserver::ChangeHandler changeHandler);
     void setAliasedProperty(QUntypedPropertyData *propertyPtr);
 
-    void notify(QPropertyBindingPrivate *triggeringBinding, QUntypedPropertyData *propertyDataPtr, const bool alreadyKnownToHaveChanged = false);
+    void notify(QPropertyBindingPrivate *triggeringBinding, QUntypedPropertyData *propertyDataPtr, const bool alreadyKnownToHaveChanged = false,
+                const bool endOfUpdateGroup = false);
+    void markBindingsDirty();
     void observeProperty(QPropertyBindingDataPointer property);
 
     explicit operator bool() const { return ptr != nullptr; }
@@ -172,6 +176,11 @@ private:
     bool hasBindingWrapper:1;
     // used to detect binding loops for eagerly evaluated properties
     bool eagerlyUpdating:1;
+    // marked dirty at the end of an update group, observers not notified yet
+    bool pendingNotification:1;
+    // value changes are recorded until the change handlers have been called
+    bool trackingValueChange:1;
+    bool valueChangedInUpdateGroup:1;
 
     const QtPrivate::BindingFunctionVTable *vtable;
 
@@ -208,6 +217,9 @@ public:
                             const QPropertyBindingSourceLocation &location)
         : hasBindingWrapper(false)
         , eagerlyUpdating(false)
+        , pendingNotification(false)
+        , trackingValueChange(false)
+        , valueChangedInUpdateGroup(false)
         , vtable(vtable)
         , inlineDependencyObservers() // Explicit initialization required because of union
         , location(location)
@@ -283,6 +295,14 @@ public:
     void unlinkAndDeref();
 
     void markDirtyAndNotifyObservers();
+    void markDirtyForUpdateGroup();
+    void notifyAfterUpdateGroup();
+    bool takeValueChangedInUpdateGroup()
+    {
+        const bool changed = valueChangedInUpdateGroup;
+        valueChangedInUpdateGroup = false;
+        return changed;
+    }
     bool evaluateIfDirtyAndReturnTrueIfValueChanged(const QUntypedPropertyData *data);
 
     static QPropertyBindingPrivate *get(const QUntypedPropertyBinding &binding)
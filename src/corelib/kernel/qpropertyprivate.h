@@ -240,19 +240,9 @@ public:
     void registerWithCurrentlyEvaluatingBinding() const;
     void notifyObservers(QUntypedPropertyData *propertyDataPtr) const;
 
-    void setExtraBit(bool b)
-    {
-        if (b)
-            d_ptr |= ExtraBit;
-        else
-            d_ptr &= ~ExtraBit;
-    }
-
-    bool extraBit() const { return d_ptr & ExtraBit; }
-
-    static const quintptr ExtraBit = 0x1;   // Used for QProperty<bool> specialization
+    static const quintptr DelayedNotificationBit = 0x1; // Are observers notified at the end of an update group?
     static const quintptr BindingBit = 0x2; // Is d_ptr pointing to a binding (1) or list of notifiers (0)?
-    static const quintptr FlagMask = BindingBit | ExtraBit;
+    static const quintptr FlagMask = BindingBit | DelayedNotificationBit;
 };
 
 template <typename T, typename Tag>
@@ -39,9 +39,6 @@
 
 #include "qmimeglobpattern_p.h"
 
-#if QT_CONFIG(regularexpression)
-#include <QRegularExpression>
-#endif
 #include <QStringList>
 #include <QDebug>
 
@@ -97,70 +94,94 @@ void QMimeGlobMatchResult::addMatch(const QString &mimeType, int weight, const Q
     \sa QMimeType, QMimeDatabase, QMimeMagicRuleMatcher, QMimeMagicRule
 */
 
+QMimeGlobPattern::PatternType QMimeGlobPattern::detectPatternType(const QString &pattern)
+{
+    const int patternLength = pattern.length();
+    if (!patternLength)
+        return OtherPattern;
+
+    const int starCount = pattern.count(QLatin1Char('*'));
+    const bool hasSquareBracket = pattern.indexOf(QLatin1Char('[')) != -1;
+    const bool hasQuestionMark = pattern.indexOf(QLatin1Char('?')) != -1;
+
+    if (!hasSquareBracket && !hasQuestionMark) {
+        if (starCount == 0) {
+            // Names without any wildcards like "README"
+            return LiteralPattern;
+        } else if (starCount == 1) {
+            // Patterns like "*~", "*.extension"
+            if (pattern.at(0) == QLatin1Char('*'))
+                return SuffixPattern;
+            // Patterns like "README*" (well this is currently the only one like that...)
+            if (pattern.at(patternLength - 1) == QLatin1Char('*'))
+                return PrefixPattern;
+        } else if (starCount == 2 && patternLength > 2 && pattern.at(0) == QLatin1Char('*')
+                   && pattern.at(patternLength - 1) == QLatin1Char('*')) {
+            // Patterns like "*foo*"
+            return SubstringPattern;
+        }
+    }
+    // Other (quite rare) patterns, like "*.anim[1-9j]"
+    return OtherPattern;
+}
+
 bool QMimeGlobPattern::matchFileName(const QString &inputFilename) const
 {
     // "Applications MUST match globs case-insensitively, except when the case-sensitive
     // attribute is set to true."
     // The constructor takes care of putting case-insensitive patterns in lowercase.
-    const QString filename = m_caseSensitivity == Qt::CaseInsensitive ? inputFilename.toLower() : inputFilename;
+    if (m_caseSensitivity == Qt::CaseSensitive)
+        return matchFileName(inputFilename, QString());
+    return matchFileName(inputFilename, inputFilename.toLower());
+}
+
+/*!
+    \internal
+    Returns \c true if \a inputFilename matches this pattern. \a lowerFileName must be
+    \a inputFilename in lowercase; it is used for case-insensitive patterns, so that
+    callers matching one file name against many patterns only have to convert it once.
+*/
+bool QMimeGlobPattern::matchFileName(const QString &inputFilename, const QString &lowerFileName) const
+{
+    const QString &filename = m_caseSensitivity == Qt::CaseInsensitive ? lowerFileName : inputFilename;
 
     const int pattern_len = m_pattern.length();
     if (!pattern_len)
         return false;
     const int len = filename.length();
 
-    const int starCount = m_pattern.count(QLatin1Char('*'));
-
-    // Patterns like "*~", "*.extension"
-    if (m_pattern[0] == QLatin1Char('*') && m_pattern.indexOf(QLatin1Char('[')) == -1 && starCount == 1)
-    {
-        if (len + 1 < pattern_len) return false;
-
-        const QChar *c1 = m_pattern.unicode() + pattern_len - 1;
-        const QChar *c2 = filename.unicode() + len - 1;
-        int cnt = 1;
-        while (cnt < pattern_len && *c1-- == *c2--)
-            ++cnt;
-        return cnt == pattern_len;
+    switch (m_patternType) {
+    case SuffixPattern:
+        if (len + 1 < pattern_len)
+            return false;
+        return filename.endsWith(QStringView{m_pattern}.mid(1));
+    case PrefixPattern:
+        if (len + 1 < pattern_len)
+            return false;
+        return filename.startsWith(QStringView{m_pattern}.chopped(1));
+    case SubstringPattern:
+        return filename.contains(QStringView{m_pattern}.mid(1, pattern_len - 2));
+    case LiteralPattern:
+        return m_pattern == filename;
+    case OtherPattern:
+        break;
     }
 
-    // Patterns like "README*" (well this is currently the only one like that...)
-    if (starCount == 1 && m_pattern.at(pattern_len - 1) == QLatin1Char('*')) {
-        if (len + 1 < pattern_len) return false;
-        if (m_pattern.at(0) == QLatin1Char('*'))
-            return filename.indexOf(QStringView{m_pattern}.mid(1, pattern_len - 2)) != -1;
-
-        const QChar *c1 = m_pattern.unicode();
-        const QChar *c2 = filename.unicode();
-        int cnt = 1;
-        while (cnt < pattern_len && *c1++ == *c2++)
-           ++cnt;
-        return cnt == pattern_len;
-    }
-
-    // Names without any wildcards like "README"
-    if (m_pattern.indexOf(QLatin1Char('[')) == -1 && starCount == 0 && m_pattern.indexOf(QLatin1Char('?')))
-        return (m_pattern == filename);
-
-    // Other (quite rare) patterns, like "*.anim[1-9j]": use slow but correct method
+    // Use the slow but correct method, with the expression compiled by the constructor
 #if QT_CONFIG(regularexpression)
-    auto rx = QRegularExpression::fromWildcard(m_pattern);
-    return rx.match(filename).hasMatch();
+    return m_regularExpression.match(filename).hasMatch();
 #else
     return false;
 #endif
 }
 
-static bool isSimplePattern(const QString &pattern)
+static bool isSimplePattern(const QMimeGlobPattern &glob)
 {
-   // starts with "*.", has no other '*'
-   return pattern.lastIndexOf(QLatin1Char('*')) == 0
-      && pattern.length() > 1
-      && pattern.at(1) == QLatin1Char('.') // (other dots are OK, like *.tar.bz2)
-      // and contains no other special character
-      && !pattern.contains(QLatin1Char('?'))
-      && !pattern.contains(QLatin1Char('['))
-      ;
+   // starts with "*.", has no other '*' (other dots are OK, like *.tar.bz2)
+   // and contains no other special character
+   return glob.patternType() == QMimeGlobPattern::SuffixPattern
+      && glob.pattern().length() > 1
+      && glob.pattern().at(1) == QLatin1Char('.');
 }
 
 static bool isFastPattern(const QString &pattern)
@@ -209,16 +230,16 @@ void QMimeAllGlobPatterns::removeMimeType(const QString &mimeType)
 }
 
 void QMimeGlobPatternList::match(QMimeGlobMatchResult &result,
-                                 const QString &fileName) const
+                                 const QString &fileName, const QString &lowerFileName) const
 {
 
     QMimeGlobPatternList::const_iterator it = this->constBegin();
     const QMimeGlobPatternList::const_iterator endIt = this->constEnd();
     for (; it != endIt; ++it) {
         const QMimeGlobPattern &glob = *it;
-        if (glob.matchFileName(fileName)) {
-            const QString pattern = glob.pattern();
-            const int suffixLen = isSimplePattern(pattern) ? pattern.length() - 2 : 0;
+        if (glob.matchFileName(fileName, lowerFileName)) {
+            const QString &pattern = glob.pattern();
+            const int suffixLen = isSimplePattern(glob) ? pattern.length() - 2 : 0;
             result.addMatch(glob.mimeType(), glob.weight(), pattern, suffixLen);
         }
     }
@@ -226,27 +247,32 @@ void QMimeGlobPatternList::match(QMimeGlobMatchResult &result,
 
 void QMimeAllGlobPatterns::matchingGlobs(const QString &fileName, QMimeGlobMatchResult &result) const
 {
+    // Case-insensitive patterns are stored in lowercase, so convert the file name only once
+    // instead of once per pattern.
+    const QString lowerFileName = fileName.toLower();
+
     // First try the high weight matches (>50), if any.
-    m_highWeightGlobs.match(result, fileName);
+    m_highWeightGlobs.match(result, fileName, lowerFileName);
 
     // Now use the "fast patterns" dict, for simple *.foo patterns with weight 50
     // (which is most of them, so this optimization is definitely worth it)
-    const int lastDot = fileName.lastIndexOf(QLatin1Char('.'));
+    const int lastDot = lowerFileName.lastIndexOf(QLatin1Char('.'));
     if (lastDot != -1) { // if no '.', skip the extension lookup
-        const int ext_len = fileName.length() - lastDot - 1;
-        const QString simpleExtension = fileName.right(ext_len).toLower();
-        // (toLower because fast patterns are always case-insensitive and saved as lowercase)
+        // (lowercase because fast patterns are always case-insensitive and saved as lowercase)
+        const QString simpleExtension = lowerFileName.mid(lastDot + 1);
 
-        const QStringList matchingMimeTypes = m_fastPatterns.value(simpleExtension);
-        const QString simplePattern = QLatin1String("*.") + simpleExtension;
-        for (const QString &mime : matchingMimeTypes)
-            result.addMatch(mime, 50, simplePattern, simpleExtension.size());
+        const auto it = m_fastPatterns.constFind(simpleExtension);
+        if (it != m_fastPatterns.constEnd()) {
+            const QString simplePattern = QLatin1String("*.") + simpleExtension;
+            for (const QString &mime : it.value())
+                result.addMatch(mime, 50, simplePattern, simpleExtension.size());
+        }
         // Can't return yet; *.tar.bz2 has to win over *.bz2, so we need the low-weight mimetypes anyway,
         // at least those with weight 50.
     }
 
     // Finally, try the low weight matches (<=50)
-    m_lowWeightGlobs.match(result, fileName);
+    m_lowWeightGlobs.match(result, fileName, lowerFileName);
 }
 
 void QMimeAllGlobPatterns::clear()
@@ -57,6 +57,9 @@ QT_REQUIRE_CONFIG(mimetype);
 
 #include <QtCore/qstringlist.h>
 #include <QtCore/qhash.h>
+#if QT_CONFIG(regularexpression)
+#include <QtCore/qregularexpression.h>
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -78,10 +81,23 @@ public:
     static const unsigned DefaultWeight = 50;
     static const unsigned MinWeight = 1;
 
+    enum PatternType {
+        SuffixPattern,    // "*.txt", "*~"
+        PrefixPattern,    // "README*"
+        SubstringPattern, // "*foo*"
+        LiteralPattern,   // "Makefile"
+        OtherPattern      // "*.anim[1-9j]", matched with a regular expression
+    };
+
     explicit QMimeGlobPattern(const QString &thePattern, const QString &theMimeType, unsigned theWeight = DefaultWeight, Qt::CaseSensitivity s = Qt::CaseInsensitive) :
         m_pattern(s == Qt::CaseInsensitive ? thePattern.toLower() : thePattern),
-        m_mimeType(theMimeType), m_weight(theWeight), m_caseSensitivity(s)
+        m_mimeType(theMimeType), m_weight(theWeight), m_caseSensitivity(s),
+        m_patternType(detectPatternType(m_pattern))
     {
+#if QT_CONFIG(regularexpression)
+        if (m_patternType == OtherPattern)
+            m_regularExpression = QRegularExpression::fromWildcard(m_pattern);
+#endif
     }
 
     void swap(QMimeGlobPattern &other) noexcept
@@ -90,20 +106,32 @@ public:
         qSwap(m_mimeType,        other.m_mimeType);
         qSwap(m_weight,          other.m_weight);
         qSwap(m_caseSensitivity, other.m_caseSensitivity);
+        qSwap(m_patternType,     other.m_patternType);
+#if QT_CONFIG(regularexpression)
+        qSwap(m_regularExpression, other.m_regularExpression);
+#endif
     }
 
     bool matchFileName(const QString &filename) const;
+    bool matchFileName(const QString &filename, const QString &lowerFileName) const;
 
     inline const QString &pattern() const { return m_pattern; }
     inline unsigned weight() const { return m_weight; }
     inline const QString &mimeType() const { return m_mimeType; }
     inline bool isCaseSensitive() const { return m_caseSensitivity == Qt::CaseSensitive; }
+    inline PatternType patternType() const { return m_patternType; }
 
 private:
+    static PatternType detectPatternType(const QString &pattern);
+
     QString m_pattern;
     QString m_mimeType;
     int m_weight;
     Qt::CaseSensitivity m_caseSensitivity;
+    PatternType m_patternType;
+#if QT_CONFIG(regularexpression)
+    QRegularExpression m_regularExpression;
+#endif
 };
 Q_DECLARE_SHARED(QMimeGlobPattern)
 
@@ -131,7 +159,7 @@ public:
         erase(std::remove_if(begin(), end(), isMimeTypeEqual), end());
     }
 
-    void match(QMimeGlobMatchResult &result, const QString &fileName) const;
+    void match(QMimeGlobMatchResult &result, const QString &fileName, const QString &lowerFileName) const;
 };
 
 /*!
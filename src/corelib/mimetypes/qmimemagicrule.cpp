@@ -133,8 +133,10 @@ bool QMimeMagicRule::matchSubstring(const char *dataPtr, int dataSize, int range
                     break;
                 }
             }
-            if (valid)
+            if (valid) {
                 found = true;
+                break;
+            }
         }
         if (!found)
             return false;
@@ -146,7 +148,9 @@ bool QMimeMagicRule::matchSubstring(const char *dataPtr, int dataSize, int range
 bool QMimeMagicRule::matchString(const QByteArray &data) const
 {
     const int rangeLength = m_endPos - m_startPos + 1;
-    return QMimeMagicRule::matchSubstring(data.constData(), data.size(), m_startPos, rangeLength, m_pattern.size(), m_pattern.constData(), m_mask.constData());
+    // Most string rules have no mask; let them use the memcmp() based search
+    const char *mask = m_mask.isEmpty() ? nullptr : m_mask.constData();
+    return QMimeMagicRule::matchSubstring(data.constData(), data.size(), m_startPos, rangeLength, m_pattern.size(), m_pattern.constData(), mask);
 }
 
 template <typename T>
@@ -282,9 +286,11 @@ QMimeMagicRule::QMimeMagicRule(const QString &type,
                     *errorString = QLatin1String("Invalid magic rule mask size \"") + QLatin1String(m_mask) + QLatin1Char('"');
                 return;
             }
-            m_mask = tempMask;
-        } else {
-            m_mask.fill(char(-1), m_pattern.size());
+            // An all-ones mask is the same as no mask at all
+            if (tempMask.count(char(-1)) == tempMask.size())
+                m_mask.clear();
+            else
+                m_mask = tempMask;
         }
         m_mask.squeeze();
         m_matchFunction = &QMimeMagicRule::matchString;
@@ -331,12 +337,58 @@ QByteArray QMimeMagicRule::mask() const
 {
     QByteArray result = m_mask;
     if (m_type == String) {
+        // an unmasked string is stored without a mask
+        if (result.isEmpty())
+            result.fill(char(-1), m_pattern.size());
         // restore '0x'
         result = "0x" + result.toHex();
     }
     return result;
 }
 
+template <typename T>
+static int leadingNumberByte(quint32 number, quint32 numberMask)
+{
+    // the first byte of data that matchNumber() compares against
+    uchar value[sizeof(T)];
+    uchar mask[sizeof(T)];
+    qToUnaligned(T(number), value);
+    qToUnaligned(T(numberMask), mask);
+    return mask[0] == 0xff ? value[0] : -1;
+}
+
+/*!
+    \internal
+    Returns the byte that data must start with for this rule to match, or -1 if
+    the rule is not anchored at offset 0 or its first byte is masked.
+    This lets QMimeMagicRuleMatcher skip most rules without evaluating them.
+*/
+int QMimeMagicRule::leadingByte() const
+{
+    if (!isValid() || m_startPos != 0 || m_endPos != 0)
+        return -1;
+
+    switch (m_type) {
+    case String:
+        if (m_pattern.isEmpty() || (!m_mask.isEmpty() && uchar(m_mask.at(0)) != 0xff))
+            return -1;
+        return uchar(m_pattern.at(0));
+    case Byte:
+        return leadingNumberByte<quint8>(m_number, m_numberMask);
+    case Host16:
+    case Big16:
+    case Little16:
+        return leadingNumberByte<quint16>(m_number, m_numberMask);
+    case Host32:
+    case Big32:
+    case Little32:
+        return leadingNumberByte<quint32>(m_number, m_numberMask);
+    default:
+        break;
+    }
+    return -1;
+}
+
 bool QMimeMagicRule::matches(const QByteArray &data) const
 {
     const bool ok = m_matchFunction && (this->*m_matchFunction)(data);
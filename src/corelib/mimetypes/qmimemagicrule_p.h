@@ -92,6 +92,8 @@ public:
 
     bool isValid() const { return m_matchFunction != nullptr; }
 
+    int leadingByte() const;
+
     bool matches(const QByteArray &data) const;
 
     QList<QMimeMagicRule> m_subMatches;
@@ -74,11 +74,18 @@ bool QMimeMagicRuleMatcher::operator==(const QMimeMagicRuleMatcher &other) const
 void QMimeMagicRuleMatcher::addRule(const QMimeMagicRule &rule)
 {
     m_list.append(rule);
+
+    const int leadingByte = rule.leadingByte();
+    if (leadingByte < 0)
+        m_anchored = false;
+    else
+        m_leadingBytes[leadingByte >> 6] |= Q_UINT64_C(1) << (leadingByte & 63);
 }
 
 void QMimeMagicRuleMatcher::addRules(const QList<QMimeMagicRule> &rules)
 {
-    m_list.append(rules);
+    for (const QMimeMagicRule &rule : rules)
+        addRule(rule);
 }
 
 QList<QMimeMagicRule> QMimeMagicRuleMatcher::magicRules() const
@@ -89,6 +96,16 @@ QList<QMimeMagicRule> QMimeMagicRuleMatcher::magicRules() const
 // Check for a match on contents of a file
 bool QMimeMagicRuleMatcher::matches(const QByteArray &data) const
 {
+    // Most matchers only have rules for magic numbers at the start of the data,
+    // so the first byte alone rules out nearly all of them.
+    if (m_anchored) {
+        if (data.isEmpty())
+            return false;
+        const uchar first = uchar(data.at(0));
+        if (!(m_leadingBytes[first >> 6] & (Q_UINT64_C(1) << (first & 63))))
+            return false;
+    }
+
     for (const QMimeMagicRule &magicRule : m_list) {
         if (magicRule.matches(data))
             return true;
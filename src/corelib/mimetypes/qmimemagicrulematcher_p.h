@@ -68,9 +68,11 @@ public:
 
     void swap(QMimeMagicRuleMatcher &other) noexcept
     {
-        qSwap(m_list,     other.m_list);
-        qSwap(m_priority, other.m_priority);
-        qSwap(m_mimetype, other.m_mimetype);
+        qSwap(m_list,         other.m_list);
+        qSwap(m_priority,     other.m_priority);
+        qSwap(m_mimetype,     other.m_mimetype);
+        qSwap(m_leadingBytes, other.m_leadingBytes);
+        qSwap(m_anchored,     other.m_anchored);
     }
 
     bool operator==(const QMimeMagicRuleMatcher &other) const;
@@ -89,6 +91,9 @@ private:
     QList<QMimeMagicRule> m_list;
     unsigned m_priority;
     QString m_mimetype;
+    // When every rule is anchored at offset 0, the set of bytes the data can start with
+    quint64 m_leadingBytes[4] = {};
+    bool m_anchored = true;
 };
 Q_DECLARE_SHARED(QMimeMagicRuleMatcher)
 
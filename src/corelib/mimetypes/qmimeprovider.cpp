@@ -54,6 +54,8 @@
 #include <QDateTime>
 #include <QtEndian>
 
+#include <algorithm>
+
 #if QT_CONFIG(mimetype_database)
 #  if defined(Q_CC_MSVC)
 #    pragma section(".qtmimedatabase", read, shared)
@@ -243,9 +245,9 @@ void QMimeBinaryProvider::addFileNameMatches(const QString &fileName, QMimeGlobM
     Q_ASSERT(m_cacheFile);
     const QString lowerFileName = fileName.toLower();
     // Check literals (e.g. "Makefile")
-    matchGlobList(result, m_cacheFile, m_cacheFile->getUint32(PosLiteralListOffset), fileName);
+    matchGlobList(result, m_cacheFile, m_cacheFile->getUint32(PosLiteralListOffset), fileName, lowerFileName);
     // Check complex globs (e.g. "callgrind.out[0-9]*")
-    matchGlobList(result, m_cacheFile, m_cacheFile->getUint32(PosGlobListOffset), fileName);
+    matchGlobList(result, m_cacheFile, m_cacheFile->getUint32(PosGlobListOffset), fileName, lowerFileName);
     // Check the very common *.txt cases with the suffix tree
     const int reverseSuffixTreeOffset = m_cacheFile->getUint32(PosReverseSuffixTreeOffset);
     const int numRoots = m_cacheFile->getUint32(reverseSuffixTreeOffset);
@@ -255,7 +257,8 @@ void QMimeBinaryProvider::addFileNameMatches(const QString &fileName, QMimeGlobM
         matchSuffixTree(result, m_cacheFile, numRoots, firstRootOffset, fileName, fileName.length() - 1, true);
 }
 
-void QMimeBinaryProvider::matchGlobList(QMimeGlobMatchResult &result, CacheFile *cacheFile, int off, const QString &fileName)
+void QMimeBinaryProvider::matchGlobList(QMimeGlobMatchResult &result, CacheFile *cacheFile, int off, const QString &fileName,
+                                        const QString &lowerFileName)
 {
     const int numGlobs = cacheFile->getUint32(off);
     //qDebug() << "Loading" << numGlobs << "globs from" << cacheFile->file.fileName() << "at offset" << cacheFile->globListOffset;
@@ -272,8 +275,7 @@ void QMimeBinaryProvider::matchGlobList(QMimeGlobMatchResult &result, CacheFile
         //qDebug() << pattern << mimeType << weight << caseSensitive;
         QMimeGlobPattern glob(pattern, QString() /*unused*/, weight, qtCaseSensitive);
 
-        // TODO: this could be done faster for literals where a simple == would do.
-        if (glob.matchFileName(fileName))
+        if (glob.matchFileName(fileName, lowerFileName))
             result.addMatch(QLatin1String(mimeType), weight, pattern);
     }
 }
@@ -719,20 +721,18 @@ void QMimeXMLProvider::addFileNameMatches(const QString &fileName, QMimeGlobMatc
 
 void QMimeXMLProvider::findByMagic(const QByteArray &data, int *accuracyPtr, QMimeType &candidate)
 {
-    QString candidateName;
-    bool foundOne = false;
+    // m_magicMatchers is sorted by decreasing priority (see addMagicMatcher()), so the
+    // first match wins, and we can stop as soon as no matcher can improve the accuracy.
     for (const QMimeMagicRuleMatcher &matcher : qAsConst(m_magicMatchers)) {
+        const int priority = matcher.priority();
+        if (priority <= *accuracyPtr)
+            break;
         if (matcher.matches(data)) {
-            const int priority = matcher.priority();
-            if (priority > *accuracyPtr) {
-                *accuracyPtr = priority;
-                candidateName = matcher.mimetype();
-                foundOne = true;
-            }
+            *accuracyPtr = priority;
+            candidate = mimeTypeForName(matcher.mimetype());
+            return;
         }
     }
-    if (foundOne)
-        candidate = mimeTypeForName(candidateName);
 }
 
 void QMimeXMLProvider::ensureLoaded()
@@ -859,7 +859,14 @@ void QMimeXMLProvider::addAllMimeTypes(QList<QMimeType> &result)
 
 void QMimeXMLProvider::addMagicMatcher(const QMimeMagicRuleMatcher &matcher)
 {
-    m_magicMatchers.append(matcher);
+    // Keep the list sorted by decreasing priority, and in file order for equal
+    // priorities, so that findByMagic() can return the first match.
+    const auto hasHigherPriority = [](const QMimeMagicRuleMatcher &lhs, const QMimeMagicRuleMatcher &rhs) {
+        return lhs.priority() > rhs.priority();
+    };
+    const auto it = std::upper_bound(m_magicMatchers.begin(), m_magicMatchers.end(), matcher,
+                                     hasHigherPriority);
+    m_magicMatchers.insert(it, matcher);
 }
 
 QT_END_NAMESPACE
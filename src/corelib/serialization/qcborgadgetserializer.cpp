@@ -0,0 +1,632 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qcborgadgetserializer.h"
+
+#include "qcborstreamreader.h"
+#include "qcborstreamwriter.h"
+#include "qcborvalue.h"
+
+#include <private/qmetaobject_p.h>
+#include <qhash.h>
+#include <qlist.h>
+#include <qmetaobject.h>
+#include <qreadwritelock.h>
+#include <qvariant.h>
+
+#include <limits>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QCborGadgetSerializer
+    \inmodule QtCore
+    \ingroup cbor
+    \reentrant
+    \since 6.0
+
+    \brief The QCborGadgetSerializer class converts Q_GADGET values to and
+    from a compact CBOR representation, using their properties.
+
+    QCborGadgetSerializer writes a gadget as a CBOR array containing the
+    values of its stored, readable properties (see Q_PROPERTY), in the order
+    they are declared, starting with the properties of the base classes. The
+    property names are not written: the class itself is the schema, so the
+    reader and the writer must agree on it.
+
+    \snippet code/src_corelib_serialization_qcborgadgetserializer.cpp 0
+
+    The property values are read and written through the code generated by
+    moc, without going through QVariant, and the way each property is encoded
+    is determined once per class and then cached. Properties of the following
+    types are encoded directly:
+
+    \list
+      \li \c bool, the integer types and enumerations registered with Q_ENUM,
+          as CBOR booleans and integers;
+      \li \c qfloat16, \c float and \c double, as CBOR floating point numbers
+          of the same precision;
+      \li QString and QByteArray, as CBOR text and byte strings;
+      \li other Q_GADGET types, recursively, as nested arrays.
+    \endlist
+
+    Properties of any other type are converted with QCborValue::fromVariant()
+    and QCborValue::toVariant().
+
+    When reading, elements missing at the end of the array leave the
+    corresponding properties unchanged, and additional elements are skipped,
+    so properties can be added to the end of a class without breaking
+    existing data. Properties that are not writable are skipped as well.
+
+    \sa QCborStreamWriter, QCborStreamReader, QMetaProperty
+*/
+
+namespace {
+struct GadgetPlan;
+
+struct PropertyPlan
+{
+    enum Kind : quint8 {
+        Bool,
+        Signed,
+        Unsigned,
+        Float16,
+        Float,
+        Double,
+        String,
+        ByteArray,
+        Gadget,
+        Variant,
+        Other
+    };
+
+    QMetaObject::Data::StaticMetacallFunction metacall;
+    const GadgetPlan *gadget;   // for Kind == Gadget
+    QMetaType type;
+    int index;                  // relative to the class declaring the property
+    Kind kind;
+    bool writable;
+};
+
+struct GadgetPlan
+{
+    QList<PropertyPlan> properties;
+};
+
+struct GadgetPlanCache
+{
+    ~GadgetPlanCache() { qDeleteAll(plans); }
+
+    QReadWriteLock lock;
+    QHash<const QMetaObject *, const GadgetPlan *> plans;
+};
+
+// Storage for one property value, on the stack for small types
+class PropertyValue
+{
+    Q_DISABLE_COPY_MOVE(PropertyValue)
+public:
+    explicit PropertyValue(QMetaType type)
+        : type(type), ptr(buffer)
+    {
+        if (type.sizeOf() <= qsizetype(sizeof(buffer))
+                && type.alignOf() <= qsizetype(alignof(std::max_align_t)))
+            type.construct(buffer);
+        else
+            ptr = type.create();
+    }
+    ~PropertyValue()
+    {
+        if (ptr == buffer)
+            type.destruct(ptr);
+        else
+            type.destroy(ptr);
+    }
+
+    void *data() const { return ptr; }
+    void assign(const void *copy)
+    {
+        if (copy == ptr)
+            return;
+        type.destruct(ptr);
+        type.construct(ptr, copy);
+    }
+
+private:
+    QMetaType type;
+    void *ptr;
+    alignas(std::max_align_t) char buffer[64];
+};
+}
+
+Q_GLOBAL_STATIC(GadgetPlanCache, gadgetPlanCache)
+
+static PropertyPlan::Kind kindOf(QMetaType type)
+{
+    if (type == QMetaType::fromType<qfloat16>())
+        return PropertyPlan::Float16;
+
+    switch (type.id()) {
+    case QMetaType::Bool:
+        return PropertyPlan::Bool;
+    case QMetaType::Char:
+        return std::numeric_limits<char>::is_signed ? PropertyPlan::Signed : PropertyPlan::Unsigned;
+    case QMetaType::SChar:
+    case QMetaType::Short:
+    case QMetaType::Int:
+    case QMetaType::Long:
+    case QMetaType::LongLong:
+        return PropertyPlan::Signed;
+    case QMetaType::UChar:
+    case QMetaType::Char16:
+    case QMetaType::Char32:
+    case QMetaType::UShort:
+    case QMetaType::UInt:
+    case QMetaType::ULong:
+    case QMetaType::ULongLong:
+        return PropertyPlan::Unsigned;
+    case QMetaType::Float:
+        return PropertyPlan::Float;
+    case QMetaType::Double:
+        return PropertyPlan::Double;
+    case QMetaType::QString:
+        return PropertyPlan::String;
+    case QMetaType::QByteArray:
+        return PropertyPlan::ByteArray;
+    case QMetaType::QVariant:
+        return PropertyPlan::Variant;
+    }
+
+    const QMetaType::TypeFlags flags = type.flags();
+    if (flags & QMetaType::IsEnumeration) {
+        return flags & QMetaType::IsUnsignedEnumeration ? PropertyPlan::Unsigned
+                                                        : PropertyPlan::Signed;
+    }
+    if (flags & QMetaType::IsGadget && type.metaObject())
+        return PropertyPlan::Gadget;
+    return PropertyPlan::Other;
+}
+
+static const GadgetPlan *gadgetPlan(const QMetaObject *metaObject)
+{
+    GadgetPlanCache *cache = gadgetPlanCache();
+    {
+        QReadLocker locker(&cache->lock);
+        if (const GadgetPlan *plan = cache->plans.value(metaObject))
+            return plan;
+    }
+
+    // Build the plan without holding the lock: nested gadgets need their own.
+    auto plan = std::make_unique<GadgetPlan>();
+    for (int i = 0; i < metaObject->propertyCount(); ++i) {
+        const QMetaProperty property = metaObject->property(i);
+        if (!property.isReadable() || !property.isStored())
+            continue;
+
+        const QMetaObject *enclosing = property.enclosingMetaObject();
+        Q_ASSERT_X(QMetaObjectPrivate::get(enclosing)->flags & PropertyAccessInStaticMetaCall
+                   && enclosing->d.static_metacall,
+                   "QCborGadgetSerializer", "Only Q_GADGET classes are supported");
+
+        PropertyPlan p;
+        p.metacall = enclosing->d.static_metacall;
+        p.gadget = nullptr;
+        p.type = property.metaType();
+        p.index = property.relativePropertyIndex();
+        p.kind = kindOf(p.type);
+        p.writable = property.isWritable();
+        if (p.kind == PropertyPlan::Gadget)
+            p.gadget = gadgetPlan(p.type.metaObject());
+        plan->properties.append(p);
+    }
+
+    QWriteLocker locker(&cache->lock);
+    const GadgetPlan *&entry = cache->plans[metaObject];
+    if (!entry)
+        entry = plan.release();
+    return entry;
+}
+
+static const void *readProperty(const PropertyPlan &p, const void *gadget, void *storage)
+{
+    // moc replaces argv[0] for properties that are read by pointer or reference
+    int status = -1;
+    void *argv[] = { storage, nullptr, &status };
+    p.metacall(reinterpret_cast<QObject *>(const_cast<void *>(gadget)),
+               QMetaObject::ReadProperty, p.index, argv);
+    return argv[0];
+}
+
+static void writeProperty(const PropertyPlan &p, void *gadget, void *value)
+{
+    int status = -1;
+    int flags = 0;
+    void *argv[] = { value, nullptr, &status, &flags };
+    p.metacall(reinterpret_cast<QObject *>(gadget), QMetaObject::WriteProperty, p.index, argv);
+}
+
+static qint64 loadSigned(const void *value, qsizetype size)
+{
+    switch (size) {
+    case 1:
+        return *static_cast<const qint8 *>(value);
+    case 2:
+        return *static_cast<const qint16 *>(value);
+    case 4:
+        return *static_cast<const qint32 *>(value);
+    }
+    return *static_cast<const qint64 *>(value);
+}
+
+static quint64 loadUnsigned(const void *value, qsizetype size)
+{
+    switch (size) {
+    case 1:
+        return *static_cast<const quint8 *>(value);
+    case 2:
+        return *static_cast<const quint16 *>(value);
+    case 4:
+        return *static_cast<const quint32 *>(value);
+    }
+    return *static_cast<const quint64 *>(value);
+}
+
+static void storeInteger(void *value, qsizetype size, quint64 v)
+{
+    switch (size) {
+    case 1:
+        *static_cast<quint8 *>(value) = quint8(v);
+        break;
+    case 2:
+        *static_cast<quint16 *>(value) = quint16(v);
+        break;
+    case 4:
+        *static_cast<quint32 *>(value) = quint32(v);
+        break;
+    default:
+        *static_cast<quint64 *>(value) = v;
+        break;
+    }
+}
+
+static void writeGadget(QCborStreamWriter &writer, const GadgetPlan &plan, const void *gadget);
+
+static void writeValue(QCborStreamWriter &writer, const PropertyPlan &p, const void *value)
+{
+    switch (p.kind) {
+    case PropertyPlan::Bool:
+        writer.append(*static_cast<const bool *>(value));
+        break;
+    case PropertyPlan::Signed:
+        writer.append(loadSigned(value, p.type.sizeOf()));
+        break;
+    case PropertyPlan::Unsigned:
+        writer.append(loadUnsigned(value, p.type.sizeOf()));
+        break;
+    case PropertyPlan::Float16:
+        writer.append(*static_cast<const qfloat16 *>(value));
+        break;
+    case PropertyPlan::Float:
+        writer.append(*static_cast<const float *>(value));
+        break;
+    case PropertyPlan::Double:
+        writer.append(*static_cast<const double *>(value));
+        break;
+    case PropertyPlan::String:
+        writer.append(QStringView(*static_cast<const QString *>(value)));
+        break;
+    case PropertyPlan::ByteArray:
+        writer.append(*static_cast<const QByteArray *>(value));
+        break;
+    case PropertyPlan::Gadget:
+        writeGadget(writer, *p.gadget, value);
+        break;
+    case PropertyPlan::Variant:
+        QCborValue::fromVariant(*static_cast<const QVariant *>(value)).toCbor(writer);
+        break;
+    case PropertyPlan::Other:
+        QCborValue::fromVariant(QVariant(p.type, value)).toCbor(writer);
+        break;
+    }
+}
+
+static void writeGadget(QCborStreamWriter &writer, const GadgetPlan &plan, const void *gadget)
+{
+    writer.startArray(quint64(plan.properties.size()));
+    for (const PropertyPlan &p : plan.properties) {
+        PropertyValue storage(p.type);
+        writeValue(writer, p, readProperty(p, gadget, storage.data()));
+    }
+    writer.endArray();
+}
+
+static QCborError::Code readGadget(QCborStreamReader &reader, const GadgetPlan &plan, void *gadget);
+
+static bool readNumber(QCborStreamReader &reader, double *d)
+{
+    switch (reader.type()) {
+    case QCborStreamReader::UnsignedInteger:
+        *d = double(reader.toUnsignedInteger());
+        break;
+    case QCborStreamReader::NegativeInteger:
+        *d = -1.0 - double(quint64(reader.toNegativeInteger()) - 1);
+        break;
+    case QCborStreamReader::Float16:
+        *d = double(reader.toFloat16());
+        break;
+    case QCborStreamReader::Float:
+        *d = double(reader.toFloat());
+        break;
+    case QCborStreamReader::Double:
+        *d = reader.toDouble();
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+static QCborError::Code readInteger(QCborStreamReader &reader, const PropertyPlan &p, void *value)
+{
+    const qsizetype size = p.type.sizeOf();
+    const int bits = 8 * int(size);
+    quint64 max;
+    if (p.kind == PropertyPlan::Signed)
+        max = (quint64(1) << (bits - 1)) - 1;
+    else
+        max = bits < 64 ? (quint64(1) << bits) - 1 : std::numeric_limits<quint64>::max();
+
+    if (reader.isUnsignedInteger()) {
+        const quint64 v = reader.toUnsignedInteger();
+        if (v > max)
+            return QCborError::IllegalNumber;
+        storeInteger(value, size, v);
+    } else if (reader.isNegativeInteger()) {
+        // the value is -1 - n, whose two's complement representation is ~n
+        const quint64 n = quint64(reader.toNegativeInteger()) - 1;
+        if (p.kind != PropertyPlan::Signed || n > max)
+            return QCborError::IllegalNumber;
+        storeInteger(value, size, ~n);
+    } else {
+        return QCborError::IllegalType;
+    }
+    reader.next();
+    return QCborError::NoError;
+}
+
+template <typename String, typename Result>
+static QCborError::Code readString(QCborStreamReader &reader, String *string, Result (QCborStreamReader::*readChunk)())
+{
+    string->clear();
+    auto r = (reader.*readChunk)();
+    while (r.status == QCborStreamReader::Ok) {
+        *string += r.data;
+        r = (reader.*readChunk)();
+    }
+    if (r.status == QCborStreamReader::Error)
+        return reader.lastError();
+    return QCborError::NoError;
+}
+
+static QCborError::Code readValue(QCborStreamReader &reader, const PropertyPlan &p, void *value)
+{
+    if (reader.lastError() != QCborError::NoError)
+        return reader.lastError();
+
+    switch (p.kind) {
+    case PropertyPlan::Bool:
+        if (!reader.isBool())
+            return QCborError::IllegalType;
+        *static_cast<bool *>(value) = reader.toBool();
+        reader.next();
+        break;
+
+    case PropertyPlan::Signed:
+    case PropertyPlan::Unsigned:
+        return readInteger(reader, p, value);
+
+    case PropertyPlan::Float16:
+    case PropertyPlan::Float:
+    case PropertyPlan::Double: {
+        double d;
+        if (!readNumber(reader, &d))
+            return QCborError::IllegalType;
+        if (p.kind == PropertyPlan::Float16)
+            *static_cast<qfloat16 *>(value) = qfloat16(float(d));
+        else if (p.kind == PropertyPlan::Float)
+            *static_cast<float *>(value) = float(d);
+        else
+            *static_cast<double *>(value) = d;
+        reader.next();
+        break;
+    }
+
+    case PropertyPlan::String:
+        if (!reader.isString())
+            return QCborError::IllegalType;
+        return readString(reader, static_cast<QString *>(value), &QCborStreamReader::readString);
+
+    case PropertyPlan::ByteArray:
+        if (!reader.isByteArray())
+            return QCborError::IllegalType;
+        return readString(reader, static_cast<QByteArray *>(value), &QCborStreamReader::readByteArray);
+
+    case PropertyPlan::Gadget:
+        return readGadget(reader, *p.gadget, value);
+
+    case PropertyPlan::Variant:
+    case PropertyPlan::Other: {
+        const QCborValue v = QCborValue::fromCbor(reader);
+        if (reader.lastError() != QCborError::NoError)
+            return reader.lastError();
+        if (p.kind == PropertyPlan::Variant) {
+            *static_cast<QVariant *>(value) = v.toVariant();
+            break;
+        }
+        QVariant variant = v.toVariant();
+        if (!variant.convert(p.type))
+            return QCborError::IllegalType;
+        p.type.destruct(value);
+        p.type.construct(value, variant.constData());
+        break;
+    }
+    }
+    return reader.lastError();
+}
+
+static QCborError::Code readGadget(QCborStreamReader &reader, const GadgetPlan &plan, void *gadget)
+{
+    if (!reader.isArray())
+        return reader.lastError() != QCborError::NoError ? reader.lastError().c
+                                                         : QCborError::IllegalType;
+    if (!reader.enterContainer())
+        return reader.lastError();
+
+    for (const PropertyPlan &p : plan.properties) {
+        if (!reader.hasNext())
+            break;
+        if (!p.writable) {
+            reader.next();
+            continue;
+        }
+
+        PropertyValue value(p.type);
+        if (p.kind == PropertyPlan::Gadget) {
+            // start from the current value, in case the nested array is shorter
+            value.assign(readProperty(p, gadget, value.data()));
+        }
+        const QCborError::Code err = readValue(reader, p, value.data());
+        if (err != QCborError::NoError)
+            return err;
+        writeProperty(p, gadget, value.data());
+    }
+
+    // skip elements this version of the class does not know about
+    while (reader.hasNext() && reader.next()) {
+    }
+    if (reader.lastError() != QCborError::NoError)
+        return reader.lastError();
+    reader.leaveContainer();
+    return reader.lastError();
+}
+
+/*!
+    Writes the stored properties of \a gadget, an instance of the class
+    described by \a metaObject, to \a writer as a CBOR array.
+
+    \sa read(), toCbor()
+*/
+void QCborGadgetSerializer::write(QCborStreamWriter &writer, const QMetaObject *metaObject,
+                                  const void *gadget)
+{
+    writeGadget(writer, *gadgetPlan(metaObject), gadget);
+}
+
+/*!
+    Reads a CBOR array written by write() from \a reader and assigns its
+    elements to the properties of \a gadget, an instance of the class
+    described by \a metaObject. Returns true on success.
+
+    On failure, \a gadget may have been partially modified. If the CBOR data
+    itself is invalid, QCborStreamReader::lastError() reports the error;
+    otherwise, the data did not match the properties of the class.
+
+    \sa write(), fromCbor()
+*/
+bool QCborGadgetSerializer::read(QCborStreamReader &reader, const QMetaObject *metaObject,
+                                 void *gadget)
+{
+    return readGadget(reader, *gadgetPlan(metaObject), gadget) == QCborError::NoError;
+}
+
+/*!
+    Returns the CBOR encoding of \a gadget, an instance of the class described
+    by \a metaObject.
+
+    \sa fromCbor(), write()
+*/
+QByteArray QCborGadgetSerializer::toCbor(const QMetaObject *metaObject, const void *gadget)
+{
+    QByteArray result;
+    QCborStreamWriter writer(&result);
+    write(writer, metaObject, gadget);
+    return result;
+}
+
+/*!
+    Decodes \a data, as returned by toCbor(), into \a gadget, an instance of
+    the class described by \a metaObject. Returns true on success.
+
+    If \a error is not null, it is set to the result of the operation. Data
+    that does not match the properties of the class is reported as
+    QCborError::IllegalType, or as QCborError::IllegalNumber if an integer is
+    out of range for its property.
+
+    \sa toCbor(), read()
+*/
+bool QCborGadgetSerializer::fromCbor(const QByteArray &data, const QMetaObject *metaObject,
+                                     void *gadget, QCborParserError *error)
+{
+    QCborStreamReader reader(data);
+    const QCborError::Code err = readGadget(reader, *gadgetPlan(metaObject), gadget);
+    if (error) {
+        error->error = QCborError{err};
+        error->offset = reader.currentOffset();
+    }
+    return err == QCborError::NoError;
+}
+
+/*!
+    \fn template <typename T> QByteArray QCborGadgetSerializer::toCbor(const T &gadget)
+    \overload
+
+    Returns the CBOR encoding of \a gadget, whose type must be a Q_GADGET
+    class.
+*/
+
+/*!
+    \fn template <typename T> bool QCborGadgetSerializer::fromCbor(const QByteArray &data, T *gadget, QCborParserError *error)
+    \overload
+
+    Decodes \a data into \a gadget, whose type must be a Q_GADGET class. If
+    \a error is not null, it is set to the result of the operation.
+*/
+
+QT_END_NAMESPACE
@@ -0,0 +1,90 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QCBORGADGETSERIALIZER_H
+#define QCBORGADGETSERIALIZER_H
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qcborcommon.h>
+#include <QtCore/qobjectdefs.h>
+
+QT_REQUIRE_CONFIG(cborstreamreader);
+QT_REQUIRE_CONFIG(cborstreamwriter);
+
+// See qcborcommon.h for why we check
+#if defined(QT_X11_DEFINES_FOUND)
+#  undef True
+#  undef False
+#endif
+
+QT_BEGIN_NAMESPACE
+
+struct QCborParserError;
+class QCborStreamReader;
+class QCborStreamWriter;
+
+class Q_CORE_EXPORT QCborGadgetSerializer
+{
+public:
+    static void write(QCborStreamWriter &writer, const QMetaObject *metaObject, const void *gadget);
+    static bool read(QCborStreamReader &reader, const QMetaObject *metaObject, void *gadget);
+
+    static QByteArray toCbor(const QMetaObject *metaObject, const void *gadget);
+    static bool fromCbor(const QByteArray &data, const QMetaObject *metaObject, void *gadget,
+                         QCborParserError *error = nullptr);
+
+    template <typename T>
+    static QByteArray toCbor(const T &gadget)
+    { return toCbor(&T::staticMetaObject, &gadget); }
+    template <typename T>
+    static bool fromCbor(const QByteArray &data, T *gadget, QCborParserError *error = nullptr)
+    { return fromCbor(data, &T::staticMetaObject, gadget, error); }
+
+private:
+    QCborGadgetSerializer() = delete;
+};
+
+QT_END_NAMESPACE
+
+#if defined(QT_X11_DEFINES_FOUND)
+#  define True  1
+#  define False 0
+#endif
+
+#endif // QCBORGADGETSERIALIZER_H
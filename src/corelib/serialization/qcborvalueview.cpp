@@ -0,0 +1,866 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qcborvalueview.h"
+
+#include <private/qstringconverter_p.h>
+#include <qendian.h>
+#include <qfloat16.h>
+#include <qlist.h>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QCborValueView
+    \inmodule QtCore
+    \ingroup cbor
+    \reentrant
+    \since 6.0
+
+    \brief The QCborValueView class provides read-only access to CBOR encoded
+    data without decoding it first.
+
+    QCborValue::fromCbor() decodes a complete CBOR stream into memory: every
+    array and map is expanded and every string is copied. For large items of
+    which only a few parts are needed, QCborValueView provides the same kind
+    of read access directly on the encoded buffer. Nothing is decoded until it
+    is accessed, and strings and byte arrays can be accessed without copying
+    them, using byteArrayView() and utf8StringView().
+
+    \snippet code/src_corelib_serialization_qcborvalueview.cpp 0
+
+    QCborValueView::fromCbor() checks the structure of the encoded item once,
+    so that later accesses never read outside of the buffer. It does not check
+    that text strings are valid UTF-8.
+
+    The view keeps a reference to the QByteArray it was created from. To avoid
+    copying the data into a QByteArray in the first place, create it with
+    QByteArray::fromRawData(); in that case, the data must remain valid for as
+    long as any view into it exists.
+
+    \section1 Containers
+
+    Elements of arrays and maps are located by skipping over the preceding
+    ones. Iterating with begin() and end() visits each element once. Random
+    access with at(), keyAt() or valueAt() is linear in the position of the
+    element, unless an index of the element offsets has been created for that
+    container with createIndex().
+
+    Looking up a key in a map with operator[]() compares the keys in the order
+    they are encoded, without decoding them.
+
+    Views are not modifiable. Use toCborValue() to decode an item, or part of
+    it, when a QCborValue is needed.
+
+    \sa QCborValue, QCborStreamReader
+*/
+
+/*!
+    \class QCborValueView::ConstIterator
+    \inmodule QtCore
+    \since 6.0
+
+    \brief The QCborValueView::ConstIterator class iterates over the elements
+    of an array or the members of a map in a QCborValueView.
+
+    For arrays, the value of an iterator is the current element. For maps, it
+    is the value of the current member, and key() returns the member's key.
+
+    An iterator shares the encoded data with the view it was obtained from,
+    so it remains valid after that view has been destroyed.
+*/
+
+class QCborValueViewIndex : public QSharedData
+{
+public:
+    QList<qsizetype> offsets;
+};
+
+namespace {
+struct ItemHeader
+{
+    quint64 value = 0;      // integer, length or count, or bits of a float
+    qsizetype size = 0;     // of the header itself
+    quint8 majorType = 0;
+    quint8 info = 0;
+    bool indefinite = false;
+};
+}
+
+static const int MaximumRecursionDepth = 1024;
+static const uchar BreakByte = 0xff;
+
+static QCborError::Code readHeader(QByteArrayView data, qsizetype offset, ItemHeader *h)
+{
+    if (offset >= data.size())
+        return QCborError::EndOfFile;
+
+    const uchar *p = reinterpret_cast<const uchar *>(data.data()) + offset;
+    h->majorType = p[0] >> 5;
+    h->info = p[0] & 0x1f;
+    h->indefinite = false;
+    if (h->info < 24) {
+        h->value = h->info;
+        h->size = 1;
+        return QCborError::NoError;
+    }
+    if (h->info == 31) {
+        if (h->majorType == 7)
+            return QCborError::UnexpectedBreak;
+        if (h->majorType < 2 || h->majorType == 6)
+            return QCborError::IllegalNumber;
+        h->value = 0;
+        h->size = 1;
+        h->indefinite = true;
+        return QCborError::NoError;
+    }
+    if (h->info > 27)
+        return QCborError::IllegalNumber;
+
+    const qsizetype n = qsizetype(1) << (h->info - 24);
+    if (data.size() - offset - 1 < n)
+        return QCborError::EndOfFile;
+    switch (n) {
+    case 1:
+        h->value = p[1];
+        break;
+    case 2:
+        h->value = qFromBigEndian<quint16>(p + 1);
+        break;
+    case 4:
+        h->value = qFromBigEndian<quint32>(p + 1);
+        break;
+    case 8:
+        h->value = qFromBigEndian<quint64>(p + 1);
+        break;
+    }
+    h->size = 1 + n;
+    return QCborError::NoError;
+}
+
+// Advances *offset past the item starting there. On error, *offset is left
+// where the error was detected.
+static QCborError::Code skipItem(QByteArrayView data, qsizetype *offset, int depth = 0)
+{
+    qsizetype &pos = *offset;
+    ItemHeader h;
+    QCborError::Code err = readHeader(data, pos, &h);
+    if (err != QCborError::NoError)
+        return err;
+    pos += h.size;
+
+    switch (h.majorType) {
+    case 0:
+    case 1:
+        break;
+
+    case 2:
+    case 3:
+        if (!h.indefinite) {
+            if (h.value > quint64(data.size() - pos))
+                return QCborError::EndOfFile;
+            pos += qsizetype(h.value);
+            break;
+        }
+        forever {
+            if (pos >= data.size())
+                return QCborError::EndOfFile;
+            if (uchar(data[pos]) == BreakByte) {
+                ++pos;
+                break;
+            }
+            ItemHeader chunk;
+            err = readHeader(data, pos, &chunk);
+            if (err != QCborError::NoError)
+                return err;
+            if (chunk.majorType != h.majorType || chunk.indefinite)
+                return QCborError::IllegalType;
+            pos += chunk.size;
+            if (chunk.value > quint64(data.size() - pos))
+                return QCborError::EndOfFile;
+            pos += qsizetype(chunk.value);
+        }
+        break;
+
+    case 4:
+    case 5:
+        if (depth >= MaximumRecursionDepth)
+            return QCborError::NestingTooDeep;
+        if (!h.indefinite) {
+            // every element takes at least one byte
+            if (h.value > quint64(data.size() - pos))
+                return QCborError::EndOfFile;
+            quint64 count = h.majorType == 5 ? h.value * 2 : h.value;
+            while (count--) {
+                err = skipItem(data, &pos, depth + 1);
+                if (err != QCborError::NoError)
+                    return err;
+            }
+            break;
+        }
+        for (quint64 count = 0; ; ++count) {
+            if (pos >= data.size())
+                return QCborError::EndOfFile;
+            if (uchar(data[pos]) == BreakByte) {
+                if (h.majorType == 5 && count % 2)
+                    return QCborError::UnexpectedBreak;
+                ++pos;
+                break;
+            }
+            err = skipItem(data, &pos, depth + 1);
+            if (err != QCborError::NoError)
+                return err;
+        }
+        break;
+
+    case 6:
+        if (depth >= MaximumRecursionDepth)
+            return QCborError::NestingTooDeep;
+        return skipItem(data, &pos, depth + 1);
+
+    case 7:
+        if (h.info == 24 && h.value < 32)
+            return QCborError::IllegalSimpleType;
+        break;
+    }
+    return QCborError::NoError;
+}
+
+// Concatenates the chunks of an indefinite-length string
+static QByteArray concatenateChunks(QByteArrayView data, qsizetype pos)
+{
+    QByteArray result;
+    while (uchar(data[pos]) != BreakByte) {
+        ItemHeader chunk;
+        readHeader(data, pos, &chunk);
+        result.append(data.data() + pos + chunk.size, qsizetype(chunk.value));
+        pos += chunk.size + qsizetype(chunk.value);
+    }
+    return result;
+}
+
+/*!
+    Constructs an invalid view.
+
+    \sa isValid()
+*/
+QCborValueView::QCborValueView() noexcept = default;
+
+/*!
+    Constructs a copy of \a other. The copy shares the index, if any.
+*/
+QCborValueView::QCborValueView(const QCborValueView &other) = default;
+
+/*!
+    Move-constructs a view from \a other.
+*/
+QCborValueView::QCborValueView(QCborValueView &&other) noexcept = default;
+
+/*!
+    Makes this view a copy of \a other and returns a reference to it.
+*/
+QCborValueView &QCborValueView::operator=(const QCborValueView &other) = default;
+
+/*!
+    Move-assigns \a other to this view and returns a reference to it.
+*/
+QCborValueView &QCborValueView::operator=(QCborValueView &&other) noexcept = default;
+
+/*!
+    Destroys the view.
+*/
+QCborValueView::~QCborValueView() = default;
+
+/*!
+    \fn void QCborValueView::swap(QCborValueView &other)
+
+    Swaps this view with \a other. This operation is very fast and never
+    fails.
+*/
+
+QCborValueView::QCborValueView(const QByteArray &data, qsizetype offset)
+    : data(data), offset(offset)
+{
+}
+
+/*!
+    Returns a view of the CBOR item at the beginning of \a data. If the item
+    is not well-formed, an invalid view is returned and, if \a error is not
+    null, it is set to the error and the offset where it was detected. Any
+    data following the first item is ignored, as QCborValue::fromCbor() does.
+
+    \sa isValid(), toCborValue()
+*/
+QCborValueView QCborValueView::fromCbor(const QByteArray &data, QCborParserError *error)
+{
+    qsizetype end = 0;
+    const QCborError::Code err = skipItem(data, &end);
+    if (error) {
+        error->error = QCborError{err};
+        error->offset = end;
+    }
+    if (err != QCborError::NoError)
+        return QCborValueView();
+    return QCborValueView(data, 0);
+}
+
+/*!
+    Returns the type of the item. Tagged items, including the extended types
+    of QCborValue, are reported as QCborValue::Tag; unsigned integers that do
+    not fit in a qint64 are reported as QCborValue::Double, as QCborValue
+    does.
+*/
+QCborValue::Type QCborValueView::type() const
+{
+    if (offset < 0)
+        return QCborValue::Invalid;
+
+    ItemHeader h;
+    readHeader(data, offset, &h);
+    switch (h.majorType) {
+    case 0:
+    case 1:
+        return h.value > quint64(std::numeric_limits<qint64>::max())
+                ? QCborValue::Double : QCborValue::Integer;
+    case 2:
+        return QCborValue::ByteArray;
+    case 3:
+        return QCborValue::String;
+    case 4:
+        return QCborValue::Array;
+    case 5:
+        return QCborValue::Map;
+    case 6:
+        return QCborValue::Tag;
+    }
+    if (h.info <= 24)
+        return QCborValue::Type(QCborValue::SimpleType + int(h.value));
+    return QCborValue::Double;
+}
+
+/*!
+    \fn bool QCborValueView::isValid() const
+
+    Returns true if this view refers to an item.
+*/
+
+/*!
+    Returns the integer value of this item, if it is an integer. If it is a
+    floating point number, the value is converted to integer. Otherwise,
+    \a defaultValue is returned.
+*/
+qint64 QCborValueView::toInteger(qint64 defaultValue) const
+{
+    switch (type()) {
+    case QCborValue::Integer: {
+        ItemHeader h;
+        readHeader(data, offset, &h);
+        return h.majorType == 0 ? qint64(h.value) : -1 - qint64(h.value);
+    }
+    case QCborValue::Double:
+        return qint64(toDouble());
+    default:
+        return defaultValue;
+    }
+}
+
+/*!
+    Returns the floating point value of this item, if it is a number,
+    converting integers as needed. Otherwise, returns \a defaultValue.
+*/
+double QCborValueView::toDouble(double defaultValue) const
+{
+    if (offset < 0)
+        return defaultValue;
+
+    ItemHeader h;
+    readHeader(data, offset, &h);
+    switch (h.majorType) {
+    case 0:
+        return double(h.value);
+    case 1:
+        return -1.0 - double(h.value);
+    case 7:
+        break;
+    default:
+        return defaultValue;
+    }
+
+    switch (h.info) {
+    case 25: {
+        const quint16 bits = quint16(h.value);
+        qfloat16 f;
+        memcpy(static_cast<void *>(&f), &bits, sizeof(f));
+        return double(f);
+    }
+    case 26: {
+        const quint32 bits = quint32(h.value);
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        return double(f);
+    }
+    case 27: {
+        double d;
+        memcpy(&d, &h.value, sizeof(d));
+        return d;
+    }
+    }
+    return defaultValue;
+}
+
+/*!
+    Returns a view of the contents of this byte array item, without copying
+    them. The returned view remains valid for as long as the data this view
+    was created from.
+
+    If this item is not a byte array, or if it was encoded in chunks, returns
+    a null QByteArrayView. Use toByteArray() for chunked byte arrays.
+
+    \sa utf8StringView(), toByteArray()
+*/
+QByteArrayView QCborValueView::byteArrayView() const
+{
+    if (offset < 0)
+        return QByteArrayView();
+    ItemHeader h;
+    readHeader(data, offset, &h);
+    if (h.majorType != 2 || h.indefinite)
+        return QByteArrayView();
+    return QByteArrayView(data.constData() + offset + h.size, qsizetype(h.value));
+}
+
+/*!
+    Returns a view of the UTF-8 contents of this text string item, without
+    copying or decoding them. The returned view remains valid for as long as
+    the data this view was created from.
+
+    If this item is not a text string, or if it was encoded in chunks, returns
+    a null QByteArrayView. Use toString() for chunked strings.
+
+    \sa byteArrayView(), toString()
+*/
+QByteArrayView QCborValueView::utf8StringView() const
+{
+    if (offset < 0)
+        return QByteArrayView();
+    ItemHeader h;
+    readHeader(data, offset, &h);
+    if (h.majorType != 3 || h.indefinite)
+        return QByteArrayView();
+    return QByteArrayView(data.constData() + offset + h.size, qsizetype(h.value));
+}
+
+/*!
+    Returns a copy of the contents of this byte array item, or \a defaultValue
+    if this item is not a byte array.
+
+    \sa byteArrayView()
+*/
+QByteArray QCborValueView::toByteArray(const QByteArray &defaultValue) const
+{
+    if (!isByteArray())
+        return defaultValue;
+    ItemHeader h;
+    readHeader(data, offset, &h);
+    if (h.indefinite)
+        return concatenateChunks(data, offset + h.size);
+    return byteArrayView().toByteArray();
+}
+
+/*!
+    Returns the contents of this text string item, decoded from UTF-8, or
+    \a defaultValue if this item is not a text string.
+
+    \sa utf8StringView()
+*/
+QString QCborValueView::toString(const QString &defaultValue) const
+{
+    if (!isString())
+        return defaultValue;
+    ItemHeader h;
+    readHeader(data, offset, &h);
+    if (h.indefinite)
+        return QString::fromUtf8(concatenateChunks(data, offset + h.size));
+    const QByteArrayView utf8 = utf8StringView();
+    return QString::fromUtf8(utf8.data(), utf8.size());
+}
+
+/*!
+    Returns the tag of this item, if it is tagged. Otherwise, returns
+    \a defaultValue.
+
+    \sa taggedValue()
+*/
+QCborTag QCborValueView::tag(QCborTag defaultValue) const
+{
+    if (!isTag())
+        return defaultValue;
+    ItemHeader h;
+    readHeader(data, offset, &h);
+    return QCborTag(h.value);
+}
+
+/*!
+    Returns a view of the item this tag applies to, or an invalid view if this
+    item is not tagged.
+
+    \sa tag()
+*/
+QCborValueView QCborValueView::taggedValue() const
+{
+    if (!isTag())
+        return QCborValueView();
+    ItemHeader h;
+    readHeader(data, offset, &h);
+    return QCborValueView(data, offset + h.size);
+}
+
+/*!
+    Returns the number of elements of an array or the number of members of a
+    map, or 0 for any other item. For containers encoded with indefinite
+    length, this requires skipping over all their elements, unless an index
+    has been created.
+
+    \sa createIndex()
+*/
+qsizetype QCborValueView::size() const
+{
+    if (!isContainer())
+        return 0;
+    const qsizetype divisor = isMap() ? 2 : 1;
+    if (index)
+        return index->offsets.size() / divisor;
+
+    ItemHeader h;
+    readHeader(data, offset, &h);
+    if (!h.indefinite)
+        return qsizetype(h.value);
+
+    qsizetype count = 0;
+    qsizetype pos = offset + h.size;
+    while (uchar(data[pos]) != BreakByte) {
+        skipItem(data, &pos);
+        ++count;
+    }
+    return count / divisor;
+}
+
+// Returns the i-th encoded element: for maps, keys and values are counted
+// separately.
+QCborValueView QCborValueView::elementAt(qsizetype i) const
+{
+    if (i < 0)
+        return QCborValueView();
+    if (index) {
+        if (i >= index->offsets.size())
+            return QCborValueView();
+        return QCborValueView(data, index->offsets.at(i));
+    }
+
+    ItemHeader h;
+    readHeader(data, offset, &h);
+    quint64 remaining = isMap() ? h.value * 2 : h.value;
+    if (!h.indefinite && quint64(i) >= remaining)
+        return QCborValueView();
+
+    qsizetype pos = offset + h.size;
+    for ( ; i; --i) {
+        if (uchar(data[pos]) == BreakByte)
+            return QCborValueView();
+        skipItem(data, &pos);
+    }
+    if (uchar(data[pos]) == BreakByte)
+        return QCborValueView();
+    return QCborValueView(data, pos);
+}
+
+/*!
+    Returns a view of element \a i of this array, or an invalid view if this
+    is not an array or \a i is out of range.
+
+    \sa size(), createIndex()
+*/
+QCborValueView QCborValueView::at(qsizetype i) const
+{
+    if (!isArray())
+        return QCborValueView();
+    return elementAt(i);
+}
+
+/*!
+    Returns a view of the key of member \a i of this map, or an invalid view
+    if this is not a map or \a i is out of range.
+
+    \sa valueAt()
+*/
+QCborValueView QCborValueView::keyAt(qsizetype i) const
+{
+    if (!isMap() || i < 0)
+        return QCborValueView();
+    return elementAt(2 * i);
+}
+
+/*!
+    Returns a view of the value of member \a i of this map, or an invalid view
+    if this is not a map or \a i is out of range.
+
+    \sa keyAt()
+*/
+QCborValueView QCborValueView::valueAt(qsizetype i) const
+{
+    if (!isMap() || i < 0)
+        return QCborValueView();
+    return elementAt(2 * i + 1);
+}
+
+QCborValueView QCborValueView::findKey(QCborValue::Type keyType, qint64 intKey,
+                                       QByteArrayView latin1Key, QStringView utf16Key) const
+{
+    for (auto it = begin(); it != end(); ++it) {
+        const QCborValueView key = it.key();
+        if (key.type() != keyType)
+            continue;
+
+        bool matches;
+        if (keyType == QCborValue::Integer) {
+            matches = key.toInteger() == intKey;
+        } else {
+            QByteArray chunked;
+            QByteArrayView utf8 = key.utf8StringView();
+            if (utf8.isNull()) {
+                chunked = key.toString().toUtf8();
+                utf8 = chunked;
+            }
+            if (latin1Key.data())
+                matches = QUtf8::compareUtf8(utf8, QLatin1String(latin1Key.data(), latin1Key.size())) == 0;
+            else
+                matches = QUtf8::compareUtf8(utf8, utf16Key) == 0;
+        }
+        if (matches)
+            return it.value();
+    }
+    return QCborValueView();
+}
+
+/*!
+    If this is a map, returns a view of the value of the first member whose
+    key is the integer \a key. If this is an array, returns a view of the
+    element at index \a key. Otherwise, or if there is no such member or
+    element, returns an invalid view.
+*/
+QCborValueView QCborValueView::operator[](qint64 key) const
+{
+    if (isArray())
+        return elementAt(key);
+    if (isMap())
+        return findKey(QCborValue::Integer, key, QByteArrayView(), QStringView());
+    return QCborValueView();
+}
+
+/*!
+    \overload
+
+    If this is a map, returns a view of the value of the first member whose
+    key is the string \a key. Otherwise, or if there is no such member,
+    returns an invalid view.
+*/
+QCborValueView QCborValueView::operator[](QLatin1String key) const
+{
+    if (!isMap())
+        return QCborValueView();
+    return findKey(QCborValue::String, 0, QByteArrayView(key.data() ? key.data() : "", key.size()),
+                   QStringView());
+}
+
+/*!
+    \overload
+*/
+QCborValueView QCborValueView::operator[](QStringView key) const
+{
+    if (!isMap())
+        return QCborValueView();
+    return findKey(QCborValue::String, 0, QByteArrayView(), key);
+}
+
+/*!
+    \fn QCborValueView QCborValueView::operator[](const QString &key) const
+    \overload
+*/
+
+/*!
+    Returns an iterator to the first element of this array or the first
+    member of this map. For any other item, returns end().
+
+    \sa end()
+*/
+QCborValueView::ConstIterator QCborValueView::begin() const
+{
+    if (!isContainer())
+        return end();
+
+    ItemHeader h;
+    readHeader(data, offset, &h);
+    const qsizetype first = offset + h.size;
+    if (h.indefinite)
+        return uchar(data[first]) == BreakByte ? end() : ConstIterator(data, isMap(), first, -1);
+    if (h.value == 0)
+        return end();
+    return ConstIterator(data, isMap(), first, qsizetype(h.value));
+}
+
+/*!
+    \fn QCborValueView::ConstIterator QCborValueView::end() const
+
+    Returns an iterator past the last element of this array or member of this
+    map.
+
+    \sa begin()
+*/
+
+/*!
+    Returns a view of the key of the current member, if the iterator belongs
+    to a map. Otherwise, returns an invalid view.
+*/
+QCborValueView QCborValueView::ConstIterator::key() const
+{
+    if (pos < 0 || !isMap)
+        return QCborValueView();
+    return QCborValueView(data, pos);
+}
+
+/*!
+    Returns a view of the current array element or map member value.
+*/
+QCborValueView QCborValueView::ConstIterator::value() const
+{
+    if (pos < 0)
+        return QCborValueView();
+    qsizetype valuePos = pos;
+    if (isMap)
+        skipItem(data, &valuePos);
+    return QCborValueView(data, valuePos);
+}
+
+/*!
+    Advances the iterator to the next element and returns a reference to it.
+*/
+QCborValueView::ConstIterator &QCborValueView::ConstIterator::operator++()
+{
+    skipItem(data, &pos);
+    if (isMap)
+        skipItem(data, &pos);
+
+    if (remaining > 0) {
+        if (--remaining == 0)
+            pos = -1;
+    } else if (uchar(data[pos]) == BreakByte) {
+        pos = -1;
+    }
+    return *this;
+}
+
+/*!
+    Returns true if an index of element offsets has been created for this
+    array or map.
+
+    \sa createIndex()
+*/
+bool QCborValueView::hasIndex() const
+{
+    return index;
+}
+
+/*!
+    Records the offsets of all elements of this array or map, so that at(),
+    keyAt(), valueAt() and size() take constant time. The index is shared by
+    copies of this view, but not by views of nested containers.
+
+    This function does nothing if this is not a container or already has an
+    index.
+
+    \sa hasIndex()
+*/
+void QCborValueView::createIndex()
+{
+    if (index || !isContainer())
+        return;
+
+    auto newIndex = new QCborValueViewIndex;
+    for (auto it = begin(); it != end(); ++it) {
+        if (isMap())
+            newIndex->offsets.append(it.pos);
+        qsizetype valuePos = it.pos;
+        if (isMap())
+            skipItem(data, &valuePos);
+        newIndex->offsets.append(valuePos);
+    }
+    index = newIndex;
+}
+
+/*!
+    Returns a view of the encoded bytes of this item, including any nested
+    items.
+*/
+QByteArrayView QCborValueView::encodedData() const
+{
+    if (offset < 0)
+        return QByteArrayView();
+    qsizetype end = offset;
+    skipItem(data, &end);
+    return QByteArrayView(data.constData() + offset, end - offset);
+}
+
+/*!
+    Decodes this item, including any nested items, and returns it as a
+    QCborValue. Unlike the view, the returned value does not refer to the
+    encoded data and can be modified.
+
+    \sa QCborValue::fromCbor()
+*/
+QCborValue QCborValueView::toCborValue() const
+{
+    if (offset < 0)
+        return QCborValue(QCborValue::Invalid);
+    const QByteArrayView encoded = encodedData();
+    return QCborValue::fromCbor(QByteArray::fromRawData(encoded.data(), encoded.size()));
+}
+
+QT_END_NAMESPACE
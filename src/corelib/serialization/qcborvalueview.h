@@ -0,0 +1,182 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QCBORVALUEVIEW_H
+#define QCBORVALUEVIEW_H
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qbytearrayview.h>
+#include <QtCore/qcborvalue.h>
+#include <QtCore/qshareddata.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qstringview.h>
+
+QT_REQUIRE_CONFIG(cborstreamreader);
+
+// See qcborcommon.h for why we check
+#if defined(QT_X11_DEFINES_FOUND)
+#  undef True
+#  undef False
+#endif
+
+QT_BEGIN_NAMESPACE
+
+class QCborValueViewIndex;
+class Q_CORE_EXPORT QCborValueView
+{
+public:
+    class ConstIterator
+    {
+    public:
+        ConstIterator() = default;
+
+        QCborValueView operator*() const    { return value(); }
+        QCborValueView key() const;
+        QCborValueView value() const;
+
+        ConstIterator &operator++();
+        ConstIterator operator++(int)       { ConstIterator copy = *this; ++*this; return copy; }
+
+        bool operator==(const ConstIterator &other) const { return pos == other.pos; }
+        bool operator!=(const ConstIterator &other) const { return pos != other.pos; }
+
+    private:
+        friend class QCborValueView;
+        ConstIterator(const QByteArray &data, bool isMap, qsizetype pos, qsizetype remaining)
+            : data(data), pos(pos), remaining(remaining), isMap(isMap) {}
+
+        // shares the encoded data, so that the iterator stays valid after
+        // the view it was obtained from is destroyed
+        QByteArray data;
+        qsizetype pos = -1;
+        qsizetype remaining = 0;
+        bool isMap = false;
+    };
+    using const_iterator = ConstIterator;
+
+    QCborValueView() noexcept;
+    QCborValueView(const QCborValueView &other);
+    QCborValueView(QCborValueView &&other) noexcept;
+    QCborValueView &operator=(const QCborValueView &other);
+    QCborValueView &operator=(QCborValueView &&other) noexcept;
+    ~QCborValueView();
+
+    void swap(QCborValueView &other) noexcept
+    {
+        qSwap(data, other.data);
+        qSwap(offset, other.offset);
+        qSwap(index, other.index);
+    }
+
+    static QCborValueView fromCbor(const QByteArray &data, QCborParserError *error = nullptr);
+
+    QCborValue::Type type() const;
+    bool isValid() const            { return type() != QCborValue::Invalid; }
+    bool isInteger() const          { return type() == QCborValue::Integer; }
+    bool isByteArray() const        { return type() == QCborValue::ByteArray; }
+    bool isString() const           { return type() == QCborValue::String; }
+    bool isArray() const            { return type() == QCborValue::Array; }
+    bool isMap() const              { return type() == QCborValue::Map; }
+    bool isTag() const              { return type() == QCborValue::Tag; }
+    bool isFalse() const            { return type() == QCborValue::False; }
+    bool isTrue() const             { return type() == QCborValue::True; }
+    bool isBool() const             { return isFalse() || isTrue(); }
+    bool isNull() const             { return type() == QCborValue::Null; }
+    bool isUndefined() const        { return type() == QCborValue::Undefined; }
+    bool isDouble() const           { return type() == QCborValue::Double; }
+    bool isSimpleType() const       { return int(type()) >> 8 == int(QCborValue::SimpleType) >> 8; }
+    bool isContainer() const        { return isMap() || isArray(); }
+
+    qint64 toInteger(qint64 defaultValue = 0) const;
+    double toDouble(double defaultValue = 0) const;
+    bool toBool(bool defaultValue = false) const
+    { return isBool() ? isTrue() : defaultValue; }
+    QCborSimpleType toSimpleType(QCborSimpleType defaultValue = QCborSimpleType::Undefined) const
+    { return isSimpleType() ? QCborSimpleType(type() & 0xff) : defaultValue; }
+
+    QByteArrayView byteArrayView() const;
+    QByteArrayView utf8StringView() const;
+    QByteArray toByteArray(const QByteArray &defaultValue = {}) const;
+    QString toString(const QString &defaultValue = {}) const;
+
+    QCborTag tag(QCborTag defaultValue = QCborTag(-1)) const;
+    QCborValueView taggedValue() const;
+
+    qsizetype size() const;
+    QCborValueView at(qsizetype i) const;
+    QCborValueView keyAt(qsizetype i) const;
+    QCborValueView valueAt(qsizetype i) const;
+    QCborValueView operator[](qint64 key) const;
+    QCborValueView operator[](QLatin1String key) const;
+    QCborValueView operator[](QStringView key) const;
+    QCborValueView operator[](const QString &key) const { return operator[](QStringView(key)); }
+
+    ConstIterator begin() const;
+    ConstIterator end() const                   { return ConstIterator(); }
+    ConstIterator constBegin() const            { return begin(); }
+    ConstIterator constEnd() const              { return end(); }
+
+    bool hasIndex() const;
+    void createIndex();
+
+    QByteArrayView encodedData() const;
+    QCborValue toCborValue() const;
+
+private:
+    friend class ConstIterator;
+    QCborValueView(const QByteArray &data, qsizetype offset);
+    QCborValueView elementAt(qsizetype i) const;
+    QCborValueView findKey(QCborValue::Type keyType, qint64 intKey, QByteArrayView latin1Key,
+                           QStringView utf16Key) const;
+
+    QByteArray data;
+    qsizetype offset = -1;
+    QExplicitlySharedDataPointer<QCborValueViewIndex> index;
+};
+
+Q_DECLARE_SHARED(QCborValueView)
+
+QT_END_NAMESPACE
+
+#if defined(QT_X11_DEFINES_FOUND)
+#  define True  1
+#  define False 0
+#endif
+
+#endif // QCBORVALUEVIEW_H
@@ -594,6 +594,54 @@ void QDataStream::setByteOrder(ByteOrder bo)
     \sa version(), Version
 */
 
+/*!
+    \since 6.0
+
+    Returns \c true if zero-copy reads are enabled for this stream;
+    otherwise returns \c false. The default is \c false.
+
+    \sa setZeroCopyEnabled()
+*/
+bool QDataStream::isZeroCopyEnabled() const
+{
+    return d && d->zeroCopyEnabled;
+}
+
+/*!
+    \since 6.0
+
+    Enables zero-copy reads if \a enable is \c true, disables them otherwise.
+
+    When zero-copy reads are enabled and the stream operates on a byte array
+    (that is, it was constructed with QDataStream(const QByteArray &) or
+    QDataStream(QByteArray *, OpenMode)), reading a QByteArray returns an
+    object created with QByteArray::fromRawData() that refers to the bytes in
+    the stream's byte array instead of a copy of them. Likewise, reading a
+    QString returns an object created with QString::fromRawData() if the
+    string data is suitably aligned and was written in the byte order of the
+    host (see setByteOrder()). All other data, and strings that cannot be
+    referenced, are copied as usual. Reads are bounds-checked in the same way
+    as with zero-copy reads disabled.
+
+    This is most useful when reading large amounts of data from a memory
+    mapped file:
+
+    \snippet code/src_corelib_io_qdatastream.cpp 7
+
+    \warning The byte arrays and strings read this way refer to the memory
+    of the byte array the stream operates on. That memory must stay valid and
+    unmodified for as long as any of them is in use; in the example above,
+    the file must not be unmapped or closed.
+
+    \sa isZeroCopyEnabled(), QFile::map(), QByteArray::fromRawData()
+*/
+void QDataStream::setZeroCopyEnabled(bool enable)
+{
+    if (!d)
+        d.reset(new QDataStreamPrivate());
+    d->zeroCopyEnabled = enable;
+}
+
 /*!
     \since 5.7
 
@@ -771,6 +819,38 @@ int QDataStream::readBlock(char *data, int len)
     return readResult;
 }
 
+/*!
+    \internal
+
+    Returns a pointer to the next \a len bytes of the stream's byte array and
+    skips past them, if zero-copy reads are enabled, the stream operates on a
+    byte array containing at least \a len more bytes and the data is aligned to
+    \a alignment. Otherwise, returns \nullptr without consuming any data, so
+    the caller can fall back to readRawData().
+*/
+const char *QDataStream::readRawDataReference(qsizetype len, qsizetype alignment)
+{
+    // owndev is only set if dev is the QBuffer created by our constructors
+    if (!d || !d->zeroCopyEnabled || !owndev || len <= 0)
+        return nullptr;
+
+    // Disable reads on failure in transacted stream
+    if (q_status != Ok && dev->isTransactionStarted())
+        return nullptr;
+
+    const QByteArray &buffer = static_cast<QBuffer *>(dev)->data();
+    const qint64 pos = dev->pos();
+    if (pos < 0 || len > buffer.size() - pos)
+        return nullptr;
+
+    const char *data = buffer.constData() + pos;
+    if (quintptr(data) % alignment != 0)
+        return nullptr;
+    if (dev->skip(len) != len)
+        return nullptr;
+    return data;
+}
+
 /*!
     \fn QDataStream &QDataStream::operator>>(std::nullptr_t &ptr)
     \since 5.9
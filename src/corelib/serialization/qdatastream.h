@@ -144,6 +144,9 @@ public:
     int version() const;
     void setVersion(int);
 
+    bool isZeroCopyEnabled() const;
+    void setZeroCopyEnabled(bool enable);
+
     QDataStream &operator>>(char &i);
     QDataStream &operator>>(qint8 &i);
     QDataStream &operator>>(quint8 &i);
@@ -209,7 +212,10 @@ private:
     Status q_status;
 
     int readBlock(char *data, int len);
+    const char *readRawDataReference(qsizetype len, qsizetype alignment = 1);
     friend class QtPrivate::StreamStateSaver;
+    friend Q_CORE_EXPORT QDataStream &operator>>(QDataStream &, QByteArray &);
+    friend Q_CORE_EXPORT QDataStream &operator>>(QDataStream &, QString &);
 };
 
 namespace QtPrivate {
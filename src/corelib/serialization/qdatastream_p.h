@@ -61,10 +61,11 @@ class QDataStreamPrivate
 {
 public:
     QDataStreamPrivate() : floatingPointPrecision(QDataStream::DoublePrecision),
-        transactionDepth(0) { }
+        transactionDepth(0), zeroCopyEnabled(false) { }
 
     QDataStream::FloatingPointPrecision floatingPointPrecision;
     int transactionDepth;
+    bool zeroCopyEnabled;
 };
 #endif
 
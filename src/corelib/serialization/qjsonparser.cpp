@@ -47,6 +47,7 @@
 #include "private/qstringconverter_p.h"
 #include "private/qcborvalue_p.h"
 #include "private/qnumeric_p.h"
+#include "private/qsimd_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -272,6 +273,145 @@ enum {
     Quote = 0x22
 };
 
+/*
+    Vectorized scanning
+
+    The parser proper stays a single-pass recursive descent parser, so errors
+    are detected at exactly the same places and reported with the same offsets
+    as before. The functions below only skip over runs of bytes that need no
+    individual attention: insignificant whitespace, and the parts of strings
+    that are plain ASCII without quotation marks or escapes. They never read
+    beyond \a end.
+
+    The AVX2 versions are selected at runtime with qCpuHasFeature().
+*/
+
+static inline const char *skipWhitespacePlain(const char *json, const char *end)
+{
+    while (json < end) {
+        const char c = *json;
+        if (c != Space && c != Tab && c != LineFeed && c != Return)
+            break;
+        ++json;
+    }
+    return json;
+}
+
+// Returns the first '"', '\\' or non-ASCII byte in [json, end), or end.
+static inline const char *findStringSpecialPlain(const char *json, const char *end)
+{
+    while (json < end) {
+        const uchar c = *json;
+        if (c == Quote || c == '\\' || c >= 0x80)
+            break;
+        ++json;
+    }
+    return json;
+}
+
+#ifdef __SSE2__
+static inline const char *skipWhitespaceSse2(const char *json, const char *end)
+{
+    const __m128i space = _mm_set1_epi8(Space);
+    const __m128i tab = _mm_set1_epi8(Tab);
+    const __m128i lineFeed = _mm_set1_epi8(LineFeed);
+    const __m128i carriageReturn = _mm_set1_epi8(Return);
+    for ( ; end - json >= 16; json += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        const __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, space),
+                                                     _mm_cmpeq_epi8(data, tab)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(data, lineFeed),
+                                                     _mm_cmpeq_epi8(data, carriageReturn)));
+        const uint n = ~_mm_movemask_epi8(ws) & 0xffff;
+        if (n)
+            return json + qCountTrailingZeroBits(n);
+    }
+    return skipWhitespacePlain(json, end);
+}
+
+static inline const char *findStringSpecialSse2(const char *json, const char *end)
+{
+    const __m128i quote = _mm_set1_epi8(Quote);
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for ( ; end - json >= 16; json += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        const __m128i special = _mm_or_si128(_mm_cmpeq_epi8(data, quote),
+                                             _mm_cmpeq_epi8(data, backslash));
+        // movemask of the data itself extracts the high bit: non-ASCII bytes
+        const uint n = _mm_movemask_epi8(special) | _mm_movemask_epi8(data);
+        if (n)
+            return json + qCountTrailingZeroBits(n);
+    }
+    return findStringSpecialPlain(json, end);
+}
+#endif
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2) && !defined(QT_BOOTSTRAPPED)
+#  define JSON_AVX2_DISPATCH
+
+QT_FUNCTION_TARGET(AVX2)
+static const char *skipWhitespaceAvx2(const char *json, const char *end)
+{
+    const __m256i space = _mm256_set1_epi8(Space);
+    const __m256i tab = _mm256_set1_epi8(Tab);
+    const __m256i lineFeed = _mm256_set1_epi8(LineFeed);
+    const __m256i carriageReturn = _mm256_set1_epi8(Return);
+    for ( ; end - json >= 32; json += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(json));
+        const __m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(data, space),
+                                                           _mm256_cmpeq_epi8(data, tab)),
+                                           _mm256_or_si256(_mm256_cmpeq_epi8(data, lineFeed),
+                                                           _mm256_cmpeq_epi8(data, carriageReturn)));
+        const uint n = ~uint(_mm256_movemask_epi8(ws));
+        if (n)
+            return json + qCountTrailingZeroBits(n);
+    }
+    return skipWhitespaceSse2(json, end);
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static const char *findStringSpecialAvx2(const char *json, const char *end)
+{
+    const __m256i quote = _mm256_set1_epi8(Quote);
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    for ( ; end - json >= 32; json += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(json));
+        const __m256i special = _mm256_or_si256(_mm256_cmpeq_epi8(data, quote),
+                                                _mm256_cmpeq_epi8(data, backslash));
+        const uint n = uint(_mm256_movemask_epi8(special)) | uint(_mm256_movemask_epi8(data));
+        if (n)
+            return json + qCountTrailingZeroBits(n);
+    }
+    return findStringSpecialSse2(json, end);
+}
+#endif
+
+static inline const char *skipWhitespace(const char *json, const char *end)
+{
+#ifdef JSON_AVX2_DISPATCH
+    if (qCpuHasFeature(AVX2))
+        return skipWhitespaceAvx2(json, end);
+#endif
+#ifdef __SSE2__
+    return skipWhitespaceSse2(json, end);
+#else
+    return skipWhitespacePlain(json, end);
+#endif
+}
+
+static inline const char *findStringSpecial(const char *json, const char *end)
+{
+#ifdef JSON_AVX2_DISPATCH
+    if (qCpuHasFeature(AVX2))
+        return findStringSpecialAvx2(json, end);
+#endif
+#ifdef __SSE2__
+    return findStringSpecialSse2(json, end);
+#else
+    return findStringSpecialPlain(json, end);
+#endif
+}
+
 void Parser::eatBOM()
 {
     // eat UTF-8 byte order mark
@@ -285,16 +425,15 @@ void Parser::eatBOM()
 
 bool Parser::eatSpace()
 {
-    while (json < end) {
-        if (*json > Space)
-            break;
-        if (*json != Space &&
-            *json != Tab &&
-            *json != LineFeed &&
-            *json != Return)
-            break;
+    // most tokens are not preceded by whitespace, and most whitespace runs
+    // in compact documents are a single space
+    if (json < end && *json > Space)
+        return true;
+    if (end - json > 1 && json[0] == Space && json[1] > Space) {
         ++json;
+        return true;
     }
+    json = skipWhitespace(json, end);
     return (json < end);
 }
 
@@ -766,78 +905,6 @@ bool Parser::parseNumber()
 
         unescaped = %x20-21 / %x23-5B / %x5D-10FFFF
  */
-static inline bool addHexDigit(char digit, uint *result)
-{
-    *result <<= 4;
-    if (digit >= '0' && digit <= '9')
-        *result |= (digit - '0');
-    else if (digit >= 'a' && digit <= 'f')
-        *result |= (digit - 'a') + 10;
-    else if (digit >= 'A' && digit <= 'F')
-        *result |= (digit - 'A') + 10;
-    else
-        return false;
-    return true;
-}
-
-static inline bool scanEscapeSequence(const char *&json, const char *end, uint *ch)
-{
-    ++json;
-    if (json >= end)
-        return false;
-
-    DEBUG << "scan escape" << (char)*json;
-    uint escaped = *json++;
-    switch (escaped) {
-    case '"':
-        *ch = '"'; break;
-    case '\\':
-        *ch = '\\'; break;
-    case '/':
-        *ch = '/'; break;
-    case 'b':
-        *ch = 0x8; break;
-    case 'f':
-        *ch = 0xc; break;
-    case 'n':
-        *ch = 0xa; break;
-    case 'r':
-        *ch = 0xd; break;
-    case 't':
-        *ch = 0x9; break;
-    case 'u': {
-        *ch = 0;
-        if (json > end - 4)
-            return false;
-        for (int i = 0; i < 4; ++i) {
-            if (!addHexDigit(*json, ch))
-                return false;
-            ++json;
-        }
-        return true;
-    }
-    default:
-        // this is not as strict as one could be, but allows for more Json files
-        // to be parsed correctly.
-        *ch = escaped;
-        return true;
-    }
-    return true;
-}
-
-static inline bool scanUtf8Char(const char *&json, const char *end, uint *result)
-{
-    const auto *usrc = reinterpret_cast<const uchar *>(json);
-    const auto *uend = reinterpret_cast<const uchar *>(end);
-    const uchar b = *usrc++;
-    int res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, result, usrc, uend);
-    if (res < 0)
-        return false;
-
-    json = reinterpret_cast<const char *>(usrc);
-    return true;
-}
-
 bool Parser::parseString()
 {
     const char *start = json;
@@ -848,6 +915,9 @@ bool Parser::parseString()
     bool isUtf8 = true;
     bool isAscii = true;
     while (json < end) {
+        json = findStringSpecial(json, end);
+        if (json >= end)
+            break;
         uint ch = 0;
         if (*json == '"')
             break;
@@ -859,13 +929,15 @@ bool Parser::parseString()
             isUtf8 = false;
             break;
         }
-        if (!scanUtf8Char(json, end, &ch)) {
-            lastError = QJsonParseError::IllegalUTF8String;
-            return false;
-        }
-        if (ch > 0x7f)
-            isAscii = false;
-        DEBUG << "  " << ch << char(ch);
+        // findStringSpecial() stops at non-ASCII bytes, validate them one by one
+        do {
+            if (!scanUtf8Char(json, end, &ch)) {
+                lastError = QJsonParseError::IllegalUTF8String;
+                return false;
+            }
+            DEBUG << "  " << ch;
+        } while (json < end && uchar(*json) >= 0x80);
+        isAscii = false;
     }
     ++json;
     DEBUG << "end of string";
@@ -890,6 +962,14 @@ bool Parser::parseString()
 
     QString ucs4;
     while (json < end) {
+        // copy runs of plain ASCII in one go
+        const char *special = findStringSpecial(json, end);
+        if (special != json) {
+            ucs4.append(QLatin1String(json, int(special - json)));
+            json = special;
+            continue;
+        }
+
         uint ch = 0;
         if (*json == '"')
             break;
@@ -0,0 +1,921 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qjsonstreamreader.h"
+#include "qjsonparser_p.h"
+
+#include <private/qnumeric_p.h>
+#include <private/qstringconverter_p.h>
+#include <qiodevice.h>
+#include <qvarlengtharray.h>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QJsonPrivate;
+
+static const int nestingLimit = 1024;
+static const qint64 readChunkSize = 64 * 1024;
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 6.0
+
+    \brief The QJsonStreamReader class is a fast pull parser for JSON text,
+    operating on either a QByteArray or a QIODevice.
+
+    QJsonStreamReader reads JSON one token at a time, without building a
+    QJsonDocument in memory. It is meant for large inputs, or for inputs that
+    arrive incrementally, where QJsonDocument::fromJson() would need to hold
+    the complete text and the resulting tree at the same time.
+
+    The reader is driven by calling readNext(), which returns the type of the
+    token just read. Containers are reported as a StartObject or StartArray
+    token, followed by their contents and a matching EndObject or EndArray
+    token. Inside objects, every member is reported as a Name token followed
+    by the member's value. Scalar values are reported as String, Number, Bool
+    or Null tokens, whose contents can be obtained with text(), toDouble(),
+    toInteger(), toBool() or value().
+
+    \snippet code/src_corelib_serialization_qjsonstream.cpp 0
+
+    Unlike QJsonDocument, QJsonStreamReader accepts any JSON value at the top
+    level and reports the end of each value with an EndDocument token. Several
+    values may follow each other in the input, separated by whitespace, as is
+    common for newline-delimited JSON ("JSON Lines") logs.
+
+    Members of an object are reported in the order they appear in the input.
+    Duplicate names are not merged.
+
+    \section1 Incremental Parsing
+
+    If the reader runs out of data in the middle of a token, readNext()
+    returns NoToken without consuming any part of that token. More data can
+    then be provided with addData(), or, when reading from a sequential
+    QIODevice, after the device has emitted \l{QIODevice::}{readyRead()}.
+    Data passed to the constructor is treated as complete; data passed to
+    addData() is treated as a stream that may continue.
+
+    Errors are not recoverable: once hasError() returns true, readNext()
+    always returns Invalid.
+
+    \sa QJsonStreamWriter, QJsonDocument, QCborStreamReader
+*/
+
+/*!
+    \enum QJsonStreamReader::TokenType
+
+    This enum describes the type of the token the reader was last positioned
+    on.
+
+    \value NoToken      The reader has not read anything yet, or needs more
+                        data to read the next token.
+    \value Invalid      An error occurred, see lastError().
+    \value StartObject  The reader opened an object.
+    \value EndObject    The reader closed the current object.
+    \value StartArray   The reader opened an array.
+    \value EndArray     The reader closed the current array.
+    \value Name         The name of an object member, available as text().
+    \value String       A string value, available as text().
+    \value Number       A number, available as toDouble() or, if
+                        isInteger() returns true, as toInteger().
+    \value Bool         A boolean value, available as toBool().
+    \value Null         A null value.
+    \value EndDocument  A complete top-level value has been read, or the
+                        input was empty.
+*/
+
+class QJsonStreamReaderPrivate
+{
+public:
+    enum State {
+        ExpectValue,
+        ExpectValueOrEndArray,
+        ExpectNameOrEndObject,
+        ExpectName,
+        ExpectNameSeparator,
+        ExpectValueSeparatorOrEnd,
+        DocumentFinished
+    };
+
+    enum ScanResult {
+        Complete,
+        NeedMoreData,
+        Failed
+    };
+
+    bool fetchData();
+    bool fetchMore(qsizetype *index);
+    bool skipSpace();
+    void skipByteOrderMark();
+
+    QJsonStreamReader::TokenType readNext();
+    QJsonStreamReader::TokenType readValue();
+    QJsonStreamReader::TokenType endContainer(QJsonStreamReader::TokenType token);
+    QJsonStreamReader::TokenType endOfInput();
+    QJsonStreamReader::TokenType setError(QJsonParseError::ParseError error);
+
+    ScanResult scanString();
+    ScanResult scanNumber();
+    ScanResult scanLiteral(const char *literal, qsizetype len);
+
+    QIODevice *device = nullptr;
+    QByteArray buffer;
+    qsizetype pos = 0;
+    qint64 bufferOffset = 0;
+    qint64 tokenOffset = 0;
+    qint64 errorOffset = -1;
+    bool inputComplete = false;
+    bool finished = false;
+
+    State state = ExpectValue;
+    QVarLengthArray<QJsonStreamReader::TokenType, 32> containers;
+
+    QJsonStreamReader::TokenType type = QJsonStreamReader::NoToken;
+    QJsonParseError::ParseError lastError = QJsonParseError::NoError;
+    QString stringValue;
+    double doubleValue = 0;
+    qint64 integerValue = 0;
+    bool integral = false;
+    bool boolValue = false;
+};
+
+// Appends more data from the device to the buffer, dropping what has already
+// been consumed. Returns false if no new data could be read.
+bool QJsonStreamReaderPrivate::fetchData()
+{
+    if (!device || inputComplete)
+        return false;
+    if (!device->isOpen()) {
+        inputComplete = true;
+        return false;
+    }
+
+    if (pos) {
+        buffer.remove(0, pos);
+        bufferOffset += pos;
+        pos = 0;
+    }
+
+    const qsizetype oldSize = buffer.size();
+    buffer.resize(oldSize + readChunkSize);
+    const qint64 n = device->read(buffer.data() + oldSize, readChunkSize);
+    buffer.resize(oldSize + qMax(n, qint64(0)));
+    if (n < 0 || (n == 0 && !device->isSequential()))
+        inputComplete = true;
+    return n > 0;
+}
+
+// Like fetchData(), but keeps *index pointing at the same byte
+bool QJsonStreamReaderPrivate::fetchMore(qsizetype *index)
+{
+    const qsizetype relative = *index - pos;
+    if (!fetchData())
+        return false;
+    *index = pos + relative;
+    return true;
+}
+
+/*
+    ws = *( %x20 / %x09 / %x0A / %x0D )
+
+    Returns true if a non-whitespace character is available at pos.
+*/
+bool QJsonStreamReaderPrivate::skipSpace()
+{
+    forever {
+        const char *data = buffer.constData();
+        const qsizetype size = buffer.size();
+        while (pos < size) {
+            const char c = data[pos];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+                return true;
+            ++pos;
+        }
+        if (!fetchData())
+            return false;
+    }
+}
+
+void QJsonStreamReaderPrivate::skipByteOrderMark()
+{
+    static const char utf8bom[] = "\xef\xbb\xbf";
+    while (buffer.size() < 3 && fetchData())
+        ;
+    if (buffer.startsWith(utf8bom))
+        pos = 3;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::setError(QJsonParseError::ParseError error)
+{
+    lastError = error;
+    errorOffset = bufferOffset + pos;
+    return type = QJsonStreamReader::Invalid;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::endOfInput()
+{
+    if (!inputComplete)
+        return type = QJsonStreamReader::NoToken;
+
+    if (containers.isEmpty()) {
+        finished = true;
+        return type = QJsonStreamReader::EndDocument;
+    }
+    if (containers.last() == QJsonStreamReader::StartArray)
+        return setError(QJsonParseError::UnterminatedArray);
+    if (state == ExpectNameSeparator)
+        return setError(QJsonParseError::MissingNameSeparator);
+    return setError(QJsonParseError::UnterminatedObject);
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::endContainer(QJsonStreamReader::TokenType token)
+{
+    ++pos;
+    containers.removeLast();
+    state = containers.isEmpty() ? DocumentFinished : ExpectValueSeparatorOrEnd;
+    return type = token;
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readNext()
+{
+    if (lastError != QJsonParseError::NoError)
+        return QJsonStreamReader::Invalid;
+
+    if (state == DocumentFinished) {
+        state = ExpectValue;
+        finished = !skipSpace() && inputComplete;
+        tokenOffset = bufferOffset + pos;
+        return type = QJsonStreamReader::EndDocument;
+    }
+
+    if (Q_UNLIKELY(bufferOffset == 0 && pos == 0)) {
+        skipByteOrderMark();
+        if (pos == 0 && !inputComplete && buffer.size() < 3
+                && QByteArrayView("\xef\xbb\xbf").startsWith(buffer)) {
+            // can't tell yet whether this is a BOM
+            if (buffer.isEmpty())
+                return endOfInput();
+            return type = QJsonStreamReader::NoToken;
+        }
+    }
+
+    forever {
+        if (!skipSpace())
+            return endOfInput();
+
+        tokenOffset = bufferOffset + pos;
+        const char c = buffer.at(pos);
+        switch (state) {
+        case ExpectValue:
+            return readValue();
+
+        case ExpectValueOrEndArray:
+            if (c == ']')
+                return endContainer(QJsonStreamReader::EndArray);
+            return readValue();
+
+        case ExpectNameOrEndObject:
+            if (c == '}')
+                return endContainer(QJsonStreamReader::EndObject);
+            Q_FALLTHROUGH();
+        case ExpectName:
+            if (c != '"') {
+                if (c == '}' && state == ExpectName)
+                    return setError(QJsonParseError::MissingObject);
+                return setError(QJsonParseError::UnterminatedObject);
+            }
+            switch (scanString()) {
+            case NeedMoreData:
+                return type = QJsonStreamReader::NoToken;
+            case Failed:
+                return QJsonStreamReader::Invalid;
+            case Complete:
+                break;
+            }
+            state = ExpectNameSeparator;
+            return type = QJsonStreamReader::Name;
+
+        case ExpectNameSeparator:
+            if (c != ':')
+                return setError(QJsonParseError::MissingNameSeparator);
+            ++pos;
+            state = ExpectValue;
+            continue;
+
+        case ExpectValueSeparatorOrEnd: {
+            const bool inObject = containers.last() == QJsonStreamReader::StartObject;
+            if (c == ',') {
+                ++pos;
+                state = inObject ? ExpectName : ExpectValue;
+                continue;
+            }
+            if (inObject && c == '}')
+                return endContainer(QJsonStreamReader::EndObject);
+            if (!inObject && c == ']')
+                return endContainer(QJsonStreamReader::EndArray);
+            return setError(inObject ? QJsonParseError::UnterminatedObject
+                                     : QJsonParseError::MissingValueSeparator);
+        }
+
+        case DocumentFinished:
+            Q_UNREACHABLE();
+            break;
+        }
+    }
+}
+
+QJsonStreamReader::TokenType QJsonStreamReaderPrivate::readValue()
+{
+    QJsonStreamReader::TokenType token;
+    ScanResult result;
+
+    switch (buffer.at(pos)) {
+    case '[':
+    case '{': {
+        if (containers.size() >= nestingLimit)
+            return setError(QJsonParseError::DeepNesting);
+        const bool isObject = buffer.at(pos++) == '{';
+        token = isObject ? QJsonStreamReader::StartObject : QJsonStreamReader::StartArray;
+        containers.append(token);
+        state = isObject ? ExpectNameOrEndObject : ExpectValueOrEndArray;
+        return type = token;
+    }
+    case '"':
+        token = QJsonStreamReader::String;
+        result = scanString();
+        break;
+    case 't':
+        token = QJsonStreamReader::Bool;
+        boolValue = true;
+        result = scanLiteral("true", 4);
+        break;
+    case 'f':
+        token = QJsonStreamReader::Bool;
+        boolValue = false;
+        result = scanLiteral("false", 5);
+        break;
+    case 'n':
+        token = QJsonStreamReader::Null;
+        result = scanLiteral("null", 4);
+        break;
+    case '-':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+        token = QJsonStreamReader::Number;
+        result = scanNumber();
+        break;
+    default:
+        return setError(QJsonParseError::IllegalValue);
+    }
+
+    if (result == NeedMoreData)
+        return type = QJsonStreamReader::NoToken;
+    if (result == Failed)
+        return QJsonStreamReader::Invalid;
+
+    state = containers.isEmpty() ? DocumentFinished : ExpectValueSeparatorOrEnd;
+    return type = token;
+}
+
+QJsonStreamReaderPrivate::ScanResult
+QJsonStreamReaderPrivate::scanLiteral(const char *literal, qsizetype len)
+{
+    while (buffer.size() - pos < len) {
+        // reject early if what we already have can't match
+        const qsizetype available = buffer.size() - pos;
+        if (memcmp(buffer.constData() + pos, literal, available) != 0)
+            break;
+        if (fetchData())
+            continue;
+        if (!inputComplete)
+            return NeedMoreData;
+        break;
+    }
+
+    if (buffer.size() - pos < len || memcmp(buffer.constData() + pos, literal, len) != 0) {
+        setError(QJsonParseError::IllegalValue);
+        return Failed;
+    }
+    pos += len;
+    return Complete;
+}
+
+QJsonStreamReaderPrivate::ScanResult QJsonStreamReaderPrivate::scanString()
+{
+    // Find the closing quotation mark first. Neither '"' nor '\\' can appear
+    // inside a multi-byte UTF-8 sequence, so this is safe to do bytewise and
+    // ensures we never decode a partially received string.
+    qsizetype i = pos + 1;
+    bool hasEscape = false;
+    forever {
+        const char *data = buffer.constData();
+        const qsizetype size = buffer.size();
+        while (i < size && data[i] != '"') {
+            if (data[i] == '\\') {
+                hasEscape = true;
+                ++i;
+            }
+            ++i;
+        }
+        if (i < size)
+            break;
+        if (fetchMore(&i))
+            continue;
+        if (!inputComplete)
+            return NeedMoreData;
+        setError(QJsonParseError::UnterminatedString);
+        return Failed;
+    }
+
+    const char *json = buffer.constData() + pos + 1;
+    const char *end = buffer.constData() + i;
+
+    if (!hasEscape) {
+        const QUtf8::ValidUtf8Result r = QUtf8::isValidUtf8(QByteArrayView(json, end - json));
+        if (!r.isValidUtf8) {
+            setError(QJsonParseError::IllegalUTF8String);
+            return Failed;
+        }
+        if (r.isValidAscii)
+            stringValue = QString::fromLatin1(json, end - json);
+        else
+            stringValue = QString::fromUtf8(json, end - json);
+        pos = i + 1;
+        return Complete;
+    }
+
+    QString ucs4;
+    ucs4.reserve(end - json);
+    while (json < end) {
+        uint ch = 0;
+        if (*json == '\\') {
+            if (!scanEscapeSequence(json, end, &ch)) {
+                pos = json - buffer.constData();
+                setError(QJsonParseError::IllegalEscapeSequence);
+                return Failed;
+            }
+        } else {
+            if (!scanUtf8Char(json, end, &ch)) {
+                pos = json - buffer.constData();
+                setError(QJsonParseError::IllegalUTF8String);
+                return Failed;
+            }
+        }
+        ucs4.append(QChar::fromUcs4(ch));
+    }
+    stringValue = std::move(ucs4);
+    pos = i + 1;
+    return Complete;
+}
+
+/*
+    number = [ minus ] int [ frac ] [ exp ]
+
+    Accepts the same grammar as QJsonPrivate::Parser::parseNumber().
+*/
+QJsonStreamReaderPrivate::ScanResult QJsonStreamReaderPrivate::scanNumber()
+{
+    // Find the end of the number first, so we never convert a prefix of it
+    qsizetype i = pos;
+    forever {
+        const char *data = buffer.constData();
+        const qsizetype size = buffer.size();
+        while (i < size) {
+            const char c = data[i];
+            if ((c < '0' || c > '9') && c != '-' && c != '+' && c != '.' && c != 'e' && c != 'E')
+                break;
+            ++i;
+        }
+        if (i < size)
+            break;
+        if (fetchMore(&i))
+            continue;
+        if (!inputComplete)
+            return NeedMoreData;
+        break;
+    }
+
+    const char *start = buffer.constData() + pos;
+    const char *end = buffer.constData() + i;
+    const char *json = start;
+    bool isInt = true;
+
+    // minus
+    if (json < end && *json == '-')
+        ++json;
+
+    // int = zero / ( digit1-9 *DIGIT )
+    if (json < end && *json == '0') {
+        ++json;
+    } else {
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+
+    // frac = decimal-point 1*DIGIT
+    if (json < end && *json == '.') {
+        ++json;
+        while (json < end && *json >= '0' && *json <= '9') {
+            isInt = isInt && *json == '0';
+            ++json;
+        }
+    }
+
+    // exp = e [ minus / plus ] 1*DIGIT
+    if (json < end && (*json == 'e' || *json == 'E')) {
+        isInt = false;
+        ++json;
+        if (json < end && (*json == '-' || *json == '+'))
+            ++json;
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+
+    const QByteArray number = QByteArray::fromRawData(start, json - start);
+    pos = json - buffer.constData();
+
+    if (isInt) {
+        bool ok;
+        const qlonglong n = number.toLongLong(&ok);
+        if (ok) {
+            integerValue = n;
+            doubleValue = double(n);
+            integral = true;
+            return Complete;
+        }
+    }
+
+    bool ok;
+    doubleValue = number.toDouble(&ok);
+    if (!ok) {
+        pos = start - buffer.constData();
+        setError(QJsonParseError::IllegalNumber);
+        return Failed;
+    }
+
+    integral = convertDoubleTo(doubleValue, &integerValue);
+    return Complete;
+}
+
+/*!
+    Constructs a QJsonStreamReader with no data. Use addData() or setDevice()
+    to provide input.
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+    Constructs a QJsonStreamReader that reads the JSON text in \a data. The
+    data is considered complete: a value at its end is finished, and
+    containers still open at its end are reported as errors.
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : d(new QJsonStreamReaderPrivate)
+{
+    d->buffer = data;
+    d->inputComplete = true;
+}
+
+/*!
+    Constructs a QJsonStreamReader that reads from \a device. The device must
+    already be open for reading.
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : d(new QJsonStreamReaderPrivate)
+{
+    d->device = device;
+}
+
+/*!
+    Destroys the reader. The device, if any, is not closed.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Sets the device the reader reads from to \a device, and resets the reader
+    to its initial state. Any data added with addData() is discarded.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    clear();
+    d->device = device;
+}
+
+/*!
+    Returns the device the reader is reading from, or \nullptr if it is
+    operating on data added with addData().
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    return d->device;
+}
+
+/*!
+    Appends \a data to the reader's buffer. After this call, readNext() can
+    continue reading tokens that were previously incomplete.
+
+    This function does nothing if the reader operates on a device.
+
+    \sa readNext(), clear()
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    addData(data.constData(), data.size());
+}
+
+/*!
+    \overload
+
+    Appends \a len bytes starting at \a data to the reader's buffer.
+*/
+void QJsonStreamReader::addData(const char *data, qsizetype len)
+{
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with device()");
+        return;
+    }
+
+    if (d->pos) {
+        d->buffer.remove(0, d->pos);
+        d->bufferOffset += d->pos;
+        d->pos = 0;
+    }
+    d->buffer.append(data, len);
+    d->inputComplete = false;
+    d->finished = false;
+}
+
+/*!
+    Discards all data and the device, if any, and resets the reader to its
+    initial state.
+*/
+void QJsonStreamReader::clear()
+{
+    d.reset(new QJsonStreamReaderPrivate);
+}
+
+/*!
+    Reads the next token and returns its type.
+
+    If the input ends in the middle of a token and more data may follow, this
+    function returns NoToken and leaves the reader positioned before that
+    token.
+
+    \sa tokenType(), atEnd()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::readNext()
+{
+    return d->readNext();
+}
+
+/*!
+    Returns the type of the current token.
+
+    \sa readNext()
+*/
+QJsonStreamReader::TokenType QJsonStreamReader::tokenType() const
+{
+    return d->type;
+}
+
+/*!
+    \fn bool QJsonStreamReader::isStartObject() const
+
+    Returns true if tokenType() is StartObject.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndObject() const
+
+    Returns true if tokenType() is EndObject.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isStartArray() const
+
+    Returns true if tokenType() is StartArray.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndArray() const
+
+    Returns true if tokenType() is EndArray.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isName() const
+
+    Returns true if tokenType() is Name.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isString() const
+
+    Returns true if tokenType() is String.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isNumber() const
+
+    Returns true if tokenType() is Number.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isBool() const
+
+    Returns true if tokenType() is Bool.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isNull() const
+
+    Returns true if tokenType() is Null.
+*/
+
+/*!
+    \fn bool QJsonStreamReader::isEndDocument() const
+
+    Returns true if tokenType() is EndDocument.
+*/
+
+/*!
+    Returns true if the reader has read all of its input, or if an error
+    occurred. Input supplied with addData() is never considered complete.
+
+    \sa readNext(), hasError()
+*/
+bool QJsonStreamReader::atEnd() const
+{
+    return d->finished || d->lastError != QJsonParseError::NoError;
+}
+
+/*!
+    Returns true if an error occurred while reading.
+
+    \sa lastError()
+*/
+bool QJsonStreamReader::hasError() const
+{
+    return d->lastError != QJsonParseError::NoError;
+}
+
+/*!
+    Returns the error that occurred while reading, including the offset in the
+    input where it was detected. If no error occurred, the returned object's
+    \l{QJsonParseError::}{error} is QJsonParseError::NoError.
+*/
+QJsonParseError QJsonStreamReader::lastError() const
+{
+    QJsonParseError error;
+    error.error = d->lastError;
+    error.offset = int(d->errorOffset);
+    return error;
+}
+
+/*!
+    Returns the number of objects and arrays that contain the current
+    position. The depth is 0 outside of any container, 1 after the outermost
+    StartObject or StartArray token has been read, and so on.
+*/
+int QJsonStreamReader::containerDepth() const
+{
+    return int(d->containers.size());
+}
+
+/*!
+    Returns the offset of the current token from the beginning of the input,
+    in bytes.
+*/
+qint64 QJsonStreamReader::currentOffset() const
+{
+    return d->tokenOffset;
+}
+
+/*!
+    Returns the text of the current Name or String token, or a null string
+    for any other token.
+*/
+QString QJsonStreamReader::text() const
+{
+    if (d->type == Name || d->type == String)
+        return d->stringValue;
+    return QString();
+}
+
+/*!
+    Returns true if the current token is a Number that can be represented as
+    a 64-bit integer without loss of precision.
+
+    \sa toInteger()
+*/
+bool QJsonStreamReader::isInteger() const
+{
+    return d->type == Number && d->integral;
+}
+
+/*!
+    Returns the value of the current Number token as an integer, if
+    isInteger() returns true. Otherwise, returns 0.
+*/
+qint64 QJsonStreamReader::toInteger() const
+{
+    return isInteger() ? d->integerValue : 0;
+}
+
+/*!
+    Returns the value of the current Number token, or 0 for any other token.
+*/
+double QJsonStreamReader::toDouble() const
+{
+    return d->type == Number ? d->doubleValue : 0;
+}
+
+/*!
+    Returns the value of the current Bool token, or false for any other token.
+*/
+bool QJsonStreamReader::toBool() const
+{
+    return d->type == Bool && d->boolValue;
+}
+
+/*!
+    Returns the current String, Number, Bool or Null token as a QJsonValue.
+    For any other token, an undefined QJsonValue is returned.
+*/
+QJsonValue QJsonStreamReader::value() const
+{
+    switch (d->type) {
+    case String:
+        return QJsonValue(d->stringValue);
+    case Number:
+        if (d->integral)
+            return QJsonValue(d->integerValue);
+        return QJsonValue(d->doubleValue);
+    case Bool:
+        return QJsonValue(d->boolValue);
+    case Null:
+        return QJsonValue(QJsonValue::Null);
+    default:
+        break;
+    }
+    return QJsonValue(QJsonValue::Undefined);
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qjsonstreamreader.cpp"
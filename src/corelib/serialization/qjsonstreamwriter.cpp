@@ -0,0 +1,460 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qjsonstreamwriter.h"
+#include "qjsonwriter_p.h"
+
+#include <private/qnumeric_p.h>
+#include <qcborvalue.h>
+#include <qiodevice.h>
+#include <qjsonvalue.h>
+#include <qlocale.h>
+#include <qvarlengtharray.h>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QJsonPrivate;
+
+static const qsizetype flushThreshold = 16 * 1024;
+
+/*!
+    \class QJsonStreamWriter
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 6.0
+
+    \brief The QJsonStreamWriter class writes JSON text to a QIODevice or a
+    QByteArray, one value at a time.
+
+    QJsonStreamWriter is the counterpart of QJsonStreamReader. It produces
+    JSON text without first building a QJsonDocument, which makes it suitable
+    for writing large documents or long-running streams of records.
+
+    Arrays and objects are opened with startArray() and startObject() and
+    closed with endArray() and endObject(). Inside an object, names and values
+    alternate: the first string appended is the name of a member, the next
+    value appended is that member's value, and so on.
+
+    \snippet code/src_corelib_serialization_qjsonstream.cpp 1
+
+    For the same content, the output is identical to that of
+    QJsonDocument::toJson() in the selected format(). As QJsonDocument sorts
+    the members of objects, this only holds if the members are written in
+    sorted order.
+
+    QJsonStreamWriter also accepts scalar values at the top level, and can
+    write several top-level values in sequence. In the
+    \l{QJsonDocument::Compact}{Compact} format, consecutive top-level values
+    are separated by a newline, producing newline-delimited JSON ("JSON
+    Lines").
+
+    Output is buffered and written to the device whenever a top-level value is
+    complete, when the buffer grows large, and when the writer is destroyed.
+    When writing to a QByteArray, output is appended to it directly.
+
+    Like QCborStreamWriter, this class does not check that the resulting JSON
+    text is valid, beyond the nesting of arrays and objects.
+
+    \sa QJsonStreamReader, QJsonDocument, QCborStreamWriter
+*/
+
+class QJsonStreamWriterPrivate
+{
+public:
+    struct Container {
+        bool isObject;
+        bool hasItems;
+        bool expectName;
+    };
+
+    QByteArray &output() { return data ? *data : buffer; }
+    bool compact() const { return format == QJsonDocument::Compact; }
+    bool expectingName() const
+    { return !containers.isEmpty() && containers.last().isObject && containers.last().expectName; }
+
+    bool beginItem();
+    void endItem();
+    void endContainer(char close);
+    void appendString(QStringView str);
+    void flush();
+
+    QIODevice *device = nullptr;
+    QByteArray *data = nullptr;
+    QByteArray buffer;
+    QJsonDocument::JsonFormat format = QJsonDocument::Indented;
+    QVarLengthArray<Container, 32> containers;
+    bool documentWritten = false;
+};
+
+// Writes whatever separates the next value from the previous one. Returns
+// false if a value isn't acceptable in this position.
+bool QJsonStreamWriterPrivate::beginItem()
+{
+    QByteArray &out = output();
+    if (containers.isEmpty()) {
+        if (documentWritten && compact())
+            out += '\n';
+        documentWritten = true;
+        return true;
+    }
+
+    Container &c = containers.last();
+    if (c.isObject) {
+        if (c.expectName) {
+            qWarning("QJsonStreamWriter: object member names must be strings");
+            return false;
+        }
+        // the separator was written along with the name
+        c.expectName = true;
+        return true;
+    }
+
+    if (c.hasItems)
+        out += compact() ? "," : ",\n";
+    c.hasItems = true;
+    if (!compact())
+        out.append(4 * containers.size(), ' ');
+    return true;
+}
+
+void QJsonStreamWriterPrivate::endItem()
+{
+    if (containers.isEmpty()) {
+        if (!compact())
+            output() += '\n';
+        flush();
+    } else if (buffer.size() >= flushThreshold) {
+        flush();
+    }
+}
+
+void QJsonStreamWriterPrivate::endContainer(char close)
+{
+    const bool hasItems = containers.last().hasItems;
+    containers.removeLast();
+    QByteArray &out = output();
+    if (!compact()) {
+        if (hasItems)
+            out += '\n';
+        out.append(4 * containers.size(), ' ');
+    }
+    out += close;
+    endItem();
+}
+
+void QJsonStreamWriterPrivate::appendString(QStringView str)
+{
+    QByteArray &out = output();
+    if (expectingName()) {
+        Container &c = containers.last();
+        if (c.hasItems)
+            out += compact() ? "," : ",\n";
+        c.hasItems = true;
+        c.expectName = false;
+        if (!compact())
+            out.append(4 * containers.size(), ' ');
+        out += '"';
+        out += Writer::escapedString(str);
+        out += compact() ? "\":" : "\": ";
+        return;
+    }
+
+    if (!beginItem())
+        return;
+    out += '"';
+    out += Writer::escapedString(str);
+    out += '"';
+    endItem();
+}
+
+void QJsonStreamWriterPrivate::flush()
+{
+    if (buffer.isEmpty())
+        return;
+    if (device)
+        device->write(buffer);
+    buffer.truncate(0);
+}
+
+/*!
+    Creates a QJsonStreamWriter that writes to \a device. The device must be
+    open for writing.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QIODevice *device)
+    : d(new QJsonStreamWriterPrivate)
+{
+    d->device = device;
+}
+
+/*!
+    Creates a QJsonStreamWriter that appends its output to \a data.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QByteArray *data)
+    : d(new QJsonStreamWriterPrivate)
+{
+    d->data = data;
+}
+
+/*!
+    Destroys the writer, writing any buffered output to the device.
+
+    QJsonStreamWriter does not check that all arrays and objects were closed.
+*/
+QJsonStreamWriter::~QJsonStreamWriter()
+{
+    d->flush();
+}
+
+/*!
+    Writes any buffered output to the current device and replaces it with
+    \a device. The format and the position in the current document are kept,
+    so this can be used to continue writing to a different device.
+
+    \sa device()
+*/
+void QJsonStreamWriter::setDevice(QIODevice *device)
+{
+    d->flush();
+    d->data = nullptr;
+    d->device = device;
+}
+
+/*!
+    Returns the device the writer writes to, or \nullptr if it was constructed
+    to write to a QByteArray.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamWriter::device() const
+{
+    return d->device;
+}
+
+/*!
+    Sets the output format to \a format. The default is
+    QJsonDocument::Indented. The format should only be changed between
+    top-level values.
+
+    \sa format()
+*/
+void QJsonStreamWriter::setFormat(QJsonDocument::JsonFormat format)
+{
+    d->format = format;
+}
+
+/*!
+    Returns the output format.
+
+    \sa setFormat()
+*/
+QJsonDocument::JsonFormat QJsonStreamWriter::format() const
+{
+    return d->format;
+}
+
+/*!
+    Appends the string \a str. Inside an object, this is either the name of
+    the next member or the value of the current one.
+*/
+void QJsonStreamWriter::append(QStringView str)
+{
+    d->appendString(str);
+}
+
+/*!
+    \overload
+
+    Appends the Latin-1 string \a str.
+*/
+void QJsonStreamWriter::append(QLatin1String str)
+{
+    d->appendString(QString(str));
+}
+
+/*!
+    \overload
+
+    Appends \a len bytes of UTF-8 encoded text starting at \a utf8. If \a len
+    is -1, \a utf8 must be null-terminated.
+*/
+void QJsonStreamWriter::append(const char *utf8, qsizetype len)
+{
+    d->appendString(QString::fromUtf8(utf8, len));
+}
+
+/*!
+    \overload
+
+    Appends the integer \a i.
+*/
+void QJsonStreamWriter::append(qint64 i)
+{
+    if (!d->beginItem())
+        return;
+    d->output() += QByteArray::number(i);
+    d->endItem();
+}
+
+/*!
+    \overload
+
+    Appends the number \a d. As JSON cannot represent infinities and NaN,
+    those are written as \c null, as QJsonDocument does.
+*/
+void QJsonStreamWriter::append(double d)
+{
+    if (!this->d->beginItem())
+        return;
+    if (qIsFinite(d))
+        this->d->output() += QByteArray::number(d, 'g', QLocale::FloatingPointShortest);
+    else
+        this->d->output() += "null"; // +INF || -INF || NaN (see RFC4627#section2.4)
+    this->d->endItem();
+}
+
+/*!
+    \overload
+
+    Appends the boolean \a b.
+*/
+void QJsonStreamWriter::append(bool b)
+{
+    if (!d->beginItem())
+        return;
+    d->output() += b ? "true" : "false";
+    d->endItem();
+}
+
+/*!
+    \fn void QJsonStreamWriter::append(std::nullptr_t)
+    \overload
+
+    Appends a null value. This is the same as appendNull().
+*/
+
+/*!
+    Appends a null value.
+*/
+void QJsonStreamWriter::appendNull()
+{
+    if (!d->beginItem())
+        return;
+    d->output() += "null";
+    d->endItem();
+}
+
+/*!
+    \overload
+
+    Appends \a value, which may itself be an array or an object. Undefined
+    values are written as \c null.
+*/
+void QJsonStreamWriter::append(const QJsonValue &value)
+{
+    if (value.isString()) {
+        d->appendString(value.toString());
+        return;
+    }
+    if (!d->beginItem())
+        return;
+    const int indent = d->compact() ? 0 : int(d->containers.size());
+    Writer::valueToJson(QCborValue::fromJsonValue(value), d->output(), indent, d->compact());
+    d->endItem();
+}
+
+/*!
+    Starts an array. Values appended after this call are elements of the
+    array, until endArray() is called.
+
+    \sa endArray(), startObject()
+*/
+void QJsonStreamWriter::startArray()
+{
+    if (!d->beginItem())
+        return;
+    d->output() += d->compact() ? "[" : "[\n";
+    d->containers.append({ false, false, false });
+}
+
+/*!
+    Ends the array started by the matching startArray(). Returns false if the
+    innermost open container is not an array.
+
+    \sa startArray(), endObject()
+*/
+bool QJsonStreamWriter::endArray()
+{
+    if (d->containers.isEmpty() || d->containers.last().isObject)
+        return false;
+    d->endContainer(']');
+    return true;
+}
+
+/*!
+    Starts an object. Strings and values appended after this call are,
+    alternately, the names and values of the object's members, until
+    endObject() is called.
+
+    \sa endObject(), startArray()
+*/
+void QJsonStreamWriter::startObject()
+{
+    if (!d->beginItem())
+        return;
+    d->output() += d->compact() ? "{" : "{\n";
+    d->containers.append({ true, false, true });
+}
+
+/*!
+    Ends the object started by the matching startObject(). Returns false if
+    the innermost open container is not an object, or if the last member name
+    has no value.
+
+    \sa startObject(), endArray()
+*/
+bool QJsonStreamWriter::endObject()
+{
+    if (!d->expectingName())
+        return false;
+    d->endContainer('}');
+    return true;
+}
+
+QT_END_NAMESPACE
@@ -56,6 +56,8 @@
 
 QT_BEGIN_NAMESPACE
 
+class QCborValue;
+
 namespace QJsonPrivate
 {
 
@@ -64,6 +66,8 @@ class Writer
 public:
     static void objectToJson(const QCborContainerPrivate *o, QByteArray &json, int indent, bool compact = false);
     static void arrayToJson(const QCborContainerPrivate *a, QByteArray &json, int indent, bool compact = false);
+    static void valueToJson(const QCborValue &v, QByteArray &json, int indent, bool compact = false);
+    static QByteArray escapedString(QStringView s);
 };
 
 }
@@ -49,6 +49,7 @@
 #include <qstack.h>
 #include <qbuffer.h>
 #include <qscopeguard.h>
+#include <qvarlengtharray.h>
 #ifndef QT_BOOTSTRAPPED
 #include <qcoreapplication.h>
 #else
@@ -64,7 +65,9 @@ public: \
 private:
 #endif
 #include <private/qmemory_p.h>
+#include <private/qsimd_p.h>
 
+#include <algorithm>
 #include <iterator>
 #include "qxmlstream_p.h"
 #include "qxmlstreamparser_p.h"
@@ -922,6 +925,100 @@ inline uint QXmlStreamReaderPrivate::filterCarriageReturn()
     return '\n';
 }
 
+namespace {
+using CharacterRun = QXmlStreamReaderPrivate::CharacterRun;
+
+/*
+  Returns true if \a c can't be part of a run of characters that the fast
+  scanners copy without looking at them one by one: the control characters,
+  including tab and the line breaks, the non-characters 0xfffe and 0xffff,
+  and the markup characters that end content or a literal.
+*/
+template <CharacterRun Run>
+constexpr bool endsCharacterRun(char16_t c)
+{
+    if constexpr (Run == CharacterRun::Space) {
+        return c != u' ';
+    } else {
+        if (c < 0x20 || c >= 0xfffe || c == u'<' || c == u'&')
+            return true;
+        if constexpr (Run == CharacterRun::Content)
+            return c == u']';
+        else
+            return c == u'"' || c == u'\'';
+    }
+}
+
+#ifdef __SSE2__
+// Returns the PMOVMSKB mask of the characters in \a data ending the run,
+// two bits per character.
+template <CharacterRun Run>
+inline uint characterRunEndMask(__m128i data)
+{
+    if constexpr (Run == CharacterRun::Space) {
+        const __m128i spaces = _mm_cmpeq_epi16(data, _mm_set1_epi16(' '));
+        return ~uint(_mm_movemask_epi8(spaces)) & 0xffff;
+    } else {
+        // there are no unsigned 16-bit comparisons in SSE2, so use saturation:
+        // c < 0x20 if c - 0x1f saturates to 0, c >= 0xfffe if c + 1 saturates
+        const __m128i control = _mm_cmpeq_epi16(_mm_subs_epu16(data, _mm_set1_epi16(0x1f)),
+                                                _mm_setzero_si128());
+        const __m128i nonCharacter = _mm_cmpeq_epi16(_mm_adds_epu16(data, _mm_set1_epi16(1)),
+                                                     _mm_set1_epi16(-1));
+        __m128i result = _mm_or_si128(control, nonCharacter);
+        result = _mm_or_si128(result, _mm_cmpeq_epi16(data, _mm_set1_epi16('<')));
+        result = _mm_or_si128(result, _mm_cmpeq_epi16(data, _mm_set1_epi16('&')));
+        if constexpr (Run == CharacterRun::Content) {
+            result = _mm_or_si128(result, _mm_cmpeq_epi16(data, _mm_set1_epi16(']')));
+        } else {
+            result = _mm_or_si128(result, _mm_cmpeq_epi16(data, _mm_set1_epi16('"')));
+            result = _mm_or_si128(result, _mm_cmpeq_epi16(data, _mm_set1_epi16('\'')));
+        }
+        return uint(_mm_movemask_epi8(result));
+    }
+}
+#endif
+
+template <CharacterRun Run>
+qsizetype characterRunLength(const char16_t *begin, const char16_t *end)
+{
+    const char16_t *ptr = begin;
+#ifdef __SSE2__
+    // we're going to read ptr[0..7] (16 bytes)
+    for (; ptr + 8 <= end; ptr += 8) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        if (const uint mask = characterRunEndMask<Run>(data))
+            return ptr - begin + qCountTrailingZeroBits(mask) / 2;
+    }
+#endif
+    while (ptr != end && !endsCharacterRun<Run>(*ptr))
+        ++ptr;
+    return ptr - begin;
+}
+} // unnamed namespace
+
+/*!
+  \internal
+
+  Appends the characters at the current position of the read buffer to the
+  text buffer, up to the first one that needs to be looked at by the
+  character-by-character loop of the fast scanner for \a Run, and returns
+  their number. Text put back with putChar() is left to that loop as well.
+ */
+template <QXmlStreamReaderPrivate::CharacterRun Run>
+inline int QXmlStreamReaderPrivate::fastScanCharacterRun()
+{
+    if (putStack.size())
+        return 0;
+    const char16_t *begin = reinterpret_cast<const char16_t *>(readBuffer.constData());
+    const int n = int(characterRunLength<Run>(begin + readBufferPos, begin + readBuffer.size()));
+    if (n) {
+        textBuffer.append(readBuffer.constData() + readBufferPos, n);
+        readBufferPos += n;
+    }
+    return n;
+}
+
 /*!
  \internal
  If the end of the file is encountered, ~0 is returned.
@@ -1150,7 +1247,10 @@ inline int QXmlStreamReaderPrivate::fastScanLiteralContent()
 {
     int n = 0;
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    for (;;) {
+        n += fastScanCharacterRun<CharacterRun::Literal>();
+        if ((c = getChar()) == StreamEOF)
+            break;
         switch (ushort(c)) {
         case 0xfffe:
         case 0xffff:
@@ -1200,7 +1300,10 @@ inline int QXmlStreamReaderPrivate::fastScanSpace()
 {
     int n = 0;
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    for (;;) {
+        n += fastScanCharacterRun<CharacterRun::Space>();
+        if ((c = getChar()) == StreamEOF)
+            break;
         switch (c) {
         case '\r':
             if ((c = filterCarriageReturn()) == 0)
@@ -1233,7 +1336,16 @@ inline int QXmlStreamReaderPrivate::fastScanContentCharList()
 {
     int n = 0;
     uint c;
-    while ((c = getChar()) != StreamEOF) {
+    for (;;) {
+        if (const int run = fastScanCharacterRun<CharacterRun::Content>()) {
+            if (isWhitespace) {
+                isWhitespace = std::all_of(textBuffer.cend() - run, textBuffer.cend(),
+                                           [](QChar ch) { return ch == QLatin1Char(' '); });
+            }
+            n += run;
+        }
+        if ((c = getChar()) == StreamEOF)
+            break;
         switch (ushort(c)) {
         case 0xfffe:
         case 0xffff:
@@ -1512,7 +1624,11 @@ uint QXmlStreamReaderPrivate::getChar_helper()
         decoder = QStringDecoder(*encoding);
     }
 
-    readBuffer = decoder(QByteArrayView(rawReadBuffer).first(nbytesread));
+    // decode straight into the read buffer, reusing its capacity
+    readBuffer.resize(decoder.requiredSpace(nbytesread));
+    const QChar *decodedEnd = decoder.appendToBuffer(readBuffer.data(),
+                                                     QByteArrayView(rawReadBuffer).first(nbytesread));
+    readBuffer.truncate(decodedEnd - readBuffer.constData());
 
     if (lockEncoding && decoder.hasError()) {
         raiseWellFormedError(QXmlStream::tr("Encountered incorrectly encoded content."));
@@ -2262,6 +2378,347 @@ QXmlStreamAttributes QXmlStreamReader::attributes() const
     return d->attributes;
 }
 
+/*!
+    \class QXmlStreamSelector
+    \inmodule QtCore
+    \since 6.0
+    \reentrant
+    \ingroup xml-tools
+
+    \brief The QXmlStreamSelector class finds elements matching paths in
+    a single pass over a QXmlStreamReader.
+
+    QXmlStreamSelector extracts parts of XML documents without building a
+    document tree, and without a hand-written state machine around
+    QXmlStreamReader. Each path added with addPath() is compiled once, and
+    select() evaluates all of them while reading the document. The handler
+    of a path is called for every element it matches, with the reader
+    positioned at the StartElement token of that element. The memory needed
+    only depends on the paths and on how deeply the elements are nested, not
+    on the size of the document.
+
+    \code
+    QXmlStreamSelector selector;
+    selector.addPath(QStringLiteral("/catalog/book[@lang='en']/title"),
+                     [&](QXmlStreamReader &reader) { titles << reader.readElementText(); });
+    selector.addPath(QStringLiteral("//price"), [&](QXmlStreamReader &reader) {
+        total += reader.readElementText().toDouble();
+    });
+    QXmlStreamReader reader(&file);
+    if (!selector.select(&reader))
+        qWarning() << reader.errorString();
+    \endcode
+
+    The paths use a subset of the XPath syntax. A path is a sequence of
+    steps, each one made of an axis, a name test and any number of
+    predicates:
+
+    \list
+    \li \c{/name} selects the child elements called \e name, and
+        \c{//name} selects all the descendant elements called \e name.
+    \li A name without a prefix matches elements with that local name in any
+        namespace. A name with a prefix, like \c{svg:rect}, matches the
+        qualified name as written in the document. \c{*} matches any element.
+    \li \c{[@attribute]} requires the element to have the attribute, and
+        \c{[@attribute='value']} or \c{[@attribute="value"]} requires the
+        attribute to have the value. Attributes are matched by their
+        qualified name.
+    \endlist
+
+    A handler may leave the reader where it is, or consume the whole matched
+    element, for instance with QXmlStreamReader::readElementText() or
+    QXmlStreamReader::skipCurrentElement(). In the latter case, the handlers
+    of other paths matching the same element, and the elements inside it,
+    are skipped. A handler can stop the selection by calling
+    QXmlStreamReader::raiseError(). It must not otherwise move the reader.
+
+    \sa QXmlStreamReader
+*/
+
+/*!
+    \typedef QXmlStreamSelector::Handler
+
+    The type of the functions called for the elements matching a path.
+*/
+
+class QXmlStreamSelectorPrivate
+{
+public:
+    struct Predicate
+    {
+        QString attribute;
+        QString value;
+        bool hasValue = false;
+    };
+
+    struct Step
+    {
+        QString name; // empty if any element matches
+        QList<Predicate> predicates;
+        int path = 0;
+        bool descendant = false;
+        bool qualified = false;
+        bool last = false;
+
+        bool matches(const QXmlStreamReader &reader) const;
+    };
+
+    bool parsePath(QStringView path, int pathIndex);
+    void startElement(QXmlStreamReader *reader);
+
+    // Each step owns a bit in the state of an element, which is set if the
+    // steps before it matched the element and its ancestors, that is if the
+    // children of the element are tested against the step.
+    QList<Step> steps;
+    QList<QXmlStreamSelector::Handler> handlers;
+    QString errorString;
+
+    QVarLengthArray<quint64, 64> states; // one state per open element, and the document
+    qsizetype stateSize = 1; // in words, never empty so that states can track the depth
+};
+
+bool QXmlStreamSelectorPrivate::Step::matches(const QXmlStreamReader &reader) const
+{
+    if (!name.isEmpty() && (qualified ? reader.qualifiedName() : reader.name()) != name)
+        return false;
+    if (predicates.isEmpty())
+        return true;
+
+    const QXmlStreamAttributes attributes = reader.attributes();
+    for (const Predicate &predicate : predicates) {
+        const auto hasAttribute = [&predicate](const QXmlStreamAttribute &attribute) {
+            return attribute.qualifiedName() == predicate.attribute
+                    && (!predicate.hasValue || attribute.value() == predicate.value);
+        };
+        if (std::none_of(attributes.cbegin(), attributes.cend(), hasAttribute))
+            return false;
+    }
+    return true;
+}
+
+static bool isPathNameChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == QLatin1Char('_') || c == QLatin1Char('-')
+            || c == QLatin1Char('.') || c == QLatin1Char(':');
+}
+
+bool QXmlStreamSelectorPrivate::parsePath(QStringView path, int pathIndex)
+{
+    const qsizetype firstStep = steps.size();
+    qsizetype pos = 0;
+
+    const auto fail = [&](const QString &message) {
+        steps.resize(firstStep);
+        errorString = QXmlStream::tr("Invalid path '%1' at position %2: %3")
+                .arg(path.toString()).arg(pos + 1).arg(message);
+        return false;
+    };
+    const auto skipSpaces = [&] {
+        while (pos < path.size() && path.at(pos).isSpace())
+            ++pos;
+    };
+    const auto readName = [&] {
+        const qsizetype start = pos;
+        while (pos < path.size() && isPathNameChar(path.at(pos)))
+            ++pos;
+        return path.mid(start, pos - start);
+    };
+
+    if (path.isEmpty())
+        return fail(QXmlStream::tr("the path is empty"));
+
+    while (pos < path.size()) {
+        if (path.at(pos) != QLatin1Char('/'))
+            return fail(QXmlStream::tr("expected '/'"));
+        Step step;
+        step.path = pathIndex;
+        if (++pos < path.size() && path.at(pos) == QLatin1Char('/')) {
+            step.descendant = true;
+            ++pos;
+        }
+
+        if (pos < path.size() && path.at(pos) == QLatin1Char('*')) {
+            ++pos;
+        } else {
+            const QStringView name = readName();
+            if (name.isEmpty())
+                return fail(QXmlStream::tr("expected an element name or '*'"));
+            step.name = name.toString();
+            step.qualified = name.contains(QLatin1Char(':'));
+        }
+
+        while (pos < path.size() && path.at(pos) == QLatin1Char('[')) {
+            ++pos;
+            skipSpaces();
+            if (pos == path.size() || path.at(pos) != QLatin1Char('@'))
+                return fail(QXmlStream::tr("expected '@'"));
+            ++pos;
+            Predicate predicate;
+            predicate.attribute = readName().toString();
+            if (predicate.attribute.isEmpty())
+                return fail(QXmlStream::tr("expected an attribute name"));
+            skipSpaces();
+            if (pos < path.size() && path.at(pos) == QLatin1Char('=')) {
+                ++pos;
+                skipSpaces();
+                const QChar quote = pos < path.size() ? path.at(pos) : QChar();
+                if (quote != QLatin1Char('\'') && quote != QLatin1Char('"'))
+                    return fail(QXmlStream::tr("expected a quoted value"));
+                const qsizetype end = path.indexOf(quote, pos + 1);
+                if (end == -1)
+                    return fail(QXmlStream::tr("unterminated value"));
+                predicate.value = path.mid(pos + 1, end - pos - 1).toString();
+                predicate.hasValue = true;
+                pos = end + 1;
+                skipSpaces();
+            }
+            if (pos == path.size() || path.at(pos) != QLatin1Char(']'))
+                return fail(QXmlStream::tr("expected ']'"));
+            ++pos;
+            step.predicates.append(predicate);
+        }
+        steps.append(step);
+    }
+
+    steps.last().last = true;
+    return true;
+}
+
+void QXmlStreamSelectorPrivate::startElement(QXmlStreamReader *reader)
+{
+    const qsizetype parent = states.size() - stateSize;
+    states.resize(states.size() + stateSize);
+    quint64 *state = states.data() + parent + stateSize;
+    std::fill_n(state, stateSize, 0);
+
+    QVarLengthArray<int, 8> matchedPaths;
+    for (qsizetype word = 0; word < stateSize; ++word) {
+        // elements outside of any match are passed over quickly
+        for (quint64 bits = states.at(parent + word); bits; bits &= bits - 1) {
+            const qsizetype index = word * 64 + qCountTrailingZeroBits(bits);
+            const Step &step = steps.at(index);
+            if (step.descendant)
+                state[index / 64] |= Q_UINT64_C(1) << (index % 64);
+            if (!step.matches(*reader))
+                continue;
+            if (step.last)
+                matchedPaths.append(step.path);
+            else
+                state[(index + 1) / 64] |= Q_UINT64_C(1) << ((index + 1) % 64);
+        }
+    }
+
+    // the steps of each path follow each other, so the paths are matched in order
+    for (int path : qAsConst(matchedPaths)) {
+        handlers.at(path)(*reader);
+        if (!reader->isStartElement()) {
+            // the handler consumed the element, or raised an error
+            if (reader->isEndElement())
+                states.resize(states.size() - stateSize);
+            break;
+        }
+    }
+}
+
+/*!
+    Constructs a selector without any paths.
+*/
+QXmlStreamSelector::QXmlStreamSelector()
+    : d_ptr(new QXmlStreamSelectorPrivate)
+{
+}
+
+/*!
+    Destroys the selector.
+*/
+QXmlStreamSelector::~QXmlStreamSelector()
+{
+}
+
+/*!
+    Compiles \a path and adds it to the paths of this selector. \a handler
+    is called for every element that matches the path in select().
+
+    Returns \c true if the path is valid; otherwise returns \c false, and
+    errorString() describes the problem.
+*/
+bool QXmlStreamSelector::addPath(const QString &path, const Handler &handler)
+{
+    Q_D(QXmlStreamSelector);
+    if (!d->parsePath(path, int(d->handlers.size())))
+        return false;
+    d->handlers.append(handler);
+    d->errorString.clear();
+    d->stateSize = qMax<qsizetype>(1, (d->steps.size() + 63) / 64);
+    return true;
+}
+
+/*!
+    Removes all paths from this selector.
+*/
+void QXmlStreamSelector::clear()
+{
+    Q_D(QXmlStreamSelector);
+    d->steps.clear();
+    d->handlers.clear();
+    d->errorString.clear();
+    d->stateSize = 1;
+}
+
+/*!
+    Returns the reason the last call to addPath() failed, or an empty string
+    if it succeeded.
+*/
+QString QXmlStreamSelector::errorString() const
+{
+    Q_D(const QXmlStreamSelector);
+    return d->errorString;
+}
+
+/*!
+    Reads from \a reader until the end of the document, and calls the handlers
+    of the paths matching the elements read.
+
+    If the reader is positioned at a StartElement token, only the content of
+    that element is read, and the paths are evaluated relative to it: \c{/a}
+    selects its children called \c a. The reader is then left at the
+    matching EndElement token. Otherwise, the paths are evaluated relative to
+    the document.
+
+    Returns \c true if the reading ended without an error; otherwise returns
+    \c false, and the error can be retrieved from \a reader.
+*/
+bool QXmlStreamSelector::select(QXmlStreamReader *reader)
+{
+    Q_D(QXmlStreamSelector);
+    const bool withinElement = reader->isStartElement();
+
+    // the steps starting the paths are tested against the top-level elements
+    d->states.clear();
+    d->states.resize(d->stateSize);
+    std::fill(d->states.begin(), d->states.end(), 0);
+    for (qsizetype index = 0; index < d->steps.size(); ++index) {
+        if (index == 0 || d->steps.at(index - 1).last)
+            d->states[index / 64] |= Q_UINT64_C(1) << (index % 64);
+    }
+
+    while (!reader->atEnd()) {
+        switch (reader->readNext()) {
+        case QXmlStreamReader::StartElement:
+            d->startElement(reader);
+            break;
+        case QXmlStreamReader::EndElement:
+            if (d->states.size() == d->stateSize && withinElement)
+                return true;
+            d->states.resize(d->states.size() - d->stateSize);
+            break;
+        default:
+            break;
+        }
+    }
+    return !reader->hasError();
+}
+
 #endif // QT_NO_XMLSTREAMREADER
 
 /*!
@@ -48,6 +48,8 @@
 #include <QtCore/qscopedpointer.h>
 #include <QtCore/qstring.h>
 
+#include <functional>
+
 QT_BEGIN_NAMESPACE
 
 namespace QtPrivate {
@@ -334,6 +336,26 @@ private:
     QScopedPointer<QXmlStreamReaderPrivate> d_ptr;
 
 };
+
+class QXmlStreamSelectorPrivate;
+class Q_CORE_EXPORT QXmlStreamSelector {
+public:
+    using Handler = std::function<void(QXmlStreamReader &reader)>;
+
+    QXmlStreamSelector();
+    ~QXmlStreamSelector();
+
+    bool addPath(const QString &path, const Handler &handler);
+    void clear();
+    QString errorString() const;
+
+    bool select(QXmlStreamReader *reader);
+
+private:
+    Q_DISABLE_COPY(QXmlStreamSelector)
+    Q_DECLARE_PRIVATE(QXmlStreamSelector)
+    QScopedPointer<QXmlStreamSelectorPrivate> d_ptr;
+};
 #endif // QT_NO_XMLSTREAMREADER
 
 #ifndef QT_NO_XMLSTREAMWRITER
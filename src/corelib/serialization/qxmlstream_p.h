@@ -499,6 +499,8 @@ public:
 
     // scan optimization functions. Not strictly necessary but LALR is
     // not very well suited for scanning fast
+    enum class CharacterRun { Content, Literal, Space };
+    template <CharacterRun Run> inline int fastScanCharacterRun();
     int fastScanLiteralContent();
     int fastScanSpace();
     int fastScanContentCharList();
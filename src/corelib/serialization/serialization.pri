@@ -15,6 +15,8 @@ HEADERS += \
     serialization/qjsonobject.h \
     serialization/qjsonvalue.h \
     serialization/qjsonarray.h \
+    serialization/qjsonstreamreader.h \
+    serialization/qjsonstreamwriter.h \
     serialization/qjsonwriter_p.h \
     serialization/qjsonparser_p.h \
     serialization/qtextstream.h \
@@ -37,6 +39,8 @@ SOURCES += \
     serialization/qjsonvalue.cpp \
     serialization/qjsonwriter.cpp \
     serialization/qjsonparser.cpp \
+    serialization/qjsonstreamreader.cpp \
+    serialization/qjsonstreamwriter.cpp \
     serialization/qtextstream.cpp \
     serialization/qxmlstream.cpp \
     serialization/qxmlstreamgrammar.cpp \
@@ -44,10 +48,12 @@ SOURCES += \
 
 qtConfig(cborstreamreader): {
     SOURCES += \
-        serialization/qcborstreamreader.cpp
+        serialization/qcborstreamreader.cpp \
+        serialization/qcborvalueview.cpp
 
     HEADERS += \
-        serialization/qcborstreamreader.h
+        serialization/qcborstreamreader.h \
+        serialization/qcborvalueview.h
 }
 
 qtConfig(cborstreamwriter): {
@@ -58,6 +64,14 @@ qtConfig(cborstreamwriter): {
         serialization/qcborstreamwriter.h
 }
 
+qtConfig(cborstreamreader):qtConfig(cborstreamwriter): {
+    SOURCES += \
+        serialization/qcborgadgetserializer.cpp
+
+    HEADERS += \
+        serialization/qcborgadgetserializer.h
+}
+
 false: SOURCES += \
     serialization/qcborarray.cpp \
     serialization/qcbormap.cpp
@@ -2906,6 +2906,11 @@ QDataStream &operator>>(QDataStream &in, QByteArray &ba)
     if (len == 0xffffffff)
         return in;
 
+    if (const char *data = in.readRawDataReference(len)) {
+        ba = QByteArray::fromRawData(data, len);
+        return in;
+    }
+
     const quint32 Step = 1024 * 1024;
     quint32 allocated = 0;
 
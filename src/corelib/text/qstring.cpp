@@ -9541,6 +9541,14 @@ QDataStream &operator>>(QDataStream &in, QString &str)
             quint32 len = bytes / 2;
             quint32 allocated = 0;
 
+            if ((in.byteOrder() == QDataStream::BigEndian)
+                    == (QSysInfo::ByteOrder == QSysInfo::BigEndian)) {
+                if (const char *data = in.readRawDataReference(bytes, alignof(QChar))) {
+                    str = QString::fromRawData(reinterpret_cast<const QChar *>(data), len);
+                    return in;
+                }
+            }
+
             while (allocated < len) {
                 int blockSize = qMin(Step, len - allocated);
                 str.resize(allocated + blockSize);
@@ -0,0 +1,676 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qdatetimeformatter.h"
+
+#include "qlist.h"
+#include "qlocale.h"
+#include "private/qlocale_p.h"
+#if QT_CONFIG(datetimeparser)
+#include "private/qdatetimeparser_p.h"
+#endif
+
+#include <iterator>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+class QDateTimeFormatterPrivate : public QSharedData
+{
+public:
+    enum TokenType : quint8 {
+        Literal,
+        Year,
+        Year2Digits,
+        Month,
+        MonthName,
+        Day,
+        DayName,
+        Hour,
+        Hour12,
+        Minute,
+        Second,
+        MSec,
+        MSecTrimmed,
+        AmPm,
+        ZoneAbbreviation,
+        IsoOffset,
+        TextOffset
+    };
+    struct Token {
+        TokenType type;
+        quint8 width;       // digits for numbers, QLocale::FormatType for names
+        quint16 size;       // literal length
+        int offset;         // literal offset in literals, or AmPm upper-case flag
+    };
+
+    explicit QDateTimeFormatterPrivate(Qt::DateFormat format);
+    QDateTimeFormatterPrivate(QStringView format, QCalendar cal);
+
+    qsizetype format(const QDateTime &dateTime, QChar *buffer, qsizetype size) const;
+    QDateTime parseIsoDate(QStringView string) const;
+
+    QList<Token> tokens;
+    QString literals;
+    QCalendar calendar;
+#if QT_CONFIG(datetimeparser)
+    std::unique_ptr<QDateTimeParser> parser;
+#endif
+    Qt::DateFormat dateFormat = Qt::TextDate;
+    bool usesDateFormat = false;
+    bool isoYearRange = false;
+
+private:
+    void addLiteral(QStringView text);
+    void addToken(TokenType type, int width = 0, int offset = 0)
+    { tokens.append({ type, quint8(width), 0, offset }); }
+    void compile(QStringView format);
+};
+
+namespace {
+// Emulates snprintf(): everything past the end of the buffer is counted, not stored
+struct Output
+{
+    QChar *data;
+    qsizetype capacity;
+    qsizetype length = 0;
+
+    void append(QChar ch)
+    {
+        if (length < capacity)
+            data[length] = ch;
+        ++length;
+    }
+
+    void append(QStringView text)
+    {
+        if (length < capacity)
+            memcpy(data + length, text.data(),
+                   qMin(text.size(), capacity - length) * sizeof(QChar));
+        length += text.size();
+    }
+
+    void appendNumber(int value, int width)
+    {
+        // Zero-padded like QLocaleData::longLongToString(), the sign counting
+        // towards the width
+        char16_t digits[12];
+        char16_t *end = digits + sizeof(digits) / sizeof(*digits);
+        char16_t *p = end;
+        uint u = value < 0 ? 0u - uint(value) : uint(value);
+        do {
+            *--p = u'0' + u % 10;
+            u /= 10;
+        } while (u);
+        if (value < 0) {
+            append(u'-');
+            --width;
+        }
+        for (qsizetype n = end - p; n < width; ++n)
+            append(u'0');
+        append(QStringView(p, end));
+    }
+
+    void appendOffset(int offset, bool colon)
+    {
+        append(offset >= 0 ? u'+' : u'-');
+        offset = qAbs(offset);
+        appendNumber(offset / 3600, 2);
+        if (colon)
+            append(u':');
+        appendNumber((offset / 60) % 60, 2);
+    }
+};
+} // unnamed namespace
+
+QDateTimeFormatterPrivate::QDateTimeFormatterPrivate(Qt::DateFormat format)
+    : dateFormat(format), usesDateFormat(true)
+{
+    switch (format) {
+    case Qt::ISODate:
+    case Qt::ISODateWithMs:
+        // yyyy-MM-ddTHH:mm:ss[.zzz][Z|+HH:mm], see QDateTime::toString()
+        isoYearRange = true;
+        addToken(Year, 4);
+        addLiteral(u"-");
+        addToken(Month, 2);
+        addLiteral(u"-");
+        addToken(Day, 2);
+        addLiteral(u"T");
+        addToken(Hour, 2);
+        addLiteral(u":");
+        addToken(Minute, 2);
+        addLiteral(u":");
+        addToken(Second, 2);
+        if (format == Qt::ISODateWithMs) {
+            addLiteral(u".");
+            addToken(MSec, 3);
+        }
+        addToken(IsoOffset);
+        break;
+    case Qt::RFC2822Date:
+        compile(u"dd MMM yyyy hh:mm:ss ");
+        addToken(TextOffset);
+        break;
+    default:
+        // Qt::TextDate depends on the time spec in too many ways to be worth
+        // precompiling; toString() and fromString() defer to QDateTime.
+        break;
+    }
+}
+
+QDateTimeFormatterPrivate::QDateTimeFormatterPrivate(QStringView format, QCalendar cal)
+    : calendar(cal)
+{
+    compile(format);
+#if QT_CONFIG(datetimeparser)
+    parser.reset(new QDateTimeParser(QMetaType::QDateTime, QDateTimeParser::FromString, cal));
+    parser->setDefaultLocale(QLocale::c());
+    if (!parser->parseFormat(format))
+        parser.reset();
+#endif
+}
+
+void QDateTimeFormatterPrivate::addLiteral(QStringView text)
+{
+    if (text.isEmpty())
+        return;
+    // merge with a preceding literal, they're always contiguous
+    if (!tokens.isEmpty() && tokens.constLast().type == Literal
+            && tokens.constLast().size + text.size() <= 0xffff) {
+        tokens.last().size += quint16(text.size());
+    } else {
+        Q_ASSERT(text.size() <= 0xffff);
+        tokens.append({ Literal, 0, quint16(text.size()), int(literals.size()) });
+    }
+    literals += text;
+}
+
+// Mirrors the format interpretation of QCalendarBackend::dateTimeToString()
+void QDateTimeFormatterPrivate::compile(QStringView format)
+{
+    bool hasAmPm = false;
+    for (int i = 0; i < format.size(); ) {
+        if (format.at(i).unicode() == '\'') {
+            qt_readEscapedFormatString(format, &i);
+        } else {
+            if (format.at(i).toLower().unicode() == 'a')
+                hasAmPm = true;
+            ++i;
+        }
+    }
+
+    int i = 0;
+    while (i < format.size()) {
+        if (format.at(i).unicode() == '\'') {
+            const QString text = qt_readEscapedFormatString(format, &i);
+            for (qsizetype from = 0; from < text.size(); from += 0xffff)
+                addLiteral(QStringView(text).mid(from, 0xffff));
+            continue;
+        }
+
+        const QChar c = format.at(i);
+        int repeat = qt_repeatCount(format.mid(i));
+        bool used = true;
+        switch (c.unicode()) {
+        case 'y':
+            if (repeat >= 4) {
+                repeat = 4;
+                addToken(Year, 4);
+            } else if (repeat >= 2) {
+                repeat = 2;
+                addToken(Year2Digits, 2);
+            } else {
+                used = false;
+            }
+            break;
+        case 'M':
+            repeat = qMin(repeat, 4);
+            if (repeat <= 2)
+                addToken(Month, repeat);
+            else
+                addToken(MonthName, repeat == 3 ? QLocale::ShortFormat : QLocale::LongFormat);
+            break;
+        case 'd':
+            repeat = qMin(repeat, 4);
+            if (repeat <= 2)
+                addToken(Day, repeat);
+            else
+                addToken(DayName, repeat == 3 ? QLocale::ShortFormat : QLocale::LongFormat);
+            break;
+        case 'h':
+            repeat = qMin(repeat, 2);
+            addToken(hasAmPm ? Hour12 : Hour, repeat);
+            break;
+        case 'H':
+            repeat = qMin(repeat, 2);
+            addToken(Hour, repeat);
+            break;
+        case 'm':
+            repeat = qMin(repeat, 2);
+            addToken(Minute, repeat);
+            break;
+        case 's':
+            repeat = qMin(repeat, 2);
+            addToken(Second, repeat);
+            break;
+        case 'a':
+        case 'A':
+            repeat = format.mid(i + 1).startsWith(c == u'a' ? u'p' : u'P') ? 2 : 1;
+            addToken(AmPm, 0, c == u'A');
+            break;
+        case 'z':
+            repeat = (repeat >= 3) ? 3 : 1;
+            addToken(repeat == 3 ? MSec : MSecTrimmed, 3);
+            break;
+        case 't':
+            repeat = 1;
+            addToken(ZoneAbbreviation);
+            break;
+        default:
+            used = false;
+            break;
+        }
+        if (!used)
+            addLiteral(QString(repeat, c));
+        i += repeat;
+    }
+}
+
+qsizetype QDateTimeFormatterPrivate::format(const QDateTime &dateTime,
+                                            QChar *buffer, qsizetype size) const
+{
+    const QDate date = dateTime.date();
+    const QTime time = dateTime.time();
+    const auto parts = calendar.partsFromDate(date);
+    if (!parts.isValid() || (isoYearRange && (parts.year < 0 || parts.year > 9999)))
+        return 0;
+
+    Output out{ buffer, size };
+    const QLocale c = QLocale::c();
+    for (const Token &token : tokens) {
+        switch (token.type) {
+        case Literal:
+            out.append(QStringView(literals).mid(token.offset, token.size));
+            break;
+        case Year:
+            out.appendNumber(parts.year, parts.year < 0 ? 5 : 4);
+            break;
+        case Year2Digits:
+            out.appendNumber(parts.year % 100, 2);
+            break;
+        case Month:
+            out.appendNumber(parts.month, token.width);
+            break;
+        case MonthName:
+            out.append(calendar.monthName(c, parts.month, parts.year,
+                                          QLocale::FormatType(token.width)));
+            break;
+        case Day:
+            out.appendNumber(parts.day, token.width);
+            break;
+        case DayName:
+            out.append(c.dayName(calendar.dayOfWeek(date), QLocale::FormatType(token.width)));
+            break;
+        case Hour:
+            out.appendNumber(time.hour(), token.width);
+            break;
+        case Hour12: {
+            int hour = time.hour();
+            if (hour > 12)
+                hour -= 12;
+            else if (hour == 0)
+                hour = 12;
+            out.appendNumber(hour, token.width);
+            break;
+        }
+        case Minute:
+            out.appendNumber(time.minute(), token.width);
+            break;
+        case Second:
+            out.appendNumber(time.second(), token.width);
+            break;
+        case MSec:
+            out.appendNumber(time.msec(), 3);
+            break;
+        case MSecTrimmed: {
+            // drop up to two trailing zeros, the way QCalendarBackend does
+            int msec = time.msec();
+            int width = 3;
+            for (; width > 1 && msec % 10 == 0; --width)
+                msec /= 10;
+            out.appendNumber(msec, width);
+            break;
+        }
+        case AmPm: {
+            const QString text = time.hour() < 12 ? c.amText() : c.pmText();
+            out.append(token.offset ? text.toUpper() : text.toLower());
+            break;
+        }
+        case ZoneAbbreviation:
+            out.append(dateTime.timeZoneAbbreviation());
+            break;
+        case IsoOffset:
+            switch (dateTime.timeSpec()) {
+            case Qt::UTC:
+                out.append(u'Z');
+                break;
+            case Qt::LocalTime:
+                break;
+            default:
+                out.appendOffset(dateTime.offsetFromUtc(), true);
+                break;
+            }
+            break;
+        case TextOffset:
+            out.appendOffset(dateTime.offsetFromUtc(), false);
+            break;
+        }
+    }
+    return out.length;
+}
+
+static int readDigits(QStringView string, qsizetype from, int count)
+{
+    int value = 0;
+    for (qsizetype i = from; i < from + count; ++i) {
+        const char16_t ch = string.at(i).unicode();
+        if (ch < u'0' || ch > u'9')
+            return -1;
+        value = value * 10 + (ch - u'0');
+    }
+    return value;
+}
+
+// Handles the yyyy-MM-ddTHH:mm:ss[.zzz][Z|+HH:mm] form that toString()
+// produces; returns an invalid QDateTime for anything else, which the caller
+// then hands to QDateTime::fromString().
+QDateTime QDateTimeFormatterPrivate::parseIsoDate(QStringView string) const
+{
+    if (string.size() < 19 || string.at(4) != u'-' || string.at(7) != u'-'
+            || !(string.at(10) == u'T' || string.at(10) == u't' || string.at(10) == u' ')
+            || string.at(13) != u':' || string.at(16) != u':') {
+        return QDateTime();
+    }
+
+    const int year = readDigits(string, 0, 4);
+    const int month = readDigits(string, 5, 2);
+    const int day = readDigits(string, 8, 2);
+    const int hour = readDigits(string, 11, 2);
+    const int minute = readDigits(string, 14, 2);
+    const int second = readDigits(string, 17, 2);
+    int msec = 0;
+    qsizetype pos = 19;
+    if (pos < string.size() && string.at(pos) == u'.') {
+        if (string.size() < pos + 4)
+            return QDateTime();
+        msec = readDigits(string, pos + 1, 3);
+        pos += 4;
+    }
+
+    Qt::TimeSpec spec = Qt::LocalTime;
+    int offset = 0;
+    if (pos < string.size()) {
+        const QChar ch = string.at(pos);
+        if ((ch == u'Z' || ch == u'z') && pos + 1 == string.size()) {
+            spec = Qt::UTC;
+        } else if ((ch == u'+' || ch == u'-') && pos + 6 == string.size()
+                   && string.at(pos + 3) == u':') {
+            const int hh = readDigits(string, pos + 1, 2);
+            const int mm = readDigits(string, pos + 4, 2);
+            if (hh < 0 || hh > 23 || mm < 0 || mm > 59)
+                return QDateTime();
+            offset = (hh * 60 + mm) * 60;
+            if (ch == u'-')
+                offset = -offset;
+            spec = Qt::OffsetFromUTC;
+        } else {
+            return QDateTime();
+        }
+    }
+
+    // readDigits() flags non-digits as -1, which the QDate and QTime
+    // validity checks reject along with out-of-range fields
+    if (year < 0 || month < 0 || day < 0 || !QTime::isValid(hour, minute, second, msec))
+        return QDateTime();
+    const QDate date(year, month, day);
+    if (!date.isValid())
+        return QDateTime();
+    return QDateTime(date, QTime(hour, minute, second, msec), spec, offset);
+}
+
+/*!
+    \class QDateTimeFormatter
+    \inmodule QtCore
+    \reentrant
+    \since 6.0
+
+    \brief The QDateTimeFormatter class converts between QDateTime and text
+    using a format that is only interpreted once.
+
+    QDateTime::toString() and QDateTime::fromString() interpret their format
+    argument anew on each call. When many values are converted with the same
+    format, as when writing time stamps to a log, that interpretation can
+    easily cost more than the conversion itself. QDateTimeFormatter does the
+    work once, when it is constructed, and can then be used any number of
+    times, from any number of threads.
+
+    \snippet code/src_corelib_time_qdatetimeformatter.cpp 0
+
+    A formatter produces exactly the same text as QDateTime::toString() and
+    accepts exactly the same text as QDateTime::fromString() would, given the
+    same format. Names of days and months, and AM/PM indicators, are in
+    English (C locale).
+
+    For Qt::ISODate and Qt::ISODateWithMs, both of which follow
+    \l{RFC 3339}, formatting and parsing of the form toString() produces do
+    not go through the general format machinery at all. The formatTo()
+    function writes directly into a buffer supplied by the caller, avoiding
+    the allocation of a QString.
+
+    \sa QDateTime::toString(), QDateTime::fromString(), QLocale::toString()
+*/
+
+/*!
+    Constructs an invalid formatter. Its toString() returns an empty string
+    and its fromString() an invalid QDateTime.
+
+    \sa isValid()
+*/
+QDateTimeFormatter::QDateTimeFormatter() noexcept = default;
+
+/*!
+    Constructs a formatter for the standard \a format.
+
+    \sa QDateTime::toString(Qt::DateFormat), QDateTime::fromString(QStringView, Qt::DateFormat)
+*/
+QDateTimeFormatter::QDateTimeFormatter(Qt::DateFormat format)
+    : d(new QDateTimeFormatterPrivate(format))
+{
+}
+
+/*!
+    Constructs a formatter for \a format, which uses the expressions
+    documented for QDateTime::toString() and QDateTime::fromString(), with
+    dates represented in the calendar \a cal.
+
+    \sa QDateTime::toString(QStringView, QCalendar)
+*/
+QDateTimeFormatter::QDateTimeFormatter(QStringView format, QCalendar cal)
+    : d(new QDateTimeFormatterPrivate(format, cal))
+{
+}
+
+/*!
+    Constructs a copy of \a other. Both share the precompiled format.
+*/
+QDateTimeFormatter::QDateTimeFormatter(const QDateTimeFormatter &other) = default;
+
+/*!
+    \fn QDateTimeFormatter::QDateTimeFormatter(QDateTimeFormatter &&other)
+
+    Move-constructs a formatter from \a other.
+*/
+QDateTimeFormatter::QDateTimeFormatter(QDateTimeFormatter &&other) noexcept = default;
+
+/*!
+    Makes this formatter a copy of \a other and returns a reference to it.
+*/
+QDateTimeFormatter &QDateTimeFormatter::operator=(const QDateTimeFormatter &other) = default;
+
+/*!
+    \fn QDateTimeFormatter &QDateTimeFormatter::operator=(QDateTimeFormatter &&other)
+
+    Move-assigns \a other to this formatter and returns a reference to it.
+*/
+QDateTimeFormatter &QDateTimeFormatter::operator=(QDateTimeFormatter &&other) noexcept = default;
+
+/*!
+    Destroys the formatter.
+*/
+QDateTimeFormatter::~QDateTimeFormatter() = default;
+
+/*!
+    \fn void QDateTimeFormatter::swap(QDateTimeFormatter &other)
+
+    Swaps this formatter with \a other. This operation is very fast and never
+    fails.
+*/
+
+/*!
+    \fn bool QDateTimeFormatter::isValid() const
+
+    Returns \c true unless this formatter was default-constructed.
+*/
+
+/*!
+    Returns \a dateTime formatted as text, exactly as QDateTime::toString()
+    would with the format this formatter was constructed with.
+
+    If \a dateTime is invalid, or cannot be represented in the format, a null
+    string is returned.
+
+    \sa formatTo(), fromString()
+*/
+QString QDateTimeFormatter::toString(const QDateTime &dateTime) const
+{
+    if (!d || !dateTime.isValid())
+        return QString();
+    if (d->usesDateFormat && d->tokens.isEmpty())
+        return dateTime.toString(d->dateFormat);
+
+    QChar buffer[64];
+    const qsizetype length = d->format(dateTime, buffer, std::size(buffer));
+    if (length == 0)
+        return QString();
+    if (length <= qsizetype(std::size(buffer)))
+        return QString(buffer, length);
+    QString result(length, Qt::Uninitialized);
+    d->format(dateTime, result.data(), length);
+    return result;
+}
+
+/*!
+    Formats \a dateTime the way toString() does, writing the result to
+    \a buffer, which has room for \a size characters, without allocating
+    memory for the result.
+
+    Returns the length of the full result, which may be larger than \a size;
+    only the first \a size characters are then written. No terminating null
+    character is appended. If \a dateTime is invalid or cannot be represented
+    in the format, nothing is written and 0 is returned.
+
+    \code
+    QChar buffer[32];
+    const qsizetype length = formatter.formatTo(QDateTime::currentDateTimeUtc(),
+                                                buffer, std::size(buffer));
+    if (length <= std::size(buffer))
+        log.append(QStringView(buffer, length));
+    \endcode
+
+    \sa toString()
+*/
+qsizetype QDateTimeFormatter::formatTo(const QDateTime &dateTime, QChar *buffer,
+                                       qsizetype size) const
+{
+    if (!d || !dateTime.isValid())
+        return 0;
+    if (d->usesDateFormat && d->tokens.isEmpty()) {
+        const QString text = dateTime.toString(d->dateFormat);
+        if (size > 0)
+            memcpy(buffer, text.constData(), qMin(text.size(), size) * sizeof(QChar));
+        return text.size();
+    }
+    return d->format(dateTime, buffer, size);
+}
+
+/*!
+    Returns the QDateTime represented by \a string, exactly as
+    QDateTime::fromString() would with the format this formatter was
+    constructed with. If \a string cannot be parsed, an invalid QDateTime is
+    returned.
+
+    \sa toString()
+*/
+QDateTime QDateTimeFormatter::fromString(QStringView string) const
+{
+    if (!d)
+        return QDateTime();
+    if (d->usesDateFormat) {
+        if (d->dateFormat == Qt::ISODate || d->dateFormat == Qt::ISODateWithMs) {
+            const QDateTime result = d->parseIsoDate(string);
+            if (result.isValid())
+                return result;
+        }
+        return QDateTime::fromString(string, d->dateFormat);
+    }
+#if QT_CONFIG(datetimeparser)
+    if (d->parser) {
+        // QDateTimeParser keeps state while parsing; a copy of the prepared
+        // one is cheap and lets threads share this formatter.
+        QDateTimeParser parser(*d->parser);
+        QDateTime result;
+        if (parser.fromString(string.toString(), &result))
+            return result;
+    }
+#endif
+    return QDateTime();
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,82 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QDATETIMEFORMATTER_H
+#define QDATETIMEFORMATTER_H
+
+#include <QtCore/qcalendar.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qshareddata.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qstringview.h>
+
+QT_REQUIRE_CONFIG(datestring);
+
+QT_BEGIN_NAMESPACE
+
+class QDateTimeFormatterPrivate;
+class Q_CORE_EXPORT QDateTimeFormatter
+{
+public:
+    QDateTimeFormatter() noexcept;
+    explicit QDateTimeFormatter(Qt::DateFormat format);
+    explicit QDateTimeFormatter(QStringView format, QCalendar cal = QCalendar());
+    QDateTimeFormatter(const QDateTimeFormatter &other);
+    QDateTimeFormatter(QDateTimeFormatter &&other) noexcept;
+    QDateTimeFormatter &operator=(const QDateTimeFormatter &other);
+    QDateTimeFormatter &operator=(QDateTimeFormatter &&other) noexcept;
+    ~QDateTimeFormatter();
+
+    void swap(QDateTimeFormatter &other) noexcept { d.swap(other.d); }
+
+    bool isValid() const noexcept { return d; }
+
+    QString toString(const QDateTime &dateTime) const;
+    qsizetype formatTo(const QDateTime &dateTime, QChar *buffer, qsizetype size) const;
+    QDateTime fromString(QStringView string) const;
+
+private:
+    QExplicitlySharedDataPointer<QDateTimeFormatterPrivate> d;
+};
+
+Q_DECLARE_SHARED(QDateTimeFormatter)
+
+QT_END_NAMESPACE
+
+#endif // QDATETIMEFORMATTER_H
@@ -53,6 +53,7 @@
 //
 
 #include "qlist.h"
+#include "qshareddata.h"
 #include "qtimezone.h"
 #include "private/qlocale_p.h"
 
@@ -290,14 +291,26 @@ constexpr inline bool operator==(const QTzTransitionRule &lhs, const QTzTransiti
 constexpr inline bool operator!=(const QTzTransitionRule &lhs, const QTzTransitionRule &rhs) noexcept
 { return !operator==(lhs, rhs); }
 
+class QTzPosixTransitions;
+
 // These are stored separately from QTzTimeZonePrivate so that they can be
-// cached, avoiding the need to re-parse them from disk constantly.
+// cached, avoiding the need to re-parse them from disk constantly. Every
+// QTzTimeZonePrivate for a zone shares the same, read-only, data.
 struct QTzTimeZoneCacheEntry
 {
     QList<QTzTransitionTime> m_tranTimes;
     QList<QTzTransitionRule> m_tranRules;
     QList<QByteArray> m_abbreviations;
+    QList<QString> m_abbreviationNames; // m_abbreviations, decoded
     QByteArray m_posixRule;
+    QExplicitlySharedDataPointer<QTzPosixTransitions> m_posixTransitions;
+
+    // Index into m_tranTimes by spans of 2^IndexSpanBits ms, about a year:
+    // m_yearIndex[i] is the first transition at or after m_indexStart + i
+    // spans. Transitions before m_indexStart are found by binary search.
+    enum { IndexSpanBits = 35 };
+    QList<int> m_yearIndex;
+    qint64 m_indexStart = 0;
 };
 
 class Q_AUTOTEST_EXPORT QTzTimeZonePrivate final : public QTimeZonePrivate
@@ -347,11 +360,12 @@ private:
     QList<QTimeZonePrivate::Data> getPosixTransitions(qint64 msNear) const;
 
     Data dataForTzTransition(QTzTransitionTime tran) const;
+    qsizetype transitionIndex(qint64 atMSecsSinceEpoch) const;
 #if QT_CONFIG(icu)
     mutable QSharedDataPointer<QTimeZonePrivate> m_icu;
 #endif
     QTzTimeZoneCacheEntry cached_data;
-    QList<QTzTransitionTime> tranCache() const { return cached_data.m_tranTimes; }
+    const QList<QTzTransitionTime> &tranCache() const { return cached_data.m_tranTimes; }
 };
 #endif // Q_OS_UNIX
 
@@ -41,6 +41,8 @@
 
 #include "qtimezone.h"
 #include "qtimezoneprivate_p.h"
+#include "private/qcalendarmath_p.h"
+#include "private/qgregoriancalendar_p.h"
 #include "private/qlocale_tools_p.h"
 
 #include <QtCore/QDataStream>
@@ -48,6 +50,7 @@
 #include <QtCore/QFile>
 #include <QtCore/QHash>
 #include <QtCore/QMutex>
+#include <QtCore/QReadWriteLock>
 
 #include <qdebug.h>
 #include <qplatformdefs.h>
@@ -532,64 +535,160 @@ PosixZone PosixZone::parse(const char *&pos, const char *end)
     return {std::move(name), offset};
 }
 
-static QList<QTimeZonePrivate::Data> calculatePosixTransitions(const QByteArray &posixRule, int startYear, int endYear,
-                                                               qint64 lastTranMSecs)
+/*
+    The transitions a POSIX rule implies, as used for the years after a TZif
+    file's last transition. The rule is parsed once and the transitions of
+    each year computed when first needed; they are then shared, via the
+    QTzTimeZoneCache, by all QTzTimeZonePrivate instances for the zone.
+*/
+class QTzPosixTransitions : public QSharedData
 {
-    QList<QTimeZonePrivate::Data> result;
+public:
+    explicit QTzPosixTransitions(const QByteArray &posixRule);
+
+    QList<QTimeZonePrivate::Data> transitions(int startYear, int endYear,
+                                              qint64 lastTranMSecs) const;
+    bool findData(qint64 forMSecsSinceEpoch, bool orFirst, QTimeZonePrivate::Data *data) const;
 
+private:
+    QTimeZonePrivate::Data constantData(qint64 atMSecsSinceEpoch) const;
+    QList<QTimeZonePrivate::Data> calculateYear(int year) const;
+    QList<QTimeZonePrivate::Data> yearTransitions(int year) const;
+
+    // Beyond this, years are computed on each use instead of being cached
+    enum { MaxCachedYears = 1000 };
+
+    PosixZone m_stdZone;
+    PosixZone m_dstZone = PosixZone::invalid();
+    QByteArray m_dstDateRule;
+    QByteArray m_stdDateRule;
+    QTime m_dstTime;
+    QTime m_stdTime;
+    bool m_hasTransitions = false;
+
+    mutable QReadWriteLock m_lock;
+    mutable QHash<int, QList<QTimeZonePrivate::Data>> m_years;
+};
+
+QTzPosixTransitions::QTzPosixTransitions(const QByteArray &posixRule)
+{
     // POSIX Format is like "TZ=CST6CDT,M3.2.0/2:00:00,M11.1.0/2:00:00"
     // i.e. "std offset dst [offset],start[/time],end[/time]"
     // See the section about TZ at
     // http://pubs.opengroup.org/onlinepubs/9699919799/basedefs/V1_chap08.html
     QList<QByteArray> parts = posixRule.split(',');
 
-    PosixZone stdZone, dstZone = PosixZone::invalid();
     {
         const QByteArray &zoneinfo = parts.at(0);
         const char *begin = zoneinfo.constBegin();
 
-        stdZone = PosixZone::parse(begin, zoneinfo.constEnd());
-        if (!stdZone.hasValidOffset()) {
-            stdZone.offset = 0;     // reset to UTC if we failed to parse
+        m_stdZone = PosixZone::parse(begin, zoneinfo.constEnd());
+        if (!m_stdZone.hasValidOffset()) {
+            m_stdZone.offset = 0;     // reset to UTC if we failed to parse
         } else if (begin < zoneinfo.constEnd()) {
-            dstZone = PosixZone::parse(begin, zoneinfo.constEnd());
-            if (!dstZone.hasValidOffset()) {
+            m_dstZone = PosixZone::parse(begin, zoneinfo.constEnd());
+            if (!m_dstZone.hasValidOffset()) {
                 // if the dst offset isn't provided, it is 1 hour ahead of the standard offset
-                dstZone.offset = stdZone.offset + (60 * 60);
+                m_dstZone.offset = m_stdZone.offset + (60 * 60);
             }
         }
     }
 
     // If only the name part then no transitions
-    if (parts.count() == 1) {
-        QTimeZonePrivate::Data data;
-        data.atMSecsSinceEpoch = lastTranMSecs;
-        data.offsetFromUtc = stdZone.offset;
-        data.standardTimeOffset = stdZone.offset;
-        data.daylightTimeOffset = 0;
-        data.abbreviation = stdZone.name;
-        result << data;
-        return result;
-    }
-
+    if (parts.count() == 1)
+        return;
+    m_hasTransitions = true;
 
     // Get the std to dst transtion details
     QList<QByteArray> dstParts = parts.at(1).split('/');
-    QByteArray dstDateRule = dstParts.at(0);
-    QTime dstTime;
+    m_dstDateRule = dstParts.at(0);
     if (dstParts.count() > 1)
-        dstTime = parsePosixTransitionTime(dstParts.at(1));
+        m_dstTime = parsePosixTransitionTime(dstParts.at(1));
     else
-        dstTime = QTime(2, 0, 0);
+        m_dstTime = QTime(2, 0, 0);
 
     // Get the dst to std transtion details
     QList<QByteArray> stdParts = parts.at(2).split('/');
-    QByteArray stdDateRule = stdParts.at(0);
-    QTime stdTime;
+    m_stdDateRule = stdParts.at(0);
     if (stdParts.count() > 1)
-        stdTime = parsePosixTransitionTime(stdParts.at(1));
+        m_stdTime = parsePosixTransitionTime(stdParts.at(1));
     else
-        stdTime = QTime(2, 0, 0);
+        m_stdTime = QTime(2, 0, 0);
+}
+
+QTimeZonePrivate::Data QTzPosixTransitions::constantData(qint64 atMSecsSinceEpoch) const
+{
+    QTimeZonePrivate::Data data;
+    data.atMSecsSinceEpoch = atMSecsSinceEpoch;
+    data.offsetFromUtc = m_stdZone.offset;
+    data.standardTimeOffset = m_stdZone.offset;
+    data.daylightTimeOffset = 0;
+    data.abbreviation = m_stdZone.name;
+    return data;
+}
+
+QList<QTimeZonePrivate::Data> QTzPosixTransitions::calculateYear(int year) const
+{
+    QList<QTimeZonePrivate::Data> result;
+    const int minYear = int(QDateTime::YearRange::First);
+    const int maxYear = int(QDateTime::YearRange::Last);
+
+    QTimeZonePrivate::Data dstData;
+    QDateTime dst(calculatePosixDate(m_dstDateRule, year), m_dstTime, Qt::UTC);
+    dstData.atMSecsSinceEpoch = dst.toMSecsSinceEpoch() - (m_stdZone.offset * 1000);
+    dstData.offsetFromUtc = m_dstZone.offset;
+    dstData.standardTimeOffset = m_stdZone.offset;
+    dstData.daylightTimeOffset = m_dstZone.offset - m_stdZone.offset;
+    dstData.abbreviation = m_dstZone.name;
+    QTimeZonePrivate::Data stdData;
+    QDateTime std(calculatePosixDate(m_stdDateRule, year), m_stdTime, Qt::UTC);
+    stdData.atMSecsSinceEpoch = std.toMSecsSinceEpoch() - (m_dstZone.offset * 1000);
+    stdData.offsetFromUtc = m_stdZone.offset;
+    stdData.standardTimeOffset = m_stdZone.offset;
+    stdData.daylightTimeOffset = 0;
+    stdData.abbreviation = m_stdZone.name;
+    // Part of maxYear will overflow (likewise for minYear, below):
+    if (year == maxYear && (dstData.atMSecsSinceEpoch < 0 || stdData.atMSecsSinceEpoch < 0)) {
+        if (dstData.atMSecsSinceEpoch > 0) {
+            result << dstData;
+        } else if (stdData.atMSecsSinceEpoch > 0) {
+            result << stdData;
+        }
+    } else if (year < 1970) { // We ignore DST before the epoch.
+        if (year > minYear || stdData.atMSecsSinceEpoch != QTimeZonePrivate::invalidMSecs())
+            result << stdData;
+    } else if (dst < std) {
+        result << dstData << stdData;
+    } else {
+        result << stdData << dstData;
+    }
+    return result;
+}
+
+QList<QTimeZonePrivate::Data> QTzPosixTransitions::yearTransitions(int year) const
+{
+    {
+        QReadLocker locker(&m_lock);
+        const auto it = m_years.constFind(year);
+        if (it != m_years.constEnd())
+            return *it;
+    }
+
+    const QList<QTimeZonePrivate::Data> result = calculateYear(year);
+    QWriteLocker locker(&m_lock);
+    if (m_years.size() < MaxCachedYears)
+        m_years.insert(year, result);
+    return result;
+}
+
+QList<QTimeZonePrivate::Data> QTzPosixTransitions::transitions(int startYear, int endYear,
+                                                               qint64 lastTranMSecs) const
+{
+    QList<QTimeZonePrivate::Data> result;
+    if (!m_hasTransitions) {
+        result << constantData(lastTranMSecs);
+        return result;
+    }
 
     // Limit year to the range QDateTime can represent:
     const int minYear = int(QDateTime::YearRange::First);
@@ -598,38 +697,61 @@ static QList<QTimeZonePrivate::Data> calculatePosixTransitions(const QByteArray
     endYear = qBound(minYear, endYear, maxYear);
     Q_ASSERT(startYear <= endYear);
 
-    for (int year = startYear; year <= endYear; ++year) {
-        QTimeZonePrivate::Data dstData;
-        QDateTime dst(calculatePosixDate(dstDateRule, year), dstTime, Qt::UTC);
-        dstData.atMSecsSinceEpoch = dst.toMSecsSinceEpoch() - (stdZone.offset * 1000);
-        dstData.offsetFromUtc = dstZone.offset;
-        dstData.standardTimeOffset = stdZone.offset;
-        dstData.daylightTimeOffset = dstZone.offset - stdZone.offset;
-        dstData.abbreviation = dstZone.name;
-        QTimeZonePrivate::Data stdData;
-        QDateTime std(calculatePosixDate(stdDateRule, year), stdTime, Qt::UTC);
-        stdData.atMSecsSinceEpoch = std.toMSecsSinceEpoch() - (dstZone.offset * 1000);
-        stdData.offsetFromUtc = stdZone.offset;
-        stdData.standardTimeOffset = stdZone.offset;
-        stdData.daylightTimeOffset = 0;
-        stdData.abbreviation = stdZone.name;
-        // Part of maxYear will overflow (likewise for minYear, below):
-        if (year == maxYear && (dstData.atMSecsSinceEpoch < 0 || stdData.atMSecsSinceEpoch < 0)) {
-            if (dstData.atMSecsSinceEpoch > 0) {
-                result << dstData;
-            } else if (stdData.atMSecsSinceEpoch > 0) {
-                result << stdData;
-            }
-        } else if (year < 1970) { // We ignore DST before the epoch.
-            if (year > minYear || stdData.atMSecsSinceEpoch != QTimeZonePrivate::invalidMSecs())
-                result << stdData;
-        } else if (dst < std) {
-            result << dstData << stdData;
-        } else {
-            result << stdData << dstData;
+    for (int year = startYear; year <= endYear; ++year)
+        result += yearTransitions(year);
+    return result;
+}
+
+static int yearOfMSecs(qint64 msecs)
+{
+    enum : qint64 {
+        MSECS_PER_DAY = 86400000,
+        JULIAN_DAY_FOR_EPOCH = 2440588, // result of julianDayFromDate(1970, 1, 1)
+        MAX_DAYS = 100000000            // keeps partsFromJulian() within int range
+    };
+    const qint64 days = QRoundingDown::qDiv(msecs, MSECS_PER_DAY);
+    if (days < -MAX_DAYS || days > MAX_DAYS)
+        return QDateTime::fromMSecsSinceEpoch(msecs, Qt::UTC).date().year();
+    return QGregorianCalendar::partsFromJulian(days + JULIAN_DAY_FOR_EPOCH).year;
+}
+
+// Equivalent to looking forMSecsSinceEpoch up in transitions() for the years
+// either side of it, without building that list
+bool QTzPosixTransitions::findData(qint64 forMSecsSinceEpoch, bool orFirst,
+                                   QTimeZonePrivate::Data *data) const
+{
+    if (!m_hasTransitions) {
+        *data = constantData(forMSecsSinceEpoch);
+        return true;
+    }
+
+    const int minYear = int(QDateTime::YearRange::First);
+    const int maxYear = int(QDateTime::YearRange::Last);
+    const int year = yearOfMSecs(forMSecsSinceEpoch);
+    const int startYear = qBound(minYear, year - 1, maxYear);
+    const int endYear = qBound(minYear, year + 1, maxYear);
+
+    // Most recent transition, if any in the past; else the first, if allowed:
+    const QTimeZonePrivate::Data *found = nullptr;
+    const QTimeZonePrivate::Data *first = nullptr;
+    QList<QTimeZonePrivate::Data> years[3];
+    for (int i = 0; i <= endYear - startYear; ++i) {
+        years[i] = yearTransitions(startYear + i);
+        for (const QTimeZonePrivate::Data &tran : qAsConst(years[i])) {
+            if (!first)
+                first = &tran;
+            if (tran.atMSecsSinceEpoch > forMSecsSinceEpoch)
+                break;
+            found = &tran;
         }
     }
-    return result;
+    if (!found && orFirst)
+        found = first;
+    if (!found)
+        return false;
+    *data = *found;
+    data->atMSecsSinceEpoch = forMSecsSinceEpoch;
+    return true;
 }
 
 // Create the system default time zone
@@ -660,6 +782,7 @@ public:
 
 private:
     QTzTimeZoneCacheEntry findEntry(const QByteArray &ianaId);
+    static void prepareEntry(QTzTimeZoneCacheEntry *entry);
     QHash<QByteArray, QTzTimeZoneCacheEntry> m_cache;
     QMutex m_mutex;
 };
@@ -848,10 +971,47 @@ QTzTimeZoneCacheEntry QTzTimeZoneCache::fetchEntry(const QByteArray &ianaId)
 
     // ... or build a new entry from scratch
     QTzTimeZoneCacheEntry ret = findEntry(ianaId);
+    prepareEntry(&ret);
     m_cache[ianaId] = ret;
     return ret;
 }
 
+// Derives the lookup structures shared by all users of the entry
+void QTzTimeZoneCache::prepareEntry(QTzTimeZoneCacheEntry *entry)
+{
+    entry->m_abbreviationNames.reserve(entry->m_abbreviations.size());
+    for (const QByteArray &abbreviation : qAsConst(entry->m_abbreviations))
+        entry->m_abbreviationNames.append(QString::fromUtf8(abbreviation));
+
+    if (!entry->m_posixRule.isEmpty())
+        entry->m_posixTransitions = new QTzPosixTransitions(entry->m_posixRule);
+
+    // Index (at most) the last MaxIndexSpans year-long spans of transitions;
+    // some files start with a transition at the "big bang", far in the past.
+    enum { MaxIndexSpans = 1024 };
+    const QList<QTzTransitionTime> &times = entry->m_tranTimes;
+    if (times.size() < 2)
+        return;
+    const qint64 last = times.constLast().atMSecsSinceEpoch;
+    qsizetype first = 0;
+    while ((quint64(last) - quint64(times.at(first).atMSecsSinceEpoch))
+           >> QTzTimeZoneCacheEntry::IndexSpanBits >= MaxIndexSpans) {
+        ++first;
+    }
+    entry->m_indexStart = times.at(first).atMSecsSinceEpoch;
+    const qsizetype spans = ((quint64(last) - quint64(entry->m_indexStart))
+                             >> QTzTimeZoneCacheEntry::IndexSpanBits) + 1;
+    entry->m_yearIndex.reserve(spans);
+    qsizetype i = first;
+    for (qsizetype span = 0; span < spans; ++span) {
+        const qint64 spanStart = entry->m_indexStart
+                + (qint64(span) << QTzTimeZoneCacheEntry::IndexSpanBits);
+        while (i < times.size() && times.at(i).atMSecsSinceEpoch < spanStart)
+            ++i;
+        entry->m_yearIndex.append(int(i));
+    }
+}
+
 void QTzTimeZonePrivate::init(const QByteArray &ianaId)
 {
     static QTzTimeZoneCache tzCache;
@@ -1010,33 +1170,28 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::dataForTzTransition(QTzTransitionTime
     data.standardTimeOffset = rule.stdOffset;
     data.daylightTimeOffset = rule.dstOffset;
     data.offsetFromUtc = rule.stdOffset + rule.dstOffset;
-    data.abbreviation = QString::fromUtf8(cached_data.m_abbreviations.at(rule.abbreviationIndex));
+    data.abbreviation = cached_data.m_abbreviationNames.at(rule.abbreviationIndex);
     return data;
 }
 
 QList<QTimeZonePrivate::Data> QTzTimeZonePrivate::getPosixTransitions(qint64 msNear) const
 {
-    const int year = QDateTime::fromMSecsSinceEpoch(msNear, Qt::UTC).date().year();
+    const int year = yearOfMSecs(msNear);
     // The Data::atMSecsSinceEpoch of the single entry if zone is constant:
     qint64 atTime = tranCache().isEmpty() ? msNear : tranCache().last().atMSecsSinceEpoch;
-    return calculatePosixTransitions(cached_data.m_posixRule, year - 1, year + 1, atTime);
+    return cached_data.m_posixTransitions->transitions(year - 1, year + 1, atTime);
 }
 
 QTimeZonePrivate::Data QTzTimeZonePrivate::data(qint64 forMSecsSinceEpoch) const
 {
     // If the required time is after the last transition (or there were none)
     // and we have a POSIX rule, then use it:
-    if (!cached_data.m_posixRule.isEmpty()
+    if (cached_data.m_posixTransitions
         && (tranCache().isEmpty() || tranCache().last().atMSecsSinceEpoch < forMSecsSinceEpoch)) {
-        QList<QTimeZonePrivate::Data> posixTrans = getPosixTransitions(forMSecsSinceEpoch);
-        auto it = std::partition_point(posixTrans.cbegin(), posixTrans.cend(),
-                                       [forMSecsSinceEpoch] (const QTimeZonePrivate::Data &at) {
-                                           return at.atMSecsSinceEpoch <= forMSecsSinceEpoch;
-                                       });
         // Use most recent, if any in the past; or the first if we have no other rules:
-        if (it > posixTrans.cbegin() || (tranCache().isEmpty() && it < posixTrans.cend())) {
-            QTimeZonePrivate::Data data = *(it > posixTrans.cbegin() ? it - 1 : it);
-            data.atMSecsSinceEpoch = forMSecsSinceEpoch;
+        Data data;
+        if (cached_data.m_posixTransitions->findData(forMSecsSinceEpoch, tranCache().isEmpty(),
+                                                     &data)) {
             return data;
         }
     }
@@ -1044,17 +1199,38 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::data(qint64 forMSecsSinceEpoch) const
         return invalidData();
 
     // Otherwise, use the rule for the most recent or first transition:
-    auto last = std::partition_point(tranCache().cbegin(), tranCache().cend(),
-                                     [forMSecsSinceEpoch] (const QTzTransitionTime &at) {
-                                         return at.atMSecsSinceEpoch <= forMSecsSinceEpoch;
-                                     });
-    if (last > tranCache().cbegin())
-        --last;
-    Data data = dataForTzTransition(*last);
+    Data data = dataForTzTransition(tranCache().at(transitionIndex(forMSecsSinceEpoch)));
     data.atMSecsSinceEpoch = forMSecsSinceEpoch;
     return data;
 }
 
+// Returns the index of the last transition at or before atMSecsSinceEpoch,
+// or 0 if there is none; tranCache() must not be empty.
+qsizetype QTzTimeZonePrivate::transitionIndex(qint64 atMSecsSinceEpoch) const
+{
+    const QList<QTzTransitionTime> &times = tranCache();
+    Q_ASSERT(!times.isEmpty());
+    const QList<int> &index = cached_data.m_yearIndex;
+    if (index.isEmpty() || atMSecsSinceEpoch < cached_data.m_indexStart) {
+        auto last = std::partition_point(times.cbegin(), times.cend(),
+                                         [atMSecsSinceEpoch] (const QTzTransitionTime &at) {
+                                             return at.atMSecsSinceEpoch <= atMSecsSinceEpoch;
+                                         });
+        return last > times.cbegin() ? last - times.cbegin() - 1 : 0;
+    }
+
+    const quint64 span = (quint64(atMSecsSinceEpoch) - quint64(cached_data.m_indexStart))
+            >> QTzTimeZoneCacheEntry::IndexSpanBits;
+    if (span >= quint64(index.size()))
+        return times.size() - 1;
+    // All transitions before index[span] precede the span; only the few in it
+    // need to be looked at.
+    qsizetype i = index.at(span);
+    while (i < times.size() && times.at(i).atMSecsSinceEpoch <= atMSecsSinceEpoch)
+        ++i;
+    return i > 0 ? i - 1 : 0;
+}
+
 bool QTzTimeZonePrivate::hasTransitions() const
 {
     return true;
@@ -1064,7 +1240,7 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::nextTransition(qint64 afterMSecsSince
 {
     // If the required time is after the last transition (or there were none)
     // and we have a POSIX rule, then use it:
-    if (!cached_data.m_posixRule.isEmpty()
+    if (cached_data.m_posixTransitions
         && (tranCache().isEmpty() || tranCache().last().atMSecsSinceEpoch < afterMSecsSinceEpoch)) {
         QList<QTimeZonePrivate::Data> posixTrans = getPosixTransitions(afterMSecsSinceEpoch);
         auto it = std::partition_point(posixTrans.cbegin(), posixTrans.cend(),
@@ -1087,7 +1263,7 @@ QTimeZonePrivate::Data QTzTimeZonePrivate::previousTransition(qint64 beforeMSecs
 {
     // If the required time is after the last transition (or there were none)
     // and we have a POSIX rule, then use it:
-    if (!cached_data.m_posixRule.isEmpty()
+    if (cached_data.m_posixTransitions
         && (tranCache().isEmpty() || tranCache().last().atMSecsSinceEpoch < beforeMSecsSinceEpoch)) {
         QList<QTimeZonePrivate::Data> posixTrans = getPosixTransitions(beforeMSecsSinceEpoch);
         auto it = std::partition_point(posixTrans.cbegin(), posixTrans.cend(),
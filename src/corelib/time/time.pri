@@ -65,6 +65,11 @@ qtConfig(timezone) {
     }
 }
 
+qtConfig(datestring) {
+    HEADERS += time/qdatetimeformatter.h
+    SOURCES += time/qdatetimeformatter.cpp
+}
+
 qtConfig(datetimeparser) {
     HEADERS += time/qdatetimeparser_p.h
     SOURCES += time/qdatetimeparser.cpp
@@ -108,6 +108,25 @@ const char *QRingBuffer::readPointerAtPosition(qint64 pos, qint64 &length) const
     return nullptr;
 }
 
+/*!
+    \internal
+
+    Stores views of up to \a maxCount leading data blocks of the buffer in
+    \a blocks, in order, and returns the number of blocks stored. This
+    allows passing the buffered data to a gather write without copying it.
+*/
+int QRingBuffer::dataBlocks(QByteArrayView *blocks, int maxCount) const
+{
+    int count = 0;
+    for (const QRingChunk &chunk : buffers) {
+        if (count == maxCount)
+            break;
+        if (chunk.size() > 0)
+            blocks[count++] = QByteArrayView(chunk.data(), chunk.size());
+    }
+    return count;
+}
+
 void QRingBuffer::free(qint64 bytes)
 {
     Q_ASSERT(bytes <= bufferSize);
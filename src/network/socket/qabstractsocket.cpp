@@ -845,10 +845,18 @@ bool QAbstractSocketPrivate::writeToSocket()
     }
 
     qint64 nextSize = writeBuffer.nextDataBlockSize();
-    const char *ptr = writeBuffer.readPointer();
-
-    // Attempt to write it all in one chunk.
-    qint64 written = nextSize ? socketEngine->write(ptr, nextSize) : Q_INT64_C(0);
+    qint64 written;
+    if (nextSize < writeBuffer.size()) {
+        // The buffer holds several chunks (e.g. shallow copies of the byte
+        // arrays passed to write()): attempt to write them all at once.
+        QByteArrayView blocks[16];
+        const int count = writeBuffer.dataBlocks(blocks, 16);
+        written = socketEngine->writeVector(blocks, count);
+    } else {
+        // Attempt to write it all in one chunk.
+        const char *ptr = writeBuffer.readPointer();
+        written = nextSize ? socketEngine->write(ptr, nextSize) : Q_INT64_C(0);
+    }
     if (written < 0) {
 #if defined (QABSTRACTSOCKET_DEBUG)
         qDebug() << "QAbstractSocketPrivate::writeToSocket() write error, aborting."
@@ -881,6 +889,62 @@ bool QAbstractSocketPrivate::writeToSocket()
     return written > 0;
 }
 
+/*! \internal
+
+    Writes \a chunks straight to the socket engine with a single gather write
+    if the socket is an unbuffered TCP socket without pending data, like
+    QAbstractSocket::writeData() does for a single block. What the engine
+    does not accept right away is buffered, keeping shallow copies of the
+    chunks that were not written at all.
+*/
+bool QAbstractSocketPrivate::writeVector(const QList<QByteArray> &chunks, qint64 *written)
+{
+    if (isBuffered || socketType != QAbstractSocket::TcpSocket || !socketEngine
+        || !writeBuffer.isEmpty() || state == QAbstractSocket::UnconnectedState) {
+        return false;
+    }
+
+    constexpr int MaxBlocks = 16;
+    QByteArrayView blocks[MaxBlocks];
+    int count = 0;
+    qint64 size = 0;
+    for (const QByteArray &chunk : chunks) {
+        if (chunk.isEmpty())
+            continue;
+        if (count < MaxBlocks)
+            blocks[count++] = chunk;
+        size += chunk.size();
+    }
+
+    qint64 ret = count ? socketEngine->writeVector(blocks, count) : Q_INT64_C(0);
+    if (ret < 0) {
+        setError(socketEngine->error(), socketEngine->errorString());
+        *written = -1;
+        return true;
+    }
+
+    if (ret < size) {
+        // Buffer what was not written yet
+        for (const QByteArray &chunk : chunks) {
+            if (ret >= chunk.size()) {
+                ret -= chunk.size();
+            } else if (ret > 0) {
+                writeBuffer.append(chunk.constData() + ret, chunk.size() - ret);
+                ret = 0;
+            } else {
+                writeBuffer.append(chunk);
+            }
+        }
+        socketEngine->setWriteNotificationEnabled(true);
+    }
+
+#if defined (QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::writeVector(%d chunks, %lli bytes)", int(chunks.size()), size);
+#endif
+    *written = size; // actually written + what has been buffered
+    return true;
+}
+
 /*! \internal
 
     Writes pending data in the write buffers to the socket. The function
@@ -90,6 +90,8 @@ public:
     bool canWriteNotification();
     void canCloseNotification();
 
+    bool writeVector(const QList<QByteArray> &chunks, qint64 *written) override;
+
     // slots
     void _q_connectToNextAddress();
     void _q_startConnecting(const QHostInfo &hostInfo);
@@ -128,6 +128,19 @@ QAbstractSocketEngine *QAbstractSocketEngine::createSocketEngine(qintptr socketD
     return new QNativeSocketEngine(parent);
 }
 
+/*!
+    Writes the \a count blocks of data in \a blocks to the socket, in order,
+    and returns the number of bytes written, or -1 if an error occurred. Like
+    write(), this may write less than all of the data.
+
+    The default implementation only writes the first block; engines that can
+    perform a gather write reimplement this function.
+*/
+qint64 QAbstractSocketEngine::writeVector(const QByteArrayView *blocks, int count)
+{
+    return count > 0 ? write(blocks[0].data(), blocks[0].size()) : Q_INT64_C(0);
+}
+
 QAbstractSocket::SocketError QAbstractSocketEngine::error() const
 {
     return d_func()->socketError;
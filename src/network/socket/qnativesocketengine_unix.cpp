@@ -1363,6 +1363,50 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
 
     return qint64(writtenBytes);
 }
+
+qint64 QNativeSocketEnginePrivate::nativeWriteVector(const QByteArrayView *blocks, int count)
+{
+    Q_Q(QNativeSocketEngine);
+
+    QVarLengthArray<iovec, 16> vectors(count);
+    for (int i = 0; i < count; ++i) {
+        vectors[i].iov_base = const_cast<char *>(blocks[i].data());
+        vectors[i].iov_len = size_t(blocks[i].size());
+    }
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = vectors.data();
+    msg.msg_iovlen = vectors.size();
+
+    ssize_t writtenBytes = qt_safe_sendmsg(socketDescriptor, &msg, 0);
+
+    if (writtenBytes < 0) {
+        switch (errno) {
+        case EPIPE:
+        case ECONNRESET:
+            writtenBytes = -1;
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            q->close();
+            break;
+        case EAGAIN:
+            writtenBytes = 0;
+            break;
+        case EMSGSIZE:
+            setError(QAbstractSocket::DatagramTooLargeError, DatagramTooLargeErrorString);
+            break;
+        default:
+            break;
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeWriteVector(%p, %i) == %i",
+           blocks, count, (int) writtenBytes);
+#endif
+
+    return qint64(writtenBytes);
+}
 /*
 */
 qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxSize)
@@ -1481,6 +1481,52 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
     return ret;
 }
 
+qint64 QNativeSocketEnginePrivate::nativeWriteVector(const QByteArrayView *blocks, int count)
+{
+    Q_Q(QNativeSocketEngine);
+
+    QVarLengthArray<WSABUF, 16> buffers(count);
+    for (int i = 0; i < count; ++i) {
+        buffers[i].buf = const_cast<char *>(blocks[i].data());
+        buffers[i].len = ULONG(blocks[i].size());
+    }
+
+    DWORD flags = 0;
+    DWORD bytesWritten = 0;
+    qint64 ret = 0;
+    int socketRet = ::WSASend(socketDescriptor, buffers.data(), DWORD(buffers.size()),
+                              &bytesWritten, flags, 0, 0);
+    if (socketRet != SOCKET_ERROR) {
+        ret = qint64(bytesWritten);
+    } else {
+        int err = WSAGetLastError();
+        if (err == WSAEWOULDBLOCK) {
+            // nothing written; try again later
+        } else if (err == WSAENOBUFS) {
+            // nativeWrite() knows how to deal with this
+            ret = nativeWrite(blocks[0].data(), blocks[0].size());
+        } else {
+            WS_ERROR_DEBUG(err);
+            switch (err) {
+            case WSAECONNRESET:
+            case WSAECONNABORTED:
+                ret = -1;
+                setError(QAbstractSocket::NetworkError, WriteErrorString);
+                q->close();
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeWriteVector(%p, %i) == %lli", blocks, count, ret);
+#endif
+
+    return ret;
+}
+
 qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxLength)
 {
     qint64 ret = -1;
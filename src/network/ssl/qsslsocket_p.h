@@ -112,6 +112,8 @@ public:
 
     void init();
     bool verifyProtocolSupported(const char *where);
+    // writeData() encrypts, so the data must never go to the socket engine directly
+    bool writeVector(const QList<QByteArray> &, qint64 *) override { return false; }
     bool initialized;
 
     QSslSocket::SslMode mode;
@@ -40,6 +40,8 @@
 #include <qstack.h>
 #include <qxmlstream.h>
 
+#include <private/qresourcepathhash_p.h>
+
 #include <algorithm>
 
 #if QT_CONFIG(zstd)
@@ -1258,6 +1260,80 @@ struct qt_rcc_compare_hash
     }
 };
 
+// Builds the perfect hash path index of format version 4 (see
+// QResourceRoot::findIndexedNode), using hash and displace: the paths are
+// distributed into buckets, and for each bucket a seed is searched that maps
+// all its paths to unused slots. Returns an empty list if that fails.
+static QList<quint32> buildPathIndex(const QList<RCCFileInfo *> &nodes)
+{
+    QHash<const RCCFileInfo *, int> nodeNumbers;
+    nodeNumbers.reserve(nodes.size());
+    for (int i = 0; i < nodes.size(); ++i)
+        nodeNumbers.insert(nodes.at(i), i);
+
+    // locale variants share a path; the index refers to the first of them
+    QStringList paths(nodes.size());
+    QList<int> keys;
+    QHash<QString, int> seen;
+    for (int i = 1; i < nodes.size(); ++i) {
+        const RCCFileInfo *node = nodes.at(i);
+        const QString &parentPath = paths.at(nodeNumbers.value(node->m_parent));
+        paths[i] = parentPath.isEmpty() ? node->m_name : parentPath + QLatin1Char('/') + node->m_name;
+        if (!seen.contains(paths.at(i))) {
+            seen.insert(paths.at(i), i);
+            keys.append(i);
+        }
+    }
+
+    const quint32 bucketCount = quint32(keys.size()) / 4 + 1;
+    const quint32 slotCount = quint32(keys.size()) + quint32(keys.size()) / 4 + 1;
+    QList<QList<int>> buckets(bucketCount);
+    for (int key : qAsConst(keys))
+        buckets[qResourcePathHash(paths.at(key), 0) % bucketCount].append(key);
+
+    QList<quint32> bucketOrder(bucketCount);
+    for (quint32 i = 0; i < bucketCount; ++i)
+        bucketOrder[i] = i;
+    std::stable_sort(bucketOrder.begin(), bucketOrder.end(), [&buckets](quint32 a, quint32 b) {
+        return buckets.at(a).size() > buckets.at(b).size();
+    });
+
+    QList<quint32> seeds(bucketCount, 0);
+    QList<quint32> slotNodes(slotCount, 0);
+    QList<quint32> positions;
+    for (quint32 bucket : qAsConst(bucketOrder)) {
+        const QList<int> &bucketKeys = buckets.at(bucket);
+        if (bucketKeys.isEmpty())
+            break;
+        quint32 seed = 1;
+        for ( ; seed != 0x100000; ++seed) {
+            positions.clear();
+            for (int key : bucketKeys) {
+                const quint32 position = qResourcePathHash(paths.at(key), seed) % slotCount;
+                if (slotNodes.at(position) || positions.contains(position))
+                    break;
+                positions.append(position);
+            }
+            if (positions.size() == bucketKeys.size())
+                break;
+        }
+        if (seed == 0x100000)
+            return QList<quint32>();
+        seeds[bucket] = seed;
+        for (int i = 0; i < bucketKeys.size(); ++i)
+            slotNodes[positions.at(i)] = bucketKeys.at(i);
+    }
+
+    QList<quint32> index;
+    index.reserve(3 + bucketCount + slotCount + nodes.size());
+    index << quint32(nodes.size()) << bucketCount << slotCount;
+    index << seeds << slotNodes;
+    index << quint32(0); // the root has no parent
+    for (int i = 1; i < nodes.size(); ++i)
+        index << quint32(nodeNumbers.value(nodes.at(i)->m_parent));
+    return index;
+}
+
 bool RCCResourceLibrary::writeDataStructure()
 {
     switch (m_format) {
@@ -1284,6 +1360,8 @@ bool RCCResourceLibrary::writeDataStructure()
         return false;
 
     //calculate the child offsets (flat)
+    QList<RCCFileInfo*> nodes;
+    nodes.append(m_root);
     pending.push(m_root);
     int offset = 1;
     while (!pending.isEmpty()) {
@@ -1298,11 +1376,22 @@ bool RCCResourceLibrary::writeDataStructure()
         for (int i = 0; i < m_children.size(); ++i) {
             RCCFileInfo *child = m_children.at(i);
             ++offset;
+            nodes.append(child);
             if (child->m_flags & RCCFileInfo::Directory)
                 pending.push(child);
         }
     }
 
+    //the path index follows the tree, the root's name offset points to it
+    QList<quint32> pathIndex;
+    if (m_formatVersion >= 4) {
+        pathIndex = buildPathIndex(nodes);
+        if (pathIndex.isEmpty() && m_verbose)
+            m_errorDevice->write("Could not build the resource path index\n");
+        if (!pathIndex.isEmpty())
+            m_root->m_nameOffset = nodes.size() * 22;
+    }
+
     //write out the structure (ie iterate again!)
     pending.push(m_root);
     m_root->writeDataInfo(*this);
@@ -1321,6 +1410,20 @@ bool RCCResourceLibrary::writeDataStructure()
                 pending.push(child);
         }
     }
+
+    if (!pathIndex.isEmpty()) {
+        const bool text = m_format == C_Code || m_format == Pass1;
+        const bool python = m_format == Python3_Code || m_format == Python2_Code;
+        if (text)
+            writeString("  // path index\n  ");
+        for (int i = 0; i < pathIndex.size(); ++i) {
+            writeNumber4(pathIndex.at(i));
+            if (text && i % 4 == 3)
+                writeString("\n  ");
+            else if (python && i % 4 == 3)
+                writeString("\\\n");
+        }
+    }
     switch (m_format) {
     case C_Code:
     case Pass1:
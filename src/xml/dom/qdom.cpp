@@ -61,6 +61,7 @@
 
 
 #include <stdio.h>
+#include <algorithm>
 #include <limits>
 
 QT_BEGIN_NAMESPACE
@@ -921,12 +922,136 @@ int QDomNodeList::length() const
     true).
 */
 
+/**************************************************************
+ *
+ * QDomNodeArena
+ *
+ **************************************************************/
+
+QDomNodeArena::~QDomNodeArena()
+{
+    for (void *chunk : qAsConst(chunks))
+        ::operator delete(chunk);
+}
+
+void *QDomNodeArena::allocate(size_t size)
+{
+    size = (size + Granularity - 1) & ~size_t(Granularity - 1);
+    if (size > MaxSlotSize)
+        return ::operator new(size);
+
+    FreeSlot *&slot = freeSlots[size / Granularity - 1];
+    if (slot) {
+        void *ptr = slot;
+        slot = slot->next;
+        return ptr;
+    }
+
+    if (size_t(chunkEnd - chunkPos) < size) {
+        chunkPos = static_cast<char *>(::operator new(nextChunkSize));
+        chunkEnd = chunkPos + nextChunkSize;
+        chunks.append(chunkPos);
+        nextChunkSize = qMin(2 * nextChunkSize, size_t(MaxChunkSize));
+    }
+    void *ptr = chunkPos;
+    chunkPos += size;
+    return ptr;
+}
+
+void QDomNodeArena::deallocate(void *ptr, size_t size)
+{
+    size = (size + Granularity - 1) & ~size_t(Granularity - 1);
+    if (size > MaxSlotSize) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    FreeSlot *&slot = freeSlots[size / Granularity - 1];
+    slot = new (ptr) FreeSlot{slot};
+}
+
+/*
+  Returns a string equal to \a name that shares its data with the other uses
+  of the same name by nodes of this arena.
+*/
+QString QDomNodeArena::internedName(const QString &name)
+{
+    if (name.isEmpty())
+        return name;
+
+    const auto it = names.constFind(name);
+    if (it != names.cend())
+        return *it;
+    names.insert(name, name);
+    return name;
+}
+
+void QDomNodeArena::internNames(QDomNodePrivate *node)
+{
+    node->name = internedName(node->name);
+    node->prefix = internedName(node->prefix);
+    node->namespaceURI = internedName(node->namespaceURI);
+}
+
 /**************************************************************
  *
  * QDomNodePrivate
  *
  **************************************************************/
 
+// Every node is preceded by a pointer to the arena it was allocated from, or
+// nullptr if it was allocated on the heap.
+static constexpr size_t NodeHeaderSize = sizeof(QDomNodeArena *);
+static_assert(alignof(QDomNodePrivate) <= NodeHeaderSize);
+
+void *QDomNodePrivate::operator new(size_t size, QDomNodeArena *arena)
+{
+    void *block;
+    if (arena) {
+        block = arena->allocate(NodeHeaderSize + size);
+        arena->ref.ref();
+    } else {
+        block = ::operator new(NodeHeaderSize + size);
+    }
+    *static_cast<QDomNodeArena **>(block) = arena;
+    return static_cast<char *>(block) + NodeHeaderSize;
+}
+
+void QDomNodePrivate::operator delete(void *ptr, size_t size)
+{
+    void *block = static_cast<char *>(ptr) - NodeHeaderSize;
+    QDomNodeArena *arena = *static_cast<QDomNodeArena **>(block);
+    if (!arena) {
+        ::operator delete(block);
+        return;
+    }
+
+    arena->deallocate(block, NodeHeaderSize + size);
+    if (!arena->ref.deref())
+        delete arena;
+}
+
+void QDomNodePrivate::operator delete(void *ptr, QDomNodeArena *arena)
+{
+    // Only called if a constructor throws. The size isn't known here, so the
+    // memory can't be reused, and is only released together with the arena.
+    void *block = static_cast<char *>(ptr) - NodeHeaderSize;
+    if (!arena)
+        ::operator delete(block);
+    else if (!arena->ref.deref())
+        delete arena;
+}
+
+/*
+  Returns the arena this node was allocated from, or nullptr if it was
+  allocated on the heap. Can be called from the constructors.
+*/
+QDomNodeArena *QDomNodePrivate::ownerArena() const
+{
+    return *reinterpret_cast<QDomNodeArena *const *>(reinterpret_cast<const char *>(this)
+                                                      - NodeHeaderSize);
+}
+
 inline void QDomNodePrivate::setOwnerDocument(QDomDocumentPrivate *doc)
 {
     ownerNode = doc;
@@ -2558,9 +2683,8 @@ QDomNamedNodeMapPrivate* QDomNamedNodeMapPrivate::clone(QDomNodePrivate* p)
     m->readonly = readonly;
     m->appendToParent = appendToParent;
 
-    auto it = map.constBegin();
-    for (; it != map.constEnd(); ++it) {
-        QDomNodePrivate *new_node = (*it)->cloneNode();
+    for (QDomNodePrivate *node : qAsConst(nodes)) {
+        QDomNodePrivate *new_node = node->cloneNode();
         new_node->setParent(p);
         m->setNamedItem(new_node);
     }
@@ -2574,26 +2698,51 @@ void QDomNamedNodeMapPrivate::clearMap()
 {
     // Dereference all of our children if we took references
     if (!appendToParent) {
-        auto it = map.constBegin();
-        for (; it != map.constEnd(); ++it)
-            if (!(*it)->ref.deref())
-                delete *it;
+        for (QDomNodePrivate *node : qAsConst(nodes))
+            if (!node->ref.deref())
+                delete node;
+    }
+    nodes.clear();
+    nodesByName.clear();
+}
+
+void QDomNamedNodeMapPrivate::removeNodes(const QString &name)
+{
+    // nothing to remove if the index does not know the name
+    if (!nodesByName.isEmpty() && !nodesByName.remove(name))
+        return;
+    const auto hasName = [&name](QDomNodePrivate *node) { return node->nodeName() == name; };
+    nodes.erase(std::remove_if(nodes.begin(), nodes.end(), hasName), nodes.end());
+}
+
+void QDomNamedNodeMapPrivate::appendNode(QDomNodePrivate *node)
+{
+    nodes.append(node);
+    if (!nodesByName.isEmpty()) {
+        nodesByName.insert(node->nodeName(), node);
+    } else if (nodes.size() > NameIndexThreshold) {
+        nodesByName.reserve(nodes.size());
+        for (QDomNodePrivate *n : qAsConst(nodes))
+            nodesByName.insert(n->nodeName(), n);
     }
-    map.clear();
 }
 
 QDomNodePrivate* QDomNamedNodeMapPrivate::namedItem(const QString& name) const
 {
-    auto it = map.constFind(name);
-    return it == map.cend() ? nullptr : *it;
+    if (!nodesByName.isEmpty())
+        return nodesByName.value(name);
+    // the node inserted last wins
+    for (auto it = nodes.crbegin(); it != nodes.crend(); ++it) {
+        if ((*it)->nodeName() == name)
+            return *it;
+    }
+    return nullptr;
 }
 
 QDomNodePrivate* QDomNamedNodeMapPrivate::namedItemNS(const QString& nsURI, const QString& localName) const
 {
-    auto it = map.constBegin();
-    QDomNodePrivate *n;
-    for (; it != map.constEnd(); ++it) {
-        n = *it;
+    for (auto it = nodes.crbegin(); it != nodes.crend(); ++it) {
+        QDomNodePrivate *n = *it;
         if (!n->prefix.isNull()) {
             // node has a namespace
             if (n->namespaceURI == nsURI && n->name == localName)
@@ -2611,10 +2760,10 @@ QDomNodePrivate* QDomNamedNodeMapPrivate::setNamedItem(QDomNodePrivate* arg)
     if (appendToParent)
         return parent->appendChild(arg);
 
-    QDomNodePrivate *n = map.value(arg->nodeName());
+    QDomNodePrivate *n = namedItem(arg->nodeName());
     // We take a reference
     arg->ref.ref();
-    map.insert(arg->nodeName(), arg);
+    appendNode(arg);
     return n;
 }
 
@@ -2631,7 +2780,7 @@ QDomNodePrivate* QDomNamedNodeMapPrivate::setNamedItemNS(QDomNodePrivate* arg)
         QDomNodePrivate *n = namedItemNS(arg->namespaceURI, arg->name);
         // We take a reference
         arg->ref.ref();
-        map.insert(arg->nodeName(), arg);
+        appendNode(arg);
         return n;
     } else {
         // ### check the following code if it is ok
@@ -2650,7 +2799,7 @@ QDomNodePrivate* QDomNamedNodeMapPrivate::removeNamedItem(const QString& name)
     if (appendToParent)
         return parent->removeChild(p);
 
-    map.remove(p->nodeName());
+    removeNodes(p->nodeName());
     // We took a reference, so we have to free one here
     p->ref.deref();
     return p;
@@ -2660,17 +2809,17 @@ QDomNodePrivate* QDomNamedNodeMapPrivate::item(int index) const
 {
     if (index >= length() || index < 0)
         return nullptr;
-    return *std::next(map.cbegin(), index);
+    return nodes.at(index);
 }
 
 int QDomNamedNodeMapPrivate::length() const
 {
-    return map.count();
+    return nodes.count();
 }
 
 bool QDomNamedNodeMapPrivate::contains(const QString& name) const
 {
-    return map.contains(name);
+    return namedItem(name) != nullptr;
 }
 
 bool QDomNamedNodeMapPrivate::containsNS(const QString& nsURI, const QString & localName) const
@@ -2974,10 +3123,10 @@ QDomDocumentTypePrivate::QDomDocumentTypePrivate(QDomDocumentTypePrivate* n, boo
     while (p) {
         if (p->isEntity())
             // Don't use normal insert function since we would create infinite recursion
-            entities->map.insert(p->nodeName(), p);
+            entities->appendNode(p);
         if (p->isNotation())
             // Don't use normal insert function since we would create infinite recursion
-            notations->map.insert(p->nodeName(), p);
+            notations->appendNode(p);
         p = p->next;
     }
 }
@@ -3021,9 +3170,9 @@ QDomNodePrivate* QDomDocumentTypePrivate::insertBefore(QDomNodePrivate* newChild
     QDomNodePrivate* p = QDomNodePrivate::insertBefore(newChild, refChild);
     // Update the maps
     if (p && p->isEntity())
-        entities->map.insert(p->nodeName(), p);
+        entities->appendNode(p);
     else if (p && p->isNotation())
-        notations->map.insert(p->nodeName(), p);
+        notations->appendNode(p);
 
     return p;
 }
@@ -3034,9 +3183,9 @@ QDomNodePrivate* QDomDocumentTypePrivate::insertAfter(QDomNodePrivate* newChild,
     QDomNodePrivate* p = QDomNodePrivate::insertAfter(newChild, refChild);
     // Update the maps
     if (p && p->isEntity())
-        entities->map.insert(p->nodeName(), p);
+        entities->appendNode(p);
     else if (p && p->isNotation())
-        notations->map.insert(p->nodeName(), p);
+        notations->appendNode(p);
 
     return p;
 }
@@ -3048,14 +3197,14 @@ QDomNodePrivate* QDomDocumentTypePrivate::replaceChild(QDomNodePrivate* newChild
     // Update the maps
     if (p) {
         if (oldChild && oldChild->isEntity())
-            entities->map.remove(oldChild->nodeName());
+            entities->removeNodes(oldChild->nodeName());
         else if (oldChild && oldChild->isNotation())
-            notations->map.remove(oldChild->nodeName());
+            notations->removeNodes(oldChild->nodeName());
 
         if (p->isEntity())
-            entities->map.insert(p->nodeName(), p);
+            entities->appendNode(p);
         else if (p->isNotation())
-            notations->map.insert(p->nodeName(), p);
+            notations->appendNode(p);
     }
 
     return p;
@@ -3067,9 +3216,9 @@ QDomNodePrivate* QDomDocumentTypePrivate::removeChild(QDomNodePrivate* oldChild)
     QDomNodePrivate* p = QDomNodePrivate::removeChild( oldChild);
     // Update the maps
     if (p && p->isEntity())
-        entities->map.remove(p->nodeName());
+        entities->removeNodes(p->nodeName());
     else if (p && p->isNotation())
-        notations->map.remove(p ->nodeName());
+        notations->removeNodes(p->nodeName());
 
     return p;
 }
@@ -3106,13 +3255,11 @@ void QDomDocumentTypePrivate::save(QTextStream& s, int, int indent) const
     if (entities->length()>0 || notations->length()>0) {
         s << " [" << Qt::endl;
 
-        auto it2 = notations->map.constBegin();
-        for (; it2 != notations->map.constEnd(); ++it2)
-            (*it2)->save(s, 0, indent);
+        for (const QDomNodePrivate *notation : qAsConst(notations->nodes))
+            notation->save(s, 0, indent);
 
-        auto it = entities->map.constBegin();
-        for (; it != entities->map.constEnd(); ++it)
-            (*it)->save(s, 0, indent);
+        for (const QDomNodePrivate *entity : qAsConst(entities->nodes))
+            entity->save(s, 0, indent);
 
         s << ']';
     }
@@ -3601,6 +3748,8 @@ QDomAttrPrivate::QDomAttrPrivate(QDomDocumentPrivate* d, QDomNodePrivate* parent
 {
     name = name_;
     m_specified = false;
+    if (QDomNodeArena *arena = ownerArena())
+        arena->internNames(this);
 }
 
 QDomAttrPrivate::QDomAttrPrivate(QDomDocumentPrivate* d, QDomNodePrivate* p, const QString& nsURI, const QString& qName)
@@ -3610,6 +3759,8 @@ QDomAttrPrivate::QDomAttrPrivate(QDomDocumentPrivate* d, QDomNodePrivate* p, con
     namespaceURI = nsURI;
     createdWithDom1Interface = false;
     m_specified = false;
+    if (QDomNodeArena *arena = ownerArena())
+        arena->internNames(this);
 }
 
 QDomAttrPrivate::QDomAttrPrivate(QDomAttrPrivate* n, bool deep)
@@ -3621,7 +3772,7 @@ QDomAttrPrivate::QDomAttrPrivate(QDomAttrPrivate* n, bool deep)
 void QDomAttrPrivate::setNodeValue(const QString& v)
 {
     value = v;
-    QDomTextPrivate *t = new QDomTextPrivate(nullptr, this, v);
+    QDomTextPrivate *t = new (ownerArena()) QDomTextPrivate(nullptr, this, v);
     // keep the refcount balanced: appendChild() does a ref anyway.
     t->ref.deref();
     if (first) {
@@ -3888,6 +4039,8 @@ QDomElementPrivate::QDomElementPrivate(QDomDocumentPrivate* d, QDomNodePrivate*
 {
     name = tagname;
     m_attr = new QDomNamedNodeMapPrivate(this);
+    if (QDomNodeArena *arena = ownerArena())
+        arena->internNames(this);
 }
 
 QDomElementPrivate::QDomElementPrivate(QDomDocumentPrivate* d, QDomNodePrivate* p,
@@ -3898,6 +4051,8 @@ QDomElementPrivate::QDomElementPrivate(QDomDocumentPrivate* d, QDomNodePrivate*
     namespaceURI = nsURI;
     createdWithDom1Interface = false;
     m_attr = new QDomNamedNodeMapPrivate(this);
+    if (QDomNodeArena *arena = ownerArena())
+        arena->internNames(this);
 }
 
 QDomElementPrivate::QDomElementPrivate(QDomElementPrivate* n, bool deep) :
@@ -3944,7 +4099,7 @@ void QDomElementPrivate::setAttribute(const QString& aname, const QString& newVa
 {
     QDomNodePrivate* n = m_attr->namedItem(aname);
     if (!n) {
-        n = new QDomAttrPrivate(ownerDocument(), this, aname);
+        n = new (ownerArena()) QDomAttrPrivate(ownerDocument(), this, aname);
         n->setNodeValue(newValue);
 
         // Referencing is done by the map, so we set the reference counter back
@@ -3962,7 +4117,7 @@ void QDomElementPrivate::setAttributeNS(const QString& nsURI, const QString& qNa
     qt_split_namespace(prefix, localName, qName, true);
     QDomNodePrivate* n = m_attr->namedItemNS(nsURI, localName);
     if (!n) {
-        n = new QDomAttrPrivate(ownerDocument(), this, nsURI, qName);
+        n = new (ownerArena()) QDomAttrPrivate(ownerDocument(), this, nsURI, qName);
         n->setNodeValue(newValue);
 
         // Referencing is done by the map, so we set the reference counter back
@@ -4077,15 +4232,14 @@ void QDomElementPrivate::save(QTextStream& s, int depth, int indent) const
 
 
     /* Write out attributes. */
-    if (!m_attr->map.isEmpty()) {
+    if (!m_attr->nodes.isEmpty()) {
         QDuplicateTracker<QString> outputtedPrefixes;
-        auto it = m_attr->map.constBegin();
-        for (; it != m_attr->map.constEnd(); ++it) {
+        for (const QDomNodePrivate *attr : qAsConst(m_attr->nodes)) {
             s << ' ';
-            if (it.value()->namespaceURI.isNull()) {
-                s << it.value()->name << "=\"" << encodeText(it.value()->value, true, true) << '\"';
+            if (attr->namespaceURI.isNull()) {
+                s << attr->name << "=\"" << encodeText(attr->value, true, true) << '\"';
             } else {
-                s << it.value()->prefix << ':' << it.value()->name << "=\"" << encodeText(it.value()->value, true, true) << '\"';
+                s << attr->prefix << ':' << attr->name << "=\"" << encodeText(attr->value, true, true) << '\"';
                 /* This is a fix for 138243, as good as it gets.
                  *
                  * QDomElementPrivate::save() output a namespace declaration if
@@ -4097,10 +4251,10 @@ void QDomElementPrivate::save(QTextStream& s, int depth, int indent) const
                  * a different namespace. However, this can only occur by the user modifying the element,
                  * and we don't do fixups by that anyway, and hence it's the user responsibility to not
                  * arrive in those situations. */
-                if((!it.value()->ownerNode ||
-                   it.value()->ownerNode->prefix != it.value()->prefix) &&
-                   !outputtedPrefixes.hasSeen(it.value()->prefix)) {
-                    s << " xmlns:" << it.value()->prefix << "=\"" << encodeText(it.value()->namespaceURI, true, true) << '\"';
+                if((!attr->ownerNode ||
+                   attr->ownerNode->prefix != attr->prefix) &&
+                   !outputtedPrefixes.hasSeen(attr->prefix)) {
+                    s << " xmlns:" << attr->prefix << "=\"" << encodeText(attr->namespaceURI, true, true) << '\"';
                 }
             }
         }
@@ -5682,6 +5836,8 @@ void QDomDocumentPrivate::clear()
     impl.reset();
     type.reset();
     QDomNodePrivate::clear();
+    if (arena)
+        arena->clearNames();
 }
 
 bool QDomDocumentPrivate::setContent(QXmlStreamReader *reader, bool namespaceProcessing,
@@ -5736,7 +5892,7 @@ QDomElementPrivate* QDomDocumentPrivate::createElement(const QString &tagName)
     if (!ok)
         return nullptr;
 
-    QDomElementPrivate *e = new QDomElementPrivate(this, nullptr, fixedName);
+    QDomElementPrivate *e = new (nodeArena()) QDomElementPrivate(this, nullptr, fixedName);
     e->ref.deref();
     return e;
 }
@@ -5748,14 +5904,14 @@ QDomElementPrivate* QDomDocumentPrivate::createElementNS(const QString &nsURI, c
     if (!ok)
         return nullptr;
 
-    QDomElementPrivate *e = new QDomElementPrivate(this, nullptr, nsURI, fixedName);
+    QDomElementPrivate *e = new (nodeArena()) QDomElementPrivate(this, nullptr, nsURI, fixedName);
     e->ref.deref();
     return e;
 }
 
 QDomDocumentFragmentPrivate* QDomDocumentPrivate::createDocumentFragment()
 {
-    QDomDocumentFragmentPrivate *f = new QDomDocumentFragmentPrivate(this, (QDomNodePrivate*)nullptr);
+    QDomDocumentFragmentPrivate *f = new (nodeArena()) QDomDocumentFragmentPrivate(this, (QDomNodePrivate*)nullptr);
     f->ref.deref();
     return f;
 }
@@ -5767,7 +5923,7 @@ QDomTextPrivate* QDomDocumentPrivate::createTextNode(const QString &data)
     if (!ok)
         return nullptr;
 
-    QDomTextPrivate *t = new QDomTextPrivate(this, nullptr, fixedData);
+    QDomTextPrivate *t = new (nodeArena()) QDomTextPrivate(this, nullptr, fixedData);
     t->ref.deref();
     return t;
 }
@@ -5779,7 +5935,7 @@ QDomCommentPrivate* QDomDocumentPrivate::createComment(const QString &data)
     if (!ok)
         return nullptr;
 
-    QDomCommentPrivate *c = new QDomCommentPrivate(this, nullptr, fixedData);
+    QDomCommentPrivate *c = new (nodeArena()) QDomCommentPrivate(this, nullptr, fixedData);
     c->ref.deref();
     return c;
 }
@@ -5791,7 +5947,7 @@ QDomCDATASectionPrivate* QDomDocumentPrivate::createCDATASection(const QString &
     if (!ok)
         return nullptr;
 
-    QDomCDATASectionPrivate *c = new QDomCDATASectionPrivate(this, nullptr, fixedData);
+    QDomCDATASectionPrivate *c = new (nodeArena()) QDomCDATASectionPrivate(this, nullptr, fixedData);
     c->ref.deref();
     return c;
 }
@@ -5808,7 +5964,7 @@ QDomProcessingInstructionPrivate* QDomDocumentPrivate::createProcessingInstructi
     if (!ok)
         return nullptr;
 
-    QDomProcessingInstructionPrivate *p = new QDomProcessingInstructionPrivate(this, nullptr, fixedTarget, fixedData);
+    QDomProcessingInstructionPrivate *p = new (nodeArena()) QDomProcessingInstructionPrivate(this, nullptr, fixedTarget, fixedData);
     p->ref.deref();
     return p;
 }
@@ -5819,7 +5975,7 @@ QDomAttrPrivate* QDomDocumentPrivate::createAttribute(const QString &aname)
     if (!ok)
         return nullptr;
 
-    QDomAttrPrivate *a = new QDomAttrPrivate(this, nullptr, fixedName);
+    QDomAttrPrivate *a = new (nodeArena()) QDomAttrPrivate(this, nullptr, fixedName);
     a->ref.deref();
     return a;
 }
@@ -5831,7 +5987,7 @@ QDomAttrPrivate* QDomDocumentPrivate::createAttributeNS(const QString &nsURI, co
     if (!ok)
         return nullptr;
 
-    QDomAttrPrivate *a = new QDomAttrPrivate(this, nullptr, nsURI, fixedName);
+    QDomAttrPrivate *a = new (nodeArena()) QDomAttrPrivate(this, nullptr, nsURI, fixedName);
     a->ref.deref();
     return a;
 }
@@ -5843,11 +5999,18 @@ QDomEntityReferencePrivate* QDomDocumentPrivate::createEntityReference(const QSt
     if (!ok)
         return nullptr;
 
-    QDomEntityReferencePrivate *e = new QDomEntityReferencePrivate(this, nullptr, fixedName);
+    QDomEntityReferencePrivate *e = new (nodeArena()) QDomEntityReferencePrivate(this, nullptr, fixedName);
     e->ref.deref();
     return e;
 }
 
+QDomNodeArena *QDomDocumentPrivate::nodeArena()
+{
+    if (!arena)
+        arena = new QDomNodeArena;
+    return arena.data();
+}
+
 QDomNodePrivate* QDomDocumentPrivate::importNode(QDomNodePrivate *importedNode, bool deep)
 {
     QDomNodePrivate *node = nullptr;
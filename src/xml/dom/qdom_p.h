@@ -76,6 +76,51 @@ public:
     static QDomImplementation::InvalidDataPolicy invalidDataPolicy;
 };
 
+/*
+  Allocates the nodes of a document from larger chunks of memory. Freed nodes
+  are kept for reuse by nodes of the same size. The arena also holds the
+  names used by the nodes, so that nodes with the same name share its data.
+  It is reference counted by the document and by every node allocated from
+  it, since nodes can outlive their document.
+*/
+class QDomNodeArena
+{
+public:
+    QDomNodeArena() = default;
+    ~QDomNodeArena();
+
+    void *allocate(size_t size);
+    void deallocate(void *ptr, size_t size);
+
+    QString internedName(const QString &name);
+    void internNames(QDomNodePrivate *node);
+    void clearNames() { names.clear(); }
+
+    QAtomicInt ref;
+
+private:
+    Q_DISABLE_COPY_MOVE(QDomNodeArena)
+
+    enum : size_t {
+        Granularity = sizeof(void *),
+        MaxSlotSize = 512,
+        FirstChunkSize = 4096,
+        MaxChunkSize = 64 * 1024
+    };
+
+    struct FreeSlot
+    {
+        FreeSlot *next;
+    };
+
+    QList<void *> chunks;
+    char *chunkPos = nullptr;
+    char *chunkEnd = nullptr;
+    size_t nextChunkSize = FirstChunkSize;
+    FreeSlot *freeSlots[MaxSlotSize / Granularity] = {};
+    QHash<QStringView, QString> names; // the keys are views of the values
+};
+
 class QDomNodePrivate
 {
 public:
@@ -83,6 +128,12 @@ public:
     QDomNodePrivate(QDomNodePrivate *n, bool deep);
     virtual ~QDomNodePrivate();
 
+    static void *operator new(size_t size) { return operator new(size, nullptr); }
+    static void *operator new(size_t size, QDomNodeArena *arena);
+    static void operator delete(void *ptr, size_t size);
+    static void operator delete(void *ptr, QDomNodeArena *arena);
+    QDomNodeArena *ownerArena() const;
+
     QString nodeName() const { return name; }
     QString nodeValue() const { return value; }
     virtual void setNodeValue(const QString &v) { value = v; }
@@ -150,6 +201,8 @@ public:
 
     // Variables
     QAtomicInt ref;
+    bool createdWithDom1Interface : 1;
+    bool hasParent : 1;
     QDomNodePrivate *prev;
     QDomNodePrivate *next;
     QDomNodePrivate *ownerNode; // either the node's parent or the node's owner document
@@ -160,8 +213,6 @@ public:
     QString value;
     QString prefix; // set this only for ElementNode and AttributeNode
     QString namespaceURI; // set this only for ElementNode and AttributeNode
-    bool createdWithDom1Interface : 1;
-    bool hasParent : 1;
 
     int lineNumber;
     int columnNumber;
@@ -208,6 +259,8 @@ public:
     int length() const;
     bool contains(const QString &name) const;
     bool containsNS(const QString &nsURI, const QString &localName) const;
+    void removeNodes(const QString &name);
+    void appendNode(QDomNodePrivate *node);
 
     /**
      * Remove all children from the map.
@@ -235,7 +288,16 @@ public:
 
     // Variables
     QAtomicInt ref;
-    QMultiHash<QString, QDomNodePrivate *> map;
+    /*
+      The nodes in the order they were inserted in. The same name can appear
+      more than once, the node inserted last takes precedence. Maps usually
+      hold only a few nodes, which are looked up by name linearly; once a map
+      holds more than NameIndexThreshold nodes, nodesByName maps each name
+      to the node that takes precedence.
+    */
+    enum { NameIndexThreshold = 8 };
+    QList<QDomNodePrivate *> nodes;
+    QHash<QString, QDomNodePrivate *> nodesByName;
     QDomNodePrivate *parent;
     bool readonly;
     bool appendToParent;
@@ -484,6 +546,8 @@ public:
 
     QDomNodePrivate *importNode(QDomNodePrivate *importedNode, bool deep);
 
+    QDomNodeArena *nodeArena();
+
     // Reimplemented from QDomNodePrivate
     QDomNodePrivate *cloneNode(bool deep = true) override;
     QDomNode::NodeType nodeType() const override { return QDomNode::DocumentNode; }
@@ -492,6 +556,7 @@ public:
     // Variables
     QExplicitlySharedDataPointer<QDomImplementationPrivate> impl;
     QExplicitlySharedDataPointer<QDomDocumentTypePrivate> type;
+    QExplicitlySharedDataPointer<QDomNodeArena> arena;
 
     void saveDocument(QTextStream &stream, const int indent,
                       QDomNode::EncodingPolicy encUsed) const;
@@ -150,7 +150,8 @@ bool QDomBuilder::characters(const QString &characters, bool cdata)
         n.reset(doc->createCDATASection(characters));
     } else if (!entityName.isEmpty()) {
         QScopedPointer<QDomEntityPrivate> e(
-                new QDomEntityPrivate(doc, nullptr, entityName, QString(), QString(), QString()));
+                new (doc->nodeArena()) QDomEntityPrivate(doc, nullptr, entityName, QString(),
+                                                         QString(), QString()));
         e->value = characters;
         e->ref.deref();
         doc->doctype()->appendChild(e.data());
@@ -222,8 +223,8 @@ bool QDomBuilder::comment(const QString &characters)
 bool QDomBuilder::unparsedEntityDecl(const QString &name, const QString &publicId,
                                      const QString &systemId, const QString &notationName)
 {
-    QDomEntityPrivate *e =
-            new QDomEntityPrivate(doc, nullptr, name, publicId, systemId, notationName);
+    QDomEntityPrivate *e = new (doc->nodeArena())
+            QDomEntityPrivate(doc, nullptr, name, publicId, systemId, notationName);
     // keep the refcount balanced: appendChild() does a ref anyway.
     e->ref.deref();
     doc->doctype()->appendChild(e);
@@ -239,7 +240,8 @@ bool QDomBuilder::externalEntityDecl(const QString &name, const QString &publicI
 bool QDomBuilder::notationDecl(const QString &name, const QString &publicId,
                                const QString &systemId)
 {
-    QDomNotationPrivate *n = new QDomNotationPrivate(doc, nullptr, name, publicId, systemId);
+    QDomNotationPrivate *n =
+            new (doc->nodeArena()) QDomNotationPrivate(doc, nullptr, name, publicId, systemId);
     // keep the refcount balanced: appendChild() does a ref anyway.
     n->ref.deref();
     doc->doctype()->appendChild(n);
@@ -354,16 +356,17 @@ bool QDomParser::parseBody()
     std::stack<QString> tagStack;
     while (!reader->atEnd() && !reader->hasError()) {
         switch (reader->tokenType()) {
-        case QXmlStreamReader::StartElement:
-            tagStack.push(reader->qualifiedName().toString());
-            if (!domBuilder.startElement(reader->namespaceUri().toString(),
-                                         reader->qualifiedName().toString(),
+        case QXmlStreamReader::StartElement: {
+            const QString qName = reader->qualifiedName().toString();
+            tagStack.push(qName);
+            if (!domBuilder.startElement(reader->namespaceUri().toString(), qName,
                                          reader->attributes())) {
                 domBuilder.fatalError(
                         QDomParser::tr("Error occurred while processing a start element"));
                 return false;
             }
             break;
+        }
         case QXmlStreamReader::EndElement:
             if (tagStack.empty() || reader->qualifiedName() != tagStack.top()) {
                 domBuilder.fatalError(
@@ -379,7 +382,7 @@ bool QDomParser::parseBody()
             break;
         case QXmlStreamReader::Characters:
             if (!reader->isWhitespace()) { // Skip the content consisting of only whitespaces
-                if (!reader->text().toString().trimmed().isEmpty()) {
+                if (!reader->text().trimmed().isEmpty()) {
                     if (!domBuilder.characters(reader->text().toString(), reader->isCDATA())) {
                         domBuilder.fatalError(QDomParser::tr(
                                 "Error occurred while processing the element content"));
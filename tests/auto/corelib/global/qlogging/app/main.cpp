@@ -82,6 +82,17 @@ int main(int argc, char **argv)
     MyClass cl;
     QMetaObject::invokeMethod(&cl, "mySlot1");
 
+    if (argc > 1)
+        qSetMessagePattern("[%{type}] %{message}");
+    if (argc > 1 && qstrcmp(argv[1], "--flood") == 0) {
+        for (int i = 0; i < 100000; ++i)
+            qDebug("flood %d", i);
+    }
+    if (argc > 1 && qstrcmp(argv[1], "--fatal") == 0) {
+        qDebug("before qFatal");
+        qFatal("qFatal");
+    }
+
     return 0;
 }
 
@@ -57,6 +57,8 @@ private slots:
     void qMessagePattern_data();
     void qMessagePattern();
     void setMessagePattern();
+    void asyncOutput_data();
+    void asyncOutput();
 
     void formatLogMessage_data();
     void formatLogMessage();
@@ -864,6 +866,75 @@ void tst_qmessagehandler::setMessagePattern()
 #endif // QT_CONFIG(process)
 }
 
+void tst_qmessagehandler::asyncOutput_data()
+{
+    QTest::addColumn<QStringList>("arguments");
+    QTest::addColumn<QString>("overflow");
+
+    QTest::newRow("exit") << QStringList() << QString();
+    QTest::newRow("fatal") << QStringList{ "--fatal" } << QString();
+    QTest::newRow("flood") << QStringList{ "--flood" } << QString();
+    QTest::newRow("flood-drop") << QStringList{ "--flood" } << QString("drop");
+}
+
+void tst_qmessagehandler::asyncOutput()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+#ifdef Q_OS_ANDROID
+    QSKIP("This test crashes on Android");
+#endif
+    QFETCH(QStringList, arguments);
+    QFETCH(QString, overflow);
+
+    const QString appExe(QLatin1String(HELPER_BINARY));
+    const auto run = [&](bool async) {
+        QStringList environment = m_baseEnvironment;
+        if (async) {
+            environment.append("QT_LOGGING_ASYNC=1");
+            if (!overflow.isEmpty())
+                environment.append("QT_LOGGING_ASYNC_OVERFLOW=" + overflow);
+        }
+        QProcess process;
+        process.setEnvironment(environment);
+        process.start(appExe, arguments);
+        if (!process.waitForStarted())
+            qWarning() << "Could not start" << appExe << process.errorString();
+        process.waitForFinished();
+        QByteArray output = process.readAllStandardError();
+#ifdef Q_OS_WIN
+        output.replace("\r\n", "\n");
+#endif
+        return output;
+    };
+
+    const QByteArray expected = run(false);
+    const QByteArray output = run(true);
+    QVERIFY(!expected.isEmpty());
+    if (arguments.contains("--fatal"))
+        QVERIFY(expected.endsWith("[debug] before qFatal\n[fatal] qFatal\n"));
+
+    if (overflow == QLatin1String("drop")) {
+        // some messages may have been dropped, but none reordered or mangled
+        QVERIFY(output.startsWith("static constructor\n"));
+        QVERIFY(output.endsWith("[debug] static destructor\n"));
+        int next = 0;
+        for (const QByteArray &line : output.split('\n')) {
+            if (!line.startsWith("[debug] flood "))
+                continue;
+            const int n = line.mid(14).toInt();
+            QVERIFY2(n >= next, line.constData());
+            next = n + 1;
+        }
+    } else {
+        // everything arrives, in order, including what was logged right before
+        // a fatal message or during static destruction
+        QCOMPARE(QString::fromLatin1(output), QString::fromLatin1(expected));
+    }
+#endif // QT_CONFIG(process)
+}
+
 Q_DECLARE_METATYPE(QtMsgType)
 
 void tst_qmessagehandler::formatLogMessage_data()
@@ -2,6 +2,7 @@ TEMPLATE=subdirs
 SUBDIRS=\
     qabstractfileengine \
     qbuffer \
+    qcompressiondevice \
     qdataurl \
     qdebug \
     qdir \
@@ -17,6 +18,7 @@ SUBDIRS=\
     qipaddress \
     qlockfile \
     qloggingcategory \
+    qlogrecord \
     qloggingregistry \
     qnodebug \
     qprocess \
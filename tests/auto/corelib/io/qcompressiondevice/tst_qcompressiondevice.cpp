@@ -0,0 +1,316 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+
+#include <QBuffer>
+#include <QCompressionDevice>
+#include <QDataStream>
+
+class tst_QCompressionDevice : public QObject
+{
+    Q_OBJECT
+private slots:
+    void roundTrip_data();
+    void roundTrip();
+    void openMode();
+    void zlibMatchesQCompress();
+    void concatenatedStreams();
+    void truncatedStream();
+    void dataStream();
+    void bytesAvailable();
+    void closeError();
+    void compressionLevel();
+};
+
+static QByteArray testPayload()
+{
+    QByteArray data;
+    for (int i = 0; i < 50000; ++i)
+        data += "line " + QByteArray::number(i) + ": the quick brown fox\n";
+    return data;
+}
+
+static QByteArray compressed(const QByteArray &data, QCompressionDevice::Format format,
+                             int chunkSize = 0, int level = -1)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QCompressionDevice compressor(&buffer, format);
+    compressor.setCompressionLevel(level);
+    if (!compressor.open(QIODevice::WriteOnly))
+        return QByteArray();
+    if (chunkSize <= 0) {
+        compressor.write(data);
+    } else {
+        for (int i = 0; i < data.size(); i += chunkSize)
+            compressor.write(data.constData() + i, qMin(chunkSize, int(data.size()) - i));
+    }
+    compressor.close();
+    return buffer.data();
+}
+
+static QByteArray decompressed(const QByteArray &data, QCompressionDevice::Format format,
+                               int chunkSize = 0)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    QDecompressionDevice decompressor(&buffer, format);
+    if (!decompressor.open(QIODevice::ReadOnly))
+        return QByteArray();
+    if (chunkSize <= 0)
+        return decompressor.readAll();
+
+    QByteArray result;
+    while (!decompressor.atEnd()) {
+        const QByteArray chunk = decompressor.read(chunkSize);
+        if (chunk.isEmpty())
+            break;
+        result += chunk;
+    }
+    return result;
+}
+
+void tst_QCompressionDevice::roundTrip_data()
+{
+    QTest::addColumn<QCompressionDevice::Format>("format");
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<int>("chunkSize");
+
+    const QByteArray payload = testPayload();
+    const struct {
+        QCompressionDevice::Format format;
+        const char *name;
+    } formats[] = {
+        { QCompressionDevice::ZlibFormat, "zlib" },
+        { QCompressionDevice::DeflateFormat, "deflate" },
+        { QCompressionDevice::GzipFormat, "gzip" },
+        { QCompressionDevice::ZstdFormat, "zstd" }
+    };
+    for (const auto &format : formats) {
+        if (!QCompressionDevice::isFormatSupported(format.format))
+            continue;
+        QTest::addRow("%s-empty", format.name) << format.format << QByteArray() << 0;
+        QTest::addRow("%s-small", format.name) << format.format << QByteArray("Hello") << 0;
+        QTest::addRow("%s-large", format.name) << format.format << payload << 0;
+        QTest::addRow("%s-chunked", format.name) << format.format << payload << 1000;
+        QTest::addRow("%s-bytewise", format.name) << format.format << payload.left(5000) << 1;
+    }
+}
+
+void tst_QCompressionDevice::roundTrip()
+{
+    QFETCH(QCompressionDevice::Format, format);
+    QFETCH(QByteArray, data);
+    QFETCH(int, chunkSize);
+
+    const QByteArray packed = compressed(data, format, chunkSize);
+    QVERIFY(!packed.isEmpty());
+    if (data.size() > 1000)
+        QVERIFY(packed.size() < data.size());
+    QCOMPARE(decompressed(packed, format, chunkSize), data);
+}
+
+void tst_QCompressionDevice::openMode()
+{
+    QBuffer buffer;
+    QCompressionDevice compressor(&buffer);
+    QDecompressionDevice decompressor(&buffer);
+
+    // the underlying device must be open
+    QVERIFY(!compressor.open(QIODevice::WriteOnly));
+    QVERIFY(!compressor.errorString().isEmpty());
+    QVERIFY(!decompressor.open(QIODevice::ReadOnly));
+    QVERIFY(!decompressor.errorString().isEmpty());
+
+    QVERIFY(buffer.open(QIODevice::ReadWrite));
+    QTest::ignoreMessage(QtWarningMsg, "QCompressionDevice::open: Compression devices can only be opened for writing");
+    QVERIFY(!compressor.open(QIODevice::ReadWrite));
+    QTest::ignoreMessage(QtWarningMsg, "QDecompressionDevice::open: Decompression devices can only be opened for reading");
+    QVERIFY(!decompressor.open(QIODevice::ReadWrite));
+
+    QVERIFY(compressor.open(QIODevice::WriteOnly));
+    QVERIFY(compressor.isSequential());
+    QCOMPARE(compressor.device(), &buffer);
+    QCOMPARE(compressor.format(), QCompressionDevice::GzipFormat);
+    compressor.close();
+    QVERIFY(buffer.isOpen());
+}
+
+void tst_QCompressionDevice::zlibMatchesQCompress()
+{
+    const QByteArray payload = testPayload();
+
+    // qCompress() prepends the uncompressed size to a zlib stream
+    QCOMPARE(decompressed(qCompress(payload).mid(4), QCompressionDevice::ZlibFormat), payload);
+
+    QByteArray packed = compressed(payload, QCompressionDevice::ZlibFormat);
+    QByteArray size(4, Qt::Uninitialized);
+    qToBigEndian<quint32>(payload.size(), size.data());
+    QCOMPARE(qUncompress(size + packed), payload);
+}
+
+void tst_QCompressionDevice::concatenatedStreams()
+{
+    // like appending to a log file with gzip
+    const QByteArray first = "first part\n";
+    const QByteArray second = testPayload();
+    QByteArray packed = compressed(first, QCompressionDevice::GzipFormat)
+            + compressed(second, QCompressionDevice::GzipFormat);
+    QCOMPARE(decompressed(packed, QCompressionDevice::GzipFormat), first + second);
+    QCOMPARE(decompressed(packed, QCompressionDevice::GzipFormat, 7), first + second);
+
+    if (QCompressionDevice::isFormatSupported(QCompressionDevice::ZstdFormat)) {
+        packed = compressed(first, QCompressionDevice::ZstdFormat)
+                + compressed(second, QCompressionDevice::ZstdFormat);
+        QCOMPARE(decompressed(packed, QCompressionDevice::ZstdFormat), first + second);
+    }
+}
+
+void tst_QCompressionDevice::truncatedStream()
+{
+    const QByteArray packed = compressed(testPayload(), QCompressionDevice::GzipFormat);
+
+    QBuffer buffer;
+    buffer.setData(packed.left(packed.size() / 2));
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QDecompressionDevice decompressor(&buffer, QCompressionDevice::GzipFormat);
+    QVERIFY(decompressor.open(QIODevice::ReadOnly));
+    const QByteArray data = decompressor.readAll();
+    QVERIFY(testPayload().startsWith(data));
+    QVERIFY(data.size() < testPayload().size());
+    QCOMPARE(decompressor.errorString(), QStringLiteral("Unexpected end of compressed data"));
+    QVERIFY(decompressor.atEnd());
+
+    // garbage is rejected
+    QCOMPARE(decompressed("this is not compressed", QCompressionDevice::GzipFormat), QByteArray());
+}
+
+void tst_QCompressionDevice::dataStream()
+{
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    {
+        QCompressionDevice compressor(&buffer, QCompressionDevice::ZlibFormat);
+        QVERIFY(compressor.open(QIODevice::WriteOnly));
+        QDataStream out(&compressor);
+        for (int i = 0; i < 10000; ++i)
+            out << i << QString::number(i);
+        QCOMPARE(out.status(), QDataStream::Ok);
+    }
+    buffer.close();
+
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QDecompressionDevice decompressor(&buffer, QCompressionDevice::ZlibFormat);
+    QVERIFY(decompressor.open(QIODevice::ReadOnly));
+    QDataStream in(&decompressor);
+    for (int i = 0; i < 10000; ++i) {
+        int number;
+        QString string;
+        in >> number >> string;
+        QCOMPARE(number, i);
+        QCOMPARE(string, QString::number(i));
+    }
+    QCOMPARE(in.status(), QDataStream::Ok);
+    QVERIFY(in.atEnd());
+}
+
+void tst_QCompressionDevice::bytesAvailable()
+{
+    const QByteArray payload = testPayload();
+
+    QBuffer buffer;
+    buffer.setData(compressed(payload, QCompressionDevice::GzipFormat));
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QDecompressionDevice decompressor(&buffer, QCompressionDevice::GzipFormat);
+    QVERIFY(decompressor.open(QIODevice::ReadOnly));
+    QVERIFY(!decompressor.atEnd());
+
+    // only decompressed data is reported, and all of it can be read
+    QByteArray data;
+    while (const qint64 available = decompressor.bytesAvailable()) {
+        QVERIFY(available <= payload.size() - data.size());
+        const QByteArray chunk = decompressor.read(available);
+        QCOMPARE(chunk.size(), available);
+        data += chunk;
+    }
+    QCOMPARE(data, payload);
+    QVERIFY(decompressor.atEnd());
+    QCOMPARE(decompressor.read(1), QByteArray());
+
+    // a stream without data is at its end right away
+    QBuffer emptyBuffer;
+    emptyBuffer.setData(compressed(QByteArray(), QCompressionDevice::GzipFormat));
+    QVERIFY(emptyBuffer.open(QIODevice::ReadOnly));
+    QDecompressionDevice emptyDecompressor(&emptyBuffer, QCompressionDevice::GzipFormat);
+    QVERIFY(emptyDecompressor.open(QIODevice::ReadOnly));
+    QCOMPARE(emptyDecompressor.bytesAvailable(), 0);
+    QVERIFY(emptyDecompressor.atEnd());
+}
+
+void tst_QCompressionDevice::closeError()
+{
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QCompressionDevice compressor(&buffer, QCompressionDevice::GzipFormat);
+    QVERIFY(compressor.open(QIODevice::WriteOnly));
+    QCOMPARE(compressor.write("data"), 4);
+
+    // the end of the stream cannot be written anymore
+    buffer.close();
+    QTest::ignoreMessage(QtWarningMsg, "QIODevice::write (QBuffer): device not open");
+    compressor.close();
+    QVERIFY(!compressor.isOpen());
+    QVERIFY(compressor.errorString().startsWith(QStringLiteral("Could not write compressed data")));
+}
+
+void tst_QCompressionDevice::compressionLevel()
+{
+    const QByteArray payload = testPayload();
+
+    QBuffer buffer;
+    QCompressionDevice compressor(&buffer);
+    QCOMPARE(compressor.compressionLevel(), -1);
+    compressor.setCompressionLevel(9);
+    QCOMPARE(compressor.compressionLevel(), 9);
+    QCOMPARE(compressor.workerCount(), 0);
+    compressor.setWorkerCount(4);
+    QCOMPARE(compressor.workerCount(), 4);
+
+    const QByteArray stored = compressed(payload, QCompressionDevice::DeflateFormat, 0, 0);
+    const QByteArray best = compressed(payload, QCompressionDevice::DeflateFormat, 0, 9);
+    QVERIFY(stored.size() > payload.size());
+    QVERIFY(best.size() < payload.size() / 4);
+    QCOMPARE(decompressed(stored, QCompressionDevice::DeflateFormat), payload);
+    QCOMPARE(decompressed(best, QCompressionDevice::DeflateFormat), payload);
+}
+
+QTEST_MAIN(tst_QCompressionDevice)
+#include "tst_qcompressiondevice.moc"
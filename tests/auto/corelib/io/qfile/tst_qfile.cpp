@@ -271,6 +271,10 @@ private slots:
 
     void openDirectory();
     void writeNothing();
+    void writeChunks_data();
+    void writeChunks();
+    void writeChunksAfterBufferedData();
+    void writeManyChunks();
 
     void invalidFile_data();
     void invalidFile();
@@ -3445,6 +3449,90 @@ void tst_QFile::writeNothing()
     }
 }
 
+void tst_QFile::writeChunks_data()
+{
+    QTest::addColumn<int>("filetype");
+    QTest::addColumn<bool>("buffered");
+
+    QTest::newRow("native") << int(OpenQFile) << true;
+    QTest::newRow("native-unbuffered") << int(OpenQFile) << false;
+    QTest::newRow("fileno") << int(OpenFd) << true;
+    QTest::newRow("stream") << int(OpenStream) << true;
+}
+
+void tst_QFile::writeChunks()
+{
+    QFETCH(int, filetype);
+    QFETCH(bool, buffered);
+
+    const QList<QByteArray> chunks = {
+        QByteArray("header\n"),
+        QByteArray(),
+        QByteArray(5000, 'a'),
+        QByteArray(7000, 'b'),
+        QByteArray(20000, 'c'),
+        QByteArray("trailer\n")
+    };
+    QByteArray expected;
+    for (const QByteArray &chunk : chunks)
+        expected += chunk;
+
+    QFile file("file.txt");
+    QIODevice::OpenMode mode = QIODevice::WriteOnly | QIODevice::Truncate;
+    if (!buffered)
+        mode |= QIODevice::Unbuffered;
+    QVERIFY(openFile(file, mode, FileType(filetype)));
+    QCOMPARE(file.write(chunks), qint64(expected.size()));
+    // a second write appends to the first one
+    QCOMPARE(file.write(chunks), qint64(expected.size()));
+    QVERIFY(file.flush());
+    QCOMPARE(file.error(), QFile::NoError);
+    closeFile(file);
+
+    // opening from a file descriptor or stream does not keep the file name
+    QFile readFile("file.txt");
+    QVERIFY(readFile.open(QIODevice::ReadOnly));
+    QCOMPARE(readFile.readAll(), expected + expected);
+}
+
+void tst_QFile::writeChunksAfterBufferedData()
+{
+    QFile file("file.txt");
+    QVERIFY(file.open(QIODevice::ReadWrite | QIODevice::Truncate));
+    QCOMPARE(file.write("0123456789"), qint64(10));
+    QVERIFY(file.seek(2));
+    QCOMPARE(file.write("ab"), qint64(2));
+
+    // too large for the write buffer, so it is written together with "ab"
+    const QByteArray body(64 * 1024, 'x');
+    QCOMPARE(file.write({ QByteArray("cd"), body }), qint64(2 + body.size()));
+    QCOMPARE(file.pos(), qint64(6 + body.size()));
+    QCOMPARE(file.write("!"), qint64(1));
+
+    QVERIFY(file.seek(0));
+    QCOMPARE(file.readAll(), "01abcd" + body + '!');
+}
+
+void tst_QFile::writeManyChunks()
+{
+    // more chunks than a single writev() accepts
+    QList<QByteArray> chunks;
+    QByteArray expected;
+    for (int i = 0; i < 3000; ++i) {
+        chunks.append(QByteArray::number(i) + ' ');
+        expected += chunks.constLast();
+    }
+
+    QFile file("file.txt");
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered));
+    QCOMPARE(file.write(chunks), qint64(expected.size()));
+    QCOMPARE(file.error(), QFile::NoError);
+    file.close();
+
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QCOMPARE(file.readAll(), expected);
+}
+
 void tst_QFile::resize_data()
 {
     QTest::addColumn<int>("filetype");
@@ -309,6 +309,133 @@ private slots:
     }
 
 
+    void QLoggingRuleMatcher_apply_data()
+    {
+        QTest::addColumn<QString>("rules");
+        QTest::addColumn<QString>("category");
+        QTest::addColumn<QString>("expected"); // d, i, w, c if enabled
+
+        QTest::newRow("no-rules") << "" << "a.b.c" << "diwc";
+        QTest::newRow("full-text") << "a.b=false" << "a.b" << "";
+        QTest::newRow("full-text-longer") << "a.b=false" << "a.b.c" << "diwc";
+        QTest::newRow("full-text-shorter") << "a.b.c=false" << "a.b" << "diwc";
+        QTest::newRow("prefix") << "a.*=false" << "a.b.c" << "";
+        QTest::newRow("prefix-mismatch") << "a.*=false" << "b.a.c" << "diwc";
+        QTest::newRow("all") << "*=false" << "x" << "";
+        QTest::newRow("suffix") << "*.c=false" << "a.b.c" << "";
+        QTest::newRow("suffix-mismatch") << "*.c=false" << "a.c.b" << "diwc";
+        QTest::newRow("suffix-twice") << "*.io=false" << "a.io.b.io" << "";
+        QTest::newRow("substring") << "*.b.*=false" << "a.b.c" << "";
+        QTest::newRow("substring-mismatch") << "*.b.*=false" << "a.bc" << "diwc";
+        QTest::newRow("type") << "a.*.warning=false" << "a.b" << "dic";
+        QTest::newRow("types") << "*.debug=false\n*.info=false" << "a" << "wc";
+        QTest::newRow("later-wins") << "a.*=false\n*.b=true" << "a.b" << "diwc";
+        QTest::newRow("later-wins-reversed") << "*.b=true\na.*=false" << "a.b" << "";
+        QTest::newRow("later-wins-type")
+                << "a.b=false\na.*.critical=true\n*.debug=true" << "a.b" << "dc";
+        QTest::newRow("same-pattern") << "a.*=false\na.*.info=true" << "a.b" << "i";
+    }
+
+    void QLoggingRuleMatcher_apply()
+    {
+        QFETCH(QString, rules);
+        QFETCH(QString, category);
+        QFETCH(QString, expected);
+
+        QLoggingSettingsParser parser;
+        parser.setImplicitRulesSection(true);
+        parser.setContent(rules);
+        QLoggingRuleMatcher matcher;
+        matcher.addRules(parser.rules());
+
+        const QByteArray name = category.toLatin1();
+        bool enabled[QLoggingRuleMatcher::NumMessageTypes] = { true, true, true, true };
+        matcher.apply(QLatin1String(name), enabled);
+        QString actual;
+        for (int type = 0; type < QLoggingRuleMatcher::NumMessageTypes; ++type) {
+            if (enabled[type])
+                actual += QLatin1Char("diwc"[type]);
+        }
+        QCOMPARE(actual, expected);
+        if (expected != QLatin1String("diwc"))
+            QVERIFY(matcher.matches(QLatin1String(name)));
+    }
+
+    void QLoggingRuleMatcher_latin1()
+    {
+        QLoggingRuleMatcher matcher;
+        matcher.addRules({ QLoggingRule(u"*\u00e9", false),
+                           QLoggingRule(u"caf\u00e9\u4e2d", true) });
+
+        bool enabled[QLoggingRuleMatcher::NumMessageTypes] = { true, true, true, true };
+        matcher.apply(QLatin1String("caf\xe9"), enabled);
+        QVERIFY(!enabled[QLoggingRuleMatcher::DebugIndex]);
+        QVERIFY(!matcher.matches(QLatin1String("caf\xe9?")));
+    }
+
+    void QLoggingRuleMatcher_compareWithRules()
+    {
+        // The matcher must agree with QLoggingRule::pass() applied rule by rule
+        QLoggingSettingsParser parser;
+        parser.setImplicitRulesSection(true);
+        parser.setContent("qt.*=true\n"
+                          "*.io.debug=false\n"
+                          "*.net.*=false\n"
+                          "app.ui=false\n"
+                          "app.*.warning=false\n"
+                          "*.render.info=true\n"
+                          "qt.net.*.critical=true\n"
+                          "*ui*.debug=true\n");
+        const QList<QLoggingRule> rules = parser.rules();
+        QCOMPARE(rules.size(), 8);
+        QLoggingRuleMatcher matcher;
+        matcher.addRules(rules);
+
+        const char *const names[] = {
+            "", "qt", "qt.io", "qt.net", "qt.net.http", "app", "app.ui", "app.ui.render",
+            "app.render", "lib.net.io", "ui", "quick.ui.io", "qt.net.", ".io"
+        };
+        const QtMsgType types[] = { QtDebugMsg, QtInfoMsg, QtWarningMsg, QtCriticalMsg };
+        for (const char *name : names) {
+            bool enabled[QLoggingRuleMatcher::NumMessageTypes] = { true, false, true, false };
+            matcher.apply(QLatin1String(name), enabled);
+            for (int type = 0; type < QLoggingRuleMatcher::NumMessageTypes; ++type) {
+                bool expected = type % 2 == 0;
+                for (const QLoggingRule &rule : rules) {
+                    const int pass = rule.pass(QLatin1String(name), types[type]);
+                    if (pass)
+                        expected = pass > 0;
+                }
+                QVERIFY2(enabled[type] == expected,
+                         QByteArray(name).append(" type ").append(QByteArray::number(type)));
+            }
+        }
+    }
+
+    void QLoggingRegistry_changeApiRules()
+    {
+        QLoggingRegistry *registry = QLoggingRegistry::instance();
+        registry->ruleSets[QLoggingRegistry::ConfigRules].clear();
+        registry->ruleSets[QLoggingRegistry::EnvironmentRules].clear();
+        registry->updateRules();
+
+        QLoggingCategory oslo("Digia.Oslo");
+        QLoggingCategory espoo("Nokia.Espoo");
+        QLoggingCategory::setFilterRules("Digia.*=false");
+        QVERIFY(!oslo.isWarningEnabled());
+        QVERIFY(espoo.isWarningEnabled());
+
+        // categories that only the old rules applied to are updated as well
+        QLoggingCategory::setFilterRules("Nokia.*.warning=false");
+        QVERIFY(oslo.isWarningEnabled());
+        QVERIFY(!espoo.isWarningEnabled());
+        QVERIFY(espoo.isCriticalEnabled());
+
+        QLoggingCategory::setFilterRules(QString());
+        QVERIFY(oslo.isWarningEnabled());
+        QVERIFY(espoo.isWarningEnabled());
+    }
+
     void QLoggingRegistry_checkErrors()
     {
         QLoggingSettingsParser parser;
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qlogrecord
+QT = core testlib
+SOURCES = tst_qlogrecord.cpp
@@ -0,0 +1,249 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLogRecord>
+
+Q_LOGGING_CATEGORY(lcRecord, "tst.record")
+Q_LOGGING_CATEGORY(lcQuiet, "tst.quiet", QtWarningMsg)
+
+struct CapturedRecord
+{
+    QtMsgType type = QtFatalMsg;
+    QByteArray category;
+    QStringList names;
+    QList<QLogRecord::FieldType> types;
+    QVariantList values;
+    QString message;
+    QByteArray json;
+};
+
+static QList<CapturedRecord> records;
+
+static void captureHandler(const QLogRecord &record)
+{
+    CapturedRecord captured;
+    captured.type = record.type();
+    captured.category = record.context().category;
+    for (qsizetype i = 0; i < record.fieldCount(); ++i) {
+        captured.names.append(record.fieldName(i));
+        captured.types.append(record.fieldType(i));
+        captured.values.append(record.fieldValue(i));
+    }
+    captured.message = record.message();
+    captured.json = record.toJson();
+    records.append(captured);
+}
+
+static QStringList messages;
+
+static void messageHandler(QtMsgType, const QMessageLogContext &context, const QString &message)
+{
+    messages.append(QString::fromLatin1(context.category) + QLatin1String(": ") + message);
+}
+
+enum class Color { Red = 1, Green = 2 };
+
+class tst_QLogRecord : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void fieldCount();
+    void fields();
+    void message_data();
+    void message();
+    void messageTypes();
+    void disabledCategory();
+    void defaultHandler();
+    void toJson();
+};
+
+void tst_QLogRecord::init()
+{
+    records.clear();
+    messages.clear();
+    qInstallLogRecordHandler(captureHandler);
+}
+
+void tst_QLogRecord::cleanup()
+{
+    qInstallLogRecordHandler(nullptr);
+}
+
+void tst_QLogRecord::fieldCount()
+{
+    static_assert(QtPrivate::qLogFieldCount("") == 0);
+    static_assert(QtPrivate::qLogFieldCount("plain text") == 0);
+    static_assert(QtPrivate::qLogFieldCount("{a}") == 1);
+    static_assert(QtPrivate::qLogFieldCount("{a} and {b}") == 2);
+    static_assert(QtPrivate::qLogFieldCount("{{a}} {b}") == 1);
+    static_assert(QtPrivate::qLogFieldCount("{a} {unterminated") == 1);
+    static_assert(QtPrivate::qLogFieldCount("}} {}") == 1);
+}
+
+void tst_QLogRecord::fields()
+{
+    const QString host = QStringLiteral("example.org");
+    const QByteArray path("/index.html");
+    qCDebugFields(lcRecord, "{b}{i}{u}{d}{f}{s}{v}{l}{c}{a}{e}",
+                  true, -42, 42u, 1.5, 0.25f, host, QStringView(host).left(7),
+                  QLatin1String("caf\xe9"), "utf8 \xc3\xa9", path, Color::Green);
+
+    QCOMPARE(records.size(), 1);
+    const CapturedRecord &record = records.first();
+    QCOMPARE(record.type, QtDebugMsg);
+    QCOMPARE(record.category, QByteArray("tst.record"));
+    QCOMPARE(record.names, QStringList({ "b", "i", "u", "d", "f", "s", "v", "l", "c", "a", "e" }));
+    QCOMPARE(record.types, QList<QLogRecord::FieldType>({
+        QLogRecord::Bool, QLogRecord::Int, QLogRecord::UInt, QLogRecord::Double,
+        QLogRecord::Double, QLogRecord::Utf16String, QLogRecord::Utf16String,
+        QLogRecord::Latin1String, QLogRecord::Utf8String, QLogRecord::ByteArray,
+        QLogRecord::Int }));
+    QCOMPARE(record.values.at(0), QVariant(true));
+    QCOMPARE(record.values.at(1), QVariant(qint64(-42)));
+    QCOMPARE(record.values.at(2), QVariant(quint64(42)));
+    QCOMPARE(record.values.at(3), QVariant(1.5));
+    QCOMPARE(record.values.at(4), QVariant(0.25));
+    QCOMPARE(record.values.at(5), QVariant(host));
+    QCOMPARE(record.values.at(6), QVariant(QStringLiteral("example")));
+    QCOMPARE(record.values.at(7), QVariant(QString::fromUtf8("caf\xc3\xa9")));
+    QCOMPARE(record.values.at(8), QVariant(QString::fromUtf8("utf8 \xc3\xa9")));
+    QCOMPARE(record.values.at(9), QVariant(path));
+    QCOMPARE(record.values.at(10), QVariant(qint64(2)));
+}
+
+void tst_QLogRecord::message_data()
+{
+    QTest::addColumn<QString>("message");
+    QTest::addColumn<QString>("expected");
+
+    records.clear();
+    qInstallLogRecordHandler(captureHandler);
+    qCInfoFields(lcRecord, "no fields");
+    qCInfoFields(lcRecord, "{host}:{port}", "localhost", 8080);
+    qCInfoFields(lcRecord, "{{literal}} {value} }} {", 3);
+    qCInfoFields(lcRecord, "{x} {y}", -0.5, std::numeric_limits<quint64>::max());
+    qCInfoFields(lcRecord, "{ok}/{failed}", true, false);
+    qCInfoFields(lcRecord, "[{s}]", QString());
+    qCInfoFields(lcRecord, "[{s}]", static_cast<const char *>(nullptr));
+    qCInfoFields(lcRecord, "{a} {b} {c} {d} {e}", 0.0, 100.0, 123456.789, 1e20, 1e21);
+    qCInfoFields(lcRecord, "{a} {b} {c} {d}", 0.000001, 1e-7, -2.5e-10, qQNaN());
+    qCInfoFields(lcRecord, "{min} {max}", std::numeric_limits<qint64>::min(), qint8(127));
+    qInstallLogRecordHandler(nullptr);
+    QCOMPARE(records.size(), 10);
+
+    QTest::newRow("plain") << records.at(0).message << "no fields";
+    QTest::newRow("fields") << records.at(1).message << "localhost:8080";
+    QTest::newRow("braces") << records.at(2).message << "{literal} 3 } {";
+    QTest::newRow("numbers") << records.at(3).message << "-0.5 18446744073709551615";
+    QTest::newRow("bools") << records.at(4).message << "true/false";
+    QTest::newRow("empty-string") << records.at(5).message << "[]";
+    QTest::newRow("null-string") << records.at(6).message << "[]";
+    QTest::newRow("doubles") << records.at(7).message
+                             << "0 100 123456.789 100000000000000000000 1e+21";
+    QTest::newRow("small-doubles") << records.at(8).message << "0.000001 1e-7 -2.5e-10 nan";
+    QTest::newRow("integers") << records.at(9).message << "-9223372036854775808 127";
+}
+
+void tst_QLogRecord::message()
+{
+    QFETCH(QString, message);
+    QFETCH(QString, expected);
+    QCOMPARE(message, expected);
+}
+
+void tst_QLogRecord::messageTypes()
+{
+    qCDebugFields(lcRecord, "d");
+    qCInfoFields(lcRecord, "i");
+    qCWarningFields(lcRecord, "w");
+    qCCriticalFields(lcRecord, "c");
+    QCOMPARE(records.size(), 4);
+    QCOMPARE(records.at(0).type, QtDebugMsg);
+    QCOMPARE(records.at(1).type, QtInfoMsg);
+    QCOMPARE(records.at(2).type, QtWarningMsg);
+    QCOMPARE(records.at(3).type, QtCriticalMsg);
+}
+
+void tst_QLogRecord::disabledCategory()
+{
+    int evaluated = 0;
+    auto value = [&evaluated]() { return ++evaluated; };
+    qCDebugFields(lcQuiet, "{value}", value());
+    qCInfoFields(lcQuiet, "{value}", value());
+    QCOMPARE(evaluated, 0);
+    QVERIFY(records.isEmpty());
+
+    qCWarningFields(lcQuiet, "{value}", value());
+    QCOMPARE(evaluated, 1);
+    QCOMPARE(records.size(), 1);
+}
+
+void tst_QLogRecord::defaultHandler()
+{
+    qInstallLogRecordHandler(nullptr);
+    QtMessageHandler oldHandler = qInstallMessageHandler(messageHandler);
+    qCWarningFields(lcRecord, "{count} items in {path}", 3, QStringLiteral("/tmp"));
+    qInstallMessageHandler(oldHandler);
+
+    QVERIFY(records.isEmpty());
+    QCOMPARE(messages, QStringList(QStringLiteral("tst.record: 3 items in /tmp")));
+}
+
+void tst_QLogRecord::toJson()
+{
+    qCCriticalFields(lcRecord, "\"{name}\" is {value}\n", QStringLiteral("a\\b\t\x01"), qInf());
+    qCInfoFields(lcRecord, "{text}", QLatin1String("\xe9"));
+    QCOMPARE(records.size(), 2);
+
+    const QByteArray &json = records.at(0).json;
+    QVERIFY(!json.contains('\n'));
+    QJsonParseError error;
+    const QJsonObject object = QJsonDocument::fromJson(json, &error).object();
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QCOMPARE(object.value("type").toString(), QStringLiteral("critical"));
+    QCOMPARE(object.value("category").toString(), QStringLiteral("tst.record"));
+    QCOMPARE(object.value("message").toString(), QStringLiteral("\"a\\b\t\x01\" is inf\n"));
+    const QJsonObject fields = object.value("fields").toObject();
+    QCOMPARE(fields.size(), 2);
+    QCOMPARE(fields.value("name").toString(), QStringLiteral("a\\b\t\x01"));
+    QVERIFY(fields.value("value").isNull());
+
+    const QJsonObject latin1 = QJsonDocument::fromJson(records.at(1).json).object();
+    QCOMPARE(latin1.value("fields").toObject().value("text").toString(),
+             QString::fromUtf8("\xc3\xa9"));
+}
+
+QTEST_APPLESS_MAIN(tst_QLogRecord)
+#include "tst_qlogrecord.moc"
@@ -148,6 +148,12 @@ private slots:
     void startStopStartStopBuffers();
     void processEventsInAReadyReadSlot_data();
     void processEventsInAReadyReadSlot();
+    void processPool();
+    void processPoolEventLoop();
+    void processPoolFailToStart();
+    void processPoolClear();
+    void processPoolDeletedProcess();
+    void processPoolFailToStartSignals();
 
     // keep these at the end, since they use lots of processes and sometimes
     // caused obscure failures to occur in tests that followed them (esp. on the Mac)
@@ -2493,5 +2499,150 @@ void tst_QProcess::processEventsInAReadyReadSlot()
         QVERIFY(process.waitForFinished());
 }
 
+void tst_QProcess::processPool()
+{
+    QProcessPool pool;
+    pool.setMaxProcessCount(2);
+    QCOMPARE(pool.maxProcessCount(), 2);
+
+    QSignalSpy doneSpy(&pool, &QProcessPool::done);
+    QList<int> exitCodes;
+    connect(&pool, &QProcessPool::processFinished, this, [&](QProcess *process) {
+        QVERIFY(pool.activeProcessCount() <= 2);
+        QCOMPARE(process->state(), QProcess::NotRunning);
+        exitCodes << process->exitCode();
+        process->deleteLater();
+    });
+
+    for (int i = 0; i < 5; ++i)
+        pool.start("testExitCodes/testExitCodes", { QString::number(i) });
+    QCOMPARE(pool.activeProcessCount(), 2);
+    QCOMPARE(pool.queuedProcessCount(), 3);
+
+    QVERIFY(pool.waitForDone(30000));
+    QCOMPARE(pool.activeProcessCount(), 0);
+    QCOMPARE(pool.queuedProcessCount(), 0);
+    QCOMPARE(doneSpy.count(), 1);
+    std::sort(exitCodes.begin(), exitCodes.end());
+    QCOMPARE(exitCodes, QList<int>({ 0, 1, 2, 3, 4 }));
+}
+
+void tst_QProcess::processPoolEventLoop()
+{
+    QProcessPool pool;
+    pool.setMaxProcessCount(3);
+    QSignalSpy finishedSpy(&pool, &QProcessPool::processFinished);
+    QSignalSpy doneSpy(&pool, &QProcessPool::done);
+
+    QProcess process;
+    process.setProcessChannelMode(QProcess::MergedChannels);
+    process.setArguments({ "hello" });
+    process.setProgram("testProcessSpacesArgs/nospace");
+    pool.start(&process);
+    for (int i = 0; i < 7; ++i)
+        pool.start("testProcessNormal/testProcessNormal");
+
+    QVERIFY(doneSpy.wait(30000));
+    QCOMPARE(finishedSpy.count(), 8);
+    QCOMPARE(process.exitStatus(), QProcess::NormalExit);
+    QVERIFY(process.readAll().contains("hello"));
+}
+
+void tst_QProcess::processPoolFailToStart()
+{
+    QProcessPool pool;
+    pool.setMaxProcessCount(1);
+    QList<QProcess::ProcessError> errors;
+    connect(&pool, &QProcessPool::processFinished, this, [&](QProcess *process) {
+        errors << process->error();
+    });
+
+    pool.start("/nonexistent/program");
+    pool.start("testProcessNormal/testProcessNormal");
+    pool.start(QString());
+
+    QVERIFY(pool.waitForDone(30000));
+    QCOMPARE(errors.size(), 3);
+    QCOMPARE(errors.at(0), QProcess::FailedToStart);
+    QCOMPARE(errors.at(1), QProcess::UnknownError);
+    QCOMPARE(errors.at(2), QProcess::FailedToStart);
+}
+
+void tst_QProcess::processPoolClear()
+{
+    QProcessPool pool;
+    pool.setMaxProcessCount(1);
+    QSignalSpy finishedSpy(&pool, &QProcessPool::processFinished);
+    QSignalSpy doneSpy(&pool, &QProcessPool::done);
+
+    for (int i = 0; i < 3; ++i)
+        pool.start("testProcessNormal/testProcessNormal");
+    QCOMPARE(pool.queuedProcessCount(), 2);
+    pool.clear();
+    QCOMPARE(pool.queuedProcessCount(), 0);
+    QCOMPARE(pool.activeProcessCount(), 1);
+    QCOMPARE(doneSpy.count(), 0);
+
+    QVERIFY(pool.waitForDone(30000));
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(doneSpy.count(), 1);
+
+    // raising the limit starts queued processes right away
+    pool.setMaxProcessCount(0);
+    QCOMPARE(pool.maxProcessCount(), 1);
+    pool.start("testProcessNormal/testProcessNormal");
+    pool.start("testProcessNormal/testProcessNormal");
+    QCOMPARE(pool.activeProcessCount(), 1);
+    pool.setMaxProcessCount(2);
+    QCOMPARE(pool.activeProcessCount(), 2);
+    QCOMPARE(pool.queuedProcessCount(), 0);
+    QVERIFY(pool.waitForDone(30000));
+    QCOMPARE(finishedSpy.count(), 3);
+}
+
+void tst_QProcess::processPoolDeletedProcess()
+{
+    QProcessPool pool;
+    pool.setMaxProcessCount(1);
+    QSignalSpy finishedSpy(&pool, &QProcessPool::processFinished);
+
+    pool.start("testProcessNormal/testProcessNormal");
+    QProcess *queued = new QProcess;
+    queued->setProgram("testProcessNormal/testProcessNormal");
+    pool.start(queued);
+    QCOMPARE(pool.queuedProcessCount(), 1);
+    delete queued;
+
+    QVERIFY(pool.waitForDone(30000));
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(pool.activeProcessCount(), 0);
+}
+
+void tst_QProcess::processPoolFailToStartSignals()
+{
+    QProcessPool pool;
+    pool.setMaxProcessCount(1);
+    QList<QProcess *> processes;
+    for (int i = 0; i < 100; ++i)
+        processes << pool.start("/nonexistent/program");
+    QCOMPARE(pool.activeProcessCount(), 1);
+    QCOMPARE(pool.queuedProcessCount(), 99);
+
+    // no signals are emitted from within start(), so none are missed here
+    QList<QProcess *> finished;
+    QList<QProcess::ProcessError> errors;
+    connect(&pool, &QProcessPool::processFinished, this, [&](QProcess *process) {
+        finished << process;
+        errors << process->error();
+    });
+    QSignalSpy doneSpy(&pool, &QProcessPool::done);
+
+    QTRY_COMPARE(doneSpy.count(), 1);
+    QCOMPARE(finished, processes);
+    QCOMPARE(errors, QList<QProcess::ProcessError>(100, QProcess::FailedToStart));
+    QCOMPARE(pool.activeProcessCount(), 0);
+    QCOMPARE(pool.queuedProcessCount(), 0);
+}
+
 QTEST_MAIN(tst_QProcess)
 #include "tst_qprocess.moc"
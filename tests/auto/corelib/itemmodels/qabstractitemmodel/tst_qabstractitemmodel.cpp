@@ -78,6 +78,9 @@ private slots:
     void reset();
 
     void complexChangesWithPersistent();
+    void persistentIndexesOnDifferentLevels();
+    void persistentIndexChangesOnDifferentLevels_data();
+    void persistentIndexChangesOnDifferentLevels();
 
     void testMoveSameParentUp_data();
     void testMoveSameParentUp();
@@ -119,6 +122,7 @@ private slots:
     void modelRoleDataSpan();
 
     void multiData();
+    void rangeData();
 private:
     DynamicTreeModel *m_model;
 };
@@ -1005,6 +1009,365 @@ void tst_QAbstractItemModel::complexChangesWithPersistent()
         QVERIFY(e[i] == model.index(2, i-2 , QModelIndex()));
 }
 
+void tst_QAbstractItemModel::persistentIndexesOnDifferentLevels()
+{
+    QList<QPersistentModelIndex> topLevel;
+    QList<QPersistentModelIndex> nested;
+    QStringList topLevelData;
+    QStringList nestedData;
+    QList<int> topLevelRows;
+    QList<int> nestedRows;
+
+    QPersistentModelIndex parent = m_model->index(5, 0);
+    for (int row = 0; row < m_model->rowCount(); ++row) {
+        topLevel << QPersistentModelIndex(m_model->index(row, 1));
+        topLevelData << topLevel.last().data().toString();
+        topLevelRows << row;
+    }
+    for (int row = 0; row < m_model->rowCount(parent); ++row) {
+        nested << QPersistentModelIndex(m_model->index(row, 1, parent));
+        nestedData << nested.last().data().toString();
+        nestedRows << row;
+    }
+
+    const auto insertRows = [&](const QList<int> &ancestors, int first, int last) {
+        ModelInsertCommand *insertCommand = new ModelInsertCommand(m_model, this);
+        insertCommand->setAncestorRowNumbers(ancestors);
+        insertCommand->setNumCols(4);
+        insertCommand->setStartRow(first);
+        insertCommand->setEndRow(last);
+        insertCommand->doCommand();
+        QList<int> &rows = ancestors.isEmpty() ? topLevelRows : nestedRows;
+        for (int &row : rows) {
+            if (row >= first)
+                row += last - first + 1;
+        }
+    };
+
+    // inserting top level rows after the parent leaves the nested indexes alone
+    insertRows({}, 7, 8);
+    // inserting nested rows only moves the nested indexes below them
+    insertRows({5}, 3, 5);
+    // inserting top level rows before the parent moves it, but not its children
+    insertRows({}, 0, 0);
+    QCOMPARE(parent.row(), 6);
+    insertRows({6}, 0, 1);
+
+    for (int i = 0; i < topLevel.count(); ++i) {
+        QCOMPARE(topLevel.at(i), QPersistentModelIndex(m_model->index(topLevelRows.at(i), 1)));
+        QCOMPARE(topLevel.at(i).data().toString(), topLevelData.at(i));
+    }
+    for (int i = 0; i < nested.count(); ++i) {
+        QCOMPARE(nested.at(i), QPersistentModelIndex(m_model->index(nestedRows.at(i), 1, parent)));
+        QCOMPARE(nested.at(i).data().toString(), nestedData.at(i));
+    }
+}
+
+/*!
+    Test model with a hierarchy of named items, whose rows and columns can be
+    inserted, removed and moved below any parent.
+
+    The internal pointer of an index is the item of its parent, and every
+    parent numbers the columns of its children in the order they were
+    inserted, so that find() can tell where a cell is after any change.
+ */
+class QtTestTreeModel : public QAbstractItemModel
+{
+public:
+    struct Item
+    {
+        ~Item() { qDeleteAll(children); }
+
+        Item *parent = nullptr;
+        QString name;
+        QList<Item *> children;
+        QStringList columns;
+        int nextColumn = 0;
+    };
+
+    explicit QtTestTreeModel(QObject *parent = nullptr) : QAbstractItemModel(parent) {}
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    bool insertRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+    bool moveRows(const QModelIndex &sourceParent, int sourceRow, int count,
+                  const QModelIndex &destinationParent, int destinationChild) override;
+    bool insertColumns(int column, int count, const QModelIndex &parent = QModelIndex()) override;
+    bool removeColumns(int column, int count, const QModelIndex &parent = QModelIndex()) override;
+
+    void reverseRows(const QModelIndex &parent);
+    QModelIndex find(const QString &name, const QString &column) const;
+
+private:
+    Item *itemAt(const QModelIndex &parent) const;
+    QModelIndex find(const Item *parent, const QString &name, const QString &column) const;
+
+    Item root;
+    int nextName = 0;
+};
+
+QModelIndex QtTestTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    return hasIndex(row, column, parent) ? createIndex(row, column, itemAt(parent)) : QModelIndex();
+}
+
+QModelIndex QtTestTreeModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || child.internalPointer() == &root)
+        return QModelIndex();
+    Item *item = static_cast<Item *>(child.internalPointer());
+    return createIndex(item->parent->children.indexOf(item), 0, item->parent);
+}
+
+int QtTestTreeModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.column() > 0 ? 0 : itemAt(parent)->children.count();
+}
+
+int QtTestTreeModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.column() > 0 ? 0 : itemAt(parent)->columns.count();
+}
+
+QVariant QtTestTreeModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+    const Item *parent = static_cast<Item *>(index.internalPointer());
+    return parent->children.at(index.row())->name + QLatin1Char('/')
+            + parent->columns.at(index.column());
+}
+
+bool QtTestTreeModel::insertRows(int row, int count, const QModelIndex &parent)
+{
+    Item *parentItem = itemAt(parent);
+    beginInsertRows(parent, row, row + count - 1);
+    for (int i = 0; i < count; ++i) {
+        Item *item = new Item;
+        item->parent = parentItem;
+        item->name = QString::number(nextName++);
+        parentItem->children.insert(row + i, item);
+    }
+    endInsertRows();
+    return true;
+}
+
+bool QtTestTreeModel::removeRows(int row, int count, const QModelIndex &parent)
+{
+    Item *parentItem = itemAt(parent);
+    beginRemoveRows(parent, row, row + count - 1);
+    for (int i = 0; i < count; ++i)
+        delete parentItem->children.takeAt(row);
+    endRemoveRows();
+    return true;
+}
+
+bool QtTestTreeModel::moveRows(const QModelIndex &sourceParent, int sourceRow, int count,
+                               const QModelIndex &destinationParent, int destinationChild)
+{
+    Item *source = itemAt(sourceParent);
+    Item *destination = itemAt(destinationParent);
+    if (!beginMoveRows(sourceParent, sourceRow, sourceRow + count - 1,
+                       destinationParent, destinationChild)) {
+        return false;
+    }
+    if (source == destination && destinationChild > sourceRow)
+        destinationChild -= count;
+    QList<Item *> moved;
+    for (int i = 0; i < count; ++i)
+        moved.append(source->children.takeAt(sourceRow));
+    for (int i = 0; i < count; ++i) {
+        moved.at(i)->parent = destination;
+        destination->children.insert(destinationChild + i, moved.at(i));
+    }
+    endMoveRows();
+    return true;
+}
+
+bool QtTestTreeModel::insertColumns(int column, int count, const QModelIndex &parent)
+{
+    Item *parentItem = itemAt(parent);
+    beginInsertColumns(parent, column, column + count - 1);
+    for (int i = 0; i < count; ++i) {
+        const QString name = QLatin1Char('c') + QString::number(parentItem->nextColumn++);
+        parentItem->columns.insert(column + i, name);
+    }
+    endInsertColumns();
+    return true;
+}
+
+bool QtTestTreeModel::removeColumns(int column, int count, const QModelIndex &parent)
+{
+    Item *parentItem = itemAt(parent);
+    beginRemoveColumns(parent, column, column + count - 1);
+    parentItem->columns.remove(column, count);
+    endRemoveColumns();
+    return true;
+}
+
+// Reverses the rows below parent, like a sort would.
+void QtTestTreeModel::reverseRows(const QModelIndex &parent)
+{
+    const QList<QPersistentModelIndex> parents = { parent };
+    emit layoutAboutToBeChanged(parents, QAbstractItemModel::VerticalSortHint);
+    Item *parentItem = itemAt(parent);
+    std::reverse(parentItem->children.begin(), parentItem->children.end());
+    const int last = parentItem->children.count() - 1;
+    QModelIndexList from;
+    QModelIndexList to;
+    for (const QModelIndex &index : persistentIndexList()) {
+        if (index.internalPointer() == parentItem) {
+            from.append(index);
+            to.append(createIndex(last - index.row(), index.column(), parentItem));
+        }
+    }
+    changePersistentIndexList(from, to);
+    emit layoutChanged(parents, QAbstractItemModel::VerticalSortHint);
+}
+
+// Returns the current index of the named cell, or an invalid one if it was removed.
+QModelIndex QtTestTreeModel::find(const QString &name, const QString &column) const
+{
+    return find(&root, name, column);
+}
+
+QModelIndex QtTestTreeModel::find(const Item *parent, const QString &name,
+                                  const QString &column) const
+{
+    for (int row = 0; row < parent->children.count(); ++row) {
+        const Item *item = parent->children.at(row);
+        if (item->name == name) {
+            const int col = parent->columns.indexOf(column);
+            return col < 0 ? QModelIndex() : createIndex(row, col, const_cast<Item *>(parent));
+        }
+        const QModelIndex index = find(item, name, column);
+        if (index.isValid())
+            return index;
+    }
+    return QModelIndex();
+}
+
+QtTestTreeModel::Item *QtTestTreeModel::itemAt(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return const_cast<Item *>(&root);
+    return static_cast<Item *>(parent.internalPointer())->children.at(parent.row());
+}
+
+void tst_QAbstractItemModel::persistentIndexChangesOnDifferentLevels_data()
+{
+    QTest::addColumn<QString>("change");
+    QTest::addColumn<QList<int>>("ancestors");
+    QTest::addColumn<int>("first");
+    QTest::addColumn<int>("count");
+    QTest::addColumn<QList<int>>("destinationAncestors");
+    QTest::addColumn<int>("destination");
+
+    // the model has ten top level rows, rows 2 and 5 have three and ten children
+    QTest::newRow("remove top level rows before the parents")
+            << "removeRows" << QList<int>() << 0 << 2 << QList<int>() << 0;
+    QTest::newRow("remove top level rows after the parents")
+            << "removeRows" << QList<int>() << 7 << 2 << QList<int>() << 0;
+    QTest::newRow("remove a parent")
+            << "removeRows" << QList<int>() << 5 << 1 << QList<int>() << 0;
+    QTest::newRow("remove nested rows")
+            << "removeRows" << QList<int>{5} << 3 << 4 << QList<int>() << 0;
+    QTest::newRow("move top level rows down across the parents")
+            << "moveRows" << QList<int>() << 0 << 3 << QList<int>() << 8;
+    QTest::newRow("move top level rows up across the parents")
+            << "moveRows" << QList<int>() << 7 << 2 << QList<int>() << 1;
+    QTest::newRow("move nested rows")
+            << "moveRows" << QList<int>{5} << 0 << 3 << QList<int>{5} << 7;
+    QTest::newRow("move nested rows to another parent")
+            << "moveRows" << QList<int>{5} << 1 << 2 << QList<int>{2} << 3;
+    QTest::newRow("move nested rows to the top level")
+            << "moveRows" << QList<int>{5} << 2 << 2 << QList<int>() << 1;
+    QTest::newRow("move top level rows into a parent")
+            << "moveRows" << QList<int>() << 8 << 2 << QList<int>{5} << 0;
+    QTest::newRow("insert top level columns")
+            << "insertColumns" << QList<int>() << 1 << 2 << QList<int>() << 0;
+    QTest::newRow("remove top level columns")
+            << "removeColumns" << QList<int>() << 1 << 2 << QList<int>() << 0;
+    QTest::newRow("insert nested columns")
+            << "insertColumns" << QList<int>{5} << 0 << 1 << QList<int>() << 0;
+    QTest::newRow("remove nested columns")
+            << "removeColumns" << QList<int>{5} << 2 << 2 << QList<int>() << 0;
+    QTest::newRow("change top level persistent indexes")
+            << "reverseRows" << QList<int>() << 0 << 0 << QList<int>() << 0;
+    QTest::newRow("change nested persistent indexes")
+            << "reverseRows" << QList<int>{5} << 0 << 0 << QList<int>() << 0;
+}
+
+void tst_QAbstractItemModel::persistentIndexChangesOnDifferentLevels()
+{
+    QFETCH(QString, change);
+    QFETCH(QList<int>, ancestors);
+    QFETCH(int, first);
+    QFETCH(int, count);
+    QFETCH(QList<int>, destinationAncestors);
+    QFETCH(int, destination);
+
+    QtTestTreeModel model;
+    model.insertColumns(0, 4);
+    model.insertRows(0, 10);
+    for (int row : {2, 5}) {
+        const QModelIndex parent = model.index(row, 0);
+        model.insertColumns(0, 4, parent);
+        model.insertRows(0, row == 2 ? 3 : 10, parent);
+    }
+
+    QList<QPersistentModelIndex> persistent;
+    QStringList cells;
+    const auto addPersistent = [&](const QModelIndex &parent) {
+        for (int row = 0; row < model.rowCount(parent); ++row) {
+            for (int column = 0; column < model.columnCount(parent); ++column) {
+                persistent.append(model.index(row, column, parent));
+                cells.append(persistent.last().data().toString());
+            }
+        }
+    };
+    addPersistent(QModelIndex());
+    addPersistent(model.index(2, 0));
+    addPersistent(model.index(5, 0));
+
+    const auto findParent = [&](const QList<int> &rows) {
+        QModelIndex parent;
+        for (int row : rows)
+            parent = model.index(row, 0, parent);
+        return parent;
+    };
+    const QModelIndex parent = findParent(ancestors);
+    if (change == QLatin1String("removeRows")) {
+        QVERIFY(model.removeRows(first, count, parent));
+    } else if (change == QLatin1String("moveRows")) {
+        QVERIFY(model.moveRows(parent, first, count, findParent(destinationAncestors),
+                               destination));
+    } else if (change == QLatin1String("insertColumns")) {
+        QVERIFY(model.insertColumns(first, count, parent));
+    } else if (change == QLatin1String("removeColumns")) {
+        QVERIFY(model.removeColumns(first, count, parent));
+    } else {
+        model.reverseRows(parent);
+    }
+
+    for (int i = 0; i < persistent.count(); ++i) {
+        const QStringList cell = cells.at(i).split(QLatin1Char('/'));
+        const QModelIndex expected = model.find(cell.at(0), cell.at(1));
+        const QPersistentModelIndex &index = persistent.at(i);
+        QCOMPARE(index.isValid(), expected.isValid());
+        QCOMPARE(index.row(), expected.row());
+        QCOMPARE(index.column(), expected.column());
+        QCOMPARE(index.parent(), expected.parent());
+        if (expected.isValid())
+            QCOMPARE(index.data().toString(), cells.at(i));
+    }
+}
+
 void tst_QAbstractItemModel::testMoveSameParentDown_data()
 {
     QTest::addColumn<int>("startRow");
@@ -2525,5 +2888,76 @@ void tst_QAbstractItemModel::multiData()
     check();
 }
 
+// model implementing multiData(), but not rangeData(); check that the
+// default implementation of rangeData() fills the span item by item
+class MultiDataTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    int rowCount(const QModelIndex &) const override { return 10; }
+    int columnCount(const QModelIndex &) const override { return 5; }
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        QModelRoleData roleData(role);
+        multiData(index, roleData);
+        return roleData.data();
+    }
+
+    void multiData(const QModelIndex &index, QModelRoleDataSpan roleDataSpan) const override
+    {
+        Q_ASSERT(checkIndex(index, CheckIndexOption::IndexIsValid));
+        ++multiDataCalls;
+        for (QModelRoleData &roleData : roleDataSpan) {
+            if (roleData.role() == Qt::DisplayRole)
+                roleData.setData(QStringLiteral("%1,%2").arg(index.row()).arg(index.column()));
+            else if (roleData.role() == Qt::UserRole)
+                roleData.setData(index.row() * 10 + index.column());
+            else
+                roleData.clearData();
+        }
+    }
+
+    mutable int multiDataCalls = 0;
+};
+
+void tst_QAbstractItemModel::rangeData()
+{
+    MultiDataTableModel model;
+
+    std::vector<QModelRoleData> roleData;
+    for (int item = 0; item < 3 * 2; ++item) {
+        roleData.emplace_back(Qt::DisplayRole);
+        roleData.emplace_back(Qt::UserRole);
+        roleData.emplace_back(Qt::ToolTipRole);
+    }
+    roleData[2].setData(QStringLiteral("stale"));
+
+    model.rangeData(model.index(4, 1), model.index(6, 2), roleData);
+    QCOMPARE(model.multiDataCalls, 6);
+
+    auto it = roleData.cbegin();
+    for (int row = 4; row <= 6; ++row) {
+        for (int column = 1; column <= 2; ++column) {
+            QCOMPARE(it->role(), Qt::DisplayRole);
+            QCOMPARE(it->data().toString(), QStringLiteral("%1,%2").arg(row).arg(column));
+            ++it;
+            QCOMPARE(it->role(), Qt::UserRole);
+            QCOMPARE(it->data().toInt(), row * 10 + column);
+            ++it;
+            QCOMPARE(it->role(), Qt::ToolTipRole);
+            QVERIFY(it->data().isNull());
+            ++it;
+        }
+    }
+    QCOMPARE(it, roleData.cend());
+
+    // a single item
+    QModelRoleData single(Qt::UserRole);
+    model.rangeData(model.index(9, 4), model.index(9, 4), single);
+    QCOMPARE(single.data().toInt(), 94);
+}
+
 QTEST_MAIN(tst_QAbstractItemModel)
 #include "tst_qabstractitemmodel.moc"
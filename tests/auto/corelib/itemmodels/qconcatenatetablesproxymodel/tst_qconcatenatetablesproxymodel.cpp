@@ -49,6 +49,8 @@
 
 #include <qconcatenatetablesproxymodel.h>
 
+#include <vector>
+
 Q_DECLARE_METATYPE(QModelIndex)
 
 // Extracts a full row from a model as a string
@@ -102,6 +104,8 @@ private Q_SLOTS:
     void shouldHandleDataChanged();
     void shouldHandleSetData();
     void shouldHandleSetItemData();
+    void shouldForwardRangeData();
+    void shouldUseDataOfSubclass();
     void shouldHandleRowInsertionAndRemoval();
     void shouldAggregateAnotherModelThenRemoveModels();
     void shouldUseSmallestColumnCount();
@@ -305,6 +309,76 @@ void tst_QConcatenateTablesProxyModel::shouldHandleSetItemData()
     QCOMPARE(pm.index(1, 2).data(Qt::UserRole).toInt(), 89);
 }
 
+void tst_QConcatenateTablesProxyModel::shouldForwardRangeData()
+{
+    // Given a combining proxy with an empty model between two others
+    QConcatenateTablesProxyModel pm;
+    QStandardItemModel empty(0, 3);
+    pm.addSourceModel(&mod);
+    pm.addSourceModel(&empty);
+    pm.addSourceModel(&mod3);
+    pm.addSourceModel(&mod2);
+    QCOMPARE(pm.rowCount(), 4);
+
+    // When asking for the data of one item
+    QModelRoleData roleData[] = { QModelRoleData(Qt::DisplayRole), QModelRoleData(Qt::UserRole) };
+    pm.multiData(pm.index(3, 1), roleData);
+
+    // Then the source model should provide it
+    QCOMPARE(roleData[0].data().toString(), QStringLiteral("E"));
+    QVERIFY(roleData[1].data().isNull());
+
+    // When enabling forwarding and asking for the data of a range spanning
+    // multiple source models
+    QVERIFY(!pm.isRangeDataForwardingEnabled());
+    QSignalSpy spy(&pm, &QConcatenateTablesProxyModel::rangeDataForwardingEnabledChanged);
+    pm.setRangeDataForwardingEnabled(true);
+    QCOMPARE(spy.count(), 1);
+    std::vector<QModelRoleData> rangeData(3 * 2, QModelRoleData(Qt::DisplayRole));
+    pm.rangeData(pm.index(1, 1), pm.index(3, 2), rangeData);
+
+    // Then all the items should be filled in, row by row
+    QString texts;
+    for (const QModelRoleData &item : rangeData)
+        texts += item.data().toString();
+    QCOMPARE(texts, QStringLiteral("2356EF"));
+}
+
+class LowerCaseConcatenateTablesProxyModel : public QConcatenateTablesProxyModel
+{
+public:
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        const QVariant value = QConcatenateTablesProxyModel::data(index, role);
+        return role == Qt::DisplayRole ? QVariant(value.toString().toLower()) : value;
+    }
+};
+
+void tst_QConcatenateTablesProxyModel::shouldUseDataOfSubclass()
+{
+    // Given a subclass of the combining proxy that reimplements data()
+    LowerCaseConcatenateTablesProxyModel pm;
+    pm.addSourceModel(&mod);
+    pm.addSourceModel(&mod2);
+
+    // When asking for the data of one item
+    QModelRoleData roleData(Qt::DisplayRole);
+    pm.multiData(pm.index(1, 1), roleData);
+
+    // Then the data should come from the subclass
+    QCOMPARE(roleData.data().toString(), QStringLiteral("e"));
+
+    // When asking for the data of a range
+    std::vector<QModelRoleData> rangeData(2 * 2, QModelRoleData(Qt::DisplayRole));
+    pm.rangeData(pm.index(0, 0), pm.index(1, 1), rangeData);
+
+    // Then the data should come from the subclass as well
+    QString texts;
+    for (const QModelRoleData &item : rangeData)
+        texts += item.data().toString();
+    QCOMPARE(texts, QStringLiteral("abde"));
+}
+
 void tst_QConcatenateTablesProxyModel::shouldHandleRowInsertionAndRemoval()
 {
     // Given two models combined
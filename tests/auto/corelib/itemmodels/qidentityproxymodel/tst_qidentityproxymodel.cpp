@@ -38,6 +38,8 @@
 #include "dynamictreemodel.h"
 #include "qidentityproxymodel.h"
 
+#include <array>
+
 Q_LOGGING_CATEGORY(lcItemModels, "qt.corelib.tests.itemmodels")
 
 class DataChangedModel : public QAbstractListModel
@@ -75,6 +77,7 @@ private slots:
     void dataChanged();
 
     void itemData();
+    void rangeData();
 
     void persistIndexOnLayoutChange();
 
@@ -420,6 +423,58 @@ void tst_QIdentityProxyModel::itemData()
     QCOMPARE(proxy.itemData(topIndex).value(Qt::DisplayRole).toString(), QStringLiteral("Monday_appended"));
 }
 
+class RangeDataStringListModel : public QStringListModel
+{
+public:
+    using QStringListModel::QStringListModel;
+
+    void rangeData(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                   QModelRoleDataSpan roleDataSpan) const override
+    {
+        ++rangeDataCalls;
+        QStringListModel::rangeData(topLeft, bottomRight, roleDataSpan);
+    }
+
+    mutable int rangeDataCalls = 0;
+};
+
+void tst_QIdentityProxyModel::rangeData()
+{
+    RangeDataStringListModel model(QStringList() << "Monday" << "Tuesday" << "Wednesday");
+    QIdentityProxyModel proxy;
+    proxy.setSourceModel(&model);
+    QVERIFY(!proxy.isRangeDataForwardingEnabled());
+    QSignalSpy spy(&proxy, &QAbstractProxyModel::rangeDataForwardingEnabledChanged);
+    proxy.setRangeDataForwardingEnabled(true);
+    QCOMPARE(spy.count(), 1);
+    proxy.setRangeDataForwardingEnabled(true);
+    QCOMPARE(spy.count(), 1);
+
+    std::array<QModelRoleData, 4> roleData = { {
+        QModelRoleData(Qt::DisplayRole),
+        QModelRoleData(Qt::UserRole),
+        QModelRoleData(Qt::DisplayRole),
+        QModelRoleData(Qt::UserRole)
+    } };
+
+    // forwarded to the source model in one go
+    proxy.rangeData(proxy.index(1, 0), proxy.index(2, 0), roleData);
+    QCOMPARE(model.rangeDataCalls, 1);
+    QCOMPARE(roleData[0].data().toString(), QStringLiteral("Tuesday"));
+    QVERIFY(roleData[1].data().isNull());
+    QCOMPARE(roleData[2].data().toString(), QStringLiteral("Wednesday"));
+    QVERIFY(roleData[3].data().isNull());
+
+    // without forwarding, a proxy transforming data() goes through data()
+    // for every item
+    AppendStringProxy appendProxy;
+    appendProxy.setSourceModel(&model);
+    appendProxy.rangeData(appendProxy.index(0, 0), appendProxy.index(1, 0), roleData);
+    QCOMPARE(model.rangeDataCalls, 1);
+    QCOMPARE(roleData[0].data().toString(), QStringLiteral("Monday_appended"));
+    QCOMPARE(roleData[2].data().toString(), QStringLiteral("Tuesday_appended"));
+}
+
 void dump(QAbstractItemModel* model, QString const& indent = " - ", QModelIndex const& parent = {})
 {
     for (auto row = 0; row < model->rowCount(parent); ++row)
@@ -89,6 +89,7 @@ private slots:
     void testValidRangesInSelectionsAfterReset();
     void testChainedSelectionClear();
     void testClearCurrentIndex();
+    void fragmentedSelection();
 
     void QTBUG48402_data();
     void QTBUG48402();
@@ -2639,6 +2640,57 @@ void tst_QItemSelectionModel::testClearCurrentIndex()
     QCOMPARE(currentIndexSpy.size(), 2);
 }
 
+void tst_QItemSelectionModel::fragmentedSelection()
+{
+    QStandardItemModel model(50, 5);
+    QItemSelectionModel selectionModel(&model);
+    selectionModel.select(QItemSelection(model.index(0, 0), model.index(49, 4)),
+                          QItemSelectionModel::Select);
+
+    auto verify = [&](auto isExpected) {
+        for (int row = 0; row < model.rowCount(); ++row) {
+            for (int column = 0; column < model.columnCount(); ++column) {
+                if (selectionModel.isSelected(model.index(row, column)) != isExpected(row, column))
+                    return false;
+            }
+        }
+        return true;
+    };
+
+    // ctrl-click every cell in the middle column
+    for (int row = 0; row < 50; ++row)
+        selectionModel.select(model.index(row, 2), QItemSelectionModel::Toggle);
+    QVERIFY(verify([](int, int column) { return column != 2; }));
+
+    // once committed, the cells left and right of the column are combined
+    selectionModel.select(QItemSelection(), QItemSelectionModel::Select);
+    QCOMPARE(selectionModel.selection().count(), 2);
+
+    // deselect every other row in one go
+    QItemSelection rows;
+    for (int row = 0; row < 50; row += 2)
+        rows.append(QItemSelectionRange(model.index(row, 0), model.index(row, 4)));
+    selectionModel.select(rows, QItemSelectionModel::Deselect);
+    QVERIFY(verify([](int row, int column) { return row % 2 && column != 2; }));
+
+    // rows inserted into the selection are not selected
+    model.insertRows(10, 5);
+    QVERIFY(verify([](int row, int column) {
+        return (row < 10 || row >= 15) && (row < 10 ? row : row - 5) % 2 && column != 2;
+    }));
+    model.removeRows(10, 5);
+
+    // selecting everything that was deselected joins the selection back together
+    selectionModel.select(rows, QItemSelectionModel::Select);
+    for (int row = 0; row < 50; ++row)
+        selectionModel.select(model.index(row, 2), QItemSelectionModel::Select);
+    selectionModel.select(QItemSelection(), QItemSelectionModel::Select);
+    QVERIFY(verify([](int, int) { return true; }));
+    QCOMPARE(selectionModel.selection().count(), 1);
+    QCOMPARE(selectionModel.selection().constFirst(),
+             QItemSelectionRange(model.index(0, 0), model.index(49, 4)));
+}
+
 void tst_QItemSelectionModel::QTBUG48402_data()
 {
     QTest::addColumn<int>("rows");
@@ -38,6 +38,8 @@
 #include <QTreeView>
 #include <QtTest>
 
+#include <vector>
+
 Q_LOGGING_CATEGORY(lcItemModels, "qt.corelib.tests.itemmodels")
 
 using IntPair = QPair<int, int>;
@@ -5093,4 +5095,400 @@ void tst_QSortFilterProxyModel::invalidateColumnsOrRowsFilter()
     QCOMPARE(proxy.rowFiltered, 20);
 }
 
+namespace SortKeyCaching {
+class VariantListModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    VariantListModel(const QVariantList &values, QObject *parent = nullptr)
+        : QAbstractListModel(parent), m_values(values)
+    {
+    }
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_values.count();
+    }
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
+    {
+        if (role != Qt::DisplayRole || !index.isValid())
+            return QVariant();
+        return m_values.at(index.row());
+    }
+    QVariantList m_values;
+};
+
+static QList<int> sourceRows(const QSortFilterProxyModel &proxy)
+{
+    QList<int> rows;
+    for (int row = 0; row < proxy.rowCount(); ++row)
+        rows.append(proxy.mapToSource(proxy.index(row, 0)).row());
+    return rows;
+}
+}
+
+void tst_QSortFilterProxyModel::sortKeyCaching_data()
+{
+    QTest::addColumn<QVariantList>("values");
+    QTest::addColumn<Qt::CaseSensitivity>("caseSensitivity");
+    QTest::addColumn<bool>("localeAware");
+
+    const QVariantList strings = { QString("delta"), QString("Alpha"), QString(), QString("alpha"),
+                                   QString("charlie"), QString("Bravo"), QString("delta"),
+                                   QString("écho"), QString("echo"), QString() };
+    QTest::newRow("strings") << strings << Qt::CaseSensitive << false;
+    QTest::newRow("strings, case insensitive") << strings << Qt::CaseInsensitive << false;
+    QTest::newRow("strings, locale aware") << strings << Qt::CaseSensitive << true;
+    QTest::newRow("ints") << QVariantList{ 3, -1, 7, 3, 0, -1, INT_MAX, INT_MIN, 7 }
+                          << Qt::CaseSensitive << false;
+    QTest::newRow("doubles") << QVariantList{ 2.5, -0.5, 1e10, 2.5, 0.0, -1e-10 }
+                             << Qt::CaseSensitive << false;
+    QTest::newRow("dates") << QVariantList{ QDate(2020, 5, 1), QDate(1999, 12, 31), QDate(2020, 5, 1),
+                                            QDate(), QDate(2001, 1, 1) }
+                           << Qt::CaseSensitive << false;
+    QTest::newRow("invalid values") << QVariantList{ 5, QVariant(), 2, QVariant(), 9, 2 }
+                                    << Qt::CaseSensitive << false;
+    QTest::newRow("int and double") << QVariantList{ 2, 1.5, 3, 0.5, 2.0, -1 }
+                                    << Qt::CaseSensitive << false;
+    QTest::newRow("int and string") << QVariantList{ 10, QString("9"), 2, QString("10"), QVariant(), 1 }
+                                    << Qt::CaseInsensitive << false;
+}
+
+void tst_QSortFilterProxyModel::sortKeyCaching()
+{
+    using namespace SortKeyCaching;
+    QFETCH(QVariantList, values);
+    QFETCH(Qt::CaseSensitivity, caseSensitivity);
+    QFETCH(bool, localeAware);
+
+    VariantListModel model(values);
+    QSortFilterProxyModel expected;
+    expected.setSourceModel(&model);
+    expected.setSortCaseSensitivity(caseSensitivity);
+    expected.setSortLocaleAware(localeAware);
+
+    QSortFilterProxyModel proxy;
+    QSignalSpy spy(&proxy, &QSortFilterProxyModel::sortKeyCachingEnabledChanged);
+    proxy.setSortKeyCachingEnabled(true);
+    QVERIFY(proxy.isSortKeyCachingEnabled());
+    QCOMPARE(spy.count(), 1);
+    proxy.setSourceModel(&model);
+    proxy.setSortCaseSensitivity(caseSensitivity);
+    proxy.setSortLocaleAware(localeAware);
+
+    for (Qt::SortOrder order : { Qt::AscendingOrder, Qt::DescendingOrder }) {
+        expected.sort(0, order);
+        proxy.sort(0, order);
+        QCOMPARE(sourceRows(proxy), sourceRows(expected));
+    }
+}
+
+void tst_QSortFilterProxyModel::concurrentSortFilter_data()
+{
+    QTest::addColumn<bool>("sortKeyCaching");
+    QTest::addColumn<bool>("numbers");
+
+    QTest::newRow("strings") << false << false;
+    QTest::newRow("strings, sort key caching") << true << false;
+    QTest::newRow("numbers") << false << true;
+    QTest::newRow("numbers, sort key caching") << true << true;
+}
+
+void tst_QSortFilterProxyModel::concurrentSortFilter()
+{
+    using namespace SortKeyCaching;
+    QFETCH(bool, sortKeyCaching);
+    QFETCH(bool, numbers);
+
+    // large enough to be split into several chunks
+    const int rowCount = 50000;
+    QVariantList values;
+    values.reserve(rowCount);
+    for (int i = 0; i < rowCount; ++i) {
+        const int key = (i * 7919) % 10007;
+        if (numbers)
+            values.append(key);
+        else
+            values.append(QString::number(key));
+    }
+    VariantListModel model(values);
+
+    QSortFilterProxyModel expected;
+    expected.setSourceModel(&model);
+    QSortFilterProxyModel proxy;
+    QSignalSpy spy(&proxy, &QSortFilterProxyModel::concurrentSortFilterEnabledChanged);
+    proxy.setConcurrentSortFilterEnabled(true);
+    QVERIFY(proxy.isConcurrentSortFilterEnabled());
+    QCOMPARE(spy.count(), 1);
+    proxy.setSortKeyCachingEnabled(sortKeyCaching);
+    proxy.setSourceModel(&model);
+
+    for (QSortFilterProxyModel *p : { &expected, &proxy }) {
+        p->setFilterRegularExpression(QStringLiteral("[13]"));
+        p->sort(0, Qt::DescendingOrder);
+    }
+    QVERIFY(proxy.rowCount() > 0);
+    QVERIFY(proxy.rowCount() < rowCount);
+    QCOMPARE(sourceRows(proxy), sourceRows(expected));
+
+    for (QSortFilterProxyModel *p : { &expected, &proxy })
+        p->setFilterRegularExpression(QStringLiteral("[135]"));
+    QCOMPARE(sourceRows(proxy), sourceRows(expected));
+
+    for (QSortFilterProxyModel *p : { &expected, &proxy })
+        p->sort(0, Qt::AscendingOrder);
+    QCOMPARE(sourceRows(proxy), sourceRows(expected));
+}
+
+namespace FilterChangeHint {
+class CountingProxyModel : public QSortFilterProxyModel
+{
+public:
+    using QSortFilterProxyModel::invalidateRowsFilter;
+
+    bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const override
+    {
+        ++filteredRows;
+        if (minimum < 0)
+            return QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
+        return sourceModel()->index(source_row, 0, source_parent).data().toInt() >= minimum;
+    }
+
+    mutable int filteredRows = 0;
+    int minimum = -1;
+};
+
+static QStringList proxyStrings(const QAbstractItemModel &proxy)
+{
+    QStringList strings;
+    for (int row = 0; row < proxy.rowCount(); ++row)
+        strings.append(proxy.index(row, 0).data().toString());
+    return strings;
+}
+}
+
+void tst_QSortFilterProxyModel::filterChangeHint_data()
+{
+    QTest::addColumn<QStringList>("initial");
+    QTest::addColumn<QString>("filter");
+    QTest::addColumn<QString>("narrowedFilter");
+
+    QTest::newRow("strings") << QStringList{ "abc", "bcd", "abd", "xyz", "ab", "cab", "a" }
+                             << "a" << "ab";
+    QTest::newRow("nothing left") << QStringList{ "abc", "bcd", "abd" } << "b" << "bx";
+    QTest::newRow("empty filter") << QStringList{ "abc", "bcd", "abd" } << "" << "bc";
+}
+
+void tst_QSortFilterProxyModel::filterChangeHint()
+{
+    using namespace FilterChangeHint;
+    using FilterChange = QSortFilterProxyModel::FilterChange;
+    QFETCH(QStringList, initial);
+    QFETCH(QString, filter);
+    QFETCH(QString, narrowedFilter);
+
+    QStringListModel model(initial);
+    QSortFilterProxyModel expected;
+    expected.setSourceModel(&model);
+    expected.sort(0);
+    CountingProxyModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.sort(0);
+
+    expected.setFilterRegularExpression(QRegularExpression(filter));
+    proxy.setFilterRegularExpression(QRegularExpression(filter));
+    QCOMPARE(proxyStrings(proxy), proxyStrings(expected));
+    const int acceptedCount = proxy.rowCount();
+
+    proxy.filteredRows = 0;
+    expected.setFilterRegularExpression(QRegularExpression(narrowedFilter));
+    proxy.setFilterRegularExpression(QRegularExpression(narrowedFilter), FilterChange::Narrowing);
+    QCOMPARE(proxy.filteredRows, acceptedCount);
+    QCOMPARE(proxyStrings(proxy), proxyStrings(expected));
+    const int narrowedCount = proxy.rowCount();
+
+    proxy.filteredRows = 0;
+    expected.setFilterRegularExpression(QRegularExpression(filter));
+    proxy.setFilterRegularExpression(QRegularExpression(filter), FilterChange::Widening);
+    QCOMPARE(proxy.filteredRows, initial.count() - narrowedCount);
+    QCOMPARE(proxyStrings(proxy), proxyStrings(expected));
+
+    // a custom filter declaring its own changes
+    model.setStringList({ "5", "1", "9", "3", "7", "2" });
+    proxy.setFilterRegularExpression(QString());
+    proxy.minimum = 3;
+    proxy.invalidateRowsFilter();
+    QCOMPARE(proxyStrings(proxy), QStringList({ "3", "5", "7", "9" }));
+
+    proxy.filteredRows = 0;
+    proxy.minimum = 6;
+    proxy.invalidateRowsFilter(FilterChange::Narrowing);
+    QCOMPARE(proxy.filteredRows, 4);
+    QCOMPARE(proxyStrings(proxy), QStringList({ "7", "9" }));
+
+    proxy.filteredRows = 0;
+    proxy.minimum = 2;
+    proxy.invalidateRowsFilter(FilterChange::Widening);
+    QCOMPARE(proxy.filteredRows, 4);
+    QCOMPARE(proxyStrings(proxy), QStringList({ "2", "3", "5", "7", "9" }));
+}
+
+void tst_QSortFilterProxyModel::filterTimeSlice()
+{
+    using namespace FilterChangeHint;
+    using FilterChange = QSortFilterProxyModel::FilterChange;
+
+    QStringList strings;
+    for (int i = 0; i < 20000; ++i)
+        strings.append(QString::number(i));
+    QStringListModel model(strings);
+    QSortFilterProxyModel expected;
+    expected.setSourceModel(&model);
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    QSignalSpy spy(&proxy, &QSortFilterProxyModel::filterTimeSliceChanged);
+    proxy.setFilterTimeSlice(1);
+    QCOMPARE(proxy.filterTimeSlice(), 1);
+    QCOMPARE(spy.count(), 1);
+
+    // filtering happens from the event loop
+    QCOMPARE(proxy.rowCount(), model.rowCount());
+    expected.setFilterFixedString("1");
+    proxy.setFilterFixedString("1");
+    QCOMPARE(proxy.rowCount(), model.rowCount());
+    QTRY_COMPARE(proxy.rowCount(), expected.rowCount());
+    QCOMPARE(proxyStrings(proxy), proxyStrings(expected));
+
+    // changes queued while others are still pending
+    expected.setFilterFixedString("12");
+    proxy.setFilterRegularExpression(QRegularExpression("12"), FilterChange::Narrowing);
+    expected.setFilterFixedString("2");
+    proxy.setFilterRegularExpression(QRegularExpression("2"), FilterChange::Widening);
+    QTRY_COMPARE(proxy.rowCount(), expected.rowCount());
+    QCOMPARE(proxyStrings(proxy), proxyStrings(expected));
+
+    // pending rows are filtered before the source model changes
+    expected.setFilterFixedString("3");
+    proxy.setFilterFixedString("3");
+    QVERIFY(model.insertRows(0, 1));
+    QCOMPARE(proxyStrings(proxy), proxyStrings(expected));
+    QVERIFY(model.setData(model.index(0), QStringLiteral("33")));
+    QCOMPARE(proxyStrings(proxy), proxyStrings(expected));
+
+    // as well as when turning time slicing off
+    expected.setFilterFixedString("4");
+    proxy.setFilterFixedString("4");
+    proxy.setFilterTimeSlice(0);
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(proxyStrings(proxy), proxyStrings(expected));
+}
+
+class RangeDataTableModel : public QAbstractTableModel
+{
+public:
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    { return parent.isValid() ? 0 : 20; }
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override
+    { return parent.isValid() ? 0 : 4; }
+
+    QVariant data(const QModelIndex &index, int role) const override
+    {
+        if (role == Qt::DisplayRole) {
+            // column 0 is used for filtering, column 1 for sorting
+            if (index.column() == 0)
+                return QString::number(index.row() % 5);
+            if (index.column() == 1)
+                return index.row();
+            return QStringLiteral("%1,%2").arg(index.row()).arg(index.column());
+        }
+        if (role == Qt::UserRole)
+            return index.row() * 10 + index.column();
+        return QVariant();
+    }
+
+    void rangeData(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                   QModelRoleDataSpan roleDataSpan) const override
+    {
+        ++rangeDataCalls;
+        QAbstractTableModel::rangeData(topLeft, bottomRight, roleDataSpan);
+    }
+
+    mutable int rangeDataCalls = 0;
+};
+
+class ColumnFilterProxyModel : public QSortFilterProxyModel
+{
+public:
+    bool filterAcceptsColumn(int source_column, const QModelIndex &) const override
+    { return source_column != 1; }
+};
+
+static bool rangeDataMatchesData(const QAbstractItemModel &model)
+{
+    const int rows = model.rowCount();
+    const int columns = model.columnCount();
+    std::vector<QModelRoleData> roleData;
+    for (int item = 0; item < rows * columns; ++item) {
+        roleData.emplace_back(Qt::DisplayRole);
+        roleData.emplace_back(Qt::UserRole);
+    }
+    model.rangeData(model.index(0, 0), model.index(rows - 1, columns - 1), roleData);
+
+    auto it = roleData.cbegin();
+    for (int row = 0; row < rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            for (int role = 0; role < 2; ++role, ++it) {
+                if (it->data() != model.index(row, column).data(it->role()))
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+void tst_QSortFilterProxyModel::rangeData()
+{
+    RangeDataTableModel model;
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+
+    // without forwarding, the data is fetched through data()
+    QVERIFY(rangeDataMatchesData(proxy));
+    QCOMPARE(model.rangeDataCalls, 0);
+    proxy.setRangeDataForwardingEnabled(true);
+
+    // all rows are adjacent in the source model
+    QVERIFY(rangeDataMatchesData(proxy));
+    QCOMPARE(model.rangeDataCalls, 1);
+
+    // filtering out rows 2, 7, 12 and 17 leaves five runs of adjacent rows
+    model.rangeDataCalls = 0;
+    proxy.setFilterRegularExpression(QRegularExpression("[^2]"));
+    QCOMPARE(proxy.rowCount(), 16);
+    QVERIFY(rangeDataMatchesData(proxy));
+    QCOMPARE(model.rangeDataCalls, 5);
+
+    // a part of the proxy, from the second to the fourth run
+    model.rangeDataCalls = 0;
+    std::vector<QModelRoleData> roleData(2 * 8, QModelRoleData(Qt::UserRole));
+    proxy.rangeData(proxy.index(3, 1), proxy.index(10, 2), roleData);
+    QCOMPARE(model.rangeDataCalls, 3);
+    QCOMPARE(roleData.front().data().toInt(), 41);
+    QCOMPARE(roleData.back().data().toInt(), 132);
+
+    // sorting in reverse order makes every row a run of its own
+    model.rangeDataCalls = 0;
+    proxy.sort(1, Qt::DescendingOrder);
+    QVERIFY(rangeDataMatchesData(proxy));
+    QCOMPARE(model.rangeDataCalls, 16);
+
+    // filtering out a column splits every row in two
+    ColumnFilterProxyModel columnProxy;
+    columnProxy.setSourceModel(&model);
+    columnProxy.setRangeDataForwardingEnabled(true);
+    QCOMPARE(columnProxy.columnCount(), 3);
+    model.rangeDataCalls = 0;
+    QVERIFY(rangeDataMatchesData(columnProxy));
+    QCOMPARE(model.rangeDataCalls, 2 * 20);
+}
+
 #include "tst_qsortfilterproxymodel.moc"
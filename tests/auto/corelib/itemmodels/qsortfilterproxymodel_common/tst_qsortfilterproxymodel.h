@@ -162,6 +162,15 @@ private slots:
     void checkFilteredIndexes();
     void invalidateColumnsOrRowsFilter();
 
+    void sortKeyCaching_data();
+    void sortKeyCaching();
+    void concurrentSortFilter_data();
+    void concurrentSortFilter();
+    void filterChangeHint_data();
+    void filterChangeHint();
+    void filterTimeSlice();
+    void rangeData();
+
 protected:
     void buildHierarchy(const QStringList &data, QAbstractItemModel *model);
     void checkHierarchy(const QStringList &data, const QAbstractItemModel *model);
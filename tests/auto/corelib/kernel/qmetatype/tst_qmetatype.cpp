@@ -227,6 +227,9 @@ private slots:
     void constRefs();
     void convertCustomType_data();
     void convertCustomType();
+    void convertNumericTypes_data();
+    void convertNumericTypes();
+    void registerConverterAfterLookup();
     void compareCustomEqualOnlyType();
     void customDebugStream();
     void unknownType();
@@ -2548,6 +2551,67 @@ void tst_QMetaType::convertCustomType()
     QCOMPARE(v.value<CustomConvertibleType2>().m_foo, testCustom.m_foo);
 }
 
+void tst_QMetaType::convertNumericTypes_data()
+{
+    QTest::addColumn<QVariant>("source");
+    QTest::addColumn<QVariant>("expected");
+
+    QTest::newRow("int to double") << QVariant(-42) << QVariant(-42.0);
+    QTest::newRow("double to int") << QVariant(2.5) << QVariant(3);
+    QTest::newRow("negative double to int") << QVariant(-2.5) << QVariant(-3);
+    QTest::newRow("float to qlonglong") << QVariant(1.6f) << QVariant(qlonglong(2));
+    QTest::newRow("double to bool") << QVariant(0.4) << QVariant(false);
+    QTest::newRow("int to bool") << QVariant(42) << QVariant(true);
+    QTest::newRow("bool to double") << QVariant(true) << QVariant(1.0);
+    QTest::newRow("double to float") << QVariant(0.5) << QVariant(0.5f);
+    QTest::newRow("int to uint") << QVariant(-1) << QVariant(UINT_MAX);
+    QTest::newRow("qulonglong to short") << QVariant(qulonglong(0x10001)) << QVariant::fromValue(short(1));
+    QTest::newRow("uchar to signed char") << QVariant::fromValue(uchar(0xff))
+                                          << QVariant::fromValue((signed char)(-1));
+    QTest::newRow("long to ulong") << QVariant::fromValue(42l) << QVariant::fromValue(42ul);
+}
+
+void tst_QMetaType::convertNumericTypes()
+{
+    QFETCH(QVariant, source);
+    QFETCH(QVariant, expected);
+
+    QVERIFY(QMetaType::canConvert(source.metaType(), expected.metaType()));
+    QVariant result(expected.metaType());
+    QVERIFY(QMetaType::convert(source.metaType(), source.constData(), expected.metaType(), result.data()));
+    QCOMPARE(result, expected);
+}
+
+struct LateConvertibleType
+{
+    int value;
+};
+
+struct LateConvertibleTarget
+{
+    int value;
+};
+
+void tst_QMetaType::registerConverterAfterLookup()
+{
+    const QMetaType from = QMetaType::fromType<LateConvertibleType>();
+    const QMetaType to = QMetaType::fromType<LateConvertibleTarget>();
+    const LateConvertibleType source{42};
+    LateConvertibleTarget target{0};
+
+    // a failed lookup must not be remembered past the registration
+    QVERIFY(!QMetaType::canConvert(from, to));
+    QVERIFY(!QMetaType::convert(from, &source, to, &target));
+    QVERIFY(!QMetaType::hasRegisteredConverterFunction(from, to));
+
+    QVERIFY((QMetaType::registerConverter<LateConvertibleType, LateConvertibleTarget>(
+            [](const LateConvertibleType &t) { return LateConvertibleTarget{t.value}; })));
+    QVERIFY(QMetaType::hasRegisteredConverterFunction(from, to));
+    QVERIFY(QMetaType::canConvert(from, to));
+    QVERIFY(QMetaType::convert(from, &source, to, &target));
+    QCOMPARE(target.value, 42);
+}
+
 void tst_QMetaType::compareCustomEqualOnlyType()
 {
     QMetaType type = QMetaType::fromType<CustomEqualsOnlyType>();
@@ -87,6 +87,12 @@ private slots:
 
     void modifyObserverListWhileIterating();
     void compatPropertyNoDobuleNotification();
+
+    void updateGroup();
+    void nestedUpdateGroups();
+    void deletePropertyInUpdateGroup();
+    void readBindingBeforeUpdateGroupNotification();
+    void bindingLoopInUpdateGroup();
 };
 
 void tst_QProperty::functorBinding()
@@ -1353,6 +1359,167 @@ void tst_QProperty::compatPropertyNoDobuleNotification()
     QCOMPARE(counter, 1);
 }
 
+void tst_QProperty::updateGroup()
+{
+    QProperty<int> a {1};
+    QProperty<int> b {2};
+    QProperty<int> c {3};
+    int sumEvaluations = 0;
+    QProperty<int> sum([&]() { ++sumEvaluations; return a + b + c; });
+    QProperty<int> doubled([&]() { return sum * 2; });
+    QCOMPARE(doubled.value(), 12);
+    QCOMPARE(sumEvaluations, 1);
+
+    int sumChanges = 0;
+    int doubledChanges = 0;
+    auto sumHandler = sum.onValueChanged([&]() { ++sumChanges; });
+    auto doubledHandler = doubled.onValueChanged([&]() {
+        ++doubledChanges;
+        QCOMPARE(doubled.value(), 2 * (a + b + c));
+    });
+
+    {
+        QScopedPropertyUpdateGroup group;
+        a = 10;
+        b = 20;
+        c = 30;
+        QCOMPARE(sumChanges, 0);
+        QCOMPARE(doubledChanges, 0);
+        QCOMPARE(sumEvaluations, 1);
+    }
+    QCOMPARE(sumChanges, 1);
+    QCOMPARE(doubledChanges, 1);
+    QCOMPARE(sumEvaluations, 2);
+    QCOMPARE(doubled.value(), 120);
+
+    // values that end up unchanged don't trigger handlers
+    Qt::beginPropertyUpdateGroup();
+    a = 11;
+    b = 19;
+    Qt::endPropertyUpdateGroup();
+    QCOMPARE(sumChanges, 1);
+    QCOMPARE(doubledChanges, 1);
+    QCOMPARE(sum.value(), 60);
+
+    // handlers of the written properties themselves are called once as well
+    int aChanges = 0;
+    auto aHandler = a.onValueChanged([&]() { ++aChanges; });
+    {
+        QScopedPropertyUpdateGroup group;
+        a = 1;
+        a = 2;
+        a = 3;
+    }
+    QCOMPARE(aChanges, 1);
+    QCOMPARE(sumChanges, 2);
+    QCOMPARE(sum.value(), 52);
+}
+
+void tst_QProperty::nestedUpdateGroups()
+{
+    QProperty<int> a {1};
+    QProperty<int> b {2};
+    QProperty<int> sum([&]() { return a + b; });
+    QCOMPARE(sum.value(), 3);
+    int sumChanges = 0;
+    auto handler = sum.onValueChanged([&]() { ++sumChanges; });
+
+    Qt::beginPropertyUpdateGroup();
+    a = 2;
+    {
+        QScopedPropertyUpdateGroup group;
+        b = 3;
+    }
+    QCOMPARE(sumChanges, 0);
+    Qt::endPropertyUpdateGroup();
+    QCOMPARE(sumChanges, 1);
+    QCOMPARE(sum.value(), 5);
+
+    // a change handler writing to properties inside a group of its own
+    QProperty<int> trigger;
+    auto triggerHandler = trigger.onValueChanged([&]() {
+        QScopedPropertyUpdateGroup group;
+        a = trigger.value();
+        b = trigger.value();
+    });
+    {
+        QScopedPropertyUpdateGroup group;
+        trigger = 10;
+    }
+    QCOMPARE(sumChanges, 2);
+    QCOMPARE(sum.value(), 20);
+}
+
+void tst_QProperty::deletePropertyInUpdateGroup()
+{
+    QProperty<int> a {1};
+    auto b = std::make_unique<QProperty<int>>(2);
+    int bChanges = 0;
+    auto bHandler = b->onValueChanged([&]() { ++bChanges; });
+    auto aHandler = a.onValueChanged([&]() { b.reset(); });
+
+    {
+        QScopedPropertyUpdateGroup group;
+        a = 10;
+        *b = 20;
+    } // should not crash
+    QVERIFY(!b);
+    QCOMPARE(bChanges, 0);
+
+    QProperty<int> c {3};
+    int cChanges = 0;
+    auto cHandler = c.onValueChanged([&]() { ++cChanges; });
+    {
+        QScopedPropertyUpdateGroup group;
+        auto d = std::make_unique<QProperty<int>>(4);
+        auto dHandler = d->onValueChanged([&]() { ++cChanges; });
+        *d = 40;
+        c = 30;
+    }
+    QCOMPARE(cChanges, 1);
+}
+
+void tst_QProperty::readBindingBeforeUpdateGroupNotification()
+{
+    // the handler of a reads sum before sum itself gets notified
+    QProperty<int> a {1};
+    QProperty<int> b {2};
+    QProperty<int> sum([&]() { return a + b; });
+    QCOMPARE(sum.value(), 3);
+    int sumSeenByA = 0;
+    auto aHandler = a.onValueChanged([&]() { sumSeenByA = sum; });
+    int sumChanges = 0;
+    auto sumHandler = sum.onValueChanged([&]() { ++sumChanges; });
+
+    {
+        QScopedPropertyUpdateGroup group;
+        a = 10;
+        b = 20;
+    }
+    QCOMPARE(sumSeenByA, 30);
+    QCOMPARE(sumChanges, 1);
+}
+
+void tst_QProperty::bindingLoopInUpdateGroup()
+{
+    QProperty<int> source {1};
+    QProperty<int> first;
+    QProperty<int> second;
+    first.setBinding([&]() { return source + second; });
+    second.setBinding([&]() { return first.value(); });
+    first.value();
+    int changes = 0;
+    auto handler = first.onValueChanged([&]() { ++changes; });
+
+    {
+        QScopedPropertyUpdateGroup group;
+        source = 2;
+    } // should not recurse endlessly
+    first.value();
+    second.value();
+    QCOMPARE(first.binding().error().type(), QPropertyBindingError::BindingLoop);
+}
+
 QTEST_MAIN(tst_QProperty);
 
 #include "tst_qproperty.moc"
@@ -264,6 +264,11 @@ void tst_QMimeDatabase::mimeTypeForFileName_data()
     QTest::newRow("glob that ends with *, also matches *.nfo. Higher weight wins.") << "README.nfo" << "text/x-nfo";
     // fdo bug 15436, needs shared-mime-info >= 0.40 (and this tests the globs2-parsing code).
     QTest::newRow("glob that ends with *, also matches *.pdf. *.pdf has higher weight") << "README.pdf" << "application/pdf";
+    QTest::newRow("glob that starts with a literal and ends with *") << "SConscript.foo" << "text/x-scons";
+    QTest::newRow("low-weight glob that ends with *") << "Makefile.foo" << "text/x-makefile";
+    QTest::newRow("glob with character classes, 1") << "123.vdr" << "video/mpeg";
+    QTest::newRow("glob with character classes, 2") << "foo.anim7" << "video/x-anim";
+    QTest::newRow("glob with character classes, no match") << "foo.anim0" << "application/octet-stream";
     QTest::newRow("directory") << "/" << "inode/directory";
     QTest::newRow("doesn't exist, no extension") << "IDontExist" << "application/octet-stream";
     QTest::newRow("doesn't exist but has known extension") << "IDontExist.txt" << "text/plain";
@@ -546,6 +551,9 @@ void tst_QMimeDatabase::mimeTypeForData_data()
     QTest::newRow("PDF magic") << QByteArray("%PDF-") << "application/pdf";
     QTest::newRow("PHP, High-priority rule") << QByteArray("<?php") << "application/x-php";
     QTest::newRow("diff\\t") << QByteArray("diff\t") << "text/x-patch";
+    QTest::newRow("PNG magic") << QByteArray("\x89PNG\r\n\x1a\n") << "image/png";
+    QTest::newRow("GIF magic") << QByteArray("GIF89a") << "image/gif";
+    QTest::newRow("tar, magic at offset 257") << QByteArray(257, '\0').append("ustar\0", 6) << "application/x-tar";
     QTest::newRow("unknown") << QByteArray("\001abc?}") << "application/octet-stream";
 }
 
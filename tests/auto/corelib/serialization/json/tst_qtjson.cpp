@@ -106,6 +106,7 @@ private Q_SLOTS:
     void fromJsonErrors();
     void parseNumbers();
     void parseStrings();
+    void parseStringsAtAllOffsets();
     void parseDuplicateKeys();
     void testParser();
 
@@ -2251,6 +2252,48 @@ void tst_QtJson::parseStrings()
 
 }
 
+void tst_QtJson::parseStringsAtAllOffsets()
+{
+    // The parser skips whitespace and plain ASCII in strings in blocks of 16
+    // or 32 bytes, so place the interesting characters at every offset
+    // across two blocks.
+    for (int i = 0; i < 70; ++i) {
+        const QByteArray prefix(i, 'a');
+        const QByteArray indent(i, ' ');
+
+        QByteArray json = "[" + indent + "\"" + prefix + "\\n" + prefix + "\"" + indent + "]";
+        QJsonDocument doc = QJsonDocument::fromJson(json);
+        QCOMPARE(doc.array().at(0).toString(), QString(prefix + '\n' + prefix));
+
+        json = "[\"" + prefix + UNICODE_DJE + prefix + "\"]";
+        doc = QJsonDocument::fromJson(json);
+        QCOMPARE(doc.array().at(0).toString(), QString::fromUtf8(prefix + UNICODE_DJE + prefix));
+
+        json = "{\"" + prefix + "\":\t\r\n" + indent + "\"\"}";
+        doc = QJsonDocument::fromJson(json);
+        QCOMPARE(doc.object().value(QString(prefix)).toString(), QString(""));
+
+        QJsonParseError error;
+        json = "[\"" + prefix + "\xff" + prefix + "\"]";
+        QJsonDocument::fromJson(json, &error);
+        QCOMPARE(error.error, QJsonParseError::IllegalUTF8String);
+        QCOMPARE(error.offset, i + 2);
+
+        json = "[\"" + prefix + "\\x" + prefix + "\\u00\"]";
+        QJsonDocument::fromJson(json, &error);
+        QCOMPARE(error.error, QJsonParseError::IllegalEscapeSequence);
+
+        json = "[\"" + prefix;
+        QJsonDocument::fromJson(json, &error);
+        QCOMPARE(error.error, QJsonParseError::UnterminatedString);
+
+        json = "[" + indent;
+        QJsonDocument::fromJson(json, &error);
+        QCOMPARE(error.error, QJsonParseError::UnterminatedArray);
+        QCOMPARE(error.offset, i + 1);
+    }
+}
+
 void tst_QtJson::parseDuplicateKeys()
 {
     const char *json = "{ \"B\": true, \"A\": null, \"B\": false }";
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qcborgadgetserializer
+QT = core testlib
+SOURCES = tst_qcborgadgetserializer.cpp
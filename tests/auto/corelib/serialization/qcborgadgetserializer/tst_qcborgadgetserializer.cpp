@@ -0,0 +1,359 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest>
+#include <QtCore/qcborarray.h>
+#include <QtCore/qcborgadgetserializer.h>
+#include <QtCore/qcborstreamreader.h>
+#include <QtCore/qcborstreamwriter.h>
+
+class Point
+{
+    Q_GADGET
+    Q_PROPERTY(int x MEMBER x)
+    Q_PROPERTY(int y MEMBER y)
+public:
+    int x = 0;
+    int y = 0;
+
+    friend bool operator==(const Point &a, const Point &b) { return a.x == b.x && a.y == b.y; }
+    friend bool operator!=(const Point &a, const Point &b) { return !(a == b); }
+};
+
+class Point3D : public Point
+{
+    Q_GADGET
+    Q_PROPERTY(int z MEMBER z)
+public:
+    int z = 0;
+};
+
+class Limits
+{
+    Q_GADGET
+    Q_PROPERTY(qint8 small MEMBER small)
+    Q_PROPERTY(quint16 port MEMBER port)
+public:
+    qint8 small = 0;
+    quint16 port = 0;
+};
+
+class Record
+{
+    Q_GADGET
+    Q_PROPERTY(bool enabled MEMBER enabled)
+    Q_PROPERTY(qint64 big MEMBER big)
+    Q_PROPERTY(quint64 ubig MEMBER ubig)
+    Q_PROPERTY(float ratio MEMBER ratio)
+    Q_PROPERTY(double value MEMBER value)
+    Q_PROPERTY(QString name READ name WRITE setName)
+    Q_PROPERTY(QByteArray payload MEMBER payload)
+    Q_PROPERTY(Color color MEMBER color)
+    Q_PROPERTY(Point origin MEMBER origin)
+    Q_PROPERTY(QStringList tags MEMBER tags)
+    Q_PROPERTY(QVariant extra MEMBER extra)
+    Q_PROPERTY(int computed READ computed STORED false)
+    Q_PROPERTY(int version READ version CONSTANT)
+public:
+    enum Color : quint8 { Red, Green, Blue };
+    Q_ENUM(Color)
+
+    QString name() const { return m_name; }
+    void setName(const QString &name) { m_name = name; ++nameChanges; }
+    int computed() const { return 42; }
+    int version() const { return m_version; }
+
+    bool enabled = false;
+    qint64 big = 0;
+    quint64 ubig = 0;
+    float ratio = 0;
+    double value = 0;
+    QByteArray payload;
+    Color color = Red;
+    Point origin;
+    QStringList tags;
+    QVariant extra;
+    QString m_name;
+    int m_version = 1;
+    int nameChanges = 0;
+};
+
+class tst_QCborGadgetSerializer : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void encoding();
+    void roundTrip();
+    void inheritance();
+    void shorterArray();
+    void longerArray();
+    void readOnlyProperties();
+    void integerLimits_data();
+    void integerLimits();
+    void errors_data();
+    void errors();
+    void stream();
+};
+
+static Record sampleRecord()
+{
+    Record r;
+    r.enabled = true;
+    r.big = std::numeric_limits<qint64>::min();
+    r.ubig = std::numeric_limits<quint64>::max();
+    r.ratio = 0.5f;
+    r.value = 1.25;
+    r.setName(QStringLiteral("sample"));
+    r.payload = QByteArray("\x00\x01\x02", 3);
+    r.color = Record::Blue;
+    r.origin.x = 10;
+    r.origin.y = -20;
+    r.tags = QStringList{ QStringLiteral("a"), QStringLiteral("b") };
+    r.extra = 7;
+    r.m_version = 2;
+    return r;
+}
+
+void tst_QCborGadgetSerializer::encoding()
+{
+    Point p;
+    p.x = 1;
+    p.y = -2;
+    QCOMPARE(QCborGadgetSerializer::toCbor(p), QByteArray("\x82\x01\x21"));
+
+    const QCborValue value = QCborValue::fromCbor(QCborGadgetSerializer::toCbor(sampleRecord()));
+    QVERIFY(value.isArray());
+    const QCborArray array = value.toArray();
+    // computed is not stored
+    QCOMPARE(array.size(), 12);
+    QCOMPARE(array.at(0), QCborValue(true));
+    QCOMPARE(array.at(1), QCborValue(std::numeric_limits<qint64>::min()));
+    QCOMPARE(array.at(2).toDouble(), 18446744073709551615.0);
+    QCOMPARE(array.at(3), QCborValue(0.5));
+    QCOMPARE(array.at(4), QCborValue(1.25));
+    QCOMPARE(array.at(5), QCborValue(QStringLiteral("sample")));
+    QCOMPARE(array.at(6), QCborValue(QByteArray("\x00\x01\x02", 3)));
+    QCOMPARE(array.at(7), QCborValue(int(Record::Blue)));
+    QCOMPARE(array.at(8), QCborValue(QCborArray{ 10, -20 }));
+    QCOMPARE(array.at(9), QCborValue(QCborArray{ QStringLiteral("a"), QStringLiteral("b") }));
+    QCOMPARE(array.at(10), QCborValue(7));
+    QCOMPARE(array.at(11), QCborValue(2));
+
+    // float properties keep their precision
+    QVERIFY(QCborGadgetSerializer::toCbor(sampleRecord()).contains(QByteArray("\xfa\x3f\x00\x00\x00", 5)));
+}
+
+void tst_QCborGadgetSerializer::roundTrip()
+{
+    const Record original = sampleRecord();
+    const QByteArray data = QCborGadgetSerializer::toCbor(original);
+
+    Record copy;
+    QCborParserError error;
+    QVERIFY(QCborGadgetSerializer::fromCbor(data, &copy, &error));
+    QCOMPARE(error.error, QCborError{QCborError::NoError});
+    QCOMPARE(error.offset, data.size());
+
+    QCOMPARE(copy.enabled, original.enabled);
+    QCOMPARE(copy.big, original.big);
+    QCOMPARE(copy.ubig, original.ubig);
+    QCOMPARE(copy.ratio, original.ratio);
+    QCOMPARE(copy.value, original.value);
+    QCOMPARE(copy.name(), original.name());
+    QCOMPARE(copy.nameChanges, 1);
+    QCOMPARE(copy.payload, original.payload);
+    QCOMPARE(copy.color, original.color);
+    QCOMPARE(copy.origin, original.origin);
+    QCOMPARE(copy.tags, original.tags);
+    QCOMPARE(copy.extra.toInt(), 7);
+
+    // version is not writable
+    QCOMPARE(copy.version(), 1);
+    copy.m_version = original.version();
+    QCOMPARE(QCborGadgetSerializer::toCbor(copy), data);
+}
+
+void tst_QCborGadgetSerializer::inheritance()
+{
+    Point3D p;
+    p.x = 1;
+    p.y = 2;
+    p.z = 3;
+    const QByteArray data = QCborGadgetSerializer::toCbor(p);
+    QCOMPARE(data, QByteArray("\x83\x01\x02\x03"));
+
+    Point3D copy;
+    QVERIFY(QCborGadgetSerializer::fromCbor(data, &copy));
+    QCOMPARE(copy.x, 1);
+    QCOMPARE(copy.y, 2);
+    QCOMPARE(copy.z, 3);
+
+    // the base class only reads its own properties
+    Point base;
+    QVERIFY(QCborGadgetSerializer::fromCbor(data, &base));
+    QCOMPARE(base.x, 1);
+    QCOMPARE(base.y, 2);
+}
+
+void tst_QCborGadgetSerializer::shorterArray()
+{
+    Point p;
+    p.x = 7;
+    p.y = 8;
+    QVERIFY(QCborGadgetSerializer::fromCbor(QByteArray("\x81\x05"), &p));
+    QCOMPARE(p.x, 5);
+    QCOMPARE(p.y, 8);
+
+    QVERIFY(QCborGadgetSerializer::fromCbor(QByteArray("\x9f\xff"), &p));
+    QCOMPARE(p.x, 5);
+
+    // nested gadgets keep their current values as well
+    Record r = sampleRecord();
+    QByteArray data("\x89\xf4\x00\x00\x00\x00\x60\x40\x00\x81\x01", 11);
+    QVERIFY(QCborGadgetSerializer::fromCbor(data, &r));
+    QCOMPARE(r.origin.x, 1);
+    QCOMPARE(r.origin.y, -20);
+    QCOMPARE(r.tags, sampleRecord().tags);
+}
+
+void tst_QCborGadgetSerializer::longerArray()
+{
+    Point p;
+    QCborParserError error;
+    const QByteArray data("\x84\x01\x02\x82\x03\x04\x61" "a");
+    QVERIFY(QCborGadgetSerializer::fromCbor(data, &p, &error));
+    QCOMPARE(error.offset, data.size());
+    QCOMPARE(p.x, 1);
+    QCOMPARE(p.y, 2);
+}
+
+void tst_QCborGadgetSerializer::readOnlyProperties()
+{
+    // the value of the constant property is skipped
+    Record r;
+    QByteArray data("\x8c\xf4\x00\x00\x00\x00\x60\x40\x00\x80\x80\xf6\x05", 13);
+    QVERIFY(QCborGadgetSerializer::fromCbor(data, &r));
+    QCOMPARE(r.version(), 1);
+    QVERIFY(r.tags.isEmpty());
+}
+
+void tst_QCborGadgetSerializer::integerLimits_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<bool>("valid");
+    QTest::addColumn<int>("small");
+    QTest::addColumn<int>("port");
+
+    QTest::newRow("zero") << QByteArray("\x82\x00\x00", 3) << true << 0 << 0;
+    QTest::newRow("max") << QByteArray("\x82\x18\x7f\x19\xff\xff") << true << 127 << 65535;
+    QTest::newRow("min") << QByteArray("\x82\x38\x7f\x00", 4) << true << -128 << 0;
+    QTest::newRow("small-too-large") << QByteArray("\x82\x18\x80\x00", 4) << false << 0 << 0;
+    QTest::newRow("small-too-small") << QByteArray("\x82\x38\x80\x00", 4) << false << 0 << 0;
+    QTest::newRow("port-too-large") << QByteArray("\x82\x00\x1a\x00\x01\x00\x00", 7)
+                                    << false << 0 << 0;
+    QTest::newRow("port-negative") << QByteArray("\x82\x00\x20", 3) << false << 0 << 0;
+}
+
+void tst_QCborGadgetSerializer::integerLimits()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(bool, valid);
+
+    Limits l;
+    QCborParserError error;
+    QCOMPARE(QCborGadgetSerializer::fromCbor(data, &l, &error), valid);
+    if (!valid) {
+        QCOMPARE(error.error, QCborError{QCborError::IllegalNumber});
+        return;
+    }
+
+    QFETCH(int, small);
+    QFETCH(int, port);
+    QCOMPARE(int(l.small), small);
+    QCOMPARE(int(l.port), port);
+    QCOMPARE(QCborGadgetSerializer::toCbor(l), data);
+}
+
+void tst_QCborGadgetSerializer::errors_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QCborError>("error");
+
+    QTest::newRow("empty") << QByteArray() << QCborError{QCborError::EndOfFile};
+    QTest::newRow("map") << QByteArray("\xa0") << QCborError{QCborError::IllegalType};
+    QTest::newRow("integer") << QByteArray("\x01") << QCborError{QCborError::IllegalType};
+    QTest::newRow("string-for-int") << QByteArray("\x82\x61" "a" "\x01")
+                                    << QCborError{QCborError::IllegalType};
+    QTest::newRow("double-for-int") << QByteArray("\x82\xf9\x3c\x00\x01", 5)
+                                    << QCborError{QCborError::IllegalType};
+    QTest::newRow("truncated") << QByteArray("\x82\x01") << QCborError{QCborError::EndOfFile};
+    QTest::newRow("unterminated") << QByteArray("\x9f\x01\x02") << QCborError{QCborError::EndOfFile};
+}
+
+void tst_QCborGadgetSerializer::errors()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QCborError, error);
+
+    Point p;
+    QCborParserError result;
+    QVERIFY(!QCborGadgetSerializer::fromCbor(data, &p, &result));
+    QCOMPARE(result.error, error);
+}
+
+void tst_QCborGadgetSerializer::stream()
+{
+    Point a;
+    a.x = 1;
+    Point b;
+    b.y = 2;
+
+    QByteArray data;
+    {
+        QCborStreamWriter writer(&data);
+        writer.startArray();
+        QCborGadgetSerializer::write(writer, &Point::staticMetaObject, &a);
+        QCborGadgetSerializer::write(writer, &Point::staticMetaObject, &b);
+        writer.endArray();
+    }
+
+    QCborStreamReader reader(data);
+    QVERIFY(reader.isArray());
+    QVERIFY(reader.enterContainer());
+    Point copy;
+    QVERIFY(QCborGadgetSerializer::read(reader, &Point::staticMetaObject, &copy));
+    QCOMPARE(copy, a);
+    QVERIFY(QCborGadgetSerializer::read(reader, &Point::staticMetaObject, &copy));
+    QCOMPARE(copy, b);
+    QVERIFY(!reader.hasNext());
+    QVERIFY(reader.leaveContainer());
+}
+
+QTEST_MAIN(tst_QCborGadgetSerializer)
+
+#include "tst_qcborgadgetserializer.moc"
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qcborvalueview
+QT = core testlib
+SOURCES = tst_qcborvalueview.cpp
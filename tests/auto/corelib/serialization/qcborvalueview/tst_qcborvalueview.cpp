@@ -0,0 +1,539 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest>
+#include <QtCore/qcborarray.h>
+#include <QtCore/qcbormap.h>
+#include <QtCore/qcborvalueview.h>
+
+class tst_QCborValueView : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void basics_data();
+    void basics();
+    void integers_data();
+    void integers();
+    void doubles_data();
+    void doubles();
+    void strings();
+    void chunkedStrings();
+    void tags();
+    void arrays();
+    void indefiniteLength();
+    void maps();
+    void nested();
+    void iteratorOutlivesView();
+    void index();
+    void toCborValue();
+    void errors_data();
+    void errors();
+    void nestingLimit();
+};
+
+static QCborValueView view(const QByteArray &data)
+{
+    QCborParserError error;
+    QCborValueView v = QCborValueView::fromCbor(data, &error);
+    if (error.error != QCborError::NoError)
+        qWarning() << "unexpected error" << error.errorString() << "at" << error.offset;
+    return v;
+}
+
+void tst_QCborValueView::basics_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QCborValue::Type>("type");
+
+    QTest::newRow("integer") << QByteArray("\x01") << QCborValue::Integer;
+    QTest::newRow("bytearray") << QByteArray("\x41" "a") << QCborValue::ByteArray;
+    QTest::newRow("string") << QByteArray("\x61" "a") << QCborValue::String;
+    QTest::newRow("array") << QByteArray("\x80") << QCborValue::Array;
+    QTest::newRow("map") << QByteArray("\xa0") << QCborValue::Map;
+    QTest::newRow("tag") << QByteArray("\xc1\x00", 2) << QCborValue::Tag;
+    QTest::newRow("false") << QByteArray("\xf4") << QCborValue::False;
+    QTest::newRow("true") << QByteArray("\xf5") << QCborValue::True;
+    QTest::newRow("null") << QByteArray("\xf6") << QCborValue::Null;
+    QTest::newRow("undefined") << QByteArray("\xf7") << QCborValue::Undefined;
+    QTest::newRow("simple(0)") << QByteArray("\xe0") << QCborValue::Type(QCborValue::SimpleType);
+    QTest::newRow("simple(255)") << QByteArray("\xf8\xff")
+                                 << QCborValue::Type(QCborValue::SimpleType + 255);
+    QTest::newRow("half") << QByteArray("\xf9\x3c\x00", 3) << QCborValue::Double;
+    QTest::newRow("float") << QByteArray("\xfa\x3f\x80\x00\x00", 5) << QCborValue::Double;
+    QTest::newRow("double") << QCborValue(1.5).toCbor() << QCborValue::Double;
+}
+
+void tst_QCborValueView::basics()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QCborValue::Type, type);
+
+    QCborValueView v = view(data);
+    QVERIFY(v.isValid());
+    QCOMPARE(v.type(), type);
+    QCOMPARE(v.encodedData(), QByteArrayView(data));
+    QCOMPARE(v.isContainer(), type == QCborValue::Array || type == QCborValue::Map);
+    QCOMPARE(v.isBool(), type == QCborValue::False || type == QCborValue::True);
+    QCOMPARE(v.toBool(), type == QCborValue::True);
+    if (v.isSimpleType())
+        QCOMPARE(int(v.toSimpleType()), int(type) & 0xff);
+
+    QCborValueView invalid;
+    QVERIFY(!invalid.isValid());
+    QCOMPARE(invalid.type(), QCborValue::Invalid);
+    QCOMPARE(invalid.toInteger(-1), -1);
+    QVERIFY(invalid.encodedData().isNull());
+    QCOMPARE(invalid.size(), 0);
+    QVERIFY(invalid.begin() == invalid.end());
+}
+
+void tst_QCborValueView::integers_data()
+{
+    QTest::addColumn<qint64>("value");
+
+    QTest::newRow("0") << Q_INT64_C(0);
+    QTest::newRow("23") << Q_INT64_C(23);
+    QTest::newRow("24") << Q_INT64_C(24);
+    QTest::newRow("256") << Q_INT64_C(256);
+    QTest::newRow("65536") << Q_INT64_C(65536);
+    QTest::newRow("2^32") << Q_INT64_C(4294967296);
+    QTest::newRow("-1") << Q_INT64_C(-1);
+    QTest::newRow("-25") << Q_INT64_C(-25);
+    QTest::newRow("-2^32") << -Q_INT64_C(4294967296);
+    QTest::newRow("max") << std::numeric_limits<qint64>::max();
+    QTest::newRow("min") << std::numeric_limits<qint64>::min();
+}
+
+void tst_QCborValueView::integers()
+{
+    QFETCH(qint64, value);
+
+    QCborValueView v = view(QCborValue(value).toCbor());
+    QVERIFY(v.isInteger());
+    QCOMPARE(v.toInteger(), value);
+    QCOMPARE(v.toDouble(), double(value));
+}
+
+void tst_QCborValueView::doubles_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<double>("value");
+
+    QTest::newRow("half-1") << QByteArray("\xf9\x3c\x00", 3) << 1.0;
+    QTest::newRow("half-min") << QByteArray("\xf9\x04\x00", 3) << 6.103515625e-05;
+    QTest::newRow("half-neg") << QByteArray("\xf9\xc4\x00", 3) << -4.0;
+    QTest::newRow("float") << QByteArray("\xfa\x47\xc3\x50\x00", 5) << 100000.0;
+    QTest::newRow("double") << QCborValue(1.1).toCbor() << 1.1;
+    QTest::newRow("double-inf") << QCborValue(qInf()).toCbor() << qInf();
+    QTest::newRow("uint64-max") << QByteArray("\x1b\xff\xff\xff\xff\xff\xff\xff\xff")
+                                << 18446744073709551615.0;
+    QTest::newRow("nint64-max") << QByteArray("\x3b\xff\xff\xff\xff\xff\xff\xff\xff")
+                                << -18446744073709551616.0;
+}
+
+void tst_QCborValueView::doubles()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(double, value);
+
+    QCborValueView v = view(data);
+    QVERIFY(v.isDouble());
+    QCOMPARE(v.toDouble(), value);
+    if (value >= std::numeric_limits<qint64>::min())
+        QCOMPARE(v.toDouble(), QCborValue::fromCbor(data).toDouble());
+}
+
+void tst_QCborValueView::strings()
+{
+    const QString text = QString::fromUtf8("Ol\xc3\xa1, mundo");
+    QByteArray data = QCborValue(text).toCbor();
+    QCborValueView v = view(data);
+    QVERIFY(v.isString());
+    QCOMPARE(v.toString(), text);
+    QCOMPARE(v.utf8StringView(), QByteArrayView(text.toUtf8()));
+    QVERIFY(v.byteArrayView().isNull());
+    QCOMPARE(v.toByteArray("default"), QByteArray("default"));
+
+    // the view points into the encoded data
+    QVERIFY(v.utf8StringView().data() > data.constData());
+    QVERIFY(v.utf8StringView().data() < data.constData() + data.size());
+
+    data = QCborValue(QByteArray("Hello")).toCbor();
+    v = view(data);
+    QVERIFY(v.isByteArray());
+    QCOMPARE(v.byteArrayView(), QByteArrayView("Hello"));
+    QCOMPARE(v.byteArrayView().data(), data.constData() + 1);
+    QCOMPARE(v.toByteArray(), QByteArray("Hello"));
+    QVERIFY(v.utf8StringView().isNull());
+    QCOMPARE(v.toString(QStringLiteral("default")), QStringLiteral("default"));
+
+    v = view(QByteArray("\x60", 1));
+    QVERIFY(v.isString());
+    QVERIFY(!v.utf8StringView().isNull());
+    QVERIFY(v.utf8StringView().isEmpty());
+    QVERIFY(v.toString().isEmpty());
+}
+
+void tst_QCborValueView::chunkedStrings()
+{
+    QCborValueView v = view("\x7f\x62" "ab" "\x60\x61" "c" "\xff");
+    QVERIFY(v.isString());
+    QVERIFY(v.utf8StringView().isNull());
+    QCOMPARE(v.toString(), QStringLiteral("abc"));
+    QCOMPARE(v.encodedData().size(), 8);
+
+    v = view("\x5f\x42" "ab" "\x41" "c" "\xff");
+    QVERIFY(v.isByteArray());
+    QVERIFY(v.byteArrayView().isNull());
+    QCOMPARE(v.toByteArray(), QByteArray("abc"));
+
+    v = view("\x7f\xff");
+    QVERIFY(v.isString());
+    QVERIFY(v.toString().isEmpty());
+}
+
+void tst_QCborValueView::tags()
+{
+    QCborValueView v = view(QCborValue(QCborKnownTags::Signature, QCborValue(42)).toCbor());
+    QVERIFY(v.isTag());
+    QCOMPARE(v.tag(), QCborTag(QCborKnownTags::Signature));
+    QCOMPARE(v.taggedValue().toInteger(), 42);
+
+    v = view(QCborValue(QDateTime::fromSecsSinceEpoch(1, Qt::UTC)).toCbor());
+    QVERIFY(v.isTag());
+    QCOMPARE(v.tag(), QCborTag(QCborKnownTags::DateTimeString));
+    QCOMPARE(v.taggedValue().toString(), QStringLiteral("1970-01-01T00:00:01.000Z"));
+
+    v = view("\x01");
+    QCOMPARE(v.tag(QCborTag(7)), QCborTag(7));
+    QVERIFY(!v.taggedValue().isValid());
+}
+
+void tst_QCborValueView::arrays()
+{
+    const QCborArray array = { 1, QStringLiteral("two"), 3.5, QCborArray{ 4 }, QCborMap{} };
+    QCborValueView v = view(QCborValue(array).toCbor());
+    QVERIFY(v.isArray());
+    QCOMPARE(v.size(), array.size());
+    for (qsizetype i = 0; i < array.size(); ++i) {
+        QCOMPARE(v.at(i).type(), array.at(i).type());
+        QCOMPARE(v[i].type(), array.at(i).type());
+    }
+    QCOMPARE(v.at(1).toString(), QStringLiteral("two"));
+    QCOMPARE(v.at(3).at(0).toInteger(), 4);
+    QVERIFY(!v.at(-1).isValid());
+    QVERIFY(!v.at(array.size()).isValid());
+    QVERIFY(!v.keyAt(0).isValid());
+    QVERIFY(!v.valueAt(0).isValid());
+    QVERIFY(!v[QLatin1String("x")].isValid());
+
+    qsizetype i = 0;
+    for (auto it = v.begin(); it != v.end(); ++it, ++i) {
+        QVERIFY(!it.key().isValid());
+        QCOMPARE((*it).toCborValue(), array.at(i));
+    }
+    QCOMPARE(i, array.size());
+
+    v = view("\x80");
+    QCOMPARE(v.size(), 0);
+    QVERIFY(v.begin() == v.end());
+    QVERIFY(!v.at(0).isValid());
+}
+
+void tst_QCborValueView::indefiniteLength()
+{
+    QCborValueView v = view("\x9f\x01\x9f\x02\xff\x03\xff");
+    QVERIFY(v.isArray());
+    QCOMPARE(v.size(), 3);
+    QCOMPARE(v.at(0).toInteger(), 1);
+    QCOMPARE(v.at(1).size(), 1);
+    QCOMPARE(v.at(1).at(0).toInteger(), 2);
+    QCOMPARE(v.at(2).toInteger(), 3);
+    QVERIFY(!v.at(3).isValid());
+
+    QList<qint64> values;
+    for (QCborValueView element : v)
+        values << element.toInteger(-1);
+    QCOMPARE(values, QList<qint64>({ 1, -1, 3 }));
+
+    v = view("\xbf\x61" "a" "\x01\x61" "b" "\x02\xff");
+    QVERIFY(v.isMap());
+    QCOMPARE(v.size(), 2);
+    QCOMPARE(v[QLatin1String("b")].toInteger(), 2);
+    QCOMPARE(v.keyAt(1).toString(), QStringLiteral("b"));
+    QVERIFY(!v.valueAt(2).isValid());
+
+    v = view("\x9f\xff");
+    QCOMPARE(v.size(), 0);
+    QVERIFY(v.begin() == v.end());
+}
+
+void tst_QCborValueView::maps()
+{
+    QCborMap map;
+    map[QStringLiteral("name")] = QStringLiteral("value");
+    map[42] = 1;
+    map[QString::fromUtf8("\xc3\xa9t\xc3\xa9")] = 2;
+    map[QStringLiteral("list")] = QCborArray{ 1, 2, 3 };
+    map[-1] = true;
+
+    QCborValueView v = view(QCborValue(map).toCbor());
+    QVERIFY(v.isMap());
+    QCOMPARE(v.size(), map.size());
+
+    QCOMPARE(v[QLatin1String("name")].toString(), QStringLiteral("value"));
+    QCOMPARE(v[QStringLiteral("name")].toString(), QStringLiteral("value"));
+    QCOMPARE(v[QStringView(u"name")].toString(), QStringLiteral("value"));
+    QCOMPARE(v[42].toInteger(), 1);
+    QCOMPARE(v[-1].toBool(), true);
+    QCOMPARE(v[QString::fromUtf8("\xc3\xa9t\xc3\xa9")].toInteger(), 2);
+    QCOMPARE(v[QLatin1String("\xe9t\xe9")].toInteger(), 2);
+    QCOMPARE(v[QLatin1String("list")].size(), 3);
+
+    QVERIFY(!v[QLatin1String("nam")].isValid());
+    QVERIFY(!v[QLatin1String("names")].isValid());
+    QVERIFY(!v[QLatin1String("")].isValid());
+    QVERIFY(!v[43].isValid());
+    QVERIFY(!v.at(0).isValid());
+
+    qsizetype i = 0;
+    for (auto it = v.begin(); it != v.end(); ++it, ++i) {
+        QCOMPARE(it.key().toCborValue(), map.keys().at(i));
+        QCOMPARE(it.value().toCborValue(), map.value(map.keys().at(i)));
+        QCOMPARE(v.keyAt(i).toCborValue(), it.key().toCborValue());
+        QCOMPARE(v.valueAt(i).toCborValue(), it.value().toCborValue());
+    }
+    QCOMPARE(i, map.size());
+
+    // keys are matched by type
+    v = view("\xa2\x61" "1" "\x01\x01\x02");
+    QCOMPARE(v[1].toInteger(), 2);
+    QCOMPARE(v[QLatin1String("1")].toInteger(), 1);
+
+    // chunked keys
+    v = view("\xa1\x7f\x61" "a" "\x61" "b" "\xff\x05");
+    QCOMPARE(v[QLatin1String("ab")].toInteger(), 5);
+    QCOMPARE(v[QStringView(u"ab")].toInteger(), 5);
+}
+
+void tst_QCborValueView::nested()
+{
+    QCborMap inner;
+    inner[QStringLiteral("b")] = QStringLiteral("found");
+    QCborMap outer;
+    outer[QStringLiteral("a")] = QCborArray{ 0, inner };
+
+    const QByteArray data = QCborValue(outer).toCbor();
+    QCborValueView v = view(data);
+    QCOMPARE(v[QLatin1String("a")][1][QLatin1String("b")].toString(), QStringLiteral("found"));
+    QVERIFY(!v[QLatin1String("a")][2][QLatin1String("b")].isValid());
+    QVERIFY(!v[QLatin1String("x")][1][QLatin1String("b")].isValid());
+
+    // views keep the data alive
+    QCborValueView child = view(QCborValue(outer).toCbor())[QLatin1String("a")];
+    QCOMPARE(child.size(), 2);
+    QCOMPARE(child.encodedData(), QCborValue(outer[QStringLiteral("a")]).toCbor());
+}
+
+void tst_QCborValueView::iteratorOutlivesView()
+{
+    QCborMap map;
+    map[QStringLiteral("list")] = QCborArray{ 1, 2, 3 };
+    map[QStringLiteral("map")] = QCborMap{ { 1, QStringLiteral("one") } };
+
+    // iterators obtained from temporary views, whose data is gone as well
+    QCborValueView::ConstIterator listIt, listEnd, mapIt;
+    {
+        const QCborValueView v = QCborValueView::fromCbor(QCborValue(map).toCbor());
+        listIt = v[QLatin1String("list")].begin();
+        listEnd = v[QLatin1String("list")].end();
+        mapIt = v[QLatin1String("map")].begin();
+    }
+
+    qint64 expected = 1;
+    for ( ; listIt != listEnd; ++listIt, ++expected)
+        QCOMPARE((*listIt).toInteger(), expected);
+    QCOMPARE(expected, 4);
+    QCOMPARE(mapIt.key().toInteger(), 1);
+    QCOMPARE(mapIt.value().toString(), QStringLiteral("one"));
+    QVERIFY(++mapIt == QCborValueView::ConstIterator());
+
+    // range-based for over a temporary view
+    expected = 1;
+    const QByteArray encoded = QCborValue(map).toCbor();
+    for (const QCborValueView element : QCborValueView::fromCbor(encoded)[QLatin1String("list")])
+        QCOMPARE(element.toInteger(), expected++);
+    QCOMPARE(expected, 4);
+}
+
+void tst_QCborValueView::index()
+{
+    QCborArray array;
+    for (int i = 0; i < 100; ++i)
+        array.append(QCborArray{ i, QString::number(i) });
+    QCborMap map;
+    for (int i = 0; i < 100; ++i)
+        map[QString::number(i)] = i;
+
+    QCborValueView v = view(QCborValue(array).toCbor());
+    QVERIFY(!v.hasIndex());
+    v.createIndex();
+    QVERIFY(v.hasIndex());
+    QCOMPARE(v.size(), 100);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(v.at(i).at(1).toString(), QString::number(i));
+    QVERIFY(!v.at(100).isValid());
+    QVERIFY(!v.at(0).hasIndex());
+
+    QCborValueView copy = v;
+    QVERIFY(copy.hasIndex());
+
+    v = view(QCborValue(map).toCbor());
+    v.createIndex();
+    QVERIFY(v.hasIndex());
+    QCOMPARE(v.size(), 100);
+    for (int i = 0; i < 100; ++i) {
+        QCOMPARE(v.keyAt(i).toCborValue(), map.keys().at(i));
+        QCOMPARE(v.valueAt(i).toCborValue(), map.value(map.keys().at(i)));
+    }
+    QCOMPARE(v[QLatin1String("42")].toInteger(), 42);
+
+    v = view("\x9f\x01\x02\xff");
+    v.createIndex();
+    QCOMPARE(v.size(), 2);
+    QCOMPARE(v.at(1).toInteger(), 2);
+
+    v = view("\x01");
+    v.createIndex();
+    QVERIFY(!v.hasIndex());
+}
+
+void tst_QCborValueView::toCborValue()
+{
+    QCborMap map;
+    map[QStringLiteral("array")] = QCborArray{ 1, -2, 3.5, QStringLiteral("four"), QByteArray("5") };
+    map[QStringLiteral("map")] = QCborMap{ { 1, QCborValue::Null }, { 2, QCborValue() } };
+    map[QStringLiteral("url")] = QCborValue(QUrl(QStringLiteral("https://qt.io")));
+    map[QStringLiteral("simple")] = QCborValue(QCborSimpleType(99));
+
+    const QByteArray data = QCborValue(map).toCbor();
+    QCborValueView v = view(data);
+    QCOMPARE(v.toCborValue(), QCborValue(map));
+    QCOMPARE(v.toCborValue(), QCborValue::fromCbor(data));
+    QCOMPARE(v[QLatin1String("url")].toCborValue(), QCborValue(QUrl(QStringLiteral("https://qt.io"))));
+    QCOMPARE(v[QLatin1String("array")].toCborValue(), map[QStringLiteral("array")]);
+    QCOMPARE(QCborValueView().toCborValue(), QCborValue(QCborValue::Invalid));
+}
+
+void tst_QCborValueView::errors_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QCborError>("error");
+    QTest::addColumn<qint64>("offset");
+
+    QTest::newRow("empty") << QByteArray() << QCborError{QCborError::EndOfFile} << Q_INT64_C(0);
+    QTest::newRow("truncated-integer") << QByteArray("\x19\x01") << QCborError{QCborError::EndOfFile}
+                                       << Q_INT64_C(0);
+    QTest::newRow("reserved-28") << QByteArray("\x1c") << QCborError{QCborError::IllegalNumber}
+                                 << Q_INT64_C(0);
+    QTest::newRow("indefinite-integer") << QByteArray("\x1f") << QCborError{QCborError::IllegalNumber}
+                                        << Q_INT64_C(0);
+    QTest::newRow("indefinite-tag") << QByteArray("\xdf") << QCborError{QCborError::IllegalNumber}
+                                    << Q_INT64_C(0);
+    QTest::newRow("break") << QByteArray("\xff") << QCborError{QCborError::UnexpectedBreak}
+                           << Q_INT64_C(0);
+    QTest::newRow("truncated-string") << QByteArray("\x63" "ab") << QCborError{QCborError::EndOfFile}
+                                      << Q_INT64_C(1);
+    QTest::newRow("huge-string") << QByteArray("\x5b\x7f\xff\xff\xff\xff\xff\xff\xff")
+                                 << QCborError{QCborError::EndOfFile} << Q_INT64_C(9);
+    QTest::newRow("truncated-array") << QByteArray("\x82\x01") << QCborError{QCborError::EndOfFile}
+                                     << Q_INT64_C(1);
+    QTest::newRow("huge-array") << QByteArray("\x9b\x7f\xff\xff\xff\xff\xff\xff\xff")
+                                << QCborError{QCborError::EndOfFile} << Q_INT64_C(9);
+    QTest::newRow("truncated-map") << QByteArray("\xa1\x01") << QCborError{QCborError::EndOfFile}
+                                   << Q_INT64_C(2);
+    QTest::newRow("unterminated-array") << QByteArray("\x9f\x01") << QCborError{QCborError::EndOfFile}
+                                        << Q_INT64_C(2);
+    QTest::newRow("odd-map") << QByteArray("\xbf\x01\xff") << QCborError{QCborError::UnexpectedBreak}
+                             << Q_INT64_C(2);
+    QTest::newRow("break-in-array") << QByteArray("\x82\x01\xff")
+                                    << QCborError{QCborError::UnexpectedBreak} << Q_INT64_C(2);
+    QTest::newRow("chunk-wrong-type") << QByteArray("\x5f\x61" "a" "\xff")
+                                      << QCborError{QCborError::IllegalType} << Q_INT64_C(1);
+    QTest::newRow("chunk-indefinite") << QByteArray("\x5f\x5f\xff\xff")
+                                      << QCborError{QCborError::IllegalType} << Q_INT64_C(1);
+    QTest::newRow("unterminated-chunks") << QByteArray("\x7f\x61" "a")
+                                         << QCborError{QCborError::EndOfFile} << Q_INT64_C(3);
+    QTest::newRow("simple-24") << QByteArray("\xf8\x18") << QCborError{QCborError::IllegalSimpleType}
+                               << Q_INT64_C(2);
+    QTest::newRow("tag-without-value") << QByteArray("\xc1") << QCborError{QCborError::EndOfFile}
+                                       << Q_INT64_C(1);
+}
+
+void tst_QCborValueView::errors()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QCborError, error);
+    QFETCH(qint64, offset);
+
+    QCborParserError result;
+    QCborValueView v = QCborValueView::fromCbor(data, &result);
+    QVERIFY(!v.isValid());
+    QCOMPARE(result.error, error);
+    QCOMPARE(result.offset, offset);
+
+    // QCborValue does not accept it either
+    QCborParserError valueError;
+    QCborValue::fromCbor(data, &valueError);
+    QVERIFY(valueError.error != QCborError::NoError);
+}
+
+void tst_QCborValueView::nestingLimit()
+{
+    QByteArray data(1024, '\x81');
+    data.append('\x01');
+    QCborParserError error;
+    QCborValueView v = QCborValueView::fromCbor(data, &error);
+    QCOMPARE(error.error, QCborError{QCborError::NoError});
+    QCOMPARE(error.offset, data.size());
+    QVERIFY(v.isArray());
+
+    data.prepend('\x81');
+    v = QCborValueView::fromCbor(data, &error);
+    QVERIFY(!v.isValid());
+    QCOMPARE(error.error, QCborError{QCborError::NestingTooDeep});
+
+    // trailing data is ignored
+    v = QCborValueView::fromCbor(QByteArray("\x01\x02"), &error);
+    QCOMPARE(error.error, QCborError{QCborError::NoError});
+    QCOMPARE(v.encodedData(), QByteArrayView("\x01"));
+}
+
+QTEST_MAIN(tst_QCborValueView)
+
+#include "tst_qcborvalueview.moc"
@@ -202,6 +202,8 @@ private slots:
 
     void floatingPointPrecision();
 
+    void zeroCopyReads();
+
     void compatibility_Qt5();
     void compatibility_Qt3();
     void compatibility_Qt2();
@@ -3691,6 +3693,70 @@ void tst_QDataStream::floatingPointPrecision()
 
 }
 
+void tst_QDataStream::zeroCopyReads()
+{
+    const QDataStream::ByteOrder hostOrder = QSysInfo::ByteOrder == QSysInfo::BigEndian
+            ? QDataStream::BigEndian : QDataStream::LittleEndian;
+    const QDataStream::ByteOrder otherOrder = hostOrder == QDataStream::BigEndian
+            ? QDataStream::LittleEndian : QDataStream::BigEndian;
+
+    QByteArray ba;
+    {
+        QDataStream stream(&ba, QIODevice::WriteOnly);
+        stream.setByteOrder(hostOrder);
+        // 4 + 8 bytes, so that the string data is 2-byte aligned
+        stream << QByteArray("payload!") << QString("text") << QByteArray() << QString();
+        stream.setByteOrder(otherOrder);
+        stream << QString("swapped");
+    }
+    {
+        QDataStream stream(ba);
+        QVERIFY(!stream.isZeroCopyEnabled());
+        stream.setZeroCopyEnabled(true);
+        QVERIFY(stream.isZeroCopyEnabled());
+        stream.setByteOrder(hostOrder);
+
+        QByteArray bytes;
+        stream >> bytes;
+        QCOMPARE(bytes, QByteArray("payload!"));
+        QVERIFY(bytes.constData() >= ba.constData());
+        QVERIFY(bytes.constData() < ba.constData() + ba.size());
+
+        QString text;
+        stream >> text;
+        QCOMPARE(text, QString("text"));
+        QVERIFY(reinterpret_cast<const char *>(text.constData()) >= ba.constData());
+        QVERIFY(reinterpret_cast<const char *>(text.constData())
+                < ba.constData() + ba.size());
+
+        stream >> bytes >> text;
+        QVERIFY(bytes.isNull());
+        QVERIFY(text.isNull());
+
+        // strings not in host byte order are copied
+        stream.setByteOrder(otherOrder);
+        stream >> text;
+        QCOMPARE(text, QString("swapped"));
+        QVERIFY(reinterpret_cast<const char *>(text.constData()) < ba.constData()
+                || reinterpret_cast<const char *>(text.constData())
+                   >= ba.constData() + ba.size());
+        QCOMPARE(stream.status(), QDataStream::Ok);
+        QVERIFY(stream.atEnd());
+    }
+
+    {
+        // bounds checking: the length claims more data than available
+        QByteArray truncated = ba.left(sizeof(quint32) + 3);
+        QDataStream stream(truncated);
+        stream.setZeroCopyEnabled(true);
+        stream.setByteOrder(hostOrder);
+        QByteArray bytes;
+        stream >> bytes;
+        QVERIFY(bytes.isEmpty());
+        QCOMPARE(stream.status(), QDataStream::ReadPastEnd);
+    }
+}
+
 void tst_QDataStream::transaction_data()
 {
     QTest::addColumn<qint8>("i8Data");
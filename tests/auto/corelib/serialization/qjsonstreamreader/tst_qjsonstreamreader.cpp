@@ -0,0 +1,430 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest>
+#include <QtCore/qjsonstreamreader.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qbuffer.h>
+
+class tst_QJsonStreamReader : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void tokens_data();
+    void tokens();
+    void incremental_data() { tokens_data(); }
+    void incremental();
+    void device_data() { tokens_data(); }
+    void device();
+    void matchesDocument();
+    void numbers_data();
+    void numbers();
+    void errors_data();
+    void errors();
+    void truncated_data();
+    void truncated();
+    void byteOrderMark();
+    void jsonLines();
+    void containerDepth();
+    void offsets();
+};
+
+static QString tokenString(const QJsonStreamReader &reader)
+{
+    switch (reader.tokenType()) {
+    case QJsonStreamReader::NoToken:
+        return QStringLiteral("NoToken");
+    case QJsonStreamReader::Invalid:
+        return QStringLiteral("Invalid");
+    case QJsonStreamReader::StartObject:
+        return QStringLiteral("{");
+    case QJsonStreamReader::EndObject:
+        return QStringLiteral("}");
+    case QJsonStreamReader::StartArray:
+        return QStringLiteral("[");
+    case QJsonStreamReader::EndArray:
+        return QStringLiteral("]");
+    case QJsonStreamReader::Name:
+        return QLatin1String("name:") + reader.text();
+    case QJsonStreamReader::String:
+        return QLatin1String("string:") + reader.text();
+    case QJsonStreamReader::Number:
+        if (reader.isInteger())
+            return QLatin1String("int:") + QString::number(reader.toInteger());
+        return QLatin1String("double:") + QString::number(reader.toDouble());
+    case QJsonStreamReader::Bool:
+        return reader.toBool() ? QStringLiteral("true") : QStringLiteral("false");
+    case QJsonStreamReader::Null:
+        return QStringLiteral("null");
+    case QJsonStreamReader::EndDocument:
+        return QStringLiteral("end");
+    }
+    return QString();
+}
+
+// Reads tokens until the reader reports EndDocument at the end of input or
+// an error, skipping NoToken results if \a feed supplies more data.
+template <typename Feed>
+static QStringList readAll(QJsonStreamReader &reader, Feed feed)
+{
+    QStringList result;
+    for (int guard = 0; guard < 100000; ++guard) {
+        QJsonStreamReader::TokenType type = reader.readNext();
+        if (type == QJsonStreamReader::NoToken) {
+            if (!feed())
+                break;
+            continue;
+        }
+        result << tokenString(reader);
+        if (reader.atEnd())
+            break;
+    }
+    return result;
+}
+
+static QStringList readAll(QJsonStreamReader &reader)
+{
+    return readAll(reader, [] { return false; });
+}
+
+void tst_QJsonStreamReader::tokens_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QStringList>("expected");
+
+    QTest::newRow("empty") << QByteArray() << QStringList{"end"};
+    QTest::newRow("whitespace") << QByteArray(" \t\r\n") << QStringList{"end"};
+    QTest::newRow("empty-object") << QByteArray("{}") << QStringList{"{", "}", "end"};
+    QTest::newRow("empty-array") << QByteArray(" [ ] ") << QStringList{"[", "]", "end"};
+    QTest::newRow("scalars")
+            << QByteArray("[true, false, null, 1, -2.5, \"x\"]")
+            << QStringList{"[", "true", "false", "null", "int:1", "double:-2.5", "string:x", "]", "end"};
+    QTest::newRow("object")
+            << QByteArray("{ \"a\" : 1, \"b\": [ {}, [] ], \"c\": { \"d\": \"e\" } }")
+            << QStringList{"{", "name:a", "int:1", "name:b", "[", "{", "}", "[", "]", "]",
+                           "name:c", "{", "name:d", "string:e", "}", "}", "end"};
+    QTest::newRow("duplicate-names")
+            << QByteArray("{\"b\":1,\"a\":2,\"b\":3}")
+            << QStringList{"{", "name:b", "int:1", "name:a", "int:2", "name:b", "int:3", "}", "end"};
+    QTest::newRow("escapes")
+            << QByteArray("[\"\\\"\\\\\\/\\b\\f\\n\\r\\t\", \"\\u00e9\\ud83d\\ude00\"]")
+            << QStringList{"[", QLatin1String("string:") + QString::fromUtf8("\"\\/\b\f\n\r\t"),
+                           QLatin1String("string:") + QString::fromUtf8("\xc3\xa9\xf0\x9f\x98\x80"),
+                           "]", "end"};
+    QTest::newRow("utf8")
+            << QByteArray("{\"\xc3\xa9t\xc3\xa9\": \"\xe2\x82\xac\"}")
+            << QStringList{"{", QLatin1String("name:") + QString::fromUtf8("\xc3\xa9t\xc3\xa9"),
+                           QLatin1String("string:") + QString::fromUtf8("\xe2\x82\xac"), "}", "end"};
+    QTest::newRow("top-level-string") << QByteArray("\"abc\"") << QStringList{"string:abc", "end"};
+    QTest::newRow("top-level-number") << QByteArray("42") << QStringList{"int:42", "end"};
+    QTest::newRow("top-level-literal") << QByteArray("null") << QStringList{"null", "end"};
+}
+
+void tst_QJsonStreamReader::tokens()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QStringList, expected);
+
+    QJsonStreamReader reader(data);
+    QCOMPARE(readAll(reader), expected);
+    QVERIFY(!reader.hasError());
+    QVERIFY(reader.atEnd());
+}
+
+void tst_QJsonStreamReader::incremental()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QStringList, expected);
+
+    QJsonStreamReader reader;
+    qsizetype fed = 0;
+    const QStringList result = readAll(reader, [&] {
+        if (fed == data.size())
+            return false;
+        reader.addData(data.constData() + fed++, 1);
+        return true;
+    });
+    QVERIFY(!reader.hasError());
+    QVERIFY(!reader.atEnd());
+
+    // data added with addData() is never complete, so the reader can't
+    // tell that a number at the very end of it has ended
+    const QByteArray tag = QTest::currentDataTag();
+    if (tag == "empty" || tag == "whitespace" || tag == "top-level-number")
+        QVERIFY(result.isEmpty());
+    else
+        QCOMPARE(result, expected);
+}
+
+void tst_QJsonStreamReader::device()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QStringList, expected);
+
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.device(), &buffer);
+    QCOMPARE(readAll(reader), expected);
+    QVERIFY(!reader.hasError());
+}
+
+static QJsonValue readValue(QJsonStreamReader &reader)
+{
+    if (reader.isStartArray()) {
+        QJsonArray array;
+        while (reader.readNext() != QJsonStreamReader::EndArray && !reader.hasError())
+            array.append(readValue(reader));
+        return array;
+    }
+    if (reader.isStartObject()) {
+        QJsonObject object;
+        while (reader.readNext() == QJsonStreamReader::Name) {
+            const QString name = reader.text();
+            reader.readNext();
+            object.insert(name, readValue(reader));
+        }
+        return object;
+    }
+    return reader.value();
+}
+
+void tst_QJsonStreamReader::matchesDocument()
+{
+    QJsonObject object;
+    object.insert("string", "Hello \"World\" \xc3\xa9\n");
+    object.insert("int", 1234567890123LL);
+    object.insert("negative", -17);
+    object.insert("double", 3.25);
+    object.insert("small", 1e-300);
+    object.insert("true", true);
+    object.insert("false", false);
+    object.insert("null", QJsonValue::Null);
+    QJsonArray array;
+    for (int i = 0; i < 1000; ++i) {
+        QJsonObject entry = object;
+        entry.insert("index", i);
+        entry.insert("nested", QJsonArray{ i, QString::number(i), QJsonArray{}, QJsonObject{} });
+        array.append(entry);
+    }
+    const QJsonDocument document(array);
+
+    for (auto format : { QJsonDocument::Indented, QJsonDocument::Compact }) {
+        const QByteArray json = document.toJson(format);
+        QBuffer buffer;
+        buffer.setData(json);
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+        QJsonStreamReader reader(&buffer);
+        QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+        const QJsonValue value = readValue(reader);
+        QVERIFY2(!reader.hasError(), qPrintable(reader.lastError().errorString()));
+        QCOMPARE(value, QJsonValue(array));
+        QCOMPARE(reader.readNext(), QJsonStreamReader::EndDocument);
+        QVERIFY(reader.atEnd());
+    }
+}
+
+void tst_QJsonStreamReader::numbers_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<bool>("isInteger");
+    QTest::addColumn<qint64>("integer");
+    QTest::addColumn<double>("number");
+
+    QTest::newRow("0") << QByteArray("0") << true << qint64(0) << 0.;
+    QTest::newRow("-0") << QByteArray("-0") << true << qint64(0) << 0.;
+    QTest::newRow("1.0") << QByteArray("1.0") << true << qint64(1) << 1.;
+    QTest::newRow("1.5") << QByteArray("1.5") << false << qint64(0) << 1.5;
+    QTest::newRow("1e3") << QByteArray("1e3") << true << qint64(1000) << 1000.;
+    QTest::newRow("-1E-2") << QByteArray("-1E-2") << false << qint64(0) << -0.01;
+    QTest::newRow("max") << QByteArray("9223372036854775807") << true
+                         << std::numeric_limits<qint64>::max() << 9223372036854775807.;
+    QTest::newRow("min") << QByteArray("-9223372036854775808") << true
+                         << std::numeric_limits<qint64>::min() << -9223372036854775808.;
+    QTest::newRow("overflow") << QByteArray("18446744073709551616") << false << qint64(0)
+                              << 18446744073709551616.;
+}
+
+void tst_QJsonStreamReader::numbers()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(bool, isInteger);
+    QFETCH(qint64, integer);
+    QFETCH(double, number);
+
+    QJsonStreamReader reader("[" + data + "]");
+    QCOMPARE(reader.readNext(), QJsonStreamReader::StartArray);
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Number);
+    QCOMPARE(reader.isInteger(), isInteger);
+    QCOMPARE(reader.toInteger(), integer);
+    QCOMPARE(reader.toDouble(), number);
+
+    // same conversion as QJsonDocument
+    const QJsonValue expected = QJsonDocument::fromJson("[" + data + "]").array().at(0);
+    QCOMPARE(reader.value(), expected);
+}
+
+void tst_QJsonStreamReader::errors_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QJsonParseError::ParseError>("error");
+    QTest::addColumn<int>("offset");
+
+    QTest::newRow("garbage") << QByteArray("x") << QJsonParseError::IllegalValue << 0;
+    QTest::newRow("bad-literal") << QByteArray("[tru]") << QJsonParseError::IllegalValue << 1;
+    QTest::newRow("missing-colon") << QByteArray("{\"a\" 1}") << QJsonParseError::MissingNameSeparator << 5;
+    QTest::newRow("missing-comma-array") << QByteArray("[1 2]") << QJsonParseError::MissingValueSeparator << 3;
+    QTest::newRow("missing-comma-object") << QByteArray("{\"a\":1 \"b\":2}") << QJsonParseError::UnterminatedObject << 7;
+    QTest::newRow("trailing-comma-object") << QByteArray("{\"a\":1,}") << QJsonParseError::MissingObject << 7;
+    QTest::newRow("trailing-comma-array") << QByteArray("[1,]") << QJsonParseError::IllegalValue << 3;
+    QTest::newRow("non-string-name") << QByteArray("{1:2}") << QJsonParseError::UnterminatedObject << 1;
+    QTest::newRow("mismatched") << QByteArray("[}") << QJsonParseError::IllegalValue << 1;
+    QTest::newRow("bad-number") << QByteArray("[-]") << QJsonParseError::IllegalNumber << 1;
+    QTest::newRow("bad-escape") << QByteArray("[\"\\u12x4\"]") << QJsonParseError::IllegalEscapeSequence << 6;
+    QTest::newRow("bad-utf8") << QByteArray("[\"\xc3\"]") << QJsonParseError::IllegalUTF8String << 1;
+    QTest::newRow("unterminated-string") << QByteArray("[\"abc") << QJsonParseError::UnterminatedString << 1;
+    QTest::newRow("unterminated-array") << QByteArray("[1, [2]") << QJsonParseError::UnterminatedArray << 7;
+    QTest::newRow("unterminated-object") << QByteArray("{\"a\": {}") << QJsonParseError::UnterminatedObject << 8;
+    QTest::newRow("dangling-name") << QByteArray("{\"a\"") << QJsonParseError::MissingNameSeparator << 4;
+
+    QByteArray deep(1025, '[');
+    QTest::newRow("deep-nesting") << deep << QJsonParseError::DeepNesting << 1024;
+}
+
+void tst_QJsonStreamReader::errors()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QJsonParseError::ParseError, error);
+    QFETCH(int, offset);
+
+    QJsonStreamReader reader(data);
+    const QStringList tokens = readAll(reader);
+    QVERIFY(!tokens.isEmpty());
+    QCOMPARE(tokens.last(), QStringLiteral("Invalid"));
+    QVERIFY(reader.hasError());
+    QVERIFY(reader.atEnd());
+    QCOMPARE(reader.lastError().error, error);
+    QCOMPARE(reader.lastError().offset, offset);
+
+    // errors are sticky
+    QCOMPARE(reader.readNext(), QJsonStreamReader::Invalid);
+    QCOMPARE(reader.lastError().error, error);
+}
+
+void tst_QJsonStreamReader::truncated_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QByteArray>("rest");
+    QTest::addColumn<QJsonStreamReader::TokenType>("type");
+
+    QTest::newRow("string") << QByteArray("[\"abc") << QByteArray("e\"]") << QJsonStreamReader::String;
+    QTest::newRow("escape") << QByteArray("[\"\\u00") << QByteArray("e9\"]") << QJsonStreamReader::String;
+    QTest::newRow("utf8") << QByteArray("[\"\xe2\x82") << QByteArray("\xac\"]") << QJsonStreamReader::String;
+    QTest::newRow("number") << QByteArray("[12") << QByteArray("]") << QJsonStreamReader::Number;
+    QTest::newRow("literal") << QByteArray("[fal") << QByteArray("se]") << QJsonStreamReader::Bool;
+    QTest::newRow("name") << QByteArray("{\"ab") << QByteArray("\": 1}") << QJsonStreamReader::Name;
+}
+
+void tst_QJsonStreamReader::truncated()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QByteArray, rest);
+    QFETCH(QJsonStreamReader::TokenType, type);
+
+    QJsonStreamReader reader;
+    reader.addData(data);
+    reader.readNext();
+    QVERIFY(reader.isStartArray() || reader.isStartObject());
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+    QVERIFY(!reader.hasError());
+    QVERIFY(!reader.atEnd());
+
+    // asking again without new data changes nothing
+    QCOMPARE(reader.readNext(), QJsonStreamReader::NoToken);
+
+    // completing the token resumes parsing where it stopped
+    reader.addData(rest);
+    QCOMPARE(reader.readNext(), type);
+    QCOMPARE(reader.currentOffset(), qint64(1));
+    QCOMPARE(reader.value(), QJsonDocument::fromJson(data + rest).array().at(0));
+}
+
+void tst_QJsonStreamReader::byteOrderMark()
+{
+    const QByteArray data("\xef\xbb\xbf[1]");
+    QJsonStreamReader reader(data);
+    QCOMPARE(readAll(reader), QStringList({"[", "int:1", "]", "end"}));
+    QVERIFY(!reader.hasError());
+
+    // also when the mark arrives in pieces
+    QJsonStreamReader incremental;
+    qsizetype fed = 0;
+    const QStringList tokens = readAll(incremental, [&] {
+        if (fed == data.size())
+            return false;
+        incremental.addData(data.constData() + fed++, 1);
+        return true;
+    });
+    QCOMPARE(tokens, QStringList({"[", "int:1", "]", "end"}));
+}
+
+void tst_QJsonStreamReader::jsonLines()
+{
+    QJsonStreamReader reader(QByteArray("{\"a\":1}\n[2]\n\"three\"\n4"));
+    QCOMPARE(readAll(reader), QStringList({"{", "name:a", "int:1", "}", "end", "[", "int:2", "]",
+                                           "end", "string:three", "end", "int:4", "end"}));
+    QVERIFY(!reader.hasError());
+    QVERIFY(reader.atEnd());
+}
+
+void tst_QJsonStreamReader::containerDepth()
+{
+    QJsonStreamReader reader(QByteArray("[[{\"a\":[]}]]"));
+    QList<int> depths;
+    while (!reader.atEnd()) {
+        reader.readNext();
+        depths << reader.containerDepth();
+    }
+    QCOMPARE(depths, QList<int>({1, 2, 3, 3, 4, 3, 2, 1, 0, 0}));
+}
+
+void tst_QJsonStreamReader::offsets()
+{
+    QJsonStreamReader reader(QByteArray("{ \"a\": [ 10, true ] }"));
+    QList<qint64> offsets;
+    while (!reader.atEnd()) {
+        reader.readNext();
+        offsets << reader.currentOffset();
+    }
+    QCOMPARE(offsets, QList<qint64>({0, 2, 7, 9, 13, 18, 20, 21}));
+}
+
+QTEST_MAIN(tst_QJsonStreamReader)
+
+#include "tst_qjsonstreamreader.moc"
@@ -0,0 +1,354 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest>
+#include <QtCore/qjsonstreamwriter.h>
+#include <QtCore/qjsonstreamreader.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qbuffer.h>
+
+class tst_QJsonStreamWriter : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void matchesToJson_data();
+    void matchesToJson();
+    void appendJsonValue_data() { matchesToJson_data(); }
+    void appendJsonValue();
+    void scalars_data();
+    void scalars();
+    void strings();
+    void jsonLines();
+    void nonStringName();
+    void mismatchedEnd();
+    void device();
+    void roundTrip();
+};
+
+Q_DECLARE_METATYPE(QJsonDocument::JsonFormat)
+
+static void writeValue(QJsonStreamWriter &writer, const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::Null:
+    case QJsonValue::Undefined:
+        writer.appendNull();
+        break;
+    case QJsonValue::Bool:
+        writer.append(value.toBool());
+        break;
+    case QJsonValue::Double:
+        if (value.toInteger() == value.toDouble())
+            writer.append(value.toInteger());
+        else
+            writer.append(value.toDouble());
+        break;
+    case QJsonValue::String:
+        writer.append(value.toString());
+        break;
+    case QJsonValue::Array:
+        writer.startArray();
+        for (const QJsonValue &element : value.toArray())
+            writeValue(writer, element);
+        QVERIFY(writer.endArray());
+        break;
+    case QJsonValue::Object: {
+        writer.startObject();
+        const QJsonObject object = value.toObject();
+        for (auto it = object.begin(); it != object.end(); ++it) {
+            writer.append(it.key());
+            writeValue(writer, it.value());
+        }
+        QVERIFY(writer.endObject());
+        break;
+    }
+    }
+}
+
+void tst_QJsonStreamWriter::matchesToJson_data()
+{
+    QTest::addColumn<QJsonDocument>("document");
+    QTest::addColumn<QJsonDocument::JsonFormat>("format");
+
+    QJsonObject object;
+    object.insert("string", "Hello \"World\"\n\xc3\xa9\t\x01");
+    object.insert("int", 1234567890123LL);
+    object.insert("million", 1000000);
+    object.insert("negative", -17);
+    object.insert("double", 3.25);
+    object.insert("small", 1e-300);
+    object.insert("true", true);
+    object.insert("false", false);
+    object.insert("null", QJsonValue::Null);
+    object.insert("emptyArray", QJsonArray());
+    object.insert("emptyObject", QJsonObject());
+    object.insert("nested", QJsonArray{ 1, QJsonArray{ QJsonObject{ {"a", QJsonArray{}} } } });
+
+    QJsonArray array;
+    for (int i = 0; i < 100; ++i)
+        array.append(object);
+
+    for (auto format : { QJsonDocument::Indented, QJsonDocument::Compact }) {
+        const char *suffix = format == QJsonDocument::Indented ? "-indented" : "-compact";
+        QTest::addRow("empty-object%s", suffix) << QJsonDocument(QJsonObject()) << format;
+        QTest::addRow("empty-array%s", suffix) << QJsonDocument(QJsonArray()) << format;
+        QTest::addRow("object%s", suffix) << QJsonDocument(object) << format;
+        QTest::addRow("array%s", suffix) << QJsonDocument(array) << format;
+    }
+}
+
+void tst_QJsonStreamWriter::matchesToJson()
+{
+    QFETCH(QJsonDocument, document);
+    QFETCH(QJsonDocument::JsonFormat, format);
+
+    QByteArray data;
+    {
+        QJsonStreamWriter writer(&data);
+        writer.setFormat(format);
+        QCOMPARE(writer.format(), format);
+        writeValue(writer, document.isArray() ? QJsonValue(document.array())
+                                              : QJsonValue(document.object()));
+    }
+    QCOMPARE(data, document.toJson(format));
+}
+
+void tst_QJsonStreamWriter::appendJsonValue()
+{
+    QFETCH(QJsonDocument, document);
+    QFETCH(QJsonDocument::JsonFormat, format);
+    const QJsonValue value = document.isArray() ? QJsonValue(document.array())
+                                                : QJsonValue(document.object());
+
+    // at the top level
+    QByteArray data;
+    {
+        QJsonStreamWriter writer(&data);
+        writer.setFormat(format);
+        writer.append(value);
+    }
+    QCOMPARE(data, document.toJson(format));
+
+    // nested inside containers written by the stream writer
+    data.clear();
+    {
+        QJsonStreamWriter writer(&data);
+        writer.setFormat(format);
+        writer.startArray();
+        writer.startObject();
+        writer.append(QLatin1String("value"));
+        writer.append(value);
+        QVERIFY(writer.endObject());
+        QVERIFY(writer.endArray());
+    }
+    const QJsonArray outer{ QJsonObject{ {"value", value} } };
+    QCOMPARE(data, QJsonDocument(outer).toJson(format));
+}
+
+void tst_QJsonStreamWriter::scalars_data()
+{
+    QTest::addColumn<QJsonValue>("value");
+    QTest::addColumn<QByteArray>("expected");
+
+    QTest::newRow("null") << QJsonValue(QJsonValue::Null) << QByteArray("null");
+    QTest::newRow("undefined") << QJsonValue(QJsonValue::Undefined) << QByteArray("null");
+    QTest::newRow("true") << QJsonValue(true) << QByteArray("true");
+    QTest::newRow("int") << QJsonValue(-42) << QByteArray("-42");
+    QTest::newRow("double") << QJsonValue(0.1) << QByteArray("0.1");
+    QTest::newRow("inf") << QJsonValue(qInf()) << QByteArray("null");
+    QTest::newRow("string") << QJsonValue("a\\b") << QByteArray("\"a\\\\b\"");
+}
+
+void tst_QJsonStreamWriter::scalars()
+{
+    QFETCH(QJsonValue, value);
+    QFETCH(QByteArray, expected);
+
+    QByteArray data;
+    QJsonStreamWriter writer(&data);
+    writer.append(value);
+    QCOMPARE(data, expected + '\n');
+
+    data.clear();
+    QJsonStreamWriter compactWriter(&data);
+    compactWriter.setFormat(QJsonDocument::Compact);
+    compactWriter.startArray();
+    compactWriter.append(value);
+    compactWriter.endArray();
+    QCOMPARE(data, '[' + expected + ']');
+}
+
+void tst_QJsonStreamWriter::strings()
+{
+    QByteArray data;
+    QJsonStreamWriter writer(&data);
+    writer.setFormat(QJsonDocument::Compact);
+    writer.startArray();
+    writer.append(QStringView(u"utf16 \u00e9"));
+    writer.append(QLatin1String("latin1 \xe9"));
+    writer.append("utf8 \xc3\xa9");
+    writer.append("utf8 with size", 4);
+    writer.append(QString("\"\\\b\f\n\r\t\x1f"));
+    writer.endArray();
+    QCOMPARE(data, QByteArray("[\"utf16 \xc3\xa9\",\"latin1 \xc3\xa9\",\"utf8 \xc3\xa9\",\"utf8\","
+                              "\"\\\"\\\\\\b\\f\\n\\r\\t\\u001f\"]"));
+}
+
+void tst_QJsonStreamWriter::jsonLines()
+{
+    QByteArray data;
+    QJsonStreamWriter writer(&data);
+    writer.setFormat(QJsonDocument::Compact);
+    for (int i = 0; i < 3; ++i) {
+        writer.startObject();
+        writer.append(QLatin1String("i"));
+        writer.append(i);
+        writer.endObject();
+    }
+    writer.append(nullptr);
+    QCOMPARE(data, QByteArray("{\"i\":0}\n{\"i\":1}\n{\"i\":2}\nnull"));
+
+    QJsonStreamReader reader(data);
+    int documents = 0;
+    while (!reader.atEnd()) {
+        if (reader.readNext() == QJsonStreamReader::EndDocument)
+            ++documents;
+    }
+    QVERIFY(!reader.hasError());
+    QCOMPARE(documents, 4);
+}
+
+void tst_QJsonStreamWriter::nonStringName()
+{
+    QByteArray data;
+    QJsonStreamWriter writer(&data);
+    writer.setFormat(QJsonDocument::Compact);
+    writer.startObject();
+    QTest::ignoreMessage(QtWarningMsg, "QJsonStreamWriter: object member names must be strings");
+    writer.append(1);
+    writer.append(QLatin1String("a"));
+    writer.append(true);
+    QVERIFY(writer.endObject());
+    QCOMPARE(data, QByteArray("{\"a\":true}"));
+}
+
+void tst_QJsonStreamWriter::mismatchedEnd()
+{
+    QByteArray data;
+    QJsonStreamWriter writer(&data);
+    writer.setFormat(QJsonDocument::Compact);
+    QVERIFY(!writer.endArray());
+    QVERIFY(!writer.endObject());
+
+    writer.startArray();
+    QVERIFY(!writer.endObject());
+    writer.startObject();
+    QVERIFY(!writer.endArray());
+    writer.append(QLatin1String("name"));
+    QVERIFY(!writer.endObject());   // name without value
+    writer.appendNull();
+    QVERIFY(writer.endObject());
+    QVERIFY(writer.endArray());
+    QCOMPARE(data, QByteArray("[{\"name\":null}]"));
+}
+
+void tst_QJsonStreamWriter::device()
+{
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    {
+        QJsonStreamWriter writer(&buffer);
+        QCOMPARE(writer.device(), &buffer);
+        writer.setFormat(QJsonDocument::Compact);
+        writer.startArray();
+        writer.append(1);
+        // nothing is written until the top-level value is complete
+        QCOMPARE(buffer.data(), QByteArray());
+        writer.endArray();
+        QCOMPARE(buffer.data(), QByteArray("[1]"));
+        writer.startArray();
+        writer.append(2);
+    }
+    // the rest is written by the destructor
+    QCOMPARE(buffer.data(), QByteArray("[1]\n[2"));
+
+    QByteArray data;
+    QJsonStreamWriter writer(&data);
+    QCOMPARE(writer.device(), nullptr);
+}
+
+void tst_QJsonStreamWriter::roundTrip()
+{
+    QJsonArray array;
+    for (int i = 0; i < 1000; ++i) {
+        array.append(QJsonObject{ {"index", i}, {"name", QString::number(i)},
+                                  {"values", QJsonArray{ i * 0.5, i % 2 == 0, QJsonValue::Null }} });
+    }
+    const QByteArray json = QJsonDocument(array).toJson();
+
+    // copy the document token by token
+    QByteArray copy;
+    {
+        QJsonStreamReader reader(json);
+        QJsonStreamWriter writer(&copy);
+        while (!reader.atEnd()) {
+            switch (reader.readNext()) {
+            case QJsonStreamReader::StartArray:
+                writer.startArray();
+                break;
+            case QJsonStreamReader::EndArray:
+                QVERIFY(writer.endArray());
+                break;
+            case QJsonStreamReader::StartObject:
+                writer.startObject();
+                break;
+            case QJsonStreamReader::EndObject:
+                QVERIFY(writer.endObject());
+                break;
+            case QJsonStreamReader::Name:
+                writer.append(reader.text());
+                break;
+            case QJsonStreamReader::String:
+            case QJsonStreamReader::Number:
+            case QJsonStreamReader::Bool:
+            case QJsonStreamReader::Null:
+                writer.append(reader.value());
+                break;
+            default:
+                break;
+            }
+        }
+        QVERIFY(!reader.hasError());
+    }
+    QCOMPARE(copy, json);
+}
+
+QTEST_MAIN(tst_QJsonStreamWriter)
+
+#include "tst_qjsonstreamwriter.moc"
@@ -579,6 +579,14 @@ private slots:
 
     void entityExpansionLimit() const;
 
+    void selectPaths_data() const;
+    void selectPaths() const;
+    void selectInvalidPaths_data() const;
+    void selectInvalidPaths() const;
+    void selectConsumingHandlers() const;
+    void selectWithinElement() const;
+    void selectStoppedByHandler() const;
+
 private:
     static QByteArray readFile(const QString &filename);
 
@@ -1720,5 +1728,166 @@ void tst_QXmlStream::roundTrip() const
     QCOMPARE(out, in);
 }
 
+static const char selectorDocument[] =
+        "<library xmlns:x='urn:x'>"
+        "<shelf id='1'>"
+        "<book id='a' lang='en'><title>A</title></book>"
+        "<book id='b' lang='de'><title>B</title><book id='c'><title>C</title></book></book>"
+        "</shelf>"
+        "<shelf id='2'>"
+        "<x:book id='d' lang='en'><title>D</title></x:book>"
+        "<magazine id='e'/>"
+        "</shelf>"
+        "</library>";
+
+// Returns the id of the current element, or its qualified name if it has none.
+static QString selectedElement(const QXmlStreamReader &reader)
+{
+    const QXmlStreamAttributes attributes = reader.attributes();
+    return attributes.hasAttribute(QLatin1String("id"))
+            ? attributes.value(QLatin1String("id")).toString()
+            : reader.qualifiedName().toString();
+}
+
+void tst_QXmlStream::selectPaths_data() const
+{
+    QTest::addColumn<QString>("path");
+    QTest::addColumn<QStringList>("expected");
+
+    QTest::newRow("root") << "/library" << QStringList{"library"};
+    QTest::newRow("children") << "/library/shelf" << QStringList{"1", "2"};
+    QTest::newRow("wrong root") << "/shelf" << QStringList();
+    QTest::newRow("descendants") << "//book" << QStringList{"a", "b", "c", "d"};
+    QTest::newRow("qualified name") << "//x:book" << QStringList{"d"};
+    QTest::newRow("local name") << "/library/shelf/book" << QStringList{"a", "b", "d"};
+    QTest::newRow("nested") << "//book/book" << QStringList{"c"};
+    QTest::newRow("wildcard") << "/library/*/*[@lang]" << QStringList{"a", "b", "d"};
+    QTest::newRow("any element") << "//*[@id='e']" << QStringList{"e"};
+    QTest::newRow("attribute value") << "//book[@lang='en']" << QStringList{"a", "d"};
+    QTest::newRow("double quotes") << "//book[@lang=\"de\"]/title" << QStringList{"title"};
+    QTest::newRow("spaces") << "//book[ @lang = 'en' ]" << QStringList{"a", "d"};
+    QTest::newRow("several predicates")
+            << "/library//book[@id][@lang='de']" << QStringList{"b"};
+    QTest::newRow("descendants of descendants")
+            << "//shelf//title" << QStringList{"title", "title", "title", "title"};
+    QTest::newRow("no match") << "//nothing" << QStringList();
+}
+
+void tst_QXmlStream::selectPaths() const
+{
+    QFETCH(QString, path);
+    QFETCH(QStringList, expected);
+
+    QStringList selected;
+    QXmlStreamSelector selector;
+    QVERIFY2(selector.addPath(path, [&](QXmlStreamReader &reader) {
+                 selected << selectedElement(reader);
+             }), qPrintable(selector.errorString()));
+    QVERIFY(selector.errorString().isEmpty());
+
+    QXmlStreamReader reader(selectorDocument);
+    QVERIFY(selector.select(&reader));
+    QCOMPARE(selected, expected);
+    QVERIFY(reader.atEnd());
+}
+
+void tst_QXmlStream::selectInvalidPaths_data() const
+{
+    QTest::addColumn<QString>("path");
+
+    QTest::newRow("empty") << "";
+    QTest::newRow("relative") << "book";
+    QTest::newRow("no name") << "/";
+    QTest::newRow("no descendant name") << "//";
+    QTest::newRow("space in name") << "/a b";
+    QTest::newRow("unterminated predicate") << "/book[";
+    QTest::newRow("no attribute name") << "/book[@]";
+    QTest::newRow("no @") << "/book[lang]";
+    QTest::newRow("unquoted value") << "/book[@lang=en]";
+    QTest::newRow("unterminated value") << "/book[@lang='en";
+    QTest::newRow("no opening bracket") << "/book]";
+}
+
+void tst_QXmlStream::selectInvalidPaths() const
+{
+    QFETCH(QString, path);
+
+    bool called = false;
+    QXmlStreamSelector selector;
+    QVERIFY(selector.addPath("//book", [&](QXmlStreamReader &) { called = true; }));
+    QVERIFY(!selector.addPath(path, [](QXmlStreamReader &) { QFAIL("Unexpected match"); }));
+    QVERIFY(!selector.errorString().isEmpty());
+
+    // the valid path is still evaluated
+    QXmlStreamReader reader(selectorDocument);
+    QVERIFY(selector.select(&reader));
+    QVERIFY(called);
+}
+
+void tst_QXmlStream::selectConsumingHandlers() const
+{
+    QStringList selected;
+    QStringList titles;
+    QXmlStreamSelector selector;
+    QVERIFY(selector.addPath("//book", [&](QXmlStreamReader &reader) {
+        selected << selectedElement(reader);
+        reader.skipCurrentElement();
+    }));
+    QVERIFY(selector.addPath("//*[@id]", [&](QXmlStreamReader &reader) {
+        selected << QLatin1Char('*') + selectedElement(reader);
+    }));
+
+    QXmlStreamReader reader(selectorDocument);
+    QVERIFY(selector.select(&reader));
+    // the handlers after the one consuming a book and the books inside it are skipped
+    QCOMPARE(selected, QStringList({"*1", "a", "b", "*2", "d", "*e"}));
+
+    selector.clear();
+    QVERIFY(selector.addPath("//title", [&](QXmlStreamReader &reader) {
+        titles << reader.readElementText();
+    }));
+    reader.clear();
+    reader.addData(selectorDocument);
+    QVERIFY(selector.select(&reader));
+    QCOMPARE(titles, QStringList({"A", "B", "C", "D"}));
+}
+
+void tst_QXmlStream::selectWithinElement() const
+{
+    QStringList selected;
+    QXmlStreamSelector selector;
+    QVERIFY(selector.addPath("/book", [&](QXmlStreamReader &reader) {
+        selected << selectedElement(reader);
+    }));
+
+    QXmlStreamReader reader(selectorDocument);
+    QVERIFY(reader.readNextStartElement());
+    QVERIFY(reader.readNextStartElement());
+    QCOMPARE(selectedElement(reader), QLatin1String("1"));
+
+    QVERIFY(selector.select(&reader));
+    QCOMPARE(selected, QStringList({"a", "b"}));
+    QVERIFY(reader.isEndElement());
+    QCOMPARE(reader.name(), QLatin1String("shelf"));
+
+    QVERIFY(reader.readNextStartElement());
+    QCOMPARE(selectedElement(reader), QLatin1String("2"));
+}
+
+void tst_QXmlStream::selectStoppedByHandler() const
+{
+    QStringList selected;
+    QXmlStreamSelector selector;
+    QVERIFY(selector.addPath("//book", [&](QXmlStreamReader &reader) {
+        selected << selectedElement(reader);
+        reader.raiseError(QLatin1String("Found it"));
+    }));
+
+    QXmlStreamReader reader(selectorDocument);
+    QVERIFY(!selector.select(&reader));
+    QCOMPARE(selected, QStringList{"a"});
+    QCOMPARE(reader.errorString(), QLatin1String("Found it"));
+}
+
 #include "tst_qxmlstream.moc"
 // vim: et:ts=4:sw=4:sts=4
@@ -1,10 +1,14 @@
 TEMPLATE = subdirs
 SUBDIRS = \
     json \
+    qcborgadgetserializer \
     qcborstreamreader \
     qcborstreamwriter \
     qcborvalue \
     qcborvalue_json \
+    qcborvalueview \
+    qjsonstreamreader \
+    qjsonstreamwriter \
     qdatastream \
     qdatastream_core_pixmap \
     qtextstream \
@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_qdatetimeformatter
+QT = core testlib
+SOURCES = tst_qdatetimeformatter.cpp
+DEFINES += QT_NO_KEYWORDS QT_NO_FOREACH
@@ -0,0 +1,320 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/qdatetimeformatter.h>
+#if QT_CONFIG(timezone)
+#  include <QtCore/qtimezone.h>
+#endif
+
+#include <iterator>
+
+class tst_QDateTimeFormatter : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void defaultConstructed();
+    void toString_data();
+    void toString();
+    void toStringDateFormat_data();
+    void toStringDateFormat();
+    void formatTo();
+    void fromString_data();
+    void fromString();
+    void fromStringIso_data();
+    void fromStringIso();
+    void copies();
+};
+
+void tst_QDateTimeFormatter::defaultConstructed()
+{
+    QDateTimeFormatter formatter;
+    QVERIFY(!formatter.isValid());
+    QVERIFY(formatter.toString(QDateTime::currentDateTime()).isNull());
+    QVERIFY(!formatter.fromString(u"2020-01-01T00:00:00").isValid());
+    QChar buffer[4];
+    QCOMPARE(formatter.formatTo(QDateTime::currentDateTime(), buffer, std::size(buffer)), 0);
+
+    QVERIFY(QDateTimeFormatter(u"").isValid());
+    QVERIFY(QDateTimeFormatter(Qt::ISODate).isValid());
+}
+
+static void addDateTimes(const char *format)
+{
+    const QDateTime samples[] = {
+        QDateTime(QDate(2001, 5, 21), QTime(14, 13, 9, 120)),
+        QDateTime(QDate(2001, 5, 21), QTime(0, 0, 0, 5), Qt::UTC),
+        QDateTime(QDate(1999, 12, 31), QTime(23, 59, 59, 999), Qt::OffsetFromUTC, -5 * 3600 - 1800),
+        QDateTime(QDate(12, 2, 29), QTime(12, 30), Qt::OffsetFromUTC, 3600),
+        QDateTime(QDate(-5, 1, 1), QTime(1, 2, 3), Qt::UTC),
+        QDateTime(QDate(12345, 6, 7), QTime(8, 9, 10, 100), Qt::UTC),
+#if QT_CONFIG(timezone)
+        QDateTime(QDate(2020, 7, 1), QTime(18, 0), QTimeZone("Europe/Oslo")),
+#endif
+    };
+    for (const QDateTime &dt : samples) {
+        QTest::addRow("%s %s", format, qPrintable(dt.toString(Qt::ISODateWithMs)))
+            << QString::fromLatin1(format) << dt;
+    }
+}
+
+void tst_QDateTimeFormatter::toString_data()
+{
+    QTest::addColumn<QString>("format");
+    QTest::addColumn<QDateTime>("dateTime");
+
+    const char *formats[] = {
+        "dd.MM.yyyy",
+        "ddd MMMM d yy",
+        "dddd MMM d y yyy yyyyy",
+        "hh:mm:ss.zzz",
+        "hh:mm:ss.z zz",
+        "h:m:s ap",
+        "H:m:s AP",
+        "hh 'o''clock' A",
+        "yyyy-MM-dd HH:mm:ss t",
+        "'quoted ''text''' x",
+        "MMMMM dddddd hhh mmm sss zzzz",
+        "",
+    };
+    for (const char *format : formats)
+        addDateTimes(format);
+}
+
+void tst_QDateTimeFormatter::toString()
+{
+    QFETCH(QString, format);
+    QFETCH(QDateTime, dateTime);
+
+    const QDateTimeFormatter formatter(format);
+    QCOMPARE(formatter.toString(dateTime), dateTime.toString(format));
+    QVERIFY(formatter.toString(QDateTime()).isNull());
+}
+
+void tst_QDateTimeFormatter::toStringDateFormat_data()
+{
+    QTest::addColumn<Qt::DateFormat>("format");
+    QTest::addColumn<QDateTime>("dateTime");
+
+    const QDateTime samples[] = {
+        QDateTime(QDate(2001, 5, 21), QTime(14, 13, 9, 120)),
+        QDateTime(QDate(2001, 5, 21), QTime(0, 0, 0, 5), Qt::UTC),
+        QDateTime(QDate(1999, 12, 31), QTime(23, 59, 59, 999), Qt::OffsetFromUTC, -5 * 3600 - 1800),
+        QDateTime(QDate(12, 2, 29), QTime(12, 30), Qt::OffsetFromUTC, 3600),
+        QDateTime(QDate(-5, 1, 1), QTime(1, 2, 3), Qt::UTC),
+        QDateTime(QDate(12345, 6, 7), QTime(8, 9, 10, 100), Qt::UTC),
+#if QT_CONFIG(timezone)
+        QDateTime(QDate(2020, 7, 1), QTime(18, 0), QTimeZone("Europe/Oslo")),
+#endif
+    };
+    const struct {
+        Qt::DateFormat format;
+        const char *name;
+    } formats[] = {
+        { Qt::ISODate, "ISODate" },
+        { Qt::ISODateWithMs, "ISODateWithMs" },
+        { Qt::RFC2822Date, "RFC2822Date" },
+        { Qt::TextDate, "TextDate" },
+    };
+    for (const auto &format : formats) {
+        for (const QDateTime &dt : samples) {
+            QTest::addRow("%s %s", format.name, qPrintable(dt.toString(Qt::ISODateWithMs)))
+                << format.format << dt;
+        }
+    }
+}
+
+void tst_QDateTimeFormatter::toStringDateFormat()
+{
+    QFETCH(Qt::DateFormat, format);
+    QFETCH(QDateTime, dateTime);
+
+    const QDateTimeFormatter formatter(format);
+    const QString expected = dateTime.toString(format);
+    QCOMPARE(formatter.toString(dateTime), expected);
+    QCOMPARE(formatter.toString(dateTime).isNull(), expected.isNull());
+}
+
+void tst_QDateTimeFormatter::formatTo()
+{
+    const QDateTimeFormatter formatter(Qt::ISODateWithMs);
+    const QDateTime dt(QDate(2001, 5, 21), QTime(14, 13, 9, 120), Qt::UTC);
+    const QString expected = QStringLiteral("2001-05-21T14:13:09.120Z");
+
+    QChar buffer[32];
+    std::fill(std::begin(buffer), std::end(buffer), QChar(u'#'));
+    qsizetype length = formatter.formatTo(dt, buffer, std::size(buffer));
+    QCOMPARE(length, expected.size());
+    QCOMPARE(QStringView(buffer, length), expected);
+    QCOMPARE(buffer[length], QChar(u'#'));
+
+    // truncated: the length is still reported and nothing is written past the end
+    std::fill(std::begin(buffer), std::end(buffer), QChar(u'#'));
+    length = formatter.formatTo(dt, buffer, 10);
+    QCOMPARE(length, expected.size());
+    QCOMPARE(QStringView(buffer, 10), QStringView(expected).first(10));
+    QCOMPARE(buffer[10], QChar(u'#'));
+    QCOMPARE(formatter.formatTo(dt, nullptr, 0), expected.size());
+
+    // years ISO 8601 cannot represent
+    const QDateTime outOfRange(QDate(10000, 1, 1), QTime(0, 0), Qt::UTC);
+    QCOMPARE(formatter.formatTo(outOfRange, buffer, std::size(buffer)), 0);
+    QVERIFY(formatter.toString(outOfRange).isNull());
+
+    // longer than the internal buffer of toString()
+    const QString longFormat = QStringLiteral("dddd, MMMM d yyyy").repeated(8);
+    const QDateTimeFormatter custom(longFormat);
+    QCOMPARE(custom.toString(dt), dt.toString(longFormat));
+    QCOMPARE(custom.formatTo(dt, buffer, std::size(buffer)), dt.toString(longFormat).size());
+    QCOMPARE(QStringView(buffer, std::size(buffer)),
+             QStringView(dt.toString(longFormat)).first(std::size(buffer)));
+
+    // Qt::TextDate is delegated to QDateTime
+    const QDateTimeFormatter text(Qt::TextDate);
+    length = text.formatTo(dt, buffer, std::size(buffer));
+    QCOMPARE(length, dt.toString(Qt::TextDate).size());
+    QCOMPARE(QStringView(buffer, length), dt.toString(Qt::TextDate));
+}
+
+void tst_QDateTimeFormatter::fromString_data()
+{
+    QTest::addColumn<QString>("format");
+    QTest::addColumn<QString>("string");
+
+    QTest::newRow("date-time")
+        << QStringLiteral("yyyy-MM-dd hh:mm:ss.zzz") << QStringLiteral("2010-01-01 13:12:11.999");
+    QTest::newRow("names")
+        << QStringLiteral("ddd MMM d yyyy h:mm AP") << QStringLiteral("Fri Jan 1 2010 1:12 PM");
+    QTest::newRow("quoted")
+        << QStringLiteral("'day' d 'of' M, yy") << QStringLiteral("day 5 of 7, 20");
+    QTest::newRow("offset")
+        << QStringLiteral("yyyyMMddhhmmss t") << QStringLiteral("20200701180000 UTC+02:00");
+    QTest::newRow("mismatch")
+        << QStringLiteral("yyyy-MM-dd") << QStringLiteral("2010/01/01");
+    QTest::newRow("invalid-date")
+        << QStringLiteral("yyyy-MM-dd") << QStringLiteral("2010-02-30");
+    QTest::newRow("empty")
+        << QStringLiteral("yyyy-MM-dd") << QString();
+}
+
+void tst_QDateTimeFormatter::fromString()
+{
+    QFETCH(QString, format);
+    QFETCH(QString, string);
+
+    const QDateTimeFormatter formatter(format);
+    const QDateTime expected = QDateTime::fromString(string, format);
+    const QDateTime parsed = formatter.fromString(string);
+    QCOMPARE(parsed, expected);
+    QCOMPARE(parsed.isValid(), expected.isValid());
+    QCOMPARE(parsed.timeSpec(), expected.timeSpec());
+    // parsing twice with the same formatter must not be affected by the first run
+    QCOMPARE(formatter.fromString(string), expected);
+}
+
+void tst_QDateTimeFormatter::fromStringIso_data()
+{
+    QTest::addColumn<Qt::DateFormat>("format");
+    QTest::addColumn<QString>("string");
+
+    const char *strings[] = {
+        "2010-01-01T13:28:34",
+        "2010-01-01T13:28:34.999",
+        "2010-01-01T13:28:34.999Z",
+        "2010-01-01t13:28:34z",
+        "2010-01-01 13:28:34+05:30",
+        "2010-01-01T13:28:34.5-08:00",
+        "2010-01-01T13:28:34,250Z",
+        "2010-01-01T13:28Z",
+        "2010-01-01T24:00:00",
+        "2010-01-01T23:59:59.9999",
+        "2010-01-01",
+        "2010-02-29T00:00:00Z",
+        "2010-13-01T00:00:00Z",
+        "2010-01-01T25:00:00Z",
+        "2010-01-01T12:00:60Z",
+        "2010-01-01T12:00:00+0530",
+        "2010-01-01T12:00:00+25:00",
+        "2010-01-01T12:00:00.12x",
+        "2010-01-01X12:00:00",
+        "20x0-01-01T12:00:00",
+        "",
+    };
+    for (const char *string : strings) {
+        QTest::addRow("ISODate %s", string) << Qt::ISODate << QString::fromLatin1(string);
+        QTest::addRow("ISODateWithMs %s", string) << Qt::ISODateWithMs << QString::fromLatin1(string);
+    }
+    QTest::addRow("RFC2822Date")
+        << Qt::RFC2822Date << QStringLiteral("Thu, 01 Jan 1970 00:12:34 +0000");
+    QTest::addRow("TextDate") << Qt::TextDate << QStringLiteral("Wed Jan 2 01:02:03.000 2013 GMT");
+}
+
+void tst_QDateTimeFormatter::fromStringIso()
+{
+    QFETCH(Qt::DateFormat, format);
+    QFETCH(QString, string);
+
+    const QDateTimeFormatter formatter(format);
+    const QDateTime expected = QDateTime::fromString(string, format);
+    const QDateTime parsed = formatter.fromString(string);
+    QCOMPARE(parsed, expected);
+    QCOMPARE(parsed.isValid(), expected.isValid());
+    QCOMPARE(parsed.timeSpec(), expected.timeSpec());
+    QCOMPARE(parsed.offsetFromUtc(), expected.offsetFromUtc());
+
+    // and back again; Qt::ISODate drops the milliseconds, as QDateTime does
+    if (parsed.isValid() && format != Qt::TextDate) {
+        const QString formatted = formatter.toString(parsed);
+        QCOMPARE(formatted, parsed.toString(format));
+        QCOMPARE(formatter.fromString(formatted), QDateTime::fromString(formatted, format));
+    }
+}
+
+void tst_QDateTimeFormatter::copies()
+{
+    QDateTimeFormatter formatter(u"yyyy-MM-dd");
+    QDateTimeFormatter copy = formatter;
+    const QDateTime dt(QDate(2020, 7, 1), QTime(0, 0));
+    QCOMPARE(copy.toString(dt), QStringLiteral("2020-07-01"));
+    QCOMPARE(copy.fromString(u"2020-07-01"), dt);
+
+    QDateTimeFormatter moved = std::move(formatter);
+    QCOMPARE(moved.toString(dt), QStringLiteral("2020-07-01"));
+
+    QDateTimeFormatter other(Qt::ISODate);
+    other.swap(copy);
+    QCOMPARE(other.toString(dt), QStringLiteral("2020-07-01"));
+    QCOMPARE(copy.toString(dt), QStringLiteral("2020-07-01T00:00:00"));
+
+    copy = QDateTimeFormatter();
+    QVERIFY(!copy.isValid());
+}
+
+QTEST_APPLESS_MAIN(tst_QDateTimeFormatter)
+#include "tst_qdatetimeformatter.moc"
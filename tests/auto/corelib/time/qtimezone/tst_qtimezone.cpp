@@ -58,6 +58,8 @@ private Q_SLOTS:
     void transitionEachZone();
     void checkOffset_data();
     void checkOffset();
+    void offsetsMatchTransitions_data();
+    void offsetsMatchTransitions();
     void stressTest();
     void windowsId();
     void isValidId_data();
@@ -677,6 +679,47 @@ void tst_QTimeZone::checkOffset()
     QCOMPARE(zone.isDaylightTime(when), dstOffset != 0);
 }
 
+void tst_QTimeZone::offsetsMatchTransitions_data()
+{
+    QTest::addColumn<QByteArray>("zoneName");
+
+    const char *zones[] = {
+        "Europe/Oslo", "America/Sao_Paulo", "Australia/Sydney", "Pacific/Apia",
+        "Asia/Kathmandu", "America/Vancouver", "Etc/UTC"
+    };
+    for (const char *zone : zones) {
+        if (QTimeZone(zone).isValid())
+            QTest::newRow(zone) << QByteArray(zone);
+        else
+            qWarning("Skipping %s test as zone is invalid", zone);
+    }
+}
+
+void tst_QTimeZone::offsetsMatchTransitions()
+{
+    // Lookups of offsets take short-cuts through the transition tables; check
+    // they agree with the transitions themselves, well past the last one that
+    // tz database files list explicitly.
+    QFETCH(QByteArray, zoneName);
+    const QTimeZone zone(zoneName);
+    QVERIFY(zone.isValid());
+
+    const QDateTime start = QDate(1900, 1, 1).startOfDay(Qt::UTC);
+    const QDateTime end = QDate(2100, 1, 1).startOfDay(Qt::UTC);
+    const QTimeZone::OffsetDataList transitions = zone.transitions(start, end);
+    for (int i = 0; i + 1 < transitions.size(); ++i) {
+        const QTimeZone::OffsetData &tran = transitions.at(i);
+        const qint64 from = tran.atUtc.toMSecsSinceEpoch();
+        const qint64 to = transitions.at(i + 1).atUtc.toMSecsSinceEpoch();
+        for (qint64 when : { from, from + (to - from) / 2, to - 1 }) {
+            const QDateTime at = QDateTime::fromMSecsSinceEpoch(when, Qt::UTC);
+            QCOMPARE(zone.offsetFromUtc(at), tran.offsetFromUtc);
+            QCOMPARE(zone.standardTimeOffset(at), tran.standardTimeOffset);
+            QCOMPARE(zone.daylightTimeOffset(at), tran.daylightTimeOffset);
+        }
+    }
+}
+
 void tst_QTimeZone::availableTimeZoneIds()
 {
     if (debug) {
@@ -3,6 +3,7 @@ SUBDIRS = \
     qcalendar \
     qdate \
     qdatetime \
+    qdatetimeformatter \
     qdatetimeparser \
     qtime
 qtConfig(timezone): SUBDIRS += qtimezone
@@ -52,6 +52,7 @@ private slots:
     void ungetChar();
     void indexOf();
     void appendAndRead();
+    void dataBlocks();
     void peek();
     void readLine();
 };
@@ -364,6 +365,30 @@ void tst_QRingBuffer::appendAndRead()
     QCOMPARE(ringBuffer.read(), ba3);
 }
 
+void tst_QRingBuffer::dataBlocks()
+{
+    QRingBuffer ringBuffer;
+    QByteArrayView blocks[4];
+    QCOMPARE(ringBuffer.dataBlocks(blocks, 4), 0);
+
+    const QByteArray ba1("Hello world!");
+    const QByteArray ba2("Test string.");
+    const QByteArray ba3("0123456789");
+    ringBuffer.append(ba1);
+    ringBuffer.append(ba2);
+    ringBuffer.append(ba3);
+    ringBuffer.free(6);
+
+    QCOMPARE(ringBuffer.dataBlocks(blocks, 4), 3);
+    QCOMPARE(blocks[0], QByteArrayView("world!"));
+    // appended byte arrays are shared, not copied
+    QCOMPARE(blocks[1].data(), ba2.constData());
+    QCOMPARE(blocks[2].data(), ba3.constData());
+
+    QCOMPARE(ringBuffer.dataBlocks(blocks, 2), 2);
+    QCOMPARE(blocks[1], QByteArrayView(ba2));
+}
+
 void tst_QRingBuffer::peek()
 {
     QRingBuffer ringBuffer;
@@ -201,6 +201,8 @@ private slots:
     void serverDisconnectWithBuffered();
     void socketDiscardDataInWriteMode();
     void writeOnReadBufferOverflow();
+    void writeChunks_data();
+    void writeChunks();
     void readNotificationsAfterBind();
 
 protected slots:
@@ -3217,5 +3219,64 @@ void tst_QTcpSocket::readNotificationsAfterBind()
     QCOMPARE(spyReadyRead.count(), 0);
 }
 
+void tst_QTcpSocket::writeChunks_data()
+{
+    QTest::addColumn<bool>("buffered");
+    QTest::addColumn<int>("chunkSize");
+
+    QTest::newRow("buffered") << true << 1000;
+    QTest::newRow("buffered-large") << true << 2 * 1024 * 1024;
+    QTest::newRow("unbuffered") << false << 1000;
+    // larger than the socket buffers, so the gather write is partial
+    QTest::newRow("unbuffered-large") << false << 2 * 1024 * 1024;
+}
+
+void tst_QTcpSocket::writeChunks()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return; // proxy not useful for localhost test case
+    QFETCH(bool, buffered);
+    QFETCH(int, chunkSize);
+
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QTcpSocket socket;
+    QIODevice::OpenMode mode = QIODevice::ReadWrite;
+    if (!buffered)
+        mode |= QIODevice::Unbuffered;
+    socket.connectToHost(server.serverAddress(), server.serverPort(), mode);
+    QVERIFY(socket.waitForConnected(5000));
+    QVERIFY(server.waitForNewConnection(5000));
+    QScopedPointer<QTcpSocket> peer(server.nextPendingConnection());
+    QVERIFY(peer);
+    socket.setSocketOption(QAbstractSocket::SendBufferSizeSocketOption, 8192);
+
+    QList<QByteArray> chunks = { QByteArray("HEADER"), QByteArray() };
+    for (int i = 0; i < 8; ++i)
+        chunks.append(QByteArray(chunkSize, char('a' + i)));
+    chunks.append(QByteArray("TRAILER"));
+    QByteArray expected;
+    for (const QByteArray &chunk : chunks)
+        expected += chunk;
+
+    QByteArray received;
+    connect(peer.data(), &QIODevice::readyRead, this, [&] { received += peer->readAll(); });
+
+    QCOMPARE(socket.write(chunks), qint64(expected.size()));
+    if (!buffered && chunkSize > 1024 * 1024)
+        QVERIFY(socket.bytesToWrite() > 0);
+
+    // a second batch is appended to what is still buffered
+    QCOMPARE(socket.write({ QByteArray("END") }), qint64(3));
+    expected += "END";
+
+    QTRY_COMPARE_WITH_TIMEOUT(received.size(), expected.size(), 30000);
+    QCOMPARE(received, expected);
+    QCOMPARE(socket.bytesToWrite(), qint64(0));
+    QCOMPARE(socket.error(), QAbstractSocket::UnknownSocketError);
+}
+
 QTEST_MAIN(tst_QTcpSocket)
 #include "tst_qtcpsocket.moc"
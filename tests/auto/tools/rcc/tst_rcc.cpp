@@ -40,6 +40,8 @@
 #include <QtCore/QResource>
 #include <QtCore/QLocale>
 #include <QtCore/QtGlobal>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QtEndian>
 
 #include <algorithm>
 
@@ -86,6 +88,9 @@ private slots:
     void binary_data();
     void binary();
 
+    void corruptPathIndex_data();
+    void corruptPathIndex();
+
     void readback_data();
     void readback();
 
@@ -276,51 +281,57 @@ void tst_rcc::binary_data()
         iter.next();
         QFileInfo qrcFileInfo = iter.fileInfo();
         QString absoluteBaseName = QFileInfo(qrcFileInfo.absolutePath(), qrcFileInfo.baseName()).absoluteFilePath();
-        QString rccFileName = absoluteBaseName + QLatin1String(".rcc");
-
-        // same as above: force no compression
-        QProcess rccProcess;
-        rccProcess.setWorkingDirectory(dataPath);
-        rccProcess.start(m_rcc, { "-binary", "-no-compress", "-o", rccFileName, qrcFileInfo.absoluteFilePath() });
-        QVERIFY2(rccProcess.waitForStarted(), msgProcessStartFailed(rccProcess).constData());
-        if (!rccProcess.waitForFinished()) {
-            rccProcess.kill();
-            QFAIL(msgProcessTimeout(rccProcess).constData());
-        }
-        QVERIFY2(rccProcess.exitStatus() == QProcess::NormalExit,
-                 msgProcessCrashed(rccProcess).constData());
-        QVERIFY2(rccProcess.exitCode() == 0,
-                 msgProcessFailed(rccProcess).constData());
-
-        QByteArray output = rccProcess.readAllStandardOutput();
-        if (!output.isEmpty())
-            qWarning("rcc stdout: %s", output.constData());
-
-        output = rccProcess.readAllStandardError();
-        if (!output.isEmpty())
-            qWarning("rcc stderr: %s", output.constData());
-
-        QString localeFileName = absoluteBaseName + QLatin1String(".locale");
-        QFile localeFile(localeFileName);
-        if (localeFile.exists()) {
-            QStringList locales = readLinesFromFile(localeFileName, Qt::SkipEmptyParts);
-            foreach (const QString &locale, locales) {
-                QString expectedFileName = QString::fromLatin1("%1.%2.%3").arg(absoluteBaseName, locale, QLatin1String("expected"));
-                QStringMap expectedFiles = readExpectedFiles(expectedFileName);
-                QTest::newRow(qPrintable(qrcFileInfo.baseName() + QLatin1Char('_') + locale)) << rccFileName
-                                                                                              << QLocale(locale)
-                                                                                              << dataPath
-                                                                                              << expectedFiles;
+
+        // format version 4 adds the path index, which must not change lookups
+        for (const char *formatVersion : { "3", "4" }) {
+            const QString suffix = QLatin1String("_v") + QLatin1String(formatVersion);
+            QString rccFileName = absoluteBaseName + suffix + QLatin1String(".rcc");
+
+            // same as above: force no compression
+            QProcess rccProcess;
+            rccProcess.setWorkingDirectory(dataPath);
+            rccProcess.start(m_rcc, { "-binary", "-no-compress", "--format-version", formatVersion,
+                                      "-o", rccFileName, qrcFileInfo.absoluteFilePath() });
+            QVERIFY2(rccProcess.waitForStarted(), msgProcessStartFailed(rccProcess).constData());
+            if (!rccProcess.waitForFinished()) {
+                rccProcess.kill();
+                QFAIL(msgProcessTimeout(rccProcess).constData());
+            }
+            QVERIFY2(rccProcess.exitStatus() == QProcess::NormalExit,
+                     msgProcessCrashed(rccProcess).constData());
+            QVERIFY2(rccProcess.exitCode() == 0,
+                     msgProcessFailed(rccProcess).constData());
+
+            QByteArray output = rccProcess.readAllStandardOutput();
+            if (!output.isEmpty())
+                qWarning("rcc stdout: %s", output.constData());
+
+            output = rccProcess.readAllStandardError();
+            if (!output.isEmpty())
+                qWarning("rcc stderr: %s", output.constData());
+
+            QString localeFileName = absoluteBaseName + QLatin1String(".locale");
+            QFile localeFile(localeFileName);
+            if (localeFile.exists()) {
+                QStringList locales = readLinesFromFile(localeFileName, Qt::SkipEmptyParts);
+                foreach (const QString &locale, locales) {
+                    QString expectedFileName = QString::fromLatin1("%1.%2.%3").arg(absoluteBaseName, locale, QLatin1String("expected"));
+                    QStringMap expectedFiles = readExpectedFiles(expectedFileName);
+                    QTest::newRow(qPrintable(qrcFileInfo.baseName() + QLatin1Char('_') + locale + suffix)) << rccFileName
+                                                                                                  << QLocale(locale)
+                                                                                                  << dataPath
+                                                                                                  << expectedFiles;
+                }
             }
-        }
 
-        // always test for the C locale as well
-        QString expectedFileName = absoluteBaseName + QLatin1String(".expected");
-        QStringMap expectedFiles = readExpectedFiles(expectedFileName);
-        QTest::newRow(qPrintable(qrcFileInfo.baseName() + QLatin1String("_C"))) << rccFileName
-                                                                                << QLocale::c()
-                                                                                << dataPath
-                                                                                << expectedFiles;
+            // always test for the C locale as well
+            QString expectedFileName = absoluteBaseName + QLatin1String(".expected");
+            QStringMap expectedFiles = readExpectedFiles(expectedFileName);
+            QTest::newRow(qPrintable(qrcFileInfo.baseName() + QLatin1String("_C") + suffix)) << rccFileName
+                                                                                    << QLocale::c()
+                                                                                    << dataPath
+                                                                                    << expectedFiles;
+        }
     }
 }
 
@@ -385,6 +396,96 @@ void tst_rcc::binary()
     QLocale::setDefault(oldDefaultLocale);
 }
 
+void tst_rcc::corruptPathIndex_data()
+{
+    QTest::addColumn<QString>("part");
+    QTest::addColumn<quint32>("value");
+    QTest::addColumn<bool>("found");
+
+    // an inconsistent index header is ignored, so the tree is walked instead
+    QTest::newRow("no buckets") << "bucket count" << 0u << true;
+    QTest::newRow("no slots") << "slot count" << 0u << true;
+    QTest::newRow("too many nodes") << "node count" << 0x0fffffffu << true;
+    QTest::newRow("too many buckets") << "bucket count" << 0x0fffffffu << true;
+    QTest::newRow("too many slots") << "slot count" << 0x0fffffffu << true;
+    // node numbers out of range are not used
+    QTest::newRow("slots out of range") << "slots" << 0x7fffffffu << false;
+    QTest::newRow("parents out of range") << "parents" << 0x7fffffffu << false;
+}
+
+void tst_rcc::corruptPathIndex()
+{
+    QFETCH(QString, part);
+    QFETCH(quint32, value);
+    QFETCH(bool, found);
+
+    const QString dataPath = m_dataPath + QLatin1String("/binary/");
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString rccFileName = tempDir.filePath(QLatin1String("allfeatures.rcc"));
+
+    QProcess rccProcess;
+    rccProcess.setWorkingDirectory(dataPath);
+    rccProcess.start(m_rcc, { "-binary", "-no-compress", "--format-version", "4",
+                              "-o", rccFileName, dataPath + QLatin1String("allfeatures.qrc") });
+    QVERIFY2(rccProcess.waitForStarted(), msgProcessStartFailed(rccProcess).constData());
+    if (!rccProcess.waitForFinished()) {
+        rccProcess.kill();
+        QFAIL(msgProcessTimeout(rccProcess).constData());
+    }
+    QVERIFY2(rccProcess.exitCode() == 0, msgProcessFailed(rccProcess).constData());
+
+    QFile rccFile(rccFileName);
+    QVERIFY(rccFile.open(QIODevice::ReadWrite));
+    QByteArray data = rccFile.readAll();
+    uchar *header = reinterpret_cast<uchar *>(data.data());
+    const qint32 treeOffset = qFromBigEndian<qint32>(header + 8);
+    const qint32 indexOffset = treeOffset + qFromBigEndian<qint32>(header + treeOffset);
+    QVERIFY(indexOffset > treeOffset && indexOffset + 12 <= data.size());
+    uchar *index = header + indexOffset;
+    const quint32 nodeCount = qFromBigEndian<quint32>(index);
+    const quint32 bucketCount = qFromBigEndian<quint32>(index + 4);
+    const quint32 slotCount = qFromBigEndian<quint32>(index + 8);
+
+    qsizetype first = 0;
+    qsizetype count = 1;
+    if (part == QLatin1String("bucket count")) {
+        first = 1;
+    } else if (part == QLatin1String("slot count")) {
+        first = 2;
+    } else if (part == QLatin1String("slots")) {
+        first = 3 + bucketCount;
+        count = slotCount;
+    } else if (part == QLatin1String("parents")) {
+        first = 3 + bucketCount + slotCount;
+        count = nodeCount;
+    }
+    QVERIFY(indexOffset + 4 * (first + count) <= data.size());
+    for (qsizetype i = first; i < first + count; ++i)
+        qToBigEndian(value, index + 4 * i);
+    QVERIFY(rccFile.seek(0));
+    QCOMPARE(rccFile.write(data), data.size());
+    rccFile.close();
+
+    const QString rootPrefix = QLatin1String("/corrupt_root/");
+    QVERIFY(QResource::registerResource(rccFileName, rootPrefix));
+    {
+        const QString resourceFileName = QLatin1Char(':') + rootPrefix
+                + QLatin1String("test/abc/123/+++/subdir/subdir.txt");
+        QCOMPARE(QFile::exists(resourceFileName), found);
+        if (found) {
+            QFile resourceFile(resourceFileName);
+            QVERIFY(resourceFile.open(QIODevice::ReadOnly));
+            QFile actualFile(dataPath + QLatin1String("subdir/subdir.txt"));
+            QVERIFY(actualFile.open(QIODevice::ReadOnly));
+            QCOMPARE(resourceFile.readAll(), actualFile.readAll());
+        }
+        QVERIFY(!QFile::exists(QLatin1Char(':') + rootPrefix
+                               + QLatin1String("test/abc/123/+++/missing.txt")));
+    }
+    QVERIFY(QResource::unregisterResource(rccFileName, rootPrefix));
+}
+
 void tst_rcc::readback_data()
 {
     QTest::addColumn<QString>("resourceName");
@@ -500,6 +601,8 @@ void tst_rcc::cleanupTestCase()
     QFileInfoList entries = dataDir.entryInfoList(QStringList() << QLatin1String("*.rcc"));
     QDir dataDepDir(m_dataPath + QLatin1String("/depfile"));
     entries += dataDepDir.entryInfoList({QLatin1String("*.d"), QLatin1String("*.qrc.cpp")});
+    QDir dataSizesDir(m_dataPath + QLatin1String("/sizes"));
+    entries += dataSizesDir.entryInfoList(QStringList() << QLatin1String("*.rcc"));
     foreach (const QFileInfo &entry, entries)
         QFile::remove(entry.absoluteFilePath());
 }
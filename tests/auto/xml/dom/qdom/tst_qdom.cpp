@@ -77,6 +77,8 @@ private slots:
     void ownerElementTask45192_data();
     void ownerElementTask45192();
     void domNodeMapAndList();
+    void namedNodeMap_data();
+    void namedNodeMap();
 
     void nullDocument();
     void invalidName_data();
@@ -117,6 +119,7 @@ private slots:
     void DTDNotationDecl();
     void DTDEntityDecl();
     void QTBUG49113_dontCrashWithNegativeIndex() const;
+    void nodesOutliveDocument() const;
 
     void cleanupTestCase() const;
 
@@ -1208,6 +1211,70 @@ void tst_QDom::domNodeMapAndList()
     QCOMPARE(list.item(1).nodeName(), QString()); // Make sure we don't assert
 }
 
+void tst_QDom::namedNodeMap_data()
+{
+    QTest::addColumn<int>("attributeCount");
+
+    // maps with more than a few nodes index them by name
+    QTest::newRow("few") << 3;
+    QTest::newRow("threshold") << 8;
+    QTest::newRow("many") << 50;
+}
+
+void tst_QDom::namedNodeMap()
+{
+    QFETCH(int, attributeCount);
+
+    QDomDocument doc;
+    QDomElement element = doc.createElement("foo");
+    doc.appendChild(element);
+    for (int i = 0; i < attributeCount; ++i)
+        element.setAttribute(QString("a%1").arg(i), i);
+
+    QDomNamedNodeMap map = element.attributes();
+    QCOMPARE(map.length(), attributeCount);
+    for (int i = 0; i < attributeCount; ++i) {
+        // item() returns the nodes in insertion order
+        QCOMPARE(map.item(i).nodeName(), QString("a%1").arg(i));
+        QCOMPARE(map.namedItem(QString("a%1").arg(i)).nodeValue(), QString::number(i));
+    }
+    QVERIFY(map.namedItem("missing").isNull());
+    QVERIFY(!map.contains("missing"));
+
+    // a node with the same name takes precedence over the old one
+    QDomAttr replacement = doc.createAttribute("a1");
+    replacement.setValue("replaced");
+    QCOMPARE(map.setNamedItem(replacement).nodeValue(), QString("1"));
+    QCOMPARE(map.namedItem("a1").nodeValue(), QString("replaced"));
+    QCOMPARE(element.attribute("a1"), QString("replaced"));
+
+    // removing a name removes all nodes of that name
+    QCOMPARE(map.removeNamedItem("a1").nodeValue(), QString("replaced"));
+    QVERIFY(map.namedItem("a1").isNull());
+    QVERIFY(!map.contains("a1"));
+    QVERIFY(!element.hasAttribute("a1"));
+    QCOMPARE(map.length(), attributeCount - 1);
+    QVERIFY(map.removeNamedItem("a1").isNull());
+
+    // the remaining nodes keep their order, new ones are appended
+    element.setAttribute("a1", "again");
+    QCOMPARE(map.length(), attributeCount);
+    QCOMPARE(map.item(0).nodeName(), QString("a0"));
+    for (int i = 2; i < attributeCount; ++i) {
+        QCOMPARE(map.item(i - 1).nodeName(), QString("a%1").arg(i));
+        QCOMPARE(map.namedItem(QString("a%1").arg(i)).nodeValue(), QString::number(i));
+    }
+    QCOMPARE(map.item(attributeCount - 1).nodeName(), QString("a1"));
+    QCOMPARE(map.namedItem("a1").nodeValue(), QString("again"));
+
+    // clones have the same nodes
+    const QDomNamedNodeMap clonedMap = element.cloneNode().attributes();
+    QCOMPARE(clonedMap.length(), attributeCount);
+    for (int i = 0; i < attributeCount; ++i)
+        QCOMPARE(clonedMap.item(i).nodeName(), map.item(i).nodeName());
+    QCOMPARE(clonedMap.namedItem("a1").nodeValue(), QString("again"));
+}
+
 // Verifies that a default-constructed QDomDocument is null, and that calling
 // any of the factory functions causes it to be non-null.
 #define TEST_NULL_DOCUMENT(func) \
@@ -2164,5 +2231,26 @@ void tst_QDom::QTBUG49113_dontCrashWithNegativeIndex() const
     QVERIFY(node.isNull());
 }
 
+void tst_QDom::nodesOutliveDocument() const
+{
+    QDomElement first;
+    QDomAttr attribute;
+    {
+        QDomDocument doc;
+        QVERIFY(doc.setContent(QByteArray("<root><item id='1' name='first'>text</item>"
+                                          "<item id='2' name='second'/></root>")));
+        first = doc.documentElement().firstChildElement(QLatin1String("item"));
+        attribute = first.nextSiblingElement(QLatin1String("item")).attributeNode(QLatin1String("name"));
+    }
+
+    QCOMPARE(first.tagName(), QLatin1String("item"));
+    QCOMPARE(first.attribute(QLatin1String("id")), QLatin1String("1"));
+    QCOMPARE(first.text(), QLatin1String("text"));
+    QCOMPARE(attribute.value(), QLatin1String("second"));
+    QCOMPARE(first.attributes().count(), 2);
+    QCOMPARE(first.attributes().namedItem(QLatin1String("name")).nodeValue(),
+             QLatin1String("first"));
+}
+
 QTEST_MAIN(tst_QDom)
 #include "tst_qdom.moc"
@@ -1,6 +1,8 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+        global \
         io \
+        itemmodels \
         json \
         mimetypes \
         kernel \
@@ -8,7 +10,8 @@ SUBDIRS = \
         thread \
         time \
         tools \
-        plugin
+        plugin \
+        serialization
 
 TRUSTED_BENCHMARKS += \
     kernel/qmetaobject \
@@ -0,0 +1,218 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QLogRecord>
+#include <QtCore/QThread>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <memory>
+#include <vector>
+
+/*
+    Measures the cost of logging through the default message handler, as
+    seen by the threads doing the logging. Run it once as is, and once with
+    QT_LOGGING_ASYNC=1 in the environment, to compare the synchronous and
+    the asynchronous output. stderr is redirected to /dev/null while the
+    benchmarks run.
+
+    categoryStream and categoryFields compare a message streamed into
+    qCDebug() with the same message logged as a structured record, both
+    through the default output and with a handler that discards it, which
+    leaves only the cost at the call site.
+*/
+class tst_QLogging : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void defaultHandler_data();
+    void defaultHandler();
+    void defaultHandlerStream_data();
+    void defaultHandlerStream();
+    void categoryStream_data();
+    void categoryStream();
+    void categoryFields_data();
+    void categoryFields();
+
+private:
+    QtMessageHandler m_testHandler = nullptr;
+    int m_stderr = -1;
+};
+
+void tst_QLogging::initTestCase()
+{
+    // bypass QtTest's message handler
+    m_testHandler = qInstallMessageHandler(nullptr);
+#ifdef Q_OS_UNIX
+    fflush(stderr);
+    m_stderr = ::dup(STDERR_FILENO);
+    const int devNull = ::open("/dev/null", O_WRONLY);
+    if (devNull >= 0) {
+        ::dup2(devNull, STDERR_FILENO);
+        ::close(devNull);
+    }
+#endif
+}
+
+void tst_QLogging::cleanupTestCase()
+{
+#ifdef Q_OS_UNIX
+    if (m_stderr >= 0) {
+        fflush(stderr);
+        ::dup2(m_stderr, STDERR_FILENO);
+        ::close(m_stderr);
+    }
+#endif
+    qInstallMessageHandler(m_testHandler);
+}
+
+static void addThreadCounts()
+{
+    QTest::addColumn<int>("threadCount");
+
+    for (int threadCount : { 1, 2, 4, 8 })
+        QTest::addRow("%d threads", threadCount) << threadCount;
+}
+
+template <typename Function>
+static void runThreads(int threadCount, Function function)
+{
+    std::vector<std::unique_ptr<QThread>> threads;
+    threads.reserve(threadCount);
+    for (int i = 0; i < threadCount; ++i)
+        threads.emplace_back(QThread::create(function));
+    for (const auto &thread : threads)
+        thread->start();
+    for (const auto &thread : threads)
+        thread->wait();
+}
+
+enum { MessagesPerThread = 10000 };
+
+void tst_QLogging::defaultHandler_data()
+{
+    addThreadCounts();
+}
+
+void tst_QLogging::defaultHandler()
+{
+    QFETCH(int, threadCount);
+
+    QBENCHMARK {
+        runThreads(threadCount, [] {
+            for (int i = 0; i < MessagesPerThread; ++i)
+                qDebug("message %d of a logging benchmark", i);
+        });
+    }
+}
+
+void tst_QLogging::defaultHandlerStream_data()
+{
+    addThreadCounts();
+}
+
+void tst_QLogging::defaultHandlerStream()
+{
+    QFETCH(int, threadCount);
+    const QString text = QStringLiteral("of a logging benchmark");
+
+    QBENCHMARK {
+        runThreads(threadCount, [&text] {
+            for (int i = 0; i < MessagesPerThread; ++i)
+                qDebug() << "message" << i << text;
+        });
+    }
+}
+
+Q_LOGGING_CATEGORY(lcBench, "bench.logging")
+
+static void discardMessage(QtMsgType, const QMessageLogContext &, const QString &)
+{
+}
+
+static void discardRecord(const QLogRecord &)
+{
+}
+
+Q_DECLARE_METATYPE(QtLogRecordHandler)
+
+void tst_QLogging::categoryStream_data()
+{
+    QTest::addColumn<bool>("discard");
+
+    QTest::newRow("default") << false;
+    QTest::newRow("discard") << true;
+}
+
+void tst_QLogging::categoryStream()
+{
+    QFETCH(bool, discard);
+    const QString path = QStringLiteral("/api/v1/items");
+
+    if (discard)
+        qInstallMessageHandler(discardMessage);
+    QBENCHMARK {
+        for (int i = 0; i < MessagesPerThread; ++i)
+            qCDebug(lcBench) << "request" << i << "for" << path << "took" << 1.5 << "ms";
+    }
+    qInstallMessageHandler(nullptr);
+}
+
+void tst_QLogging::categoryFields_data()
+{
+    QTest::addColumn<QtLogRecordHandler>("handler");
+
+    QTest::newRow("default") << QtLogRecordHandler(nullptr);
+    QTest::newRow("json") << QtLogRecordHandler(qJsonLogRecordHandler);
+    QTest::newRow("discard") << QtLogRecordHandler(discardRecord);
+}
+
+void tst_QLogging::categoryFields()
+{
+    QFETCH(QtLogRecordHandler, handler);
+    const QString path = QStringLiteral("/api/v1/items");
+
+    qInstallLogRecordHandler(handler);
+    QBENCHMARK {
+        for (int i = 0; i < MessagesPerThread; ++i)
+            qCDebugFields(lcBench, "request {id} for {path} took {ms} ms", i, path, 1.5);
+    }
+    qInstallLogRecordHandler(nullptr);
+}
+
+QTEST_MAIN(tst_QLogging)
+
+#include "tst_bench_qlogging.moc"
@@ -5,7 +5,8 @@ SUBDIRS = \
         qfile \
         qfileinfo \
         qiodevice \
+        qloggingcategory \
         qtemporaryfile \
         qtextstream
 
-qtConfig(process): SUBDIRS += qprocess
+qtConfig(process): SUBDIRS += qprocess qresource
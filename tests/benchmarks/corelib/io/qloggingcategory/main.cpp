@@ -0,0 +1,162 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QLoggingCategory>
+
+#include <memory>
+#include <vector>
+
+/*
+    Measures QLoggingCategory::setFilterRules() and installFilter() with
+    many registered categories, as in applications that load plugins
+    defining thousands of them.
+*/
+class tst_QLoggingCategory : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void createCategories();
+    void setFilterRules_data();
+    void setFilterRules();
+    void installFilter();
+
+private:
+    enum { CategoryCount = 10000 };
+
+    void createCategories(std::vector<std::unique_ptr<QLoggingCategory>> &categories);
+
+    QList<QByteArray> m_names;
+    std::vector<std::unique_ptr<QLoggingCategory>> m_categories;
+};
+
+void tst_QLoggingCategory::initTestCase()
+{
+    static const char *const modules[] = { "qt", "app", "plugin", "org.example" };
+    m_names.reserve(CategoryCount);
+    for (int i = 0; i < CategoryCount; ++i) {
+        m_names.append(QByteArray(modules[i % 4]) + ".module" + QByteArray::number(i % 97)
+                       + ".component" + QByteArray::number(i)
+                       + (i % 3 ? ".io" : ".parser"));
+    }
+    createCategories(m_categories);
+}
+
+void tst_QLoggingCategory::cleanupTestCase()
+{
+    QLoggingCategory::setFilterRules(QString());
+    m_categories.clear();
+}
+
+void tst_QLoggingCategory::createCategories(std::vector<std::unique_ptr<QLoggingCategory>> &categories)
+{
+    categories.reserve(categories.size() + m_names.size());
+    for (const QByteArray &name : qAsConst(m_names))
+        categories.emplace_back(new QLoggingCategory(name.constData()));
+}
+
+void tst_QLoggingCategory::createCategories()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("app.*.debug=false\n*.parser=true"));
+
+    QBENCHMARK {
+        std::vector<std::unique_ptr<QLoggingCategory>> categories;
+        createCategories(categories);
+    }
+    QLoggingCategory::setFilterRules(QString());
+}
+
+void tst_QLoggingCategory::setFilterRules_data()
+{
+    QTest::addColumn<QString>("rules");
+    QTest::addColumn<QString>("otherRules");
+
+    QTest::newRow("exact")
+            << "app.module1.component1.parser.debug=true"
+            << "app.module2.component2.io.debug=true";
+    QTest::newRow("prefix")
+            << "plugin.module5.*=false"
+            << "plugin.module6.*=false";
+    QTest::newRow("suffix")
+            << "*.parser.debug=true"
+            << "*.parser.warning=false";
+    QTest::newRow("substring")
+            << "*.module42.*=true"
+            << "*.module43.*=true";
+
+    QString rules;
+    QString otherRules;
+    for (int i = 0; i < 10; ++i) {
+        rules += QString::fromLatin1("app.module%1.*.debug=true\n"
+                                     "*.component%2.io=false\n").arg(i).arg(i * 7);
+        otherRules += QString::fromLatin1("plugin.module%1.*.info=false\n"
+                                          "*.component%2.parser=true\n").arg(i).arg(i * 11);
+    }
+    QTest::newRow("mixed-20") << rules << otherRules;
+}
+
+void tst_QLoggingCategory::setFilterRules()
+{
+    QFETCH(QString, rules);
+    QFETCH(QString, otherRules);
+
+    bool other = false;
+    QBENCHMARK {
+        QLoggingCategory::setFilterRules(other ? otherRules : rules);
+        other = !other;
+    }
+    QLoggingCategory::setFilterRules(QString());
+}
+
+static QLoggingCategory::CategoryFilter defaultFilter = nullptr;
+
+static void chainingFilter(QLoggingCategory *category)
+{
+    defaultFilter(category);
+}
+
+void tst_QLoggingCategory::installFilter()
+{
+    QLoggingCategory::setFilterRules(QStringLiteral("app.*.debug=false\n*.parser=true"));
+    // the filter is applied to all categories while it is being installed
+    defaultFilter = QLoggingCategory::installFilter(nullptr);
+
+    QBENCHMARK {
+        QLoggingCategory::installFilter(chainingFilter);
+        QLoggingCategory::installFilter(nullptr);
+    }
+    QLoggingCategory::setFilterRules(QString());
+}
+
+QTEST_MAIN(tst_QLoggingCategory)
+
+#include "main.moc"
@@ -37,6 +37,8 @@ class tst_QProcess : public QObject
 private slots:
 
     void echoTest_performance();
+    void startupLatency_data();
+    void startupLatency();
 };
 
 void tst_QProcess::echoTest_performance()
@@ -84,5 +86,44 @@ void tst_QProcess::echoTest_performance()
     QVERIFY(process.waitForFinished());
 }
 
+void tst_QProcess::startupLatency_data()
+{
+    QTest::addColumn<int>("residentMegabytes");
+    QTest::addColumn<bool>("useChildModifier");
+
+    QTest::newRow("small") << 0 << false;
+    QTest::newRow("small-modifier") << 0 << true;
+    QTest::newRow("512MB") << 512 << false;
+    QTest::newRow("512MB-modifier") << 512 << true;
+}
+
+void tst_QProcess::startupLatency()
+{
+    QFETCH(int, residentMegabytes);
+    QFETCH(bool, useChildModifier);
+
+    // Touch every page so that they are part of the resident set and a full
+    // fork() has to copy the page tables for them.
+    QByteArray ballast(residentMegabytes * 1024 * 1024, 'a');
+    QVERIFY(ballast.isDetached());
+
+    QProcess process;
+#ifdef Q_OS_UNIX
+    if (useChildModifier)
+        process.setChildProcessModifier([] {});
+#else
+    if (useChildModifier)
+        QSKIP("Child process modifiers are only supported on Unix");
+#endif
+    process.setProgram("testProcessLoopback/testProcessLoopback");
+
+    QBENCHMARK {
+        process.start();
+        QVERIFY(process.waitForStarted());
+        process.closeWriteChannel();
+        QVERIFY(process.waitForFinished());
+    }
+}
+
 QTEST_MAIN(tst_QProcess)
 #include "tst_bench_qprocess.moc"
@@ -0,0 +1,132 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QtTest/QtTest>
+#include <QtCore/QLibraryInfo>
+#include <QtCore/QProcess>
+#include <QtCore/QResource>
+#include <QtCore/QTemporaryDir>
+
+static const int directoryCount = 50;
+static const int filesPerDirectory = 1000;
+
+class tst_QResource : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void lookup_data();
+    void lookup();
+
+private:
+    QTemporaryDir m_dir;
+};
+
+void tst_QResource::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    const QString rcc = QLibraryInfo::path(QLibraryInfo::BinariesPath) + QLatin1String("/rcc");
+    if (!QFileInfo(rcc).isExecutable())
+        QSKIP("rcc is not available");
+
+    // 50k small files in a two level tree
+    QFile qrc(m_dir.filePath(QLatin1String("resources.qrc")));
+    QVERIFY(qrc.open(QIODevice::WriteOnly));
+    qrc.write("<RCC><qresource prefix=\"/\">\n");
+    for (int d = 0; d < directoryCount; ++d) {
+        const QString directory = QString::fromLatin1("dir%1").arg(d);
+        QVERIFY(QDir(m_dir.path()).mkdir(directory));
+        for (int f = 0; f < filesPerDirectory; ++f) {
+            const QString fileName = directory + QString::fromLatin1("/file%1.txt").arg(f);
+            QFile file(m_dir.filePath(fileName));
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(fileName.toLatin1());
+            qrc.write("<file>" + fileName.toLatin1() + "</file>\n");
+        }
+    }
+    qrc.write("</qresource></RCC>\n");
+    qrc.close();
+
+    for (const char *formatVersion : { "3", "4" }) {
+        QProcess process;
+        process.setWorkingDirectory(m_dir.path());
+        process.start(rcc, { "-binary", "-no-compress", "--format-version", formatVersion,
+                             "-o", QLatin1String("v") + QLatin1String(formatVersion) + QLatin1String(".rcc"),
+                             qrc.fileName() });
+        QVERIFY(process.waitForFinished(120000));
+        QCOMPARE(process.exitStatus(), QProcess::NormalExit);
+        QCOMPARE(process.exitCode(), 0);
+    }
+}
+
+void tst_QResource::lookup_data()
+{
+    QTest::addColumn<QString>("rccFile");
+    QTest::addColumn<bool>("existing");
+
+    QTest::newRow("v3-existing") << QString::fromLatin1("v3.rcc") << true;
+    QTest::newRow("v3-missing") << QString::fromLatin1("v3.rcc") << false;
+    QTest::newRow("v4-existing") << QString::fromLatin1("v4.rcc") << true;
+    QTest::newRow("v4-missing") << QString::fromLatin1("v4.rcc") << false;
+}
+
+void tst_QResource::lookup()
+{
+    QFETCH(QString, rccFile);
+    QFETCH(bool, existing);
+
+    const QString rccFileName = m_dir.filePath(rccFile);
+    QVERIFY(QResource::registerResource(rccFileName));
+
+    QStringList paths;
+    for (int i = 0; i < 1000; ++i) {
+        const int d = (i * 7) % directoryCount;
+        const int f = (i * 997) % filesPerDirectory;
+        paths << QString::fromLatin1(existing ? ":/dir%1/file%2.txt" : ":/dir%1/missing%2.txt")
+                 .arg(d).arg(f);
+    }
+
+    int found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (const QString &path : qAsConst(paths)) {
+            if (QResource(path).isValid())
+                ++found;
+        }
+    }
+    QCOMPARE(found, existing ? paths.size() : 0);
+
+    QVERIFY(QResource::unregisterResource(rccFileName));
+}
+
+QTEST_MAIN(tst_QResource)
+
+#include "tst_bench_qresource.moc"
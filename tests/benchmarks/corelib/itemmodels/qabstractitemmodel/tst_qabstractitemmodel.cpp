@@ -0,0 +1,201 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QAbstractItemModel>
+#include <QTest>
+
+// A two level model: every top level row may have children. The children's
+// internal pointer identifies their parent, so it stays valid when the
+// parent's row changes.
+class TreeModel : public QAbstractItemModel
+{
+public:
+    TreeModel(int topLevelRows, int childRows)
+    {
+        m_groups.reserve(topLevelRows);
+        for (int row = 0; row < topLevelRows; ++row)
+            m_groups.append(new Group{row, childRows});
+    }
+    ~TreeModel() { qDeleteAll(m_groups); }
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override
+    {
+        if (!hasIndex(row, column, parent))
+            return QModelIndex();
+        return createIndex(row, column, parent.isValid() ? m_groups.at(parent.row()) : nullptr);
+    }
+    QModelIndex parent(const QModelIndex &index) const override
+    {
+        Group *group = static_cast<Group *>(index.internalPointer());
+        if (!group)
+            return QModelIndex();
+        return createIndex(group->row, 0, nullptr);
+    }
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        if (!parent.isValid())
+            return m_groups.size();
+        if (parent.internalPointer() || parent.column() != 0)
+            return 0;
+        return m_groups.at(parent.row())->childCount;
+    }
+    int columnCount(const QModelIndex & = QModelIndex()) const override { return m_columnCount; }
+    QVariant data(const QModelIndex &, int = Qt::DisplayRole) const override { return QVariant(); }
+
+    bool insertRows(int row, int count, const QModelIndex &parent = QModelIndex()) override
+    {
+        beginInsertRows(parent, row, row + count - 1);
+        if (parent.isValid()) {
+            m_groups.at(parent.row())->childCount += count;
+        } else {
+            for (int i = 0; i < count; ++i)
+                m_groups.insert(row, new Group{row, 0});
+            updateRows(row);
+        }
+        endInsertRows();
+        return true;
+    }
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override
+    {
+        beginRemoveRows(parent, row, row + count - 1);
+        if (parent.isValid()) {
+            m_groups.at(parent.row())->childCount -= count;
+        } else {
+            for (int i = 0; i < count; ++i)
+                delete m_groups.takeAt(row);
+            updateRows(row);
+        }
+        endRemoveRows();
+        return true;
+    }
+    bool insertColumns(int column, int count, const QModelIndex &parent = QModelIndex()) override
+    {
+        beginInsertColumns(parent, column, column + count - 1);
+        m_columnCount += count;
+        endInsertColumns();
+        return true;
+    }
+    bool removeColumns(int column, int count, const QModelIndex &parent = QModelIndex()) override
+    {
+        beginRemoveColumns(parent, column, column + count - 1);
+        m_columnCount -= count;
+        endRemoveColumns();
+        return true;
+    }
+
+private:
+    void updateRows(int first)
+    {
+        for (int row = first; row < m_groups.size(); ++row)
+            m_groups.at(row)->row = row;
+    }
+
+    struct Group { int row; int childCount; };
+    QList<Group *> m_groups;
+    int m_columnCount = 2;
+};
+
+class tst_QAbstractItemModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertRemoveRows_data();
+    void insertRemoveRows();
+    void insertRemoveColumns();
+};
+
+void tst_QAbstractItemModel::insertRemoveRows_data()
+{
+    QTest::addColumn<int>("topLevelRows");
+    QTest::addColumn<int>("childRows");
+    QTest::addColumn<int>("parentRow");
+    QTest::addColumn<int>("row");
+
+    // 100000 persistent indexes in every case
+    QTest::newRow("flat, first row") << 100000 << 0 << -1 << 0;
+    QTest::newRow("flat, middle row") << 100000 << 0 << -1 << 50000;
+    QTest::newRow("flat, last row") << 100000 << 0 << -1 << 99999;
+    QTest::newRow("tree, first top level row") << 100 << 1000 << -1 << 0;
+    QTest::newRow("tree, last top level row") << 100 << 1000 << -1 << 99;
+    QTest::newRow("tree, first child row") << 100 << 1000 << 50 << 0;
+    QTest::newRow("tree, last child row") << 100 << 1000 << 50 << 999;
+}
+
+void tst_QAbstractItemModel::insertRemoveRows()
+{
+    QFETCH(int, topLevelRows);
+    QFETCH(int, childRows);
+    QFETCH(int, parentRow);
+    QFETCH(int, row);
+
+    TreeModel model(topLevelRows, childRows);
+    QList<QPersistentModelIndex> persistent;
+    persistent.reserve(100000);
+    for (int topLevelRow = 0; topLevelRow < topLevelRows; ++topLevelRow) {
+        const QModelIndex topLevel = model.index(topLevelRow, 0);
+        if (childRows == 0)
+            persistent.append(topLevel);
+        for (int childRow = 0; childRow < childRows; ++childRow)
+            persistent.append(model.index(childRow, 0, topLevel));
+    }
+    QCOMPARE(persistent.count(), 100000);
+    const QModelIndex first = persistent.first();
+    const QModelIndex last = persistent.last();
+
+    const QPersistentModelIndex parent = model.index(parentRow, 0);
+    model.insertRows(row, 1, parent);
+    model.removeRows(row, 1, parent);
+
+    QBENCHMARK {
+        model.insertRows(row, 1, parent);
+        model.removeRows(row, 1, parent);
+    }
+    QCOMPARE(QModelIndex(persistent.first()), first);
+    QCOMPARE(QModelIndex(persistent.last()), last);
+}
+
+void tst_QAbstractItemModel::insertRemoveColumns()
+{
+    TreeModel model(100000, 0);
+    QList<QPersistentModelIndex> persistent;
+    persistent.reserve(100000);
+    for (int row = 0; row < 100000; ++row)
+        persistent.append(model.index(row, row % 2));
+    model.insertColumns(1, 1);
+    model.removeColumns(1, 1);
+
+    QBENCHMARK {
+        model.insertColumns(1, 1);
+        model.removeColumns(1, 1);
+    }
+}
+
+QTEST_MAIN(tst_QAbstractItemModel)
+
+#include "tst_qabstractitemmodel.moc"
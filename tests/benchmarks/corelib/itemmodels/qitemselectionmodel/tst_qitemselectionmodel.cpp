@@ -0,0 +1,200 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QAbstractTableModel>
+#include <QItemSelectionModel>
+#include <QTest>
+
+class TableModel : public QAbstractTableModel
+{
+public:
+    TableModel(int rows, int columns) : m_rows(rows), m_columns(columns) {}
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    { return parent.isValid() ? 0 : m_rows; }
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override
+    { return parent.isValid() ? 0 : m_columns; }
+    QVariant data(const QModelIndex &, int = Qt::DisplayRole) const override { return QVariant(); }
+
+private:
+    int m_rows;
+    int m_columns;
+};
+
+class tst_QItemSelectionModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void selectAll_data();
+    void selectAll();
+    void toggle_data();
+    void toggle();
+    void isSelected_data();
+    void isSelected();
+    void bulkSelect_data();
+    void bulkSelect();
+
+private:
+    static void selectAllAndToggle(QItemSelectionModel *selectionModel, int toggles);
+};
+
+static const int columnCount = 10;
+
+// Selects everything, then ctrl-clicks toggles cells spread evenly over the
+// whole table, each in a different column than the previous one.
+void tst_QItemSelectionModel::selectAllAndToggle(QItemSelectionModel *selectionModel, int toggles)
+{
+    const QAbstractItemModel *model = selectionModel->model();
+    const int rows = model->rowCount();
+    selectionModel->select(QItemSelection(model->index(0, 0),
+                                          model->index(rows - 1, columnCount - 1)),
+                           QItemSelectionModel::ClearAndSelect);
+    const int step = rows / toggles;
+    for (int i = 0; i < toggles; ++i)
+        selectionModel->select(model->index(i * step, i % columnCount), QItemSelectionModel::Toggle);
+}
+
+void tst_QItemSelectionModel::selectAll_data()
+{
+    QTest::addColumn<int>("rows");
+
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("1000000") << 1000000;
+}
+
+void tst_QItemSelectionModel::selectAll()
+{
+    QFETCH(int, rows);
+
+    TableModel model(rows, columnCount);
+    QItemSelectionModel selectionModel(&model);
+    const QItemSelection all(model.index(0, 0), model.index(rows - 1, columnCount - 1));
+
+    QBENCHMARK {
+        selectionModel.select(all, QItemSelectionModel::ClearAndSelect);
+        selectionModel.select(all, QItemSelectionModel::Deselect);
+    }
+}
+
+void tst_QItemSelectionModel::toggle_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<int>("toggles");
+
+    QTest::newRow("1000000 rows, 100 toggles") << 1000000 << 100;
+    QTest::newRow("1000000 rows, 1000 toggles") << 1000000 << 1000;
+}
+
+void tst_QItemSelectionModel::toggle()
+{
+    QFETCH(int, rows);
+    QFETCH(int, toggles);
+
+    TableModel model(rows, columnCount);
+    QItemSelectionModel selectionModel(&model);
+
+    QBENCHMARK {
+        selectAllAndToggle(&selectionModel, toggles);
+    }
+}
+
+void tst_QItemSelectionModel::isSelected_data()
+{
+    QTest::addColumn<int>("toggles");
+
+    QTest::newRow("single range") << 0;
+    QTest::newRow("100 toggles") << 100;
+    QTest::newRow("1000 toggles") << 1000;
+}
+
+void tst_QItemSelectionModel::isSelected()
+{
+    QFETCH(int, toggles);
+
+    TableModel model(1000000, columnCount);
+    QItemSelectionModel selectionModel(&model);
+    if (toggles)
+        selectAllAndToggle(&selectionModel, toggles);
+    else
+        selectionModel.select(QItemSelection(model.index(0, 0), model.index(999999, columnCount - 1)),
+                              QItemSelectionModel::Select);
+    // commit the last toggle, as a view would on the next click
+    selectionModel.select(model.index(0, 0), QItemSelectionModel::NoUpdate | QItemSelectionModel::Select);
+
+    // every cell of a screenful of rows in several places of the table
+    QList<QModelIndex> indexes;
+    for (int top = 0; top < 1000000; top += 100000) {
+        for (int row = top; row < top + 50; ++row) {
+            for (int column = 0; column < columnCount; ++column)
+                indexes.append(model.index(row, column));
+        }
+    }
+
+    int selected = 0;
+    QBENCHMARK {
+        for (const QModelIndex &index : qAsConst(indexes))
+            selected += selectionModel.isSelected(index);
+    }
+    QVERIFY(selected > 0);
+}
+
+void tst_QItemSelectionModel::bulkSelect_data()
+{
+    QTest::addColumn<int>("ranges");
+
+    QTest::newRow("100") << 100;
+    QTest::newRow("10000") << 10000;
+}
+
+// Selects every other row of a table with a single selection of many
+// ranges, then deselects every fourth row with another one.
+void tst_QItemSelectionModel::bulkSelect()
+{
+    QFETCH(int, ranges);
+
+    TableModel model(4 * ranges, columnCount);
+    QItemSelectionModel selectionModel(&model);
+    QItemSelection everyOther;
+    QItemSelection everyFourth;
+    for (int row = 0; row < 4 * ranges; row += 2) {
+        QItemSelection &selection = row % 4 ? everyOther : everyFourth;
+        selection.append(QItemSelectionRange(model.index(row, 0), model.index(row, columnCount - 1)));
+    }
+    everyOther += everyFourth;
+
+    QBENCHMARK {
+        selectionModel.select(everyOther, QItemSelectionModel::ClearAndSelect);
+        selectionModel.select(everyFourth, QItemSelectionModel::Deselect);
+    }
+    QCOMPARE(selectionModel.selection().count(), ranges);
+}
+
+QTEST_MAIN(tst_QItemSelectionModel)
+
+#include "tst_qitemselectionmodel.moc"
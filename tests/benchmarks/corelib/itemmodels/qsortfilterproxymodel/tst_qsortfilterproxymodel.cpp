@@ -0,0 +1,261 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QAbstractTableModel>
+#include <QSortFilterProxyModel>
+#include <QTest>
+
+#include <vector>
+
+class TableModel : public QAbstractTableModel
+{
+public:
+    enum KeyType { IntKeys, StringKeys };
+
+    TableModel(int rowCount, KeyType keyType)
+    {
+        m_keys.reserve(rowCount);
+        for (int row = 0; row < rowCount; ++row) {
+            const int key = int((qint64(row) * 7919) % 100003);
+            if (keyType == IntKeys)
+                m_keys.append(key);
+            else
+                m_keys.append(QString::number(key));
+        }
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : m_keys.size();
+    }
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : 2;
+    }
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override
+    {
+        if (role != Qt::DisplayRole || !index.isValid())
+            return QVariant();
+        return index.column() == 0 ? m_keys.at(index.row()) : QVariant(index.row());
+    }
+    void rangeData(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                   QModelRoleDataSpan roleDataSpan) const override
+    {
+        const int columns = bottomRight.column() - topLeft.column() + 1;
+        const qsizetype rolesPerItem = roleDataSpan.size()
+                / ((bottomRight.row() - topLeft.row() + 1) * columns);
+        QModelRoleData *roleData = roleDataSpan.begin();
+        for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+            for (int column = topLeft.column(); column <= bottomRight.column(); ++column) {
+                for (qsizetype i = 0; i < rolesPerItem; ++i, ++roleData) {
+                    if (roleData->role() != Qt::DisplayRole)
+                        roleData->clearData();
+                    else if (column == 0)
+                        roleData->data() = m_keys.at(row);
+                    else
+                        roleData->setData(row);
+                }
+            }
+        }
+    }
+
+private:
+    QVariantList m_keys;
+};
+
+class tst_QSortFilterProxyModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sort_data();
+    void sort();
+    void filter_data();
+    void filter();
+    void narrowFilter_data();
+    void narrowFilter();
+    void fetchData_data();
+    void fetchData();
+};
+
+Q_DECLARE_METATYPE(TableModel::KeyType)
+
+void tst_QSortFilterProxyModel::sort_data()
+{
+    QTest::addColumn<TableModel::KeyType>("keyType");
+    QTest::addColumn<bool>("sortKeyCaching");
+    QTest::addColumn<bool>("concurrent");
+
+    for (auto keyType : { TableModel::IntKeys, TableModel::StringKeys }) {
+        const char *keys = keyType == TableModel::IntKeys ? "int" : "string";
+        for (bool sortKeyCaching : { false, true }) {
+            for (bool concurrent : { false, true }) {
+                QTest::addRow("%s%s%s", keys, sortKeyCaching ? ", sort key caching" : "",
+                              concurrent ? ", concurrent" : "")
+                        << keyType << sortKeyCaching << concurrent;
+            }
+        }
+    }
+}
+
+void tst_QSortFilterProxyModel::sort()
+{
+    QFETCH(TableModel::KeyType, keyType);
+    QFETCH(bool, sortKeyCaching);
+    QFETCH(bool, concurrent);
+
+    TableModel model(100000, keyType);
+    QSortFilterProxyModel proxy;
+    proxy.setSortKeyCachingEnabled(sortKeyCaching);
+    proxy.setConcurrentSortFilterEnabled(concurrent);
+    proxy.setSourceModel(&model);
+    QCOMPARE(proxy.rowCount(), model.rowCount());
+
+    QBENCHMARK {
+        proxy.sort(0);
+        proxy.sort(-1);
+    }
+}
+
+void tst_QSortFilterProxyModel::filter_data()
+{
+    QTest::addColumn<bool>("concurrent");
+
+    QTest::newRow("default") << false;
+    QTest::newRow("concurrent") << true;
+}
+
+void tst_QSortFilterProxyModel::filter()
+{
+    QFETCH(bool, concurrent);
+
+    TableModel model(100000, TableModel::StringKeys);
+    QSortFilterProxyModel proxy;
+    proxy.setConcurrentSortFilterEnabled(concurrent);
+    proxy.setSourceModel(&model);
+    QCOMPARE(proxy.rowCount(), model.rowCount());
+
+    QBENCHMARK {
+        proxy.setFilterRegularExpression(QStringLiteral("^[1-4]"));
+        proxy.setFilterRegularExpression(QStringLiteral("7$"));
+    }
+}
+
+void tst_QSortFilterProxyModel::narrowFilter_data()
+{
+    QTest::addColumn<QSortFilterProxyModel::FilterChange>("narrowing");
+    QTest::addColumn<QSortFilterProxyModel::FilterChange>("widening");
+
+    QTest::newRow("unspecified") << QSortFilterProxyModel::FilterChange::Unspecified
+                                 << QSortFilterProxyModel::FilterChange::Unspecified;
+    QTest::newRow("narrowing/widening") << QSortFilterProxyModel::FilterChange::Narrowing
+                                        << QSortFilterProxyModel::FilterChange::Widening;
+}
+
+void tst_QSortFilterProxyModel::narrowFilter()
+{
+    QFETCH(QSortFilterProxyModel::FilterChange, narrowing);
+    QFETCH(QSortFilterProxyModel::FilterChange, widening);
+
+    // typing "123" into a search field, then deleting it again
+    const QRegularExpression filters[] = { QRegularExpression(QStringLiteral("1")),
+                                           QRegularExpression(QStringLiteral("12")),
+                                           QRegularExpression(QStringLiteral("123")) };
+    TableModel model(100000, TableModel::StringKeys);
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.setFilterRegularExpression(filters[0]);
+    QVERIFY(proxy.rowCount() > 0);
+
+    QBENCHMARK {
+        proxy.setFilterRegularExpression(filters[1], narrowing);
+        proxy.setFilterRegularExpression(filters[2], narrowing);
+        proxy.setFilterRegularExpression(filters[1], widening);
+        proxy.setFilterRegularExpression(filters[0], widening);
+    }
+}
+
+void tst_QSortFilterProxyModel::fetchData_data()
+{
+    QTest::addColumn<bool>("sorted");
+    QTest::addColumn<bool>("rangeData");
+
+    for (bool sorted : { false, true }) {
+        for (bool rangeData : { false, true }) {
+            QTest::addRow("%s, %s", sorted ? "sorted" : "unsorted",
+                          rangeData ? "rangeData" : "data")
+                    << sorted << rangeData;
+        }
+    }
+}
+
+void tst_QSortFilterProxyModel::fetchData()
+{
+    QFETCH(bool, sorted);
+    QFETCH(bool, rangeData);
+
+    // scrolling through the whole proxy, one screen of rows at a time
+    const int rowsPerPage = 50;
+    const int roles[] = { Qt::DisplayRole, Qt::DecorationRole, Qt::ToolTipRole };
+    TableModel model(100000, TableModel::IntKeys);
+    QSortFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.setRangeDataForwardingEnabled(rangeData);
+    if (sorted)
+        proxy.sort(0);
+    const int columns = proxy.columnCount();
+    std::vector<QModelRoleData> roleData;
+    for (int item = 0; item < rowsPerPage * columns; ++item) {
+        for (int role : roles)
+            roleData.emplace_back(role);
+    }
+
+    QBENCHMARK {
+        for (int top = 0; top < proxy.rowCount(); top += rowsPerPage) {
+            const int bottom = qMin(top + rowsPerPage, proxy.rowCount()) - 1;
+            if (rangeData) {
+                proxy.rangeData(proxy.index(top, 0), proxy.index(bottom, columns - 1),
+                                QModelRoleDataSpan(roleData.data(),
+                                                   (bottom - top + 1) * columns * std::size(roles)));
+            } else {
+                auto it = roleData.begin();
+                for (int row = top; row <= bottom; ++row) {
+                    for (int column = 0; column < columns; ++column) {
+                        const QModelIndex index = proxy.index(row, column);
+                        for (int role : roles)
+                            (it++)->data() = proxy.data(index, role);
+                    }
+                }
+            }
+        }
+    }
+}
+
+QTEST_MAIN(tst_QSortFilterProxyModel)
+
+#include "tst_qsortfilterproxymodel.moc"
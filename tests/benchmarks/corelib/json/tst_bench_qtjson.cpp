@@ -29,6 +29,9 @@
 #include <QtTest>
 #include <qjsondocument.h>
 #include <qjsonobject.h>
+#include <qjsonarray.h>
+#include <qjsonstreamreader.h>
+#include <qjsonstreamwriter.h>
 
 class BenchmarkQtJson: public QObject
 {
@@ -45,6 +48,11 @@ private Q_SLOTS:
     void parseNumbers();
     void parseJson();
     void parseJsonToVariant();
+    void streamReadNumbers();
+    void streamReadJson();
+
+    void toJson();
+    void streamWriteJson();
 
     void jsonObjectInsert();
     void variantMapInsert();
@@ -117,6 +125,94 @@ void BenchmarkQtJson::parseJsonToVariant()
     }
 }
 
+void BenchmarkQtJson::streamReadNumbers()
+{
+    QString testFile = QFINDTESTDATA("numbers.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file numbers.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    QByteArray testJson = file.readAll();
+
+    QBENCHMARK {
+        QJsonStreamReader reader(testJson);
+        double sum = 0;
+        while (!reader.atEnd()) {
+            if (reader.readNext() == QJsonStreamReader::Number)
+                sum += reader.toDouble();
+        }
+        Q_UNUSED(sum);
+    }
+}
+
+void BenchmarkQtJson::streamReadJson()
+{
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    QByteArray testJson = file.readAll();
+
+    QBENCHMARK {
+        QJsonStreamReader reader(testJson);
+        while (!reader.atEnd())
+            reader.readNext();
+    }
+}
+
+static void writeValue(QJsonStreamWriter &writer, const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::Array:
+        writer.startArray();
+        for (const QJsonValue &element : value.toArray())
+            writeValue(writer, element);
+        writer.endArray();
+        break;
+    case QJsonValue::Object: {
+        writer.startObject();
+        const QJsonObject object = value.toObject();
+        for (auto it = object.begin(); it != object.end(); ++it) {
+            writer.append(it.key());
+            writeValue(writer, it.value());
+        }
+        writer.endObject();
+        break;
+    }
+    default:
+        writer.append(value);
+        break;
+    }
+}
+
+void BenchmarkQtJson::toJson()
+{
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+
+    QBENCHMARK {
+        QByteArray json = doc.toJson();
+    }
+}
+
+void BenchmarkQtJson::streamWriteJson()
+{
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QCOMPARE(doc.isArray(), true);
+
+    QBENCHMARK {
+        QByteArray json;
+        QJsonStreamWriter writer(&json);
+        writeValue(writer, doc.array());
+    }
+}
+
 void BenchmarkQtJson::jsonObjectInsert()
 {
     QJsonObject object;
@@ -4,6 +4,7 @@ SUBDIRS = \
         qmetaobject \
         qmetatype \
         qobject \
+        qproperty \
         qvariant \
         qcoreapplication \
         qtimer_vs_qmetaobject
@@ -0,0 +1,182 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qtest.h>
+#include <QtCore/qproperty.h>
+
+#include <vector>
+
+class tst_QProperty : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void deepChain_data();
+    void deepChain();
+    void wideFanIn_data();
+    void wideFanIn();
+    void layeredGraph_data();
+    void layeredGraph();
+};
+
+// Writes all the sources, either one by one or inside an update group.
+static void writeSources(std::vector<QProperty<int>> &sources, int value, bool grouped)
+{
+    if (grouped)
+        Qt::beginPropertyUpdateGroup();
+    for (auto &source : sources)
+        source = value;
+    if (grouped)
+        Qt::endPropertyUpdateGroup();
+}
+
+void tst_QProperty::deepChain_data()
+{
+    QTest::addColumn<int>("depth");
+    QTest::addColumn<bool>("grouped");
+
+    for (int depth : { 10, 100, 1000 }) {
+        QTest::addRow("depth %d", depth) << depth << false;
+        QTest::addRow("depth %d, grouped", depth) << depth << true;
+    }
+}
+
+// A chain of bindings, each depending on the previous one, with a change
+// handler at the end; the source of the chain is written several times.
+void tst_QProperty::deepChain()
+{
+    QFETCH(int, depth);
+    QFETCH(bool, grouped);
+
+    std::vector<QProperty<int>> sources(1);
+    std::vector<QProperty<int>> chain(depth);
+    chain[0].setBinding([&]() { return sources[0] + 1; });
+    for (int i = 1; i < depth; ++i)
+        chain[i].setBinding([&, i]() { return chain[i - 1] + 1; });
+    int handlerCalls = 0;
+    auto handler = chain.back().onValueChanged([&]() { ++handlerCalls; });
+    chain.back().value();
+
+    int value = 0;
+    QBENCHMARK {
+        if (grouped)
+            Qt::beginPropertyUpdateGroup();
+        for (int i = 0; i < 10; ++i)
+            sources[0] = ++value;
+        if (grouped)
+            Qt::endPropertyUpdateGroup();
+    }
+    QCOMPARE(chain.back().value(), value + depth);
+}
+
+void tst_QProperty::wideFanIn_data()
+{
+    QTest::addColumn<int>("width");
+    QTest::addColumn<bool>("grouped");
+
+    for (int width : { 10, 100, 1000 }) {
+        QTest::addRow("width %d", width) << width << false;
+        QTest::addRow("width %d, grouped", width) << width << true;
+    }
+}
+
+// A single binding depending on many properties that are all written.
+void tst_QProperty::wideFanIn()
+{
+    QFETCH(int, width);
+    QFETCH(bool, grouped);
+
+    std::vector<QProperty<int>> sources(width);
+    QProperty<int> sum([&]() {
+        int result = 0;
+        for (const auto &source : sources)
+            result += source;
+        return result;
+    });
+    int handlerCalls = 0;
+    auto handler = sum.onValueChanged([&]() { ++handlerCalls; });
+    sum.value();
+
+    int value = 0;
+    QBENCHMARK {
+        writeSources(sources, ++value, grouped);
+    }
+    QCOMPARE(sum.value(), value * width);
+}
+
+void tst_QProperty::layeredGraph_data()
+{
+    QTest::addColumn<int>("depth");
+    QTest::addColumn<int>("width");
+    QTest::addColumn<bool>("grouped");
+
+    for (int size : { 4, 8, 16 }) {
+        QTest::addRow("%dx%d", size, size) << size << size << false;
+        QTest::addRow("%dx%d, grouped", size, size) << size << size << true;
+    }
+    // without a group, the number of notifications grows exponentially with the depth
+    QTest::addRow("64x64, grouped") << 64 << 64 << true;
+}
+
+// Layers of bindings, each depending on two bindings of the previous layer,
+// with change handlers on the last layer; all the sources are written.
+void tst_QProperty::layeredGraph()
+{
+    QFETCH(int, depth);
+    QFETCH(int, width);
+    QFETCH(bool, grouped);
+
+    std::vector<QProperty<int>> sources(width);
+    std::vector<std::vector<QProperty<int>>> layers(depth);
+    for (int layer = 0; layer < depth; ++layer) {
+        auto &previous = layer ? layers[layer - 1] : sources;
+        layers[layer] = std::vector<QProperty<int>>(width);
+        for (int i = 0; i < width; ++i) {
+            layers[layer][i].setBinding([&previous, i, width]() {
+                return (previous[i] + previous[(i + 1) % width]) % 1000003;
+            });
+        }
+    }
+    int handlerCalls = 0;
+    std::vector<QPropertyChangeHandler<std::function<void()>>> handlers;
+    handlers.reserve(width);
+    for (auto &property : layers.back()) {
+        handlers.push_back(property.onValueChanged(std::function<void()>([&]() { ++handlerCalls; })));
+        property.value();
+    }
+
+    int value = 0;
+    QBENCHMARK {
+        writeSources(sources, ++value, grouped);
+    }
+    QVERIFY(handlerCalls > 0);
+}
+
+QTEST_MAIN(tst_QProperty)
+
+#include "tst_qproperty.moc"
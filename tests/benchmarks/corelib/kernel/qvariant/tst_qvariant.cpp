@@ -85,6 +85,11 @@ private slots:
     void createCoreType();
     void createCoreTypeCopy_data();
     void createCoreTypeCopy();
+
+    void convert_data();
+    void convert();
+    void convertFailure_data();
+    void convertFailure();
 };
 
 struct BigClass
@@ -107,6 +112,13 @@ Q_DECLARE_TYPEINFO(SmallClass, Q_MOVABLE_TYPE);
 QT_END_NAMESPACE
 Q_DECLARE_METATYPE(SmallClass);
 
+struct ConvertibleClass
+{
+    int value;
+    QString toString() const { return QString::number(value); }
+};
+Q_DECLARE_METATYPE(ConvertibleClass);
+
 void tst_qvariant::testBound()
 {
     qreal d = qreal(.5);
@@ -373,6 +385,73 @@ void tst_qvariant::createCoreTypeCopy()
     }
 }
 
+void tst_qvariant::convert_data()
+{
+    QMetaType::registerConverter<ConvertibleClass, QString>(&ConvertibleClass::toString);
+
+    QTest::addColumn<QVariant>("source");
+    QTest::addColumn<QMetaType>("targetType");
+
+    QTest::newRow("int to double") << QVariant(42) << QMetaType::fromType<double>();
+    QTest::newRow("double to int") << QVariant(42.5) << QMetaType::fromType<int>();
+    QTest::newRow("int to qlonglong") << QVariant(42) << QMetaType::fromType<qlonglong>();
+    QTest::newRow("uint to int") << QVariant(42u) << QMetaType::fromType<int>();
+    QTest::newRow("bool to int") << QVariant(true) << QMetaType::fromType<int>();
+    QTest::newRow("float to double") << QVariant(42.5f) << QMetaType::fromType<double>();
+    QTest::newRow("int to bool") << QVariant(42) << QMetaType::fromType<bool>();
+    QTest::newRow("int to QString") << QVariant(42) << QMetaType::fromType<QString>();
+    QTest::newRow("double to QString") << QVariant(42.5) << QMetaType::fromType<QString>();
+    QTest::newRow("QString to int") << QVariant(QStringLiteral("42")) << QMetaType::fromType<int>();
+    QTest::newRow("QString to double") << QVariant(QStringLiteral("42.5")) << QMetaType::fromType<double>();
+    QTest::newRow("QString to QByteArray") << QVariant(QStringLiteral("42")) << QMetaType::fromType<QByteArray>();
+    QTest::newRow("QByteArray to QString") << QVariant(QByteArray("42")) << QMetaType::fromType<QString>();
+    QTest::newRow("enum to int") << QVariant::fromValue(SecondEnumValue) << QMetaType::fromType<int>();
+    QTest::newRow("custom to QString") << QVariant::fromValue(ConvertibleClass{42})
+                                       << QMetaType::fromType<QString>();
+}
+
+// Tests how fast a QVariant can be converted to another type, which is what
+// QVariant::value<T>() does whenever the variant holds a different type.
+void tst_qvariant::convert()
+{
+    QFETCH(QVariant, source);
+    QFETCH(QMetaType, targetType);
+    QVariant target(targetType);
+    void *data = target.data();
+    QVERIFY(QMetaType::convert(source.metaType(), source.constData(), targetType, data));
+    QBENCHMARK {
+        for (int i = 0; i < ITERATION_COUNT; ++i)
+            QMetaType::convert(source.metaType(), source.constData(), targetType, data);
+    }
+}
+
+void tst_qvariant::convertFailure_data()
+{
+    QTest::addColumn<QVariant>("source");
+    QTest::addColumn<QMetaType>("targetType");
+
+    QTest::newRow("QString to int") << QVariant(QStringLiteral("forty-two"))
+                                    << QMetaType::fromType<int>();
+    QTest::newRow("custom to int") << QVariant::fromValue(SmallClass())
+                                   << QMetaType::fromType<int>();
+    QTest::newRow("custom to custom") << QVariant::fromValue(SmallClass())
+                                      << QMetaType::fromType<BigClass>();
+}
+
+// Tests how fast a conversion that is not possible is rejected.
+void tst_qvariant::convertFailure()
+{
+    QFETCH(QVariant, source);
+    QFETCH(QMetaType, targetType);
+    QVariant target(targetType);
+    void *data = target.data();
+    QVERIFY(!QMetaType::convert(source.metaType(), source.constData(), targetType, data));
+    QBENCHMARK {
+        for (int i = 0; i < ITERATION_COUNT; ++i)
+            QMetaType::convert(source.metaType(), source.constData(), targetType, data);
+    }
+}
+
 QTEST_MAIN(tst_qvariant)
 
 #include "tst_qvariant.moc"
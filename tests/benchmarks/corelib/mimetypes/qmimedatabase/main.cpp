@@ -36,6 +36,10 @@ class tst_QMimeDatabase: public QObject
 private slots:
     void inheritsPerformance();
     void benchMimeTypeForName();
+    void benchMimeTypeForFileName_data();
+    void benchMimeTypeForFileName();
+    void benchMimeTypeForData_data();
+    void benchMimeTypeForData();
 };
 
 void tst_QMimeDatabase::inheritsPerformance()
@@ -81,5 +85,55 @@ void tst_QMimeDatabase::benchMimeTypeForName()
     }
 }
 
+void tst_QMimeDatabase::benchMimeTypeForFileName_data()
+{
+    QTest::addColumn<QStringList>("fileNames");
+
+    QTest::newRow("extensions")
+        << QStringList{ QStringLiteral("textfile.txt"), QStringLiteral("image.PNG"),
+                        QStringLiteral("archive.tar.bz2"), QStringLiteral("main.cpp"),
+                        QStringLiteral("Document.pdf"), QStringLiteral("backup~"),
+                        QStringLiteral("file.unknownextension") };
+    QTest::newRow("special globs")
+        << QStringList{ QStringLiteral("Makefile"), QStringLiteral("README.md"),
+                        QStringLiteral("SConscript.foo"), QStringLiteral("001.vdr"),
+                        QStringLiteral("movie.anim3"), QStringLiteral("core") };
+}
+
+void tst_QMimeDatabase::benchMimeTypeForFileName()
+{
+    QFETCH(QStringList, fileNames);
+    QMimeDatabase db;
+
+    QBENCHMARK {
+        for (const QString &fileName : qAsConst(fileNames)) {
+            const auto mime = db.mimeTypeForFile(fileName, QMimeDatabase::MatchExtension);
+            QVERIFY(mime.isValid());
+        }
+    }
+}
+
+void tst_QMimeDatabase::benchMimeTypeForData_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QString>("expectedMimeType");
+
+    QTest::newRow("png") << QByteArray("\x89PNG\r\n\x1a\n") << "image/png";
+    QTest::newRow("pdf") << QByteArray("%PDF-1.4") << "application/pdf";
+    QTest::newRow("tar") << QByteArray(257, '\0').append("ustar\0", 6) << "application/x-tar";
+    QTest::newRow("text") << QByteArray("Hello world, this is some plain text.\n") << "text/plain";
+}
+
+void tst_QMimeDatabase::benchMimeTypeForData()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QString, expectedMimeType);
+    QMimeDatabase db;
+
+    QBENCHMARK {
+        QCOMPARE(db.mimeTypeForData(data).name(), expectedMimeType);
+    }
+}
+
 QTEST_MAIN(tst_QMimeDatabase)
 #include "main.moc"
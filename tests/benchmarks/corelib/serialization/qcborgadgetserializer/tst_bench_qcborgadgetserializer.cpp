@@ -0,0 +1,315 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include <QtTest/QtTest>
+#include <QtCore/QCborArray>
+#include <QtCore/QCborGadgetSerializer>
+#include <QtCore/QCborStreamReader>
+#include <QtCore/QCborStreamWriter>
+#include <QtCore/QDataStream>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMetaProperty>
+
+class Position
+{
+    Q_GADGET
+    Q_PROPERTY(double latitude MEMBER latitude)
+    Q_PROPERTY(double longitude MEMBER longitude)
+public:
+    double latitude = 0;
+    double longitude = 0;
+
+    friend bool operator==(const Position &a, const Position &b)
+    { return a.latitude == b.latitude && a.longitude == b.longitude; }
+    friend bool operator!=(const Position &a, const Position &b) { return !(a == b); }
+};
+
+class Sample
+{
+    Q_GADGET
+    Q_PROPERTY(int id MEMBER id)
+    Q_PROPERTY(qint64 timestamp MEMBER timestamp)
+    Q_PROPERTY(QString name MEMBER name)
+    Q_PROPERTY(bool valid MEMBER valid)
+    Q_PROPERTY(double value MEMBER value)
+    Q_PROPERTY(Kind kind MEMBER kind)
+    Q_PROPERTY(QByteArray checksum MEMBER checksum)
+    Q_PROPERTY(Position position MEMBER position)
+public:
+    enum Kind { Temperature, Pressure, Humidity };
+    Q_ENUM(Kind)
+
+    int id = 0;
+    qint64 timestamp = 0;
+    QString name;
+    bool valid = false;
+    double value = 0;
+    Kind kind = Temperature;
+    QByteArray checksum;
+    Position position;
+};
+
+static QDataStream &operator<<(QDataStream &out, const Sample &s)
+{
+    return out << s.id << s.timestamp << s.name << s.valid << s.value << int(s.kind)
+               << s.checksum << s.position.latitude << s.position.longitude;
+}
+
+static QDataStream &operator>>(QDataStream &in, Sample &s)
+{
+    int kind;
+    in >> s.id >> s.timestamp >> s.name >> s.valid >> s.value >> kind
+       >> s.checksum >> s.position.latitude >> s.position.longitude;
+    s.kind = Sample::Kind(kind);
+    return in;
+}
+
+static QJsonObject toJson(const Sample &s)
+{
+    return QJsonObject{
+        { QLatin1String("id"), s.id },
+        { QLatin1String("timestamp"), s.timestamp },
+        { QLatin1String("name"), s.name },
+        { QLatin1String("valid"), s.valid },
+        { QLatin1String("value"), s.value },
+        { QLatin1String("kind"), int(s.kind) },
+        { QLatin1String("checksum"), QString::fromLatin1(s.checksum.toBase64()) },
+        { QLatin1String("position"), QJsonObject{
+                { QLatin1String("latitude"), s.position.latitude },
+                { QLatin1String("longitude"), s.position.longitude } } }
+    };
+}
+
+static Sample fromJson(const QJsonObject &o)
+{
+    Sample s;
+    s.id = o.value(QLatin1String("id")).toInt();
+    s.timestamp = o.value(QLatin1String("timestamp")).toInteger();
+    s.name = o.value(QLatin1String("name")).toString();
+    s.valid = o.value(QLatin1String("valid")).toBool();
+    s.value = o.value(QLatin1String("value")).toDouble();
+    s.kind = Sample::Kind(o.value(QLatin1String("kind")).toInt());
+    s.checksum = QByteArray::fromBase64(o.value(QLatin1String("checksum")).toString().toLatin1());
+    const QJsonObject position = o.value(QLatin1String("position")).toObject();
+    s.position.latitude = position.value(QLatin1String("latitude")).toDouble();
+    s.position.longitude = position.value(QLatin1String("longitude")).toDouble();
+    return s;
+}
+
+// What generic code does without QCborGadgetSerializer
+static QCborValue toVariantCbor(const QMetaObject *mo, const void *gadget)
+{
+    QCborArray array;
+    for (int i = 0; i < mo->propertyCount(); ++i) {
+        const QMetaProperty property = mo->property(i);
+        const QVariant value = property.readOnGadget(gadget);
+        if (property.metaType().flags() & QMetaType::IsGadget)
+            array.append(toVariantCbor(property.metaType().metaObject(), value.constData()));
+        else
+            array.append(QCborValue::fromVariant(value));
+    }
+    return array;
+}
+
+static void fromVariantCbor(const QCborArray &array, const QMetaObject *mo, void *gadget)
+{
+    for (int i = 0; i < mo->propertyCount() && i < array.size(); ++i) {
+        const QMetaProperty property = mo->property(i);
+        if (property.metaType().flags() & QMetaType::IsGadget) {
+            QVariant value(property.metaType());
+            fromVariantCbor(array.at(i).toArray(), property.metaType().metaObject(), value.data());
+            property.writeOnGadget(gadget, value);
+        } else {
+            property.writeOnGadget(gadget, array.at(i).toVariant());
+        }
+    }
+}
+
+class tst_QCborGadgetSerializer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void writeGadget();
+    void readGadget();
+    void writeVariant();
+    void readVariant();
+    void writeJson();
+    void readJson();
+    void writeDataStream();
+    void readDataStream();
+
+private:
+    QList<Sample> samples;
+};
+
+enum { SampleCount = 1000 };
+
+void tst_QCborGadgetSerializer::initTestCase()
+{
+    for (int i = 0; i < SampleCount; ++i) {
+        Sample s;
+        s.id = i;
+        s.timestamp = Q_INT64_C(1600000000000) + i * 1000;
+        s.name = QString::fromLatin1("sensor-%1").arg(i % 16);
+        s.valid = i % 7 != 0;
+        s.value = i * 0.25;
+        s.kind = Sample::Kind(i % 3);
+        s.checksum = QByteArray::number(i * 7919, 16);
+        s.position.latitude = 59.9 + i * 1e-4;
+        s.position.longitude = 10.7 - i * 1e-4;
+        samples.append(s);
+    }
+}
+
+void tst_QCborGadgetSerializer::writeGadget()
+{
+    QByteArray data;
+    QBENCHMARK {
+        data.clear();
+        QCborStreamWriter writer(&data);
+        writer.startArray(samples.size());
+        for (const Sample &s : qAsConst(samples))
+            QCborGadgetSerializer::write(writer, &Sample::staticMetaObject, &s);
+        writer.endArray();
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void tst_QCborGadgetSerializer::readGadget()
+{
+    QByteArray data;
+    {
+        QCborStreamWriter writer(&data);
+        writer.startArray(samples.size());
+        for (const Sample &s : qAsConst(samples))
+            QCborGadgetSerializer::write(writer, &Sample::staticMetaObject, &s);
+        writer.endArray();
+    }
+
+    QBENCHMARK {
+        QCborStreamReader reader(data);
+        QVERIFY(reader.enterContainer());
+        Sample s;
+        int count = 0;
+        while (reader.hasNext()) {
+            QVERIFY(QCborGadgetSerializer::read(reader, &Sample::staticMetaObject, &s));
+            ++count;
+        }
+        QCOMPARE(count, samples.size());
+    }
+}
+
+void tst_QCborGadgetSerializer::writeVariant()
+{
+    QByteArray data;
+    QBENCHMARK {
+        QCborArray array;
+        for (const Sample &s : qAsConst(samples))
+            array.append(toVariantCbor(&Sample::staticMetaObject, &s));
+        data = QCborValue(array).toCbor();
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void tst_QCborGadgetSerializer::readVariant()
+{
+    QCborArray array;
+    for (const Sample &s : qAsConst(samples))
+        array.append(toVariantCbor(&Sample::staticMetaObject, &s));
+    const QByteArray data = QCborValue(array).toCbor();
+
+    QBENCHMARK {
+        const QCborArray decoded = QCborValue::fromCbor(data).toArray();
+        Sample s;
+        for (const QCborValue &v : decoded)
+            fromVariantCbor(v.toArray(), &Sample::staticMetaObject, &s);
+        QCOMPARE(decoded.size(), samples.size());
+    }
+}
+
+void tst_QCborGadgetSerializer::writeJson()
+{
+    QByteArray data;
+    QBENCHMARK {
+        QJsonArray array;
+        for (const Sample &s : qAsConst(samples))
+            array.append(toJson(s));
+        data = QJsonDocument(array).toJson(QJsonDocument::Compact);
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void tst_QCborGadgetSerializer::readJson()
+{
+    QJsonArray array;
+    for (const Sample &s : qAsConst(samples))
+        array.append(toJson(s));
+    const QByteArray data = QJsonDocument(array).toJson(QJsonDocument::Compact);
+
+    QBENCHMARK {
+        const QJsonArray decoded = QJsonDocument::fromJson(data).array();
+        Sample s;
+        for (const QJsonValue &v : decoded)
+            s = fromJson(v.toObject());
+        QCOMPARE(decoded.size(), samples.size());
+    }
+}
+
+void tst_QCborGadgetSerializer::writeDataStream()
+{
+    QByteArray data;
+    QBENCHMARK {
+        data.clear();
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << samples;
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void tst_QCborGadgetSerializer::readDataStream()
+{
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << samples;
+    }
+
+    QBENCHMARK {
+        QDataStream in(data);
+        QList<Sample> decoded;
+        in >> decoded;
+        QCOMPARE(decoded.size(), samples.size());
+    }
+}
+
+QTEST_MAIN(tst_QCborGadgetSerializer)
+#include "tst_bench_qcborgadgetserializer.moc"
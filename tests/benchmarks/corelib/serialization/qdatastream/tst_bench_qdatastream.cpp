@@ -0,0 +1,123 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryFile>
+
+class tst_QDataStream : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void readFromFile_data() { readData(); }
+    void readFromFile();
+    void readFromMappedFile_data() { readData(); }
+    void readFromMappedFile();
+
+private:
+    void readData();
+    void checkRecords(QDataStream &in, int records);
+
+    QTemporaryFile file;
+};
+
+enum { RecordCount = 20000 };
+
+void tst_QDataStream::initTestCase()
+{
+    QVERIFY(file.open());
+
+    // Each record is a key string and a 4 kB payload, written in the byte
+    // order of the host so that strings can be referenced directly.
+    QDataStream out(&file);
+    out.setByteOrder(QSysInfo::ByteOrder == QSysInfo::BigEndian ? QDataStream::BigEndian
+                                                                 : QDataStream::LittleEndian);
+    const QByteArray payload(4096, 'x');
+    for (int i = 0; i < RecordCount; ++i)
+        out << QString::fromLatin1("record-%1").arg(i) << payload;
+    QVERIFY(file.flush());
+}
+
+void tst_QDataStream::readData()
+{
+    QTest::addColumn<bool>("zeroCopy");
+    QTest::newRow("copy") << false;
+    QTest::newRow("zero-copy") << true;
+}
+
+void tst_QDataStream::checkRecords(QDataStream &in, int records)
+{
+    in.setByteOrder(QSysInfo::ByteOrder == QSysInfo::BigEndian ? QDataStream::BigEndian
+                                                                : QDataStream::LittleEndian);
+    QString key;
+    QByteArray payload;
+    qsizetype total = 0;
+    for (int i = 0; i < records; ++i) {
+        in >> key >> payload;
+        total += key.size() + payload.size();
+    }
+    QCOMPARE(in.status(), QDataStream::Ok);
+    QVERIFY(total > 0);
+}
+
+void tst_QDataStream::readFromFile()
+{
+    QFETCH(bool, zeroCopy);
+
+    QBENCHMARK {
+        QVERIFY(file.seek(0));
+        QDataStream in(&file);
+        // no effect on streams operating on a device
+        in.setZeroCopyEnabled(zeroCopy);
+        checkRecords(in, RecordCount);
+    }
+}
+
+void tst_QDataStream::readFromMappedFile()
+{
+    QFETCH(bool, zeroCopy);
+
+    const qint64 size = file.size();
+    const uchar *memory = file.map(0, size);
+    QVERIFY(memory);
+
+    QBENCHMARK {
+        QDataStream in(QByteArray::fromRawData(reinterpret_cast<const char *>(memory), size));
+        in.setZeroCopyEnabled(zeroCopy);
+        checkRecords(in, RecordCount);
+    }
+
+    QVERIFY(file.unmap(const_cast<uchar *>(memory)));
+}
+
+QTEST_MAIN(tst_QDataStream)
+#include "tst_bench_qdatastream.moc"
@@ -0,0 +1,188 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtCore/QBuffer>
+#include <QtCore/QXmlStreamReader>
+
+class tst_QXmlStreamReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void readAll_data();
+    void readAll();
+    void readAllFromDevice_data() { readAll_data(); }
+    void readAllFromDevice();
+    void selectElementText();
+    void readElementTextByHand();
+
+private:
+    QMap<QByteArray, QByteArray> documents;
+};
+
+enum { ElementCount = 20000 };
+
+// Each document is about 2 MB of UTF-8 encoded XML of a different shape.
+void tst_QXmlStreamReader::initTestCase()
+{
+    const QByteArray sentence = "The quick brown fox jumps over the lazy dog, again and again. ";
+    QByteArray text = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<document>\n";
+    for (int i = 0; i < ElementCount; ++i)
+        text += "  <p id=\"" + QByteArray::number(i) + "\">" + sentence + sentence + "</p>\n";
+    text += "</document>\n";
+    documents.insert("text", text);
+
+    QByteArray attributes = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<document>\n";
+    for (int i = 0; i < ElementCount; ++i) {
+        attributes += "  <point x=\"" + QByteArray::number(i * 1.5) + "\" y=\""
+                + QByteArray::number(i * 2.5) + "\" label=\"point number "
+                + QByteArray::number(i) + " of the polyline\" style=\"stroke: black; fill: none\"/>\n";
+    }
+    attributes += "</document>\n";
+    documents.insert("attributes", attributes);
+
+    QByteArray nested = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<document>\n";
+    for (int i = 0; i < ElementCount; ++i) {
+        nested += "  <item>\n    <name>item" + QByteArray::number(i) + "</name>\n"
+                  "    <value>" + QByteArray::number(i) + "</value>\n  </item>\n";
+    }
+    nested += "</document>\n";
+    documents.insert("indented elements", nested);
+
+    const QByteArray greek = QString::fromUtf16(u"Ταχίστη αλώπηξ βαφής ψημένη γη, δρασκελίζει υπέρ νωθρού κυνός. ").toUtf8();
+    QByteArray nonAscii = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<document>\n";
+    for (int i = 0; i < ElementCount; ++i)
+        nonAscii += "  <p>" + greek + greek + "</p>\n";
+    nonAscii += "</document>\n";
+    documents.insert("non-ASCII text", nonAscii);
+}
+
+void tst_QXmlStreamReader::readAll_data()
+{
+    QTest::addColumn<QByteArray>("document");
+    for (auto it = documents.cbegin(); it != documents.cend(); ++it)
+        QTest::newRow(it.key().constData()) << it.key();
+}
+
+static qint64 readAllTokens(QXmlStreamReader &reader)
+{
+    qint64 characters = 0;
+    while (!reader.atEnd()) {
+        switch (reader.readNext()) {
+        case QXmlStreamReader::Characters:
+            characters += reader.text().size();
+            break;
+        case QXmlStreamReader::StartElement:
+            for (const auto &attribute : reader.attributes())
+                characters += attribute.value().size();
+            break;
+        default:
+            break;
+        }
+    }
+    return characters;
+}
+
+// Parses a document held in memory.
+void tst_QXmlStreamReader::readAll()
+{
+    QFETCH(QByteArray, document);
+    const QByteArray data = documents.value(document);
+
+    QBENCHMARK {
+        QXmlStreamReader reader(data);
+        QVERIFY(readAllTokens(reader) > 0);
+        QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+    }
+}
+
+// Parses a document read from a device, in chunks.
+void tst_QXmlStreamReader::readAllFromDevice()
+{
+    QFETCH(QByteArray, document);
+    QByteArray data = documents.value(document);
+
+    QBENCHMARK {
+        QBuffer buffer(&data);
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+        QXmlStreamReader reader(&buffer);
+        QVERIFY(readAllTokens(reader) > 0);
+        QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+    }
+}
+
+// Extracts the names of all items with a selector.
+void tst_QXmlStreamReader::selectElementText()
+{
+    const QByteArray data = documents.value("indented elements");
+
+    QBENCHMARK {
+        QStringList names;
+        QXmlStreamSelector selector;
+        selector.addPath(QLatin1String("/document/item/name"), [&](QXmlStreamReader &reader) {
+            names.append(reader.readElementText());
+        });
+        QXmlStreamReader reader(data);
+        QVERIFY2(selector.select(&reader), qPrintable(reader.errorString()));
+        QCOMPARE(names.size(), int(ElementCount));
+    }
+}
+
+// Extracts the names of all items with a hand-written reader loop, for comparison.
+void tst_QXmlStreamReader::readElementTextByHand()
+{
+    const QByteArray data = documents.value("indented elements");
+
+    QBENCHMARK {
+        QStringList names;
+        QXmlStreamReader reader(data);
+        if (reader.readNextStartElement() && reader.name() == QLatin1String("document")) {
+            while (reader.readNextStartElement()) {
+                if (reader.name() != QLatin1String("item")) {
+                    reader.skipCurrentElement();
+                    continue;
+                }
+                while (reader.readNextStartElement()) {
+                    if (reader.name() == QLatin1String("name"))
+                        names.append(reader.readElementText());
+                    else
+                        reader.skipCurrentElement();
+                }
+            }
+        }
+        QVERIFY2(!reader.hasError(), qPrintable(reader.errorString()));
+        QCOMPARE(names.size(), int(ElementCount));
+    }
+}
+
+QTEST_MAIN(tst_QXmlStreamReader)
+
+#include "tst_bench_qxmlstream.moc"
@@ -27,6 +27,7 @@
 ****************************************************************************/
 
 #include <QDateTime>
+#include <QDateTimeFormatter>
 #include <QTimeZone>
 #include <QTest>
 #include <QList>
@@ -77,6 +78,9 @@ private Q_SLOTS:
     void toString();
     void toStringTextFormat();
     void toStringIsoFormat();
+    void toStringFormatter();
+    void toStringIsoFormatter();
+    void formatToIsoFormatter();
     void addDays();
     void addDaysTz();
     void addMSecs();
@@ -97,6 +101,8 @@ private Q_SLOTS:
     void fromString();
     void fromStringText();
     void fromStringIso();
+    void fromStringFormatter();
+    void fromStringIsoFormatter();
     void fromMSecsSinceEpoch();
     void fromMSecsSinceEpochUtc();
     void fromMSecsSinceEpochTz();
@@ -337,6 +343,37 @@ void tst_QDateTime::toStringIsoFormat()
     }
 }
 
+void tst_QDateTime::toStringFormatter()
+{
+    const auto list = daily(JULIAN_DAY_2010, JULIAN_DAY_2011);
+    const QDateTimeFormatter formatter(u"yyy-MM-dd hh:mm:ss.zzz t");
+    QBENCHMARK {
+        for (const QDateTime &test : list)
+            formatter.toString(test);
+    }
+}
+
+void tst_QDateTime::toStringIsoFormatter()
+{
+    const auto list = daily(JULIAN_DAY_2010, JULIAN_DAY_2011);
+    const QDateTimeFormatter formatter(Qt::ISODate);
+    QBENCHMARK {
+        for (const QDateTime &test : list)
+            formatter.toString(test);
+    }
+}
+
+void tst_QDateTime::formatToIsoFormatter()
+{
+    const auto list = daily(JULIAN_DAY_2010, JULIAN_DAY_2011);
+    const QDateTimeFormatter formatter(Qt::ISODate);
+    QChar buffer[32];
+    QBENCHMARK {
+        for (const QDateTime &test : list)
+            formatter.formatTo(test, buffer, 32);
+    }
+}
+
 void tst_QDateTime::addDays()
 {
     const auto list = daily(JULIAN_DAY_2010, JULIAN_DAY_2020);
@@ -538,6 +575,28 @@ void tst_QDateTime::fromStringIso()
     }
 }
 
+void tst_QDateTime::fromStringFormatter()
+{
+    const QDateTimeFormatter formatter(u"yyyy-MM-dd hh:mm:ss.zzz");
+    QString input = "2010-01-01 13:12:11.999";
+    QVERIFY(formatter.fromString(input).isValid());
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            formatter.fromString(input);
+    }
+}
+
+void tst_QDateTime::fromStringIsoFormatter()
+{
+    const QDateTimeFormatter formatter(Qt::ISODate);
+    QString input = "2010-01-01T13:28:34.999Z";
+    QVERIFY(formatter.fromString(input).isValid());
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i)
+            formatter.fromString(input);
+    }
+}
+
 void tst_QDateTime::fromMSecsSinceEpoch()
 {
     const int start = JULIAN_DAY_2010 - JULIAN_DAY_1970;
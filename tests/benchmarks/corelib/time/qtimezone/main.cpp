@@ -49,6 +49,10 @@ private Q_SLOTS:
     void transitionsForward();
     void transitionsReverse_data() { transitionList_data(); }
     void transitionsReverse();
+    void offsetFromUtc_data() { transitionList_data(); }
+    void offsetFromUtc();
+    void offsetFromUtcFuture_data() { transitionList_data(); }
+    void offsetFromUtcFuture();
 };
 
 static QList<QByteArray> enoughZones()
@@ -161,6 +165,43 @@ void tst_QTimeZone::transitionsReverse()
     }
 }
 
+static QList<QDateTime> hourly(const QDateTime &from, int count)
+{
+    QList<QDateTime> list;
+    list.reserve(count);
+    for (int i = 0; i < count; ++i)
+        list.append(from.addSecs(i * 3637));
+    return list;
+}
+
+void tst_QTimeZone::offsetFromUtc()
+{
+    QFETCH(QByteArray, name);
+    const QTimeZone zone = name.isEmpty() ? QTimeZone::systemTimeZone() : QTimeZone(name);
+    // Spans the transitions tz database files list explicitly
+    const auto list = hourly(QDate(1970, 1, 1).startOfDay(Qt::UTC), 100000);
+    int sum = 0;
+    QBENCHMARK {
+        for (const QDateTime &when : list)
+            sum += zone.offsetFromUtc(when);
+    }
+    Q_UNUSED(sum);
+}
+
+void tst_QTimeZone::offsetFromUtcFuture()
+{
+    QFETCH(QByteArray, name);
+    const QTimeZone zone = name.isEmpty() ? QTimeZone::systemTimeZone() : QTimeZone(name);
+    // Past the end of explicit transitions, where POSIX rules apply
+    const auto list = hourly(QDate(2040, 1, 1).startOfDay(Qt::UTC), 100000);
+    int sum = 0;
+    QBENCHMARK {
+        for (const QDateTime &when : list)
+            sum += zone.offsetFromUtc(when);
+    }
+    Q_UNUSED(sum);
+}
+
 QTEST_MAIN(tst_QTimeZone)
 
 #include "main.moc"
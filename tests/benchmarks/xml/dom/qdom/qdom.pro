@@ -0,0 +1,6 @@
+TEMPLATE = app
+CONFIG += benchmark
+QT = core xml testlib
+
+TARGET = tst_bench_qdom
+SOURCES += tst_bench_qdom.cpp
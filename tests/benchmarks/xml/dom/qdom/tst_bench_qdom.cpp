@@ -0,0 +1,202 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtXml/QDomDocument>
+#include <QtCore/QXmlStreamReader>
+
+#if defined(__GLIBC__)
+#  include <malloc.h>
+#endif
+
+class tst_QDomDocument : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void setContent_data();
+    void setContent();
+    void memoryUsage_data() { setContent_data(); }
+    void memoryUsage();
+    void traverse_data() { setContent_data(); }
+    void traverse();
+    void extractTextWithDom();
+    void extractTextWithSelector();
+
+private:
+    QMap<QByteArray, QByteArray> documents;
+};
+
+enum { ElementCount = 20000 };
+
+void tst_QDomDocument::initTestCase()
+{
+    QByteArray records = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<records>\n";
+    for (int i = 0; i < ElementCount; ++i) {
+        records += "  <record id=\"" + QByteArray::number(i) + "\" type=\"entry\">\n"
+                   "    <name>record" + QByteArray::number(i) + "</name>\n"
+                   "    <value unit=\"mm\">" + QByteArray::number(i * 0.25) + "</value>\n"
+                   "  </record>\n";
+    }
+    records += "</records>\n";
+    documents.insert("records", records);
+
+    QByteArray text = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<book>\n";
+    for (int i = 0; i < ElementCount; ++i) {
+        text += "  <para>The quick brown fox jumps over the lazy dog, "
+                "again and again, for the " + QByteArray::number(i) + "th time.</para>\n";
+    }
+    text += "</book>\n";
+    documents.insert("text", text);
+
+    QByteArray namespaces = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                            "<svg:svg xmlns:svg=\"http://www.w3.org/2000/svg\" "
+                            "xmlns:xlink=\"http://www.w3.org/1999/xlink\">\n";
+    for (int i = 0; i < ElementCount; ++i) {
+        namespaces += "  <svg:use xlink:href=\"#shape" + QByteArray::number(i % 16)
+                + "\" svg:x=\"" + QByteArray::number(i) + "\" svg:y=\"" + QByteArray::number(i)
+                + "\"/>\n";
+    }
+    namespaces += "</svg:svg>\n";
+    documents.insert("namespaces", namespaces);
+}
+
+void tst_QDomDocument::setContent_data()
+{
+    QTest::addColumn<QByteArray>("document");
+    QTest::addColumn<bool>("namespaceProcessing");
+    for (auto it = documents.cbegin(); it != documents.cend(); ++it) {
+        QTest::newRow(it.key().constData()) << it.key() << false;
+        QTest::newRow(it.key() + " (namespace processing)") << it.key() << true;
+    }
+}
+
+// Parses a document, including destroying it afterwards.
+void tst_QDomDocument::setContent()
+{
+    QFETCH(QByteArray, document);
+    QFETCH(bool, namespaceProcessing);
+    const QByteArray data = documents.value(document);
+
+    QBENCHMARK {
+        QDomDocument doc;
+        QVERIFY(doc.setContent(data, namespaceProcessing));
+    }
+}
+
+// Reports the heap memory held by a parsed document.
+void tst_QDomDocument::memoryUsage()
+{
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    QFETCH(QByteArray, document);
+    QFETCH(bool, namespaceProcessing);
+    const QByteArray data = documents.value(document);
+
+    const size_t before = mallinfo2().uordblks;
+    QDomDocument doc;
+    QVERIFY(doc.setContent(data, namespaceProcessing));
+    const size_t after = mallinfo2().uordblks;
+
+    QTest::setBenchmarkResult(qreal(after - before), QTest::BytesAllocated);
+#else
+    QSKIP("Measuring the heap usage requires glibc 2.33 or later");
+#endif
+}
+
+// Visits every element and attribute of a parsed document.
+void tst_QDomDocument::traverse()
+{
+    QFETCH(QByteArray, document);
+    QFETCH(bool, namespaceProcessing);
+    QDomDocument doc;
+    QVERIFY(doc.setContent(documents.value(document), namespaceProcessing));
+
+    QBENCHMARK {
+        qsizetype count = 0;
+        QDomNode node = doc.documentElement();
+        while (!node.isNull()) {
+            if (node.isElement()) {
+                const QDomNamedNodeMap attributes = node.attributes();
+                for (int i = 0; i < attributes.length(); ++i)
+                    count += attributes.item(i).nodeValue().size();
+            }
+            count += node.nodeName().size();
+
+            if (node.hasChildNodes()) {
+                node = node.firstChild();
+                continue;
+            }
+            while (!node.isNull() && node.nextSibling().isNull())
+                node = node.parentNode();
+            if (!node.isNull())
+                node = node.nextSibling();
+        }
+        QVERIFY(count > 0);
+    }
+}
+
+// Extracts the names of all records by parsing the document into a tree.
+void tst_QDomDocument::extractTextWithDom()
+{
+    const QByteArray data = documents.value("records");
+
+    QBENCHMARK {
+        QStringList names;
+        QDomDocument doc;
+        QVERIFY(doc.setContent(data));
+        for (QDomElement record = doc.documentElement().firstChildElement(QLatin1String("record"));
+             !record.isNull(); record = record.nextSiblingElement(QLatin1String("record"))) {
+            names.append(record.firstChildElement(QLatin1String("name")).text());
+        }
+        QCOMPARE(names.size(), int(ElementCount));
+    }
+}
+
+// Extracts the names of all records from the same document with a
+// QXmlStreamSelector, for comparison.
+void tst_QDomDocument::extractTextWithSelector()
+{
+    const QByteArray data = documents.value("records");
+
+    QBENCHMARK {
+        QStringList names;
+        QXmlStreamSelector selector;
+        selector.addPath(QLatin1String("/records/record/name"), [&](QXmlStreamReader &reader) {
+            names.append(reader.readElementText());
+        });
+        QXmlStreamReader reader(data);
+        QVERIFY2(selector.select(&reader), qPrintable(reader.errorString()));
+        QCOMPARE(names.size(), int(ElementCount));
+    }
+}
+
+QTEST_MAIN(tst_QDomDocument)
+
+#include "tst_bench_qdom.moc"